@@ -26,6 +26,9 @@
 #include "Sound_and_LPC.h"
 #include "Sound.h"
 #include "Sound_and_LPC_robust.h"
+#include "MelderThread.h"
+#include <atomic>
+#include <vector>
 
 #include "oo_DESTROY.h"
 #include "FormantPath_def.h"
@@ -243,7 +246,12 @@ autoFormantPath Sound_to_FormantPath_any (Sound me, kLPC_Analysis lpcType, doubl
 		*/
 		integer numberOfFrames;
 		double t1;
-		autoSound midCeiling = Sound_resample (me, 2.0 * middleCeiling, 50);
+		/*
+			Every ceiling needs a downsampled copy of the sound;
+			the downsamplings share the Fourier transform of the sound for their anti-aliasing filter.
+		*/
+		autoMAT antiAliasingSpectra = Sound_computeAntiAliasingSpectra (me);
+		autoSound midCeiling = Sound_resample_fromSpectra (me, antiAliasingSpectra.get(), 2.0 * middleCeiling, 50);
 		Sampled_shortTermAnalysis (midCeiling.get(), windowDuration, timeStep, & numberOfFrames, & t1); // Gaussian window
 		const integer predictionOrder = Melder_iround (2.0 * maximumNumberOfFormants);
 		autoFormantPath thee = FormantPath_create (my xmin, my xmax, numberOfFrames, timeStep, t1, numberOfCeilings);
@@ -251,34 +259,53 @@ autoFormantPath Sound_to_FormantPath_any (Sound me, kLPC_Analysis lpcType, doubl
 		if (out_sourcesMultiChannel)
 			multiChannelSound = Sound_create (numberOfCeilings, midCeiling -> xmin, midCeiling -> xmax, midCeiling -> nx, midCeiling -> dx, midCeiling -> x1);
 		const double formantSafetyMargin = 50.0;
+		for (integer ic  = 1; ic <= numberOfCeilings; ic ++)
+			thy ceilings [ic] = middleCeiling * exp (ceilingStepSize * (ic - numberOfStepsToACeiling - 1));
 		thy ceilings [numberOfStepsToACeiling + 1] = middleCeiling;
-		for (integer ic  = 1; ic <= numberOfCeilings; ic ++) {
-			autoFormant formant;
-			if (ic <= numberOfStepsToACeiling)
-				thy ceilings [ic] = middleCeiling * exp (-ceilingStepSize * (numberOfStepsToACeiling - ic + 1));
-			else if (ic > numberOfStepsToACeiling + 1)
-				thy ceilings [ic] = middleCeiling * exp ( ceilingStepSize * (ic - numberOfStepsToACeiling - 1));
-			autoSound resampled;
-			if (ic != numberOfStepsToACeiling + 1)
-				resampled = Sound_resample (me, 2.0 * thy ceilings [ic], 50);
-			else 
-				resampled = midCeiling.move();
-			autoLPC lpc = LPC_create (my xmin, my xmax, numberOfFrames, timeStep, t1, predictionOrder, resampled -> dx);
-			if (lpcType != kLPC_Analysis::ROBUST) {
-				Sound_into_LPC (resampled.get(), lpc.get(), analysisWidth, preemphasisFrequency, lpcType, marple_tol1, marple_tol2);
-			} else {
-				Sound_into_LPC (resampled.get(), lpc.get(), analysisWidth, preemphasisFrequency, kLPC_Analysis::AUTOCORRELATION, marple_tol1, marple_tol2);
-				lpc = LPC_Sound_to_LPC_robust (lpc.get(), resampled.get(), analysisWidth, preemphasisFrequency, huber_numberOfStdDev, huber_maximumNumberOfIterations, huber_tol, true);
-			}
-			formant = LPC_to_Formant (lpc.get(), formantSafetyMargin);
-			thy formants . addItem_move (formant.move());
-			if (out_sourcesMultiChannel) {
-				autoSound source = LPC_Sound_filterInverse (lpc.get(), resampled.get ());
-				autoSound source_resampled = Sound_resample (source.get(), 2.0 * middleCeiling, 50);
-				const integer numberOfSamples = std::min (midCeiling -> nx, source_resampled -> nx);
-				multiChannelSound -> z.row (ic).part (1, numberOfSamples) <<= source_resampled -> z.row (1).part (1, numberOfSamples);
+		/*
+			The ceilings are independent analyses, so they can run concurrently;
+			each of them writes only its own Formant and its own channel of the sources.
+			The tasks count their failed and suspect frames instead of warning, so that we warn only once.
+		*/
+		std::vector <autoFormant> formants (integer_to_uinteger (numberOfCeilings));
+		std::atomic <integer> numberOfFailedLPCFrames (0), numberOfSuspectFormantFrames (0);
+		MelderThread_run (numberOfCeilings, MelderThread_computeNumberOfThreads (numberOfCeilings, 1), 1,
+			[&] (integer /* ithread */, integer firstCeiling, integer lastCeiling) {
+				for (integer ic = firstCeiling; ic <= lastCeiling; ic ++) {
+					autoSound resampled;
+					if (ic != numberOfStepsToACeiling + 1)
+						resampled = Sound_resample_fromSpectra (me, antiAliasingSpectra.get(), 2.0 * thy ceilings [ic], 50);
+					else
+						resampled = Data_copy (midCeiling.get());
+					autoLPC lpc = LPC_create (my xmin, my xmax, numberOfFrames, timeStep, t1, predictionOrder, resampled -> dx);
+					if (lpcType != kLPC_Analysis::ROBUST) {
+						Sound_into_LPC (resampled.get(), lpc.get(), analysisWidth, preemphasisFrequency, lpcType, marple_tol1, marple_tol2);
+					} else {
+						Sound_into_LPC (resampled.get(), lpc.get(), analysisWidth, preemphasisFrequency, kLPC_Analysis::AUTOCORRELATION, marple_tol1, marple_tol2);
+						integer numberOfFailedFrames;
+						lpc = LPC_Sound_to_LPC_robust_noWarning (lpc.get(), resampled.get(), analysisWidth, preemphasisFrequency,
+							huber_numberOfStdDev, huber_maximumNumberOfIterations, huber_tol, true, & numberOfFailedFrames);
+						numberOfFailedLPCFrames += numberOfFailedFrames;
+					}
+					integer numberOfSuspectFrames;
+					formants [ic - 1] = LPC_to_Formant_noWarning (lpc.get(), formantSafetyMargin, & numberOfSuspectFrames);
+					numberOfSuspectFormantFrames += numberOfSuspectFrames;
+					if (out_sourcesMultiChannel) {
+						autoSound source = LPC_Sound_filterInverse (lpc.get(), resampled.get ());
+						autoSound source_resampled = Sound_resample (source.get(), 2.0 * middleCeiling, 50);
+						const integer numberOfSamples = std::min (midCeiling -> nx, source_resampled -> nx);
+						multiChannelSound -> z.row (ic).part (1, numberOfSamples) <<= source_resampled -> z.row (1).part (1, numberOfSamples);
+					}
+				}
 			}
-		}
+		);
+		if (numberOfFailedLPCFrames > 0)
+			Melder_warning (U"Results of ", (integer) numberOfFailedLPCFrames, U" frame(s) out of ", numberOfCeilings * numberOfFrames,
+				U" could not be optimised.");
+		if (numberOfSuspectFormantFrames > 0)
+			Melder_warning ((integer) numberOfSuspectFormantFrames, U" formant frames out of ", numberOfCeilings * numberOfFrames, U" are suspect.");
+		for (integer ic = 1; ic <= numberOfCeilings; ic ++)
+			thy formants. addItem_move (formants [ic - 1].move());
 		/*
 			Maintain invariants
 		*/
@@ -24,6 +24,11 @@
 #include "Formant.h"
 
 autoFormant LPC_to_Formant (LPC me, double margin);
+/*
+	As LPC_to_Formant, but instead of warning about the frames whose roots could not be found,
+	counts them in *out_numberOfSuspectFrames, so that a caller that runs it in a MelderThread task can warn once.
+*/
+autoFormant LPC_to_Formant_noWarning (LPC me, double margin, integer *out_numberOfSuspectFrames);
 
 autoLPC Formant_to_LPC (Formant me, double samplingPeriod);
 
@@ -21,6 +21,7 @@
 #include "NUM2.h"
 #include "Sound_and_Spectrum.h"
 #include "Sound_extensions.h"
+#include <functional>
 
 
 #define TOLOG(x) ((1 / NUMln10) * log ((x) + 1e-30))
@@ -313,20 +314,41 @@ autoPowerCepstrogram Matrix_to_PowerCepstrogram (Matrix me) {
 	}
 }
 
+/*
+	The resampled and pre-emphasized Sound and the analysis frames of Sound_to_PowerCepstrogram ().
+*/
+static autoSound Sound_prepareForPowerCepstrogram (Sound me, double pitchFloor, double dt, double maximumFrequency, double preEmphasisFrequency,
+	double *out_windowDuration, integer *out_numberOfFrames, double *out_t1)
+{
+	const double analysisWidth = 3.0  / pitchFloor; // minimum analysis window has 3 periods of lowest pitch
+	double windowDuration = 2.0 * analysisWidth; // gaussian window
+
+	// Convenience: analyse the whole sound into one Cepstrogram_frame
+	if (windowDuration > my dx * my nx)
+		windowDuration = my dx * my nx;
+	const double samplingFrequency = 2 * maximumFrequency;
+	autoSound sound = Sound_resample (me, samplingFrequency, 50);
+	Sound_preEmphasis (sound.get(), preEmphasisFrequency);
+	Sampled_shortTermAnalysis (me, windowDuration, dt, out_numberOfFrames, out_t1);
+	*out_windowDuration = windowDuration;
+	return sound;
+}
+
+static void Sound_into_PowerCepstrogram_frame (Sound sound, Sound sframe, Sound window, double t, VECVU const& cepstrum) {
+	Sound_into_Sound (sound, sframe, t - (sframe -> xmax - sframe -> xmin) / 2);
+	Vector_subtractMean (sframe);
+	Sounds_multiply (sframe, window);
+	autoSpectrum spec = Sound_to_Spectrum (sframe, true);   // FFT yes
+	autoPowerCepstrum powerCepstrum = Spectrum_to_PowerCepstrum (spec.get());
+	cepstrum  <<=  powerCepstrum -> z.row (1);
+}
+
 autoPowerCepstrogram Sound_to_PowerCepstrogram (Sound me, double pitchFloor, double dt, double maximumFrequency, double preEmphasisFrequency) {
 	try {
-		const double analysisWidth = 3.0  / pitchFloor; // minimum analysis window has 3 periods of lowest pitch
-		double windowDuration = 2.0 * analysisWidth; // gaussian window
+		double windowDuration, t1;
 		integer nFrames;
-
-		// Convenience: analyse the whole sound into one Cepstrogram_frame
-		if (windowDuration > my dx * my nx)
-			windowDuration = my dx * my nx;
+		autoSound sound = Sound_prepareForPowerCepstrogram (me, pitchFloor, dt, maximumFrequency, preEmphasisFrequency, & windowDuration, & nFrames, & t1);
 		const double samplingFrequency = 2 * maximumFrequency;
-		autoSound sound = Sound_resample (me, samplingFrequency, 50);
-		Sound_preEmphasis (sound.get(), preEmphasisFrequency);
-		double t1;
-		Sampled_shortTermAnalysis (me, windowDuration, dt, & nFrames, & t1);
 		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
 		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
 		/*
@@ -343,13 +365,7 @@ autoPowerCepstrogram Sound_to_PowerCepstrogram (Sound me, double pitchFloor, dou
 
 		for (integer iframe = 1; iframe <= nFrames; iframe++) {
 			const double t = Sampled_indexToX (thee.get(), iframe);
-			Sound_into_Sound (sound.get(), sframe.get(), t - windowDuration / 2);
-			Vector_subtractMean (sframe.get());
-			Sounds_multiply (sframe.get(), window.get());
-			autoSpectrum spec = Sound_to_Spectrum (sframe.get(), true);   // FFT yes
-			autoPowerCepstrum cepstrum = Spectrum_to_PowerCepstrum (spec.get());
-			for (integer i = 1; i <= nq; i ++)
-				thy z [i] [iframe] = cepstrum -> z [1] [i];
+			Sound_into_PowerCepstrogram_frame (sound.get(), sframe.get(), window.get(), t, thy z.column (iframe));
 
 			if ((iframe % 10) == 1)
 				Melder_progress ((double) iframe / nFrames, U"PowerCepstrogram analysis of frame ",
@@ -467,8 +483,108 @@ autoPowerCepstrogram Sound_to_PowerCepstrogram_hillenbrand (Sound me, double pit
 	}
 }
 
+/*
+	The mean cepstral peak prominence of the smoothed cepstrogram, without creating the full or the smoothed cepstrogram.
+	`getFrame (iframe, cepstrum)` delivers the frames 1 .. numberOfFrames of a cepstrogram with the given time sampling,
+	in order and each frame once; we keep only the frames that the time averaging of the current frame needs.
+	The smoothing is the same as in PowerCepstrogram_smoothRectangular ().
+*/
+static double PowerCepstrogram_getCPPS_streaming (double tmin, double tmax, integer numberOfFrames, double dt, double t1, double qmax, integer nq, double dq,
+	std::function <void (integer iframe, VEC cepstrum)> const& getFrame,
+	bool subtractTrendBeforeSmoothing, double qstartFit, double qendFit, kCepstrumTrendType lineType, kCepstrumTrendFit fitMethod,
+	double timeAveragingWindow, double quefrencyAveragingWindow, std::function <double (PowerCepstrum)> const& getPeakProminence)
+{
+	/*
+		Sampled_getMean () over a time window needs the frames inside the window and one more on either side.
+		The buffer is a PowerCepstrogram that holds the frames firstFrameInBuffer .. firstFrameInBuffer + numberOfFramesInBuffer - 1;
+		it has the time domain of the whole cepstrogram, so that the means are computed as if all frames were there.
+	*/
+	const double halfWindow = 0.5 * timeAveragingWindow;
+	const bool weAverageOverTime = ( Melder_ifloor (timeAveragingWindow / dt) > 1 );
+	const integer margin = ( weAverageOverTime ? Melder_iceiling (halfWindow / dt) + 2 : 0 );
+	const integer bufferSize = std::min (numberOfFrames, 2 * margin + 1 + 64);   // shift the buffer once every 64 frames
+	autoPowerCepstrogram buffer = PowerCepstrogram_create (tmin, tmax, bufferSize, dt, t1, 0.0, qmax, nq, dq, 0.0);
+	integer firstFrameInBuffer = 1, numberOfFramesInBuffer = 0;
+	buffer -> nx = 0;
+
+	autoPowerCepstrum trend = PowerCepstrum_create (qmax, nq);
+	autoPowerCepstrum smooth = PowerCepstrum_create (qmax, nq);
+	const bool weAverageOverQuefrency = ( Melder_ifloor (quefrencyAveragingWindow / buffer -> dy) > 1 );
+	longdouble sum = 0.0;
+	for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
+		const integer firstFrameNeeded = std::max (1_integer, iframe - margin);
+		const integer lastFrameNeeded = std::min (iframe + margin, numberOfFrames);
+		if (lastFrameNeeded >= firstFrameInBuffer + bufferSize) {
+			const integer shift = firstFrameNeeded - firstFrameInBuffer;
+			for (integer iq = 1; iq <= nq; iq ++) {
+				const VEC row = buffer -> z.row (iq);
+				std::copy (& row [shift + 1], & row [numberOfFramesInBuffer] + 1, & row [1]);
+			}
+			firstFrameInBuffer = firstFrameNeeded;
+			numberOfFramesInBuffer -= shift;
+			buffer -> x1 = t1 + (firstFrameInBuffer - 1) * dt;
+		}
+		while (firstFrameInBuffer + numberOfFramesInBuffer - 1 < lastFrameNeeded) {
+			const integer column = ++ numberOfFramesInBuffer;
+			buffer -> nx = numberOfFramesInBuffer;
+			getFrame (firstFrameInBuffer + column - 1, trend -> z.row (1));
+			if (subtractTrendBeforeSmoothing)
+				PowerCepstrum_subtractTrend_inplace (trend.get(), qstartFit, qendFit, lineType, fitMethod);
+			buffer -> z.column (column)  <<=  trend -> z.row (1);
+		}
+		/*
+			1. average across time
+		*/
+		const integer column = iframe - firstFrameInBuffer + 1;
+		if (weAverageOverTime) {
+			const double xmid = t1 + (iframe - 1) * dt;
+			for (integer iq = 1; iq <= nq; iq ++)
+				smooth -> z [1] [iq] = Sampled_getMean (buffer.get(), xmid - halfWindow, xmid + halfWindow, iq, 0, true);
+		} else
+			smooth -> z.row (1)  <<=  buffer -> z.column (column);
+		/*
+			2. average across quefrencies
+		*/
+		if (weAverageOverQuefrency)
+			PowerCepstrum_smooth_inplace (smooth.get(), quefrencyAveragingWindow, 1);
+		sum += getPeakProminence (smooth.get());
+	}
+	return double (sum) / numberOfFrames;
+}
+
+static double PowerCepstrogram_getCPPS_streaming (PowerCepstrogram me,
+	bool subtractTrendBeforeSmoothing, double qstartFit, double qendFit, kCepstrumTrendType lineType, kCepstrumTrendFit fitMethod,
+	double timeAveragingWindow, double quefrencyAveragingWindow, std::function <double (PowerCepstrum)> const& getPeakProminence)
+{
+	return PowerCepstrogram_getCPPS_streaming (my xmin, my xmax, my nx, my dx, my x1, my ymax, my ny, my dy,
+		[&] (integer iframe, VEC cepstrum) {
+			cepstrum  <<=  my z.column (iframe);
+		},
+		subtractTrendBeforeSmoothing, qstartFit, qendFit, lineType, fitMethod,
+		timeAveragingWindow, quefrencyAveragingWindow, getPeakProminence
+	);
+}
+
+/*
+	The smoothing methods for debugging work on the whole cepstrogram at once.
+*/
+static bool PowerCepstrogram_smoothingCanStream () {
+	return Melder_debug != -4 && Melder_debug != -5;
+}
+
 double PowerCepstrogram_getCPPS (PowerCepstrogram me, bool subtractTiltBeforeSmoothing, double timeAveragingWindow, double quefrencyAveragingWindow, double pitchFloor, double pitchCeiling, double deltaF0, kVector_peakInterpolation peakInterpolationType, double qstartFit, double qendFit, kCepstrumTrendType lineType, kCepstrumTrendFit fitMethod) {
 	try {
+		if (PowerCepstrogram_smoothingCanStream ()) {
+			(void) deltaF0;   // only needed for the rnr column of PowerCepstrogram_to_Table_cpp ()
+			return PowerCepstrogram_getCPPS_streaming (me, subtractTiltBeforeSmoothing, qstartFit, qendFit, lineType, fitMethod,
+				timeAveragingWindow, quefrencyAveragingWindow,
+				[&] (PowerCepstrum smooth) {
+					double qpeak;
+					return PowerCepstrum_getPeakProminence (smooth, pitchFloor, pitchCeiling, peakInterpolationType,
+						qstartFit, qendFit, lineType, fitMethod, & qpeak);
+				}
+			);
+		}
 		autoPowerCepstrogram flattened;
 		if (subtractTiltBeforeSmoothing)
 			flattened = PowerCepstrogram_subtractTrend (me, qstartFit, qendFit, lineType, fitMethod);
@@ -484,6 +600,14 @@ double PowerCepstrogram_getCPPS (PowerCepstrogram me, bool subtractTiltBeforeSmo
 
 double PowerCepstrogram_getCPPS_hillenbrand (PowerCepstrogram me, bool subtractTiltBeforeSmoothing, double timeAveragingWindow, double quefrencyAveragingWindow, double pitchFloor, double pitchCeiling) {
 	try {
+		if (PowerCepstrogram_smoothingCanStream ())
+			return PowerCepstrogram_getCPPS_streaming (me, subtractTiltBeforeSmoothing, 0.001, 0, kCepstrumTrendType::LINEAR, kCepstrumTrendFit::LEAST_SQUARES,
+				timeAveragingWindow, quefrencyAveragingWindow,
+				[&] (PowerCepstrum smooth) {
+					double qpeak;
+					return PowerCepstrum_getPeakProminence_hillenbrand (smooth, pitchFloor, pitchCeiling, & qpeak);
+				}
+			);
 		autoPowerCepstrogram him;
 		if (subtractTiltBeforeSmoothing)
 			him = PowerCepstrogram_subtractTrend (me, 0.001, 0, kCepstrumTrendType::LINEAR, kCepstrumTrendFit::LEAST_SQUARES);
@@ -497,4 +621,47 @@ double PowerCepstrogram_getCPPS_hillenbrand (PowerCepstrogram me, bool subtractT
 	}
 }
 
+double Sound_getCPPS (Sound me, double pitchFloor, double dt, double maximumFrequency, double preEmphasisFrequency,
+	bool subtractTiltBeforeSmoothing, double timeAveragingWindow, double quefrencyAveragingWindow, double pitchFloor_peak, double pitchCeiling_peak,
+	double deltaF0, kVector_peakInterpolation peakInterpolationType, double qstartFit, double qendFit, kCepstrumTrendType lineType, kCepstrumTrendFit fitMethod)
+{
+	try {
+		if (! PowerCepstrogram_smoothingCanStream ()) {
+			autoPowerCepstrogram cepstrogram = Sound_to_PowerCepstrogram (me, pitchFloor, dt, maximumFrequency, preEmphasisFrequency);
+			return PowerCepstrogram_getCPPS (cepstrogram.get(), subtractTiltBeforeSmoothing, timeAveragingWindow, quefrencyAveragingWindow,
+				pitchFloor_peak, pitchCeiling_peak, deltaF0, peakInterpolationType, qstartFit, qendFit, lineType, fitMethod);
+		}
+		double windowDuration, t1;
+		integer numberOfFrames;
+		autoSound sound = Sound_prepareForPowerCepstrogram (me, pitchFloor, dt, maximumFrequency, preEmphasisFrequency, & windowDuration, & numberOfFrames, & t1);
+		const double samplingFrequency = 2 * maximumFrequency;
+		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
+		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
+		integer nfft = 2;
+		while (nfft < sframe -> nx)
+			nfft *= 2;
+		const integer nq = nfft / 2 + 1;
+		const double qmax = 0.5 * nfft / samplingFrequency, dq = qmax / (nq - 1);
+
+		autoMelderProgress progress (U"CPPS analysis");
+		return PowerCepstrogram_getCPPS_streaming (my xmin, my xmax, numberOfFrames, dt, t1, qmax, nq, dq,
+			[&] (integer iframe, VEC cepstrum) {
+				Sound_into_PowerCepstrogram_frame (sound.get(), sframe.get(), window.get(), t1 + (iframe - 1) * dt, cepstrum);
+				if ((iframe % 10) == 1)
+					Melder_progress ((double) iframe / numberOfFrames, U"CPPS analysis of frame ",
+						iframe, U" out of ", numberOfFrames, U".");
+			},
+			subtractTiltBeforeSmoothing, qstartFit, qendFit, lineType, fitMethod,
+			timeAveragingWindow, quefrencyAveragingWindow,
+			[&] (PowerCepstrum smooth) {
+				double qpeak;
+				return PowerCepstrum_getPeakProminence (smooth, pitchFloor_peak, pitchCeiling_peak, peakInterpolationType,
+					qstartFit, qendFit, lineType, fitMethod, & qpeak);
+			}
+		);
+	} catch (MelderError) {
+		Melder_throw (me, U": no CPPS value calculated.");
+	}
+}
+
 /* End of file PowerCepstrogram.cpp */
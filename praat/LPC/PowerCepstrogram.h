@@ -68,6 +68,14 @@ double PowerCepstrogram_getCPPS_hillenbrand (PowerCepstrogram me, bool subtractT
 
 double PowerCepstrogram_getCPPS (PowerCepstrogram me, bool subtractTiltBeforeSmoothing, double timeAveragingWindow, double quefrencyAveragingWindow, double pitchFloor, double pitchCeiling, double deltaF0, kVector_peakInterpolation peakInterpolationType, double qstartFit, double qendFit, kCepstrumTrendType lineType, kCepstrumTrendFit fitMethod);
 
+double Sound_getCPPS (Sound me, double pitchFloor, double dt, double maximumFrequency, double preEmphasisFrequency,
+	bool subtractTiltBeforeSmoothing, double timeAveragingWindow, double quefrencyAveragingWindow, double pitchFloor_peak, double pitchCeiling_peak,
+	double deltaF0, kVector_peakInterpolation peakInterpolationType, double qstartFit, double qendFit, kCepstrumTrendType lineType, kCepstrumTrendFit fitMethod);
+/*
+	The same as Sound_to_PowerCepstrogram () followed by PowerCepstrogram_getCPPS (),
+	but without creating the cepstrogram: the memory use does not grow with the duration of the sound.
+*/
+
 autoMatrix PowerCepstrogram_to_Matrix (PowerCepstrogram me);
 
 autoPowerCepstrogram Matrix_to_PowerCepstrogram (Matrix me);
@@ -29,11 +29,11 @@
 #include "Sound_extensions.h"
 #include "Vector.h"
 #include "Spectrum.h"
-#include <thread>
+#include "NUM2.h"
+#include "MelderThread.h"
 #include <atomic>
-#include <functional>
+#include <optional>
 #include <vector>
-#include "NUM2.h"
 
 #define LPC_METHOD_AUTO 1
 #define LPC_METHOD_COVAR 2
@@ -72,12 +72,6 @@ static integer getLPCAnalysisWorkspaceSize (integer numberOfSamples, integer num
 	return size;
 }
 
-static autoVEC getLPCAnalysisWorkspace (integer numberOfSamples, integer numberOfCoefficients, kLPC_Analysis method) {
-	integer size = getLPCAnalysisWorkspaceSize (numberOfSamples, numberOfCoefficients, method);
-	autoVEC result = raw_VEC (size);
-	return result;
-}
-
 static int Sound_into_LPC_Frame_auto (Sound me, LPC_Frame thee, VEC const& workspace) {
 	Melder_assert (thy nCoefficients == thy a.size); // check invariant
 	const integer numberOfCoefficients = thy nCoefficients, np1 = numberOfCoefficients + 1;
@@ -434,66 +428,7 @@ end:
 	return status == 1 || status == 4 || status == 5;
 }
 
-static void Sound_into_LPC_noThreads (Sound me, LPC thee, double analysisWidth, double preEmphasisFrequency, kLPC_Analysis method, double tol1, double tol2) {
-	Melder_require (my xmin == thy xmin && my xmax == thy xmax, 
-		U"The Sound and the LPC should have the same domain.");
-	const double samplingFrequency = 1.0 / my dx;
-	double windowDuration = 2.0 * analysisWidth; // Gaussian window
-	const integer predictionOrder = thy maxnCoefficients;
-	Melder_require (Melder_roundDown (windowDuration / my dx) > predictionOrder,
-		U"Analysis window duration too short.\n For a prediction order of ", predictionOrder,
-		U" the analysis window duration should be greater than ", my dx * (predictionOrder + 1),
-		U" s. Please increase the analysis window duration.");
-	/*
-		Convenience: analyse the whole sound into one LPC_frame.
-	*/
-	if (windowDuration > my dx * my nx)
-		windowDuration = my dx * my nx;
-	integer numberOfFrames = thy nx;
-	autoSound sound = Data_copy (me);
-	autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
-	autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
-	for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-		const LPC_Frame lpcFrame = & thy d_frames [iframe];
-		LPC_Frame_init (lpcFrame, predictionOrder);
-	}
-
-	autoVEC workspace = getLPCAnalysisWorkspace (sframe -> nx, predictionOrder, method);
-	autoMelderProgress progress (U"LPC analysis");
-
-	if (preEmphasisFrequency < samplingFrequency / 2.0)
-		Sound_preEmphasis (sound.get(), preEmphasisFrequency);
-	integer frameErrorCount = 0;
-	for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-		const LPC_Frame lpcframe = & thy d_frames [iframe];
-		const double t = Sampled_indexToX (thee, iframe);
-		Sound_into_Sound (sound.get(), sframe.get(), t - 0.5 * windowDuration);
-		Vector_subtractMean (sframe.get());
-		Sounds_multiply (sframe.get(), window.get());
-		integer status = 1;
-		if (method == kLPC_Analysis :: AUTOCORRELATION)
-			status = Sound_into_LPC_Frame_auto (sframe.get(), lpcframe, workspace.get());
-		else if (method == kLPC_Analysis :: COVARIANCE)
-			status = Sound_into_LPC_Frame_covar (sframe.get(), lpcframe, workspace.get());
-		else if (method == kLPC_Analysis :: BURG)
-			status = Sound_into_LPC_Frame_burg (sframe.get(), lpcframe, workspace.get());
-		else if (method == kLPC_Analysis :: MARPLE)
-			status = Sound_into_LPC_Frame_marple (sframe.get(), lpcframe, tol1, tol2, workspace.get());
-		if (status != 0)
-			frameErrorCount ++;
-		if (iframe % 10 == 1)
-			Melder_progress (double (iframe) / numberOfFrames, U"LPC analysis of frame ", iframe, U" out of ", numberOfFrames, U".");
-	}
-}
-
 void Sound_into_LPC (Sound me, LPC thee, double analysisWidth, double preEmphasisFrequency, kLPC_Analysis method, double tol1, double tol2) {
-	const integer numberOfProcessors = std::thread::hardware_concurrency ();
-	if (numberOfProcessors <= 1) {
-		/*
-			We cannot use multithreading.
-		*/
-		Sound_into_LPC_noThreads (me, thee, analysisWidth, preEmphasisFrequency, method, tol1, tol2);
-	}
 	const double samplingFrequency = 1.0 / my dx;
 	Melder_require (my xmin == thy xmin && my xmax == thy xmax, 
 		U"The Sound and the LPC should have the same domain.");
@@ -521,63 +456,52 @@ void Sound_into_LPC (Sound me, LPC thee, double analysisWidth, double preEmphasi
 	}
 	if (preEmphasisFrequency < samplingFrequency / 2.0)
 		Sound_preEmphasis (sound.get(), preEmphasisFrequency);
-	
-	constexpr integer maximumNumberOfThreads = 16;
-	integer numberOfThreads, numberOfFramesPerThread = 25;
-	NUMgetThreadingInfo (numberOfFrames, std::min (numberOfProcessors, maximumNumberOfThreads), & numberOfFramesPerThread, & numberOfThreads);
+
 	/*
-		We have to reserve all the needed working memory for each thread beforehand.
+		Each thread copies its frames into its own Sound and runs the chosen method
+		in its own row of `workspaces`; only the LPC frames themselves are shared.
 	*/
-	autoSound sframe [maximumNumberOfThreads + 1];
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfFrames, 25);
+	std::vector <autoSound> soundFrames (integer_to_uinteger (numberOfThreads));
 	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++)
-		sframe [ithread] = Sound_createSimple (1, windowDuration, samplingFrequency);
-	
-	const integer workspaceSize = getLPCAnalysisWorkspaceSize (sframe [1] -> nx, predictionOrder, method);
+		soundFrames [ithread - 1] = Sound_createSimple (1, windowDuration, samplingFrequency);
+	const integer workspaceSize = getLPCAnalysisWorkspaceSize (soundFrames [0] -> nx, predictionOrder, method);
 	Melder_require (workspaceSize > 0,
 		U"The workspace size is not properly defined.");
-	autoMAT workspace = raw_MAT (numberOfThreads, workspaceSize);
-
-	std::vector <std::thread> thread (numberOfThreads);
-	std::atomic<integer> frameErrorCount (0);
-	
-	try {
-		for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
-			Sound soundFrame = sframe [ithread]. get(), fullsound = sound.get(), windowFrame = window.get();
-			VEC threadWorkspace = workspace. row (ithread);
-			const integer firstFrame = 1 + (ithread - 1) * numberOfFramesPerThread;
-			const integer lastFrame = ( ithread == numberOfThreads ? numberOfFrames : firstFrame + numberOfFramesPerThread - 1 );
-			
-			thread [ithread - 1] = std::thread ([=, & frameErrorCount]() {
-				for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
-					const LPC_Frame lpcframe = & thy d_frames [iframe];
-					const double t = Sampled_indexToX (thee, iframe);
-					Sound_into_Sound (fullsound, soundFrame, t - 0.5 * windowDuration);
-					Vector_subtractMean (soundFrame);
-					Sounds_multiply (soundFrame, windowFrame);
-					integer status = 1;
-					if (method == kLPC_Analysis :: AUTOCORRELATION)
-						status = Sound_into_LPC_Frame_auto (soundFrame, lpcframe, threadWorkspace);
-					else if (method == kLPC_Analysis :: COVARIANCE)
-						status = Sound_into_LPC_Frame_covar (soundFrame, lpcframe, threadWorkspace);
-					else if (method == kLPC_Analysis :: BURG)
-						status = Sound_into_LPC_Frame_burg (soundFrame, lpcframe, threadWorkspace);
-					else if (method == kLPC_Analysis :: MARPLE)
-						status = Sound_into_LPC_Frame_marple (soundFrame, lpcframe, tol1, tol2, threadWorkspace);
-					if (status != 0)
-						++ frameErrorCount;
-				}
-			});
-		}
-	} catch (MelderError) {
-		for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
-			if (thread [ithread - 1]. joinable ())
-				thread [ithread - 1]. join ();
+	autoMAT workspaces = raw_MAT (numberOfThreads, workspaceSize);
+	const bool weReportProgress = ! MelderThread_isRunningTask ();
+	std::optional <autoMelderProgress> progress;
+	if (weReportProgress)
+		progress. emplace (U"LPC analysis");
+	std::atomic <integer> numberOfFramesDone (0), frameErrorCount (0);
+	MelderThread_run (numberOfFrames, numberOfThreads, 5,
+		[&] (integer ithread, integer firstFrame, integer lastFrame) {
+			const Sound soundFrame = soundFrames [ithread - 1]. get();
+			const VEC workspace = workspaces. row (ithread);
+			for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
+				const LPC_Frame lpcframe = & thy d_frames [iframe];
+				const double t = Sampled_indexToX (thee, iframe);
+				Sound_into_Sound (sound.get(), soundFrame, t - 0.5 * windowDuration);
+				Vector_subtractMean (soundFrame);
+				Sounds_multiply (soundFrame, window.get());
+				integer status = 1;
+				if (method == kLPC_Analysis :: AUTOCORRELATION)
+					status = Sound_into_LPC_Frame_auto (soundFrame, lpcframe, workspace);
+				else if (method == kLPC_Analysis :: COVARIANCE)
+					status = Sound_into_LPC_Frame_covar (soundFrame, lpcframe, workspace);
+				else if (method == kLPC_Analysis :: BURG)
+					status = Sound_into_LPC_Frame_burg (soundFrame, lpcframe, workspace);
+				else if (method == kLPC_Analysis :: MARPLE)
+					status = Sound_into_LPC_Frame_marple (soundFrame, lpcframe, tol1, tol2, workspace);
+				if (status != 0)
+					++ frameErrorCount;
+				++ numberOfFramesDone;
+				if (ithread == 1 && weReportProgress && iframe % 10 == 1)
+					Melder_progress (double (numberOfFramesDone) / numberOfFrames,
+						U"LPC analysis of frame ", iframe, U" out of ", numberOfFrames, U".");
+			}
 		}
-		throw;
-	}
-	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++)
-		thread [ithread - 1]. join ();
-
+	);
 }
 
 static autoLPC Sound_to_LPC (Sound me, int predictionOrder, double analysisWidth, double dt, double preEmphasisFrequency, kLPC_Analysis method, double tol1, double tol2) {
@@ -644,20 +568,27 @@ autoSound LPC_Sound_filterInverse (LPC me, Sound thee) {
 		autoSound him = Data_copy (thee);
 		VEC source = his z.row (1);
 		VEC sound = thy z.row (1);
-		for (integer isamp = 1; isamp <= his nx; isamp ++) {
-			const double sampleTime = Sampled_indexToX (him.get(), isamp);
-			const integer frameNumber = Sampled_xToNearestIndex (me, sampleTime);
-			if (frameNumber < 1 || frameNumber > my nx) {
-				source [isamp] = 0.0;
-				continue;
+		/*
+			Every source sample depends on the sound only, so the samples can be filtered in parallel.
+		*/
+		MelderThread_run (his nx, MelderThread_computeNumberOfThreads (his nx, 10000), 1000,
+			[&] (integer /* ithread */, integer firstSample, integer lastSample) {
+				for (integer isamp = firstSample; isamp <= lastSample; isamp ++) {
+					const double sampleTime = Sampled_indexToX (him.get(), isamp);
+					const integer frameNumber = Sampled_xToNearestIndex (me, sampleTime);
+					if (frameNumber < 1 || frameNumber > my nx) {
+						source [isamp] = 0.0;
+						continue;
+					}
+					const LPC_Frame frame = & my d_frames [frameNumber];
+					const integer maximumFilterDepth = frame -> nCoefficients;
+					const integer maximumSoundDepth = isamp - 1;
+					const integer usableDepth = std::min (maximumFilterDepth, maximumSoundDepth);
+					for (integer icoef = 1; icoef <= usableDepth; icoef ++)
+						source [isamp] += frame -> a [icoef] * sound [isamp - icoef];
+				}
 			}
-			const LPC_Frame frame = & my d_frames [frameNumber];
-			const integer maximumFilterDepth = frame -> nCoefficients;
-			const integer maximumSoundDepth = isamp - 1;
-			const integer usableDepth = std::min (maximumFilterDepth, maximumSoundDepth);
-			for (integer icoef = 1; icoef <= usableDepth; icoef ++)
-				source [isamp] += frame -> a [icoef] * sound [isamp - icoef];
-		}
+		);
 		return him;
 	} catch (MelderError) {
 		Melder_throw (thee, U": not inverse filtered.");
@@ -768,12 +699,19 @@ void LPC_Sound_filterInverseWithFilterAtTime_inplace (LPC me, Sound thee, intege
 		if (channel > thy ny)
 			channel = 1;
 		LPC_Frame lpc = & my d_frames [frameIndex];
-		autoVEC work = raw_VEC (lpc -> nCoefficients);
-		if (channel > 0)
+		if (channel > 0) {
+			autoVEC work = raw_VEC (lpc -> nCoefficients);
 			VECfilterInverse_inplace (thy z.row (channel), lpc -> a.get(), work);
-		else
-			for (integer ichan = 1; ichan <= thy ny; ichan ++)
-				VECfilterInverse_inplace (thy z.row (ichan), lpc -> a.get(), work);
+		} else {
+			const integer numberOfThreads = MelderThread_computeNumberOfThreads (thy ny, 1);
+			autoMAT work = raw_MAT (numberOfThreads, lpc -> nCoefficients);
+			MelderThread_run (thy ny, numberOfThreads, 1,
+				[&] (integer ithread, integer firstChannel, integer lastChannel) {
+					for (integer ichan = firstChannel; ichan <= lastChannel; ichan ++)
+						VECfilterInverse_inplace (thy z.row (ichan), lpc -> a.get(), work.row (ithread));
+				}
+			);
+		}
 	} catch (MelderError) {
 		Melder_throw (thee, U": not inverse filtered.");
 	}
@@ -33,6 +33,10 @@
 #include "SVD.h"
 #include "Vector.h"
 #include "NUM2.h"
+#include "MelderThread.h"
+#include <atomic>
+#include <optional>
+#include <vector>
 
 struct huber_struct {
 	autoVEC error;
@@ -148,9 +152,8 @@ void huber_struct_minimize (struct huber_struct *me, constVEC const& sound, cons
 	} while (++ my iter < my itermax && farFromScale);
 }
 
-autoLPC LPC_Sound_to_LPC_robust (LPC thee, Sound me, double analysisWidth, double preEmphasisFrequency, double k_stdev,
-	integer itermax, double tol, bool wantlocation) {
-	struct huber_struct struct_huber;
+autoLPC LPC_Sound_to_LPC_robust_noWarning (LPC thee, Sound me, double analysisWidth, double preEmphasisFrequency, double k_stdev,
+	integer itermax, double tol, bool wantlocation, integer *out_numberOfFailedFrames) {
 	try {
 		const double samplingFrequency = 1.0 / my dx, tol_svd = 0.000001;
 		const double windowDuration = 2 * analysisWidth; /* Gaussian window */
@@ -161,58 +164,84 @@ autoLPC LPC_Sound_to_LPC_robust (LPC thee, Sound me, double analysisWidth, doubl
 			U"Sampling intervals should be equal.");
 		Melder_require (Melder_roundDown (windowDuration / my dx) > predictionOrder,
 			U"Analysis window too short.");
-		double t1;
-		integer numberOfFrames;
-		Sampled_shortTermAnalysis (me, windowDuration, thy dx, & numberOfFrames, & t1);
-		Melder_require (numberOfFrames == thy nx && t1 == thy x1,
-			U"Incorrect retrieved analysis width.");
+		/*
+			We refine the frames of `thee` where they are, as Sound_into_LPC () analyses them,
+			even if a short-term analysis of `me` would place them slightly differently:
+			Sound_to_FormantPath_any () analyses the Sounds of all its ceilings on the frames of the middle ceiling.
+		*/
+		const integer numberOfFrames = thy nx;
 
 		autoSound sound = Data_copy (me);
-		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
 		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
 		autoLPC him = Data_copy (thee);
-		double location = 0.0;
-		huber_struct_init (& struct_huber, window -> nx, predictionOrder, location, wantlocation);
-		struct_huber.k_stdev = k_stdev;
-		struct_huber.tol = tol;
-		struct_huber.tol_svd = tol_svd;
-		struct_huber.itermax = itermax;
-
-		autoMelderProgress progess (U"LPC analysis");
+		/*
+			huber_struct_minimize () iterates on the buffers inside its huber_struct,
+			so every thread needs a huber_struct (and a frame Sound) of its own.
+		*/
+		const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfFrames, 25);
+		std::vector <autoSound> soundFrames (integer_to_uinteger (numberOfThreads));
+		std::vector <struct huber_struct> hubers (integer_to_uinteger (numberOfThreads));
+		for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
+			soundFrames [ithread - 1] = Sound_createSimple (1, windowDuration, samplingFrequency);
+			struct huber_struct *huber = & hubers [ithread - 1];
+			double location = 0.0;
+			huber_struct_init (huber, window -> nx, predictionOrder, location, wantlocation);
+			huber -> k_stdev = k_stdev;
+			huber -> tol = tol;
+			huber -> tol_svd = tol_svd;
+			huber -> itermax = itermax;
+		}
+		const bool weReportProgress = ! MelderThread_isRunningTask ();
+		std::optional <autoMelderProgress> progress;
+		if (weReportProgress)
+			progress. emplace (U"LPC analysis");
 
 		Sound_preEmphasis (sound.get(), preEmphasisFrequency);
-		integer frameErrorCount = 0, iter = 0;
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-			const LPC_Frame lpc = & thy d_frames [iframe];
-			const LPC_Frame lpcto = & his d_frames [iframe];
-			const double t = Sampled_indexToX (thee, iframe);
-
-			Sound_into_Sound (sound.get(), sframe.get(), t - windowDuration / 2);
-			Vector_subtractMean (sframe.get());
-			Sounds_multiply (sframe.get(), window.get());
-			//huber_struct_resize (& struct_huber, lpc -> nCoefficients);
-			try {
-				huber_struct_minimize (& struct_huber, sframe -> z.row(1), lpc -> a.get(), lpcto -> a.get());
-			} catch (MelderError) {
-				frameErrorCount ++;
-			}
+		std::atomic <integer> numberOfFramesDone (0), frameErrorCount (0);
+		MelderThread_run (numberOfFrames, numberOfThreads, 5,
+			[&] (integer ithread, integer firstFrame, integer lastFrame) {
+				const Sound sframe = soundFrames [ithread - 1]. get();
+				struct huber_struct *huber = & hubers [ithread - 1];
+				for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
+					const LPC_Frame lpc = & thy d_frames [iframe];
+					const LPC_Frame lpcto = & his d_frames [iframe];
+					const double t = Sampled_indexToX (thee, iframe);
 
-			iter += struct_huber.iter;
-
-			if (iframe % 10 == 1)
-				Melder_progress ((double) iframe / numberOfFrames,
-					U"LPC analysis of frame ", iframe, U" out of ", numberOfFrames, U".");
-		}
-
-		if (frameErrorCount > 0)
-			Melder_warning (U"Results of ", frameErrorCount, U" frame(s) out of ", numberOfFrames, 
-				U" could not be optimised.");
+					Sound_into_Sound (sound.get(), sframe, t - windowDuration / 2);
+					Vector_subtractMean (sframe);
+					Sounds_multiply (sframe, window.get());
+					//huber_struct_resize (huber, lpc -> nCoefficients);
+					try {
+						huber_struct_minimize (huber, sframe -> z.row(1), lpc -> a.get(), lpcto -> a.get());
+					} catch (MelderError) {
+						Melder_clearError ();   // the frame keeps its original coefficients
+						++ frameErrorCount;
+					}
+					++ numberOfFramesDone;
+					if (ithread == 1 && weReportProgress && iframe % 10 == 1)
+						Melder_progress ((double) numberOfFramesDone / numberOfFrames,
+							U"LPC analysis of frame ", iframe, U" out of ", numberOfFrames, U".");
+				}
+			}
+		);
+		*out_numberOfFailedFrames = frameErrorCount;
 		return him;
 	} catch (MelderError) {
 		Melder_throw (me, U": no robust LPC created.");
 	}
 }
 
+autoLPC LPC_Sound_to_LPC_robust (LPC thee, Sound me, double analysisWidth, double preEmphasisFrequency, double k_stdev,
+	integer itermax, double tol, bool wantlocation) {
+	integer numberOfFailedFrames;
+	autoLPC him = LPC_Sound_to_LPC_robust_noWarning (thee, me, analysisWidth, preEmphasisFrequency, k_stdev,
+		itermax, tol, wantlocation, & numberOfFailedFrames);
+	if (numberOfFailedFrames > 0)
+		Melder_warning (U"Results of ", numberOfFailedFrames, U" frame(s) out of ", his nx,
+			U" could not be optimised.");
+	return him;
+}
+
 autoFormant Sound_to_Formant_robust (Sound me, double dt_in, double numberOfFormants, double maximumFrequency,
 	double halfdt_window, double preEmphasisFrequency, double safetyMargin, double k, integer itermax, double tol, bool wantlocation) {
 	const double dt = dt_in > 0.0 ? dt_in : halfdt_window / 4.0;
@@ -36,6 +36,12 @@ void LPC_Frames_Sound_huber (LPC_Frame me, Sound thee, LPC_Frame him, struct hub
 
 autoLPC LPC_Sound_to_LPC_robust (LPC thee, Sound me, double analysisWidth,
 	double preEmphasisFrequency, double k_stdev, integer itermax, double tol, bool wantlocation);
+/*
+	As LPC_Sound_to_LPC_robust, but instead of warning about the frames that could not be optimised,
+	counts them in *out_numberOfFailedFrames, so that a caller that runs it in a MelderThread task can warn once.
+*/
+autoLPC LPC_Sound_to_LPC_robust_noWarning (LPC thee, Sound me, double analysisWidth,
+	double preEmphasisFrequency, double k_stdev, integer itermax, double tol, bool wantlocation, integer *out_numberOfFailedFrames);
 
 autoFormant Sound_to_Formant_robust (Sound me, double dt_in, double numberOfFormants, double maximumFrequency,
 	double halfdt_window, double preemphasisFrequency, double safetyMargin, double k, integer itermax, double tol, bool wantlocation);
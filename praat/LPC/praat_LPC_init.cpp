@@ -968,6 +968,34 @@ DO
 }
 
 
+FORM (REAL_Sound_getCPPS, U"Sound: Get CPPS", U"PowerCepstrogram: Get CPPS...") {
+	LABEL (U"Cepstrogram:")
+	POSITIVE (pitchFloor, U"Pitch floor (Hz)", U"60.0")
+	POSITIVE (timeStep,U"Time step (s)", U"0.002")
+	POSITIVE (maximumFrequency, U"Maximum frequency (Hz)", U"5000.0")
+	POSITIVE (preEmphasisFrequency, U"Pre-emphasis from (Hz)", U"50")
+	LABEL (U"Smoothing of the Cepstrogram")
+	BOOLEAN (subtractTrendBeforeSmoothing, U"Subtract trend before smoothing", true)
+	REAL (smoothingWindowDuration, U"Time averaging window (s)", U"0.02")
+	REAL (quefrencySmoothingWindowDuration, U"Quefrency averaging window (s)", U"0.0005")
+	LABEL (U"Peak search:")
+	REAL (fromPitch, U"left Peak search pitch range (Hz)", U"60.0")
+	REAL (toPitch, U"right Peak search pitch range (Hz)", U"330.0")
+	POSITIVE (tolerance, U"Tolerance (0-1)", U"0.05")
+	RADIO_ENUM (kVector_peakInterpolation, peakInterpolationType,
+			U"Interpolation", kVector_peakInterpolation :: PARABOLIC)
+	LABEL (U"Trend line:")
+	REAL (fromQuefrency_trendLine, U"left Trend line quefrency range (s)", U"0.001")
+	REAL (toQuefrency_trendLine, U"right Trend line quefrency range (s)", U"0.05")
+	OPTIONMENU_ENUM (kCepstrumTrendType, lineType, U"Trend type", kCepstrumTrendType::DEFAULT)
+	OPTIONMENU_ENUM (kCepstrumTrendFit, fitMethod, U"Fit method", kCepstrumTrendFit::DEFAULT)
+	OK
+DO
+	NUMBER_ONE (Sound)
+		const double result = Sound_getCPPS (me, pitchFloor, timeStep, maximumFrequency, preEmphasisFrequency, subtractTrendBeforeSmoothing, smoothingWindowDuration, quefrencySmoothingWindowDuration, fromPitch, toPitch, tolerance, peakInterpolationType, fromQuefrency_trendLine, toQuefrency_trendLine, lineType, fitMethod);
+	NUMBER_ONE_END (U" dB");
+}
+
 FORM (NEW_Sound_to_PowerCepstrogram_hillenbrand, U"Sound: To PowerCepstrogram (hillenbrand)", U"Sound: To PowerCepstrogram...") {
 	POSITIVE (pitchFloor, U"Pitch floor (Hz)", U"60.0")
 	POSITIVE (timeStep, U"Time step (s)", U"0.002")
@@ -1390,6 +1418,7 @@ void praat_uvafon_LPC_init () {
 
 	praat_addAction1 (classSound, 0, U"To PowerCepstrogram...", U"To Harmonicity (gne)...", 1, NEW_Sound_to_PowerCepstrogram);
 	praat_addAction1 (classSound, 0, U"To PowerCepstrogram (hillenbrand)...", U"To Harmonicity (gne)...", praat_HIDDEN + praat_DEPTH_1, NEW_Sound_to_PowerCepstrogram_hillenbrand);
+	praat_addAction1 (classSound, 1, U"Get CPPS...", U"To PowerCepstrogram (hillenbrand)...", praat_HIDDEN + praat_DEPTH_1, REAL_Sound_getCPPS);
 	praat_addAction1 (classSound, 0, U"To Formant (robust)...", U"To Formant (sl)...", 2, NEW_Sound_to_Formant_robust);
 	praat_addAction1 (classSound, 0, U"To FormantPath...", U"To Formant (robust)...", 2, NEW_Sound_to_FormantPath);
 	praat_addAction1 (classSound, 0, U"To FormantPath (burg)...", U"To FormantPath...", 1, NEW_Sound_to_FormantPath_burg);
@@ -1089,6 +1089,13 @@ void NUMfft_forward (NUMfft_Table table, VEC data);
 	followed by a call of NUMfft_backward will multiply the input sequence by n.
 */
 
+void NUMfft_forward (NUMfft_Table table, MAT data);
+/*
+	Transforms every row of `data` as NUMfft_forward (table, data.row (irow)) would,
+	one directly after the other, so that the trigonometric tables stay in the cache.
+	Each row must have table -> n elements.
+*/
+
 void NUMfft_backward (NUMfft_Table table, VEC data);
 /*
 	Function:
@@ -1372,15 +1379,4 @@ void NUMeigencmp22 (double a, double b, double c, double *out_rt1, double *out_r
 void NUMpolynomial_recurrence (VEC const& pn, double a, double b, double c, constVEC const& pnm1, constVEC const& pnm2);
 
 
-/* 20200405 djmw This functions resides here temporarily until MelderThread.h copes with lambda's */
-static inline void NUMgetThreadingInfo (integer numberOfFrames, integer maximumNumberOfThreads, integer *inout_numberOfFramesPerThread, integer * out_numberOfThreads) {
-	if (*inout_numberOfFramesPerThread <= 0)
-		*inout_numberOfFramesPerThread = 25;
-	integer numberOfThreads = (numberOfFrames - 1) / *inout_numberOfFramesPerThread + 1;
-	Melder_clip (1_integer, & numberOfThreads, maximumNumberOfThreads);
-	*inout_numberOfFramesPerThread = (numberOfFrames - 1) / numberOfThreads + 1;
-	if (out_numberOfThreads)
-		*out_numberOfThreads = numberOfThreads;
-}
-
 #endif // _NUM2_h_
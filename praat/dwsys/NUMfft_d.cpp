@@ -68,6 +68,12 @@ void NUMfft_forward (NUMfft_Table me, VEC data) {
 	);
 }
 
+void NUMfft_forward (NUMfft_Table me, MAT data) {
+	Melder_assert (my n == data.ncol);
+	for (integer irow = 1; irow <= data.nrow; irow ++)
+		NUMfft_forward (me, data.row (irow));
+}
+
 void NUMfft_backward (NUMfft_Table me, VEC data) {
 	if (my n == 1)
 		return;
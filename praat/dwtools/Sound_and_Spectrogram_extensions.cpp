@@ -31,6 +31,9 @@
 #include "Sound_to_Pitch.h"
 #include "Vector.h"
 #include "NUM2.h"
+#include "MelderThread.h"
+#include <atomic>
+#include <vector>
 
 autoSound BandFilterSpectrogram_as_Sound (BandFilterSpectrogram me, int to_dB);
 
@@ -83,31 +86,142 @@ static autoSpectrum Sound_to_Spectrum_power (Sound me) {
 	}
 }
 
-static void Sound_into_BarkSpectrogram_frame (Sound me, BarkSpectrogram thee, integer frame) {
-	autoSpectrum him = Sound_to_Spectrum_power (me);
-	integer numberOfFrequencies = his nx;
+/*
+	The Bark and Mel analyses apply the same filter bank to the power spectrum of every frame.
+	We compute that bank once, as a band matrix: filter `ifilter` has its weights
+	in the bins firstBin [ifilter] .. lastBin [ifilter] of row `ifilter` of `weights`.
+*/
+struct BandFilterBank {
+	autoMAT weights;
+	autoINTVEC firstBin, lastBin;
+};
+
+static integer getFFTSize (integer numberOfSamples) {
+	integer fftSize = 2;
+	while (fftSize < numberOfSamples)
+		fftSize *= 2;
+	return fftSize;
+}
+
+/*
+	A Spectrum without data, with the frequency bins that Sound_to_Spectrum (frame, true) gives for a frame
+	with the same number of samples as `window`.
+*/
+static autoSpectrum Sound_createFrameSpectrumBins (Sound window) {
+	const integer fftSize = getFFTSize (window -> nx);
+	autoSpectrum bins = Spectrum_create (0.5 / window -> dx, fftSize / 2 + 1);
+	bins -> dx = 1.0 / (window -> dx * fftSize);   // as in Sound_to_Spectrum
+	return bins;
+}
 
-	autoVEC z = raw_VEC (numberOfFrequencies);
-	for (integer ifreq = 1; ifreq <= numberOfFrequencies; ifreq ++) {
-		const double frequency_Hz = his x1 + (ifreq - 1) * his dx;
-		z [ifreq] = thy v_hertzToFrequency (frequency_Hz);
+static BandFilterBank BarkSpectrogram_createFilterBank (BarkSpectrogram me, Spectrum bins) {
+	BandFilterBank bank;
+	bank. weights = raw_MAT (my ny, bins -> nx);
+	bank. firstBin = raw_INTVEC (my ny);
+	bank. lastBin = raw_INTVEC (my ny);
+	autoVEC z = raw_VEC (bins -> nx);
+	for (integer ifreq = 1; ifreq <= bins -> nx; ifreq ++) {
+		const double frequency_Hz = bins -> x1 + (ifreq - 1) * bins -> dx;
+		z [ifreq] = my v_hertzToFrequency (frequency_Hz);
+	}
+	for (integer ifilter = 1; ifilter <= my ny; ifilter ++) {
+		const double z0 = my y1 + (ifilter - 1) * my dy;
+		/*
+			Sekey & Hanson filter is defined in the power domain.
+			We therefore multiply the power with a (and not a^2).
+			integral (F(z),z=0..25) = 1.58/9
+		*/
+		for (integer ifreq = 1; ifreq <= bins -> nx; ifreq ++)
+			bank. weights [ifilter] [ifreq] = NUMsekeyhansonfilter_amplitude (z0, z [ifreq]);
+		bank. firstBin [ifilter] = 1;
+		bank. lastBin [ifilter] = bins -> nx;
 	}
+	return bank;
+}
 
-	for (integer i = 1; i <= thy ny; i ++) {
-		const double z0 = thy y1 + (i - 1) * thy dy;
-		constVEC pow = his z.row (1); // TODO ??
-		longdouble p = 0.0;
-		for (integer ifreq = 1; ifreq <= numberOfFrequencies; ifreq ++) {
+static BandFilterBank MelSpectrogram_createFilterBank (MelSpectrogram me, Spectrum bins) {
+	BandFilterBank bank;
+	bank. weights = zero_MAT (my ny, bins -> nx);
+	bank. firstBin = raw_INTVEC (my ny);
+	bank. lastBin = raw_INTVEC (my ny);
+	for (integer ifilter = 1; ifilter <= my ny; ifilter ++) {
+		const double fc_mel = my y1 + (ifilter - 1) * my dy;
+		const double fc_hz = my v_frequencyToHertz (fc_mel);
+		const double fl_hz = my v_frequencyToHertz (fc_mel - my dy);
+		const double fh_hz =  my v_frequencyToHertz (fc_mel + my dy);
+		Sampled_getWindowSamples (bins, fl_hz, fh_hz, & bank. firstBin [ifilter], & bank. lastBin [ifilter]);
+		for (integer ifreq = bank. firstBin [ifilter]; ifreq <= bank. lastBin [ifilter]; ifreq ++) {
 			/*
-				Sekey & Hanson filter is defined in the power domain.
-				We therefore multiply the power with a (and not a^2).
-				integral (F(z),z=0..25) = 1.58/9
+				Bin with a triangular filter the power (= amplitude-squared)
 			*/
-			const double a = NUMsekeyhansonfilter_amplitude (z0, z [ifreq]);
-			p += a * pow [ifreq] ;
+			const double f = bins -> x1 + (ifreq - 1) * bins -> dx;
+			bank. weights [ifilter] [ifreq] = NUMtriangularfilter_amplitude (fl_hz, fc_hz, fh_hz, f);
 		}
-		thy z [i] [frame] = double (p);
 	}
+	return bank;
+}
+
+/*
+	Fill every frame of `thee` with the filtered power spectrum of the windowed Sound.
+	This computes the same as Sound_to_Spectrum_power () on each frame followed by the filters,
+	but the frames are analysed in parallel, and every thread reuses its own FFT table and buffers.
+*/
+static void Sound_into_BandFilterSpectrogram (Sound me, BandFilterSpectrogram thee, Sound window, Spectrum bins, BandFilterBank const& bank) {
+	const integer numberOfFrames = thy nx, fftSize = getFFTSize (window -> nx), numberOfFrequencies = bins -> nx;
+	Melder_assert (numberOfFrequencies == fftSize / 2 + 1);
+	/*
+		factor '2' because we combine positive and negative frequencies
+		bins -> dx : width of frequency bin
+		windowDuration : duration of the frame
+	*/
+	const double windowDuration = window -> xmax - window -> xmin;
+	const double scale = 2.0 * bins -> dx / windowDuration, amplitudeScaling = window -> dx;
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfFrames, 25);
+	std::vector <autoNUMfft_Table> fourierTables (integer_to_uinteger (numberOfThreads));
+	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++)
+		NUMfft_Table_init (& fourierTables [ithread - 1], fftSize);
+	autoMAT frames = raw_MAT (numberOfThreads, fftSize);
+	autoMAT powers = raw_MAT (numberOfThreads, numberOfFrequencies);
+	const bool weReportProgress = ! MelderThread_isRunningTask ();
+	std::atomic <integer> numberOfFramesDone (0);
+	MelderThread_run (numberOfFrames, numberOfThreads, 5,
+		[&] (integer ithread, integer firstFrame, integer lastFrame) {
+			const VEC data = frames. row (ithread), power = powers. row (ithread);
+			for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
+				const double t = Sampled_indexToX (thee, iframe);
+				const integer index = Sampled_xToNearestIndex (me, t - windowDuration / 2.0);
+				for (integer i = 1; i <= window -> nx; i ++) {
+					const integer j = index - 1 + i;
+					data [i] = ( j < 1 || j > my nx ? 0.0 : my z [1] [j] ) * window -> z [1] [i];
+				}
+				data. part (window -> nx + 1, fftSize)  <<=  0.0;
+				NUMfft_forward (& fourierTables [ithread - 1], data);
+
+				for (integer ifreq = 1; ifreq <= numberOfFrequencies; ifreq ++) {
+					const double re = ( ifreq == 1 ? data [1] : data [ifreq + ifreq - 2] ) * amplitudeScaling;
+					const double im = ( ifreq == 1 || ifreq == numberOfFrequencies ? 0.0 : data [ifreq + ifreq - 1] * amplitudeScaling );
+					power [ifreq] = scale * (re * re + im * im);
+				}
+				/*
+					Correction of frequency bins at 0 Hz and nyquist: don't count for two.
+				*/
+				power [1] *= 0.5;
+				power [numberOfFrequencies] *= 0.5;
+
+				for (integer ifilter = 1; ifilter <= thy ny; ifilter ++) {
+					const constVEC weights = bank. weights. row (ifilter);
+					longdouble p = 0.0;
+					for (integer ifreq = bank. firstBin [ifilter]; ifreq <= bank. lastBin [ifilter]; ifreq ++)
+						p += weights [ifreq] * power [ifreq];
+					thy z [ifilter] [iframe] = double (p);
+				}
+				++ numberOfFramesDone;
+				if (ithread == 1 && weReportProgress && iframe % 10 == 1)
+					Melder_progress (double (numberOfFramesDone) / numberOfFrames,
+						U"Frame ", iframe, U" out of ", numberOfFrames, U".");
+			}
+		}
+	);
 }
 
 autoBarkSpectrogram Sound_to_BarkSpectrogram (Sound me, double analysisWidth, double dt, double f1_bark, double fmax_bark, double df_bark) {
@@ -134,24 +248,14 @@ autoBarkSpectrogram Sound_to_BarkSpectrogram (Sound me, double analysisWidth, do
 		integer numberOfFrames;
 		double t1;
 		Sampled_shortTermAnalysis (me, windowDuration, dt, & numberOfFrames, & t1);
-		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
 		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
 		autoBarkSpectrogram thee = BarkSpectrogram_create (my xmin, my xmax, numberOfFrames, dt, t1, fmin_bark, fmax_bark, numberOfFilters, df_bark, f1_bark);
+		autoSpectrum bins = Sound_createFrameSpectrumBins (window.get());
+		const BandFilterBank bank = BarkSpectrogram_createFilterBank (thee.get(), bins.get());
 
 		autoMelderProgress progess (U"BarkSpectrogram analysis");
+		Sound_into_BandFilterSpectrogram (me, thee.get(), window.get(), bins.get(), bank);
 
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-			const double t = Sampled_indexToX (thee.get(), iframe);
-
-			Sound_into_Sound (me, sframe.get(), t - windowDuration / 2.0);
-			Sounds_multiply (sframe.get(), window.get());
-			Sound_into_BarkSpectrogram_frame (sframe.get(), thee.get(), iframe);
-
-			if (iframe % 10 == 1)
-				Melder_progress ( (double) iframe / numberOfFrames,  U"BarkSpectrogram analysis: frame ",
-					iframe, U" from ", numberOfFrames, U".");
-		}
-		
 		_Spectrogram_windowCorrection ((Spectrogram) thee.get(), window -> nx);
 
 		return thee;
@@ -160,29 +264,6 @@ autoBarkSpectrogram Sound_to_BarkSpectrogram (Sound me, double analysisWidth, do
 	}
 }
 
-static void Sound_into_MelSpectrogram_frame (Sound me, MelSpectrogram thee, integer frame) {
-	autoSpectrum him = Sound_to_Spectrum_power (me);
-
-	for (integer ifilter = 1; ifilter <= thy ny; ifilter ++) {
-		longdouble power = 0.0;
-		const double fc_mel = thy y1 + (ifilter - 1) * thy dy;
-		const double fc_hz = thy v_frequencyToHertz (fc_mel);
-		const double fl_hz = thy v_frequencyToHertz (fc_mel - thy dy);
-		const double fh_hz =  thy v_frequencyToHertz (fc_mel + thy dy);
-		integer ifrom, ito;
-		Sampled_getWindowSamples (him.get(), fl_hz, fh_hz, & ifrom, & ito);
-		for (integer i = ifrom; i <= ito; i ++) {
-			/*
-				Bin with a triangular filter the power (= amplitude-squared)
-			*/
-			const double f = his x1 + (i - 1) * his dx;
-			const double a = NUMtriangularfilter_amplitude (fl_hz, fc_hz, fh_hz, f);
-			power += a * his z [1] [i];
-		}
-		thy z [ifilter] [frame] = double (power);
-	}
-}
-
 autoMelSpectrogram Sound_to_MelSpectrogram (Sound me, double analysisWidth, double dt, double f1_mel, double fmax_mel, double df_mel) {
 	try {
 		const double samplingFrequency = 1.0 / my dx, nyquist = 0.5 * samplingFrequency;
@@ -211,22 +292,14 @@ autoMelSpectrogram Sound_to_MelSpectrogram (Sound me, double analysisWidth, doub
 		integer numberOfFrames;
 		double t1;
 		Sampled_shortTermAnalysis (me, windowDuration, dt, & numberOfFrames, & t1);
-		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
 		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
 		autoMelSpectrogram thee = MelSpectrogram_create (my xmin, my xmax, numberOfFrames, dt, t1, fmin_mel, fmax_mel, numberOfFilters, df_mel, f1_mel);
+		autoSpectrum bins = Sound_createFrameSpectrumBins (window.get());
+		const BandFilterBank bank = MelSpectrogram_createFilterBank (thee.get(), bins.get());
 
 		autoMelderProgress progress (U"MelSpectrograms analysis");
+		Sound_into_BandFilterSpectrogram (me, thee.get(), window.get(), bins.get(), bank);
 
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-			const double t = Sampled_indexToX (thee.get(), iframe);
-			Sound_into_Sound (me, sframe.get(), t - windowDuration / 2.0);
-			Sounds_multiply (sframe.get(), window.get());
-			Sound_into_MelSpectrogram_frame (sframe.get(), thee.get(), iframe);
-			
-			if (iframe % 10 == 1)
-				Melder_progress ((double) iframe / numberOfFrames, U"Frame ", iframe, U" out of ", numberOfFrames, U".");
-		}
-		
 		_Spectrogram_windowCorrection ((Spectrogram) thee.get(), window -> nx);
 
 		return thee;
@@ -45,6 +45,11 @@
 #include "Preferences.h"
 #include "flac_FLAC_stream_decoder.h"
 #include "mp3.h"
+#if defined (UNIX) || defined (macintosh)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 
 Thing_implement (LongSound, Sampled, 0);
 Thing_implement (SoundAndLongSoundList, Ordered, 0);
@@ -56,6 +61,9 @@ constexpr integer minimumBufferDuration = 10;   // seconds
 constexpr integer defaultBufferDuration = 60;   // seconds
 constexpr integer maximumBufferDuration = 10000;   // seconds
 
+constexpr integer samplesPerCachedBlock = 32768;   // per channel
+constexpr integer numberOfCacheSlots = 32;   // at 44.1 kHz, some 24 seconds of sound
+
 static integer prefs_bufferLength;
 
 void LongSound_preferences () {
@@ -70,12 +78,51 @@ void LongSound_setBufferSizePref_seconds (integer size) {
 	prefs_bufferLength = Melder_clipped (minimumBufferDuration, size, maximumBufferDuration);
 }
 
+static void _LongSound_mapSampleData (LongSound me) {
+	my mapping = nullptr;
+	my mappedSamples = nullptr;
+	my numberOfMappedSamples = 0;
+	#if defined (UNIX) || defined (macintosh)
+		if (my audioFileType == Melder_FLAC || my audioFileType == Melder_MP3)
+			return;
+		struct stat fileStatus;
+		if (fstat (fileno (my f), & fileStatus) != 0 || ! S_ISREG (fileStatus.st_mode) || fileStatus.st_size <= my startOfData)
+			return;
+		const integer numberOfBytesPerSample = my numberOfChannels * my numberOfBytesPerSamplePoint;
+		const integer numberOfAvailableSamples = std::min (my nx, integer ((fileStatus.st_size - my startOfData) / numberOfBytesPerSample));
+		const off_t pageSize = sysconf (_SC_PAGESIZE);
+		const off_t startOfMapping = my startOfData - my startOfData % pageSize;
+		const double sizeOfMapping_f = double (my startOfData - startOfMapping) + double (numberOfAvailableSamples) * double (numberOfBytesPerSample);
+		if (numberOfAvailableSamples < 1 || sizeOfMapping_f > double (SIZE_MAX / 2))
+			return;   // e.g. a file of several gigabytes in a 32-bit edition; we read it through the buffer instead
+		const size_t sizeOfMapping = size_t (sizeOfMapping_f);
+		void *mapping = mmap (nullptr, sizeOfMapping, PROT_READ, MAP_PRIVATE, fileno (my f), startOfMapping);
+		if (mapping == MAP_FAILED)
+			return;   // no problem: we read through the buffer instead
+		my mapping = mapping;
+		my sizeOfMapping = sizeOfMapping;
+		my mappedSamples = (const uint8 *) mapping + (my startOfData - startOfMapping);
+		my numberOfMappedSamples = numberOfAvailableSamples;
+	#endif
+}
+
+static void _LongSound_unmapSampleData (LongSound me) noexcept {
+	#if defined (UNIX) || defined (macintosh)
+		if (my mapping)
+			munmap (my mapping, my sizeOfMapping);
+	#endif
+	my mapping = nullptr;
+	my mappedSamples = nullptr;
+	my numberOfMappedSamples = 0;
+}
+
 void structLongSound :: v_destroy () noexcept {
 	/*
 		The play callback may contain a pointer to my buffer.
 		That pointer is about to dangle, so kill the playback.
 	*/
 	MelderAudio_stopPlaying (MelderAudio_IMPLICIT);
+	_LongSound_unmapSampleData (this);
 	if (mp3f)
 		mp3f_delete (mp3f);
 	if (flacDecoder) {
@@ -108,58 +155,21 @@ void structLongSound :: v_info () {
 	MelderInfo_writeLine (U"Start of sample data: ", startOfData, U" bytes from the start of the file");
 }
 
-static void _LongSound_FLAC_convertFloats (LongSound me, const int32 * const samples[], integer bitsPerSample, integer numberOfSamples) {
-	double multiplier;
-	switch (bitsPerSample) {
-		case 8: multiplier = (1.0 / 128.0); break;
-		case 16: multiplier = (1.0 / 32768.0); break;
-		case 24: multiplier = (1.0 / 8388608.0); break;
-		case 32: multiplier = (1.0 / 32768.0 / 65536.0); break;
-		default: multiplier = 0.0;
-	}
-	for (integer i = 0; i < 2; ++i) {
-		const int32 *input = samples [i];
-		double *output = my compressedFloats [i];
-		if (! output ) continue;
-		for (integer j = 0; j < numberOfSamples; ++j)
-			output [j] = (double) input [j] * multiplier;
-		my compressedFloats [i] += numberOfSamples;
-	}
-}
-
-static void _LongSound_FLAC_convertShorts (LongSound me, const int32 * const samples[], integer bitsPerSample, integer numberOfSamples) {
-	for (integer channel = 0; channel < my numberOfChannels; ++ channel) {
-		int16 *output = my compressedShorts + channel;
-		const int32 *input = samples [channel];
-		for (integer j = 0; j < numberOfSamples; ++ j, output += my numberOfChannels) {
-			int32 sample = * (input ++);
-			switch (bitsPerSample) {
-				case 8: sample *= 256; break;
-				case 16: break;
-				case 24: sample /= 256; break;
-				case 32: sample /= 65536; break;
-				default: sample = 0; break;
-			}
-			*output = (int16) sample;
-		}
-	}
-	my compressedShorts += numberOfSamples * my numberOfChannels;
-}
-
 static FLAC__StreamDecoderWriteStatus _LongSound_FLAC_write (const FLAC__StreamDecoder *decoder, const FLAC__Frame *frame, const FLAC__int32 * const buffer[], void *void_me) {
 	iam (LongSound);
 	const FLAC__FrameHeader *header = & frame -> header;
 	integer numberOfSamples = header -> blocksize;
-	integer bitsPerSample = header -> bits_per_sample;
 	(void) decoder;
 	if (numberOfSamples > my compressedSamplesLeft)
 		numberOfSamples = my compressedSamplesLeft;
 	if (numberOfSamples == 0)
 		return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
-	if (my compressedMode == COMPRESSED_MODE_READ_FLOAT)
-		_LongSound_FLAC_convertFloats (me, buffer, bitsPerSample, numberOfSamples);
-	else
-		_LongSound_FLAC_convertShorts (me, buffer, bitsPerSample, numberOfSamples);
+	my compressedBitsPerSample = header -> bits_per_sample;
+	for (integer ichan = 0; ichan < my numberOfChannels; ichan ++) {
+		int32 *output = my compressedBlock + ichan * samplesPerCachedBlock + my compressedBlockOffset;
+		std::copy (buffer [ichan], buffer [ichan] + numberOfSamples, output);
+	}
+	my compressedBlockOffset += numberOfSamples;
 	my compressedSamplesLeft -= numberOfSamples;
 	return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
 }
@@ -167,39 +177,17 @@ static FLAC__StreamDecoderWriteStatus _LongSound_FLAC_write (const FLAC__StreamD
 static void _LongSound_FLAC_error (const FLAC__StreamDecoder * /* decoder */, FLAC__StreamDecoderErrorStatus /* status */, void * /* longSound */) {
 }
 
-static void _LongSound_MP3_convertFloats (LongSound me, const MP3F_SAMPLE *channels [MP3F_MAX_CHANNELS], integer numberOfSamples) {
-	for (integer i = 0; i < 2; ++i) {
-		const MP3F_SAMPLE *input = channels [i];
-		double *output = my compressedFloats [i];
-		if (! output ) continue;
-		for (integer j = 0; j < numberOfSamples; ++j)
-			output [j] = mp3f_sample_to_float (input [j]);
-		my compressedFloats [i] += numberOfSamples;
-	}
-}
-
-static void _LongSound_MP3_convertShorts (LongSound me, const MP3F_SAMPLE *channels [MP3F_MAX_CHANNELS], integer numberOfSamples) {
-	for (integer i = 0; i < my numberOfChannels; ++ i) {
-		const MP3F_SAMPLE *input = channels [i];
-		int16 *output = my compressedShorts + i;
-		for (integer j = 0; j < numberOfSamples; ++j, output += my numberOfChannels) {
-			int sample = *input++;
-			*output = mp3f_sample_to_short (sample);
-		}
-	}
-	my compressedShorts += numberOfSamples * my numberOfChannels;
-}
-
 static void _LongSound_MP3_convert (const MP3F_SAMPLE *channels [MP3F_MAX_CHANNELS], integer numberOfSamples, void *void_me) {
 	iam (LongSound);
 	if (numberOfSamples > my compressedSamplesLeft)
 		numberOfSamples = my compressedSamplesLeft;
 	if (numberOfSamples == 0)
 		return;
-	if (my compressedMode == COMPRESSED_MODE_READ_FLOAT)
-		_LongSound_MP3_convertFloats (me, channels, numberOfSamples);
-	else
-		_LongSound_MP3_convertShorts (me, channels, numberOfSamples);
+	for (integer ichan = 0; ichan < my numberOfChannels; ichan ++) {
+		int32 *output = my compressedBlock + ichan * samplesPerCachedBlock + my compressedBlockOffset;
+		std::copy (channels [ichan], channels [ichan] + numberOfSamples, output);
+	}
+	my compressedBlockOffset += numberOfSamples;
 	my compressedSamplesLeft -= numberOfSamples;
 }
 
@@ -234,12 +222,21 @@ static void LongSound_init (LongSound me, MelderFile file) {
 	}
 	my imin = 1;
 	my imax = 0;
+	my numberOfEnvelopeLevels = 0;
+	_LongSound_mapSampleData (me);
 	my flacDecoder = nullptr;
 	if (my audioFileType == Melder_FLAC) {
 		my flacDecoder = FLAC__stream_decoder_new ();
 		FLAC__stream_decoder_init_FILE (my flacDecoder, my f, _LongSound_FLAC_write, nullptr, _LongSound_FLAC_error, me);
 	}
 	my mp3f = nullptr;
+	if (my audioFileType == Melder_FLAC || my audioFileType == Melder_MP3) {
+		my cachedSamples = newvectorraw <int32> (numberOfCacheSlots * my numberOfChannels * samplesPerCachedBlock);
+		my cachedBlockNumbers = newvectorzero <integer> (numberOfCacheSlots);
+		my cachedBlockLastUse = newvectorzero <integer> (numberOfCacheSlots);
+		my cachedBlockBitsPerSample = newvectorzero <integer> (numberOfCacheSlots);
+		my cacheClock = 0;
+	}
 	if (my audioFileType == Melder_MP3) {
 		my mp3f = mp3f_new ();
 		mp3f_set_file (my mp3f, my f);
@@ -255,6 +252,8 @@ void structLongSound :: v_copy (Daata thee_Daata) {
 	LongSound thee = static_cast <LongSound> (thee_Daata);
 	thy f = nullptr;
 	thy buffer.releaseToAmbiguousOwner();   // this may have been shallow-copied, so undangle and nullify
+	thy mapping = nullptr;   // ditto; the copy gets its own mapping
+	thy mappedSamples = nullptr;
 	LongSound_init (thee, & our file);   // this recreates a new buffer
 }
 
@@ -269,8 +268,8 @@ autoLongSound LongSound_open (MelderFile file) {
 }
 
 static void _LongSound_FLAC_process (LongSound me, integer firstSample, integer numberOfSamples) {
-	my compressedSamplesLeft = numberOfSamples - 1;
-	if (! FLAC__stream_decoder_seek_absolute (my flacDecoder, firstSample))
+	my compressedSamplesLeft = numberOfSamples;
+	if (! FLAC__stream_decoder_seek_absolute (my flacDecoder, firstSample - 1))   // FLAC counts its samples from 0
 		Melder_throw (U"Cannot seek in FLAC file ", & my file, U".");
 	while (my compressedSamplesLeft > 0) {
 		if (FLAC__stream_decoder_get_state (my flacDecoder) == FLAC__STREAM_DECODER_END_OF_STREAM)
@@ -280,45 +279,176 @@ static void _LongSound_FLAC_process (LongSound me, integer firstSample, integer
 	}
 }
 
+static void _LongSound_MP3_process (LongSound me, integer firstSample, integer numberOfSamples) {
+	if (! mp3f_seek (my mp3f, firstSample - 1))   // MP3 counts its samples from 0
+		Melder_throw (U"Cannot seek in MP3 file ", & my file, U".");
+	my compressedSamplesLeft = numberOfSamples;
+	if (! mp3f_read (my mp3f, numberOfSamples))
+		Melder_throw (U"Error decoding MP3 file ", & my file, U".");
+}
+
+static integer _LongSound_COMPRESSED_getNumberOfSamplesInBlock (LongSound me, integer blockNumber) {
+	return std::min (samplesPerCachedBlock, my nx - (blockNumber - 1) * samplesPerCachedBlock);
+}
+
+/*
+	The cache slot that contains the decoded samples of block `blockNumber` (1-based),
+	which contains the samples (blockNumber - 1) * samplesPerCachedBlock + 1 .. blockNumber * samplesPerCachedBlock.
+*/
+static integer _LongSound_COMPRESSED_getCachedBlock (LongSound me, integer blockNumber) {
+	integer slotToDecodeInto = 1;
+	for (integer islot = 1; islot <= numberOfCacheSlots; islot ++) {
+		if (my cachedBlockNumbers [islot] == blockNumber) {
+			my cachedBlockLastUse [islot] = ++ my cacheClock;
+			return islot;
+		}
+		if (my cachedBlockLastUse [islot] < my cachedBlockLastUse [slotToDecodeInto])
+			slotToDecodeInto = islot;   // empty slots have never been used, so they come first
+	}
+	const integer islot = slotToDecodeInto;
+	my cachedBlockNumbers [islot] = 0;   // in case decoding fails
+	my cachedBlockLastUse [islot] = 0;
+	my compressedBlock = & my cachedSamples [1 + (islot - 1) * my numberOfChannels * samplesPerCachedBlock];
+	my compressedBlockOffset = 0;
+	my compressedBitsPerSample = 0;
+	const integer firstSample = (blockNumber - 1) * samplesPerCachedBlock + 1;
+	const integer numberOfSamples = _LongSound_COMPRESSED_getNumberOfSamplesInBlock (me, blockNumber);
+	if (my audioFileType == Melder_FLAC)
+		_LongSound_FLAC_process (me, firstSample, numberOfSamples);
+	else
+		_LongSound_MP3_process (me, firstSample, numberOfSamples);
+	if (my compressedBlockOffset < numberOfSamples) {
+		/*
+			An MP3 file can end before the number of samples that its analysis predicted.
+		*/
+		for (integer ichan = 0; ichan < my numberOfChannels; ichan ++) {
+			int32 *channel = my compressedBlock + ichan * samplesPerCachedBlock;
+			std::fill (channel + my compressedBlockOffset, channel + numberOfSamples, 0);
+		}
+	}
+	my cachedBlockNumbers [islot] = blockNumber;
+	my cachedBlockLastUse [islot] = ++ my cacheClock;
+	my cachedBlockBitsPerSample [islot] = my compressedBitsPerSample;
+	return islot;
+}
+
+static double _LongSound_FLAC_sampleToFloat (int32 sample, integer bitsPerSample) {
+	double multiplier;
+	switch (bitsPerSample) {
+		case 8: multiplier = (1.0 / 128.0); break;
+		case 16: multiplier = (1.0 / 32768.0); break;
+		case 24: multiplier = (1.0 / 8388608.0); break;
+		case 32: multiplier = (1.0 / 32768.0 / 65536.0); break;
+		default: multiplier = 0.0;
+	}
+	return (double) sample * multiplier;
+}
+
+static int16 _LongSound_FLAC_sampleToShort (int32 sample, integer bitsPerSample) {
+	switch (bitsPerSample) {
+		case 8: sample *= 256; break;
+		case 16: break;
+		case 24: sample /= 256; break;
+		case 32: sample /= 65536; break;
+		default: sample = 0; break;
+	}
+	return (int16) sample;
+}
+
+/*
+	Copy the samples firstSample .. firstSample + numberOfSamples - 1 out of the cache, decoding the blocks that are not in it yet;
+	`copy (cachedChannels, bitsPerSample, offsetInBlock, numberOfSamplesToCopy, offsetInOutput)` converts a stretch that lies within one block.
+*/
+template <typename CopyFromBlock>
+static void _LongSound_COMPRESSED_read (LongSound me, integer firstSample, integer numberOfSamples, CopyFromBlock copy) {
+	integer offsetInOutput = 0;
+	while (offsetInOutput < numberOfSamples) {
+		const integer isample = firstSample + offsetInOutput;
+		if (isample > my nx)
+			break;
+		const integer blockNumber = (isample - 1) / samplesPerCachedBlock + 1;
+		const integer offsetInBlock = (isample - 1) % samplesPerCachedBlock;
+		const integer islot = _LongSound_COMPRESSED_getCachedBlock (me, blockNumber);
+		const integer numberOfSamplesToCopy = std::min (numberOfSamples - offsetInOutput,
+				_LongSound_COMPRESSED_getNumberOfSamplesInBlock (me, blockNumber) - offsetInBlock);
+		const int32 *cachedChannels = & my cachedSamples [1 + (islot - 1) * my numberOfChannels * samplesPerCachedBlock];
+		copy (cachedChannels, my cachedBlockBitsPerSample [islot], offsetInBlock, numberOfSamplesToCopy, offsetInOutput);
+		offsetInOutput += numberOfSamplesToCopy;
+	}
+}
+
+static void _LongSound_COMPRESSED_readAudioToFloat (LongSound me, MAT buffer, integer firstSample) {
+	const bool isFlac = ( my audioFileType == Melder_FLAC );
+	_LongSound_COMPRESSED_read (me, firstSample, buffer.ncol,
+		[&] (const int32 *cachedChannels, integer bitsPerSample, integer offsetInBlock, integer numberOfSamplesToCopy, integer offsetInOutput) {
+			for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++) {
+				const int32 *input = cachedChannels + (ichan - 1) * samplesPerCachedBlock + offsetInBlock;
+				double *output = & buffer [ichan] [1 + offsetInOutput];
+				for (integer j = 0; j < numberOfSamplesToCopy; j ++)
+					output [j] = ( isFlac ? _LongSound_FLAC_sampleToFloat (input [j], bitsPerSample) : mp3f_sample_to_float (input [j]) );
+			}
+		}
+	);
+}
+
+static void _LongSound_COMPRESSED_readAudioToShort (LongSound me, int16 *buffer, integer firstSample, integer numberOfSamples) {
+	const bool isFlac = ( my audioFileType == Melder_FLAC );
+	_LongSound_COMPRESSED_read (me, firstSample, numberOfSamples,
+		[&] (const int32 *cachedChannels, integer bitsPerSample, integer offsetInBlock, integer numberOfSamplesToCopy, integer offsetInOutput) {
+			for (integer ichan = 0; ichan < my numberOfChannels; ichan ++) {
+				const int32 *input = cachedChannels + ichan * samplesPerCachedBlock + offsetInBlock;
+				int16 *output = buffer + offsetInOutput * my numberOfChannels + ichan;
+				for (integer j = 0; j < numberOfSamplesToCopy; j ++, output += my numberOfChannels)
+					*output = ( isFlac ? _LongSound_FLAC_sampleToShort (input [j], bitsPerSample) : mp3f_sample_to_short (input [j]) );
+			}
+		}
+	);
+}
+
 static void _LongSound_FILE_seekSample (LongSound me, integer firstSample) {
 	if (fseek (my f, my startOfData + (firstSample - 1) * my numberOfChannels * my numberOfBytesPerSamplePoint, SEEK_SET))
 		Melder_throw (U"Cannot seek in file ", & my file, U".");
 }
 
-static void _LongSound_FLAC_readAudioToShort (LongSound me, int16 *buffer, integer firstSample, integer numberOfSamples) {
-	my compressedMode = COMPRESSED_MODE_READ_SHORT;
-	my compressedShorts = buffer + 1;
-	_LongSound_FLAC_process (me, firstSample, numberOfSamples);
+/*
+	The bytes of the mapped sample data from `firstSample` on;
+	there may be fewer than requested at the end of a file that is shorter than its header claims.
+*/
+static integer _LongSound_getNumberOfMappedBytesFrom (LongSound me, integer firstSample) {
+	const integer numberOfBytesPerSample = my numberOfChannels * my numberOfBytesPerSamplePoint;
+	return std::max (0_integer, my numberOfMappedSamples - firstSample + 1) * numberOfBytesPerSample;
 }
 
-static void _LongSound_MP3_process (LongSound me, integer firstSample, integer numberOfSamples) {
-	if (! mp3f_seek (my mp3f, firstSample))
-		Melder_throw (U"Cannot seek in MP3 file ", & my file, U".");
-	my compressedSamplesLeft = numberOfSamples;
-	if (! mp3f_read (my mp3f, numberOfSamples))
-		Melder_throw (U"Error decoding MP3 file ", & my file, U".");
+static const uint8 *_LongSound_getMappedSample (LongSound me, integer firstSample) {
+	return my mappedSamples + (firstSample - 1) * my numberOfChannels * my numberOfBytesPerSamplePoint;
 }
 
-static void _LongSound_MP3_readAudioToShort (LongSound me, int16 *buffer, integer firstSample, integer numberOfSamples) {
-	my compressedMode = COMPRESSED_MODE_READ_SHORT;
-	my compressedShorts = buffer + 1;
-	_LongSound_MP3_process (me, firstSample, numberOfSamples - 1);
+/*
+	Whether we can decode from the mapping.
+	If another program has truncated the file since we mapped it, reading the pages beyond the new end
+	would raise SIGBUS, so we drop the mapping and read through the buffer instead, which merely sees a short file.
+*/
+static bool _LongSound_canReadMappedSamples (LongSound me) {
+	if (! my mappedSamples)
+		return false;
+	#if defined (UNIX) || defined (macintosh)
+		const integer numberOfBytesPerSample = my numberOfChannels * my numberOfBytesPerSamplePoint;
+		const off_t endOfMappedSamples = my startOfData + off_t (my numberOfMappedSamples) * off_t (numberOfBytesPerSample);
+		struct stat fileStatus;
+		if (fstat (fileno (my f), & fileStatus) == 0 && fileStatus.st_size >= endOfMappedSamples)
+			return true;
+	#endif
+	_LongSound_unmapSampleData (me);
+	return false;
 }
 
 void LongSound_readAudioToFloat (LongSound me, MAT buffer, integer firstSample) {
 	Melder_assert (buffer.nrow == my numberOfChannels);
-	if (my encoding == Melder_FLAC_COMPRESSION_16) {
-		my compressedMode = COMPRESSED_MODE_READ_FLOAT;
-		for (int ichan = 1; ichan <= my numberOfChannels; ichan ++) {
-			my compressedFloats [ichan - 1] = & buffer [ichan] [1];
-		}
-		_LongSound_FLAC_process (me, firstSample, buffer.ncol);
-	} else if (my encoding == Melder_MPEG_COMPRESSION_16) {
-		my compressedMode = COMPRESSED_MODE_READ_FLOAT;
-		for (int ichan = 1; ichan <= my numberOfChannels; ichan ++) {
-			my compressedFloats [ichan - 1] = & buffer [ichan] [1];
-		}
-		_LongSound_MP3_process (me, firstSample, buffer.ncol);
+	if (my encoding == Melder_FLAC_COMPRESSION_16 || my encoding == Melder_MPEG_COMPRESSION_16) {
+		_LongSound_COMPRESSED_readAudioToFloat (me, buffer, firstSample);
+	} else if (_LongSound_canReadMappedSamples (me)) {
+		Melder_decodeAudioToFloat (_LongSound_getMappedSample (me, firstSample), _LongSound_getNumberOfMappedBytesFrom (me, firstSample),
+				my encoding, buffer);
 	} else {
 		_LongSound_FILE_seekSample (me, firstSample);
 		Melder_readAudioToFloat (my f, my encoding, buffer);
@@ -326,10 +456,11 @@ void LongSound_readAudioToFloat (LongSound me, MAT buffer, integer firstSample)
 }
 
 void LongSound_readAudioToShort (LongSound me, int16 *buffer, integer firstSample, integer numberOfSamples) {
-	if (my encoding == Melder_FLAC_COMPRESSION_16) {
-		_LongSound_FLAC_readAudioToShort (me, buffer, firstSample, numberOfSamples);
-	} else if (my encoding == Melder_MPEG_COMPRESSION_16) {
-		_LongSound_MP3_readAudioToShort (me, buffer, firstSample, numberOfSamples);
+	if (my encoding == Melder_FLAC_COMPRESSION_16 || my encoding == Melder_MPEG_COMPRESSION_16) {
+		_LongSound_COMPRESSED_readAudioToShort (me, buffer, firstSample, numberOfSamples);
+	} else if (_LongSound_canReadMappedSamples (me)) {
+		Melder_decodeAudioToShort (_LongSound_getMappedSample (me, firstSample), _LongSound_getNumberOfMappedBytesFrom (me, firstSample),
+				my numberOfChannels, my encoding, buffer, numberOfSamples);
 	} else {
 		_LongSound_FILE_seekSample (me, firstSample);
 		Melder_readAudioToShort (my f, my numberOfChannels, my encoding, buffer, numberOfSamples);
@@ -500,20 +631,170 @@ static void _LongSound_haveSamples (LongSound me, integer imin, integer imax) {
 	my imax = imax;
 }
 
+static bool _LongSound_windowFits (LongSound me, integer numberOfSamples) {
+	return (1.0 + 2 * MARGIN) * numberOfSamples + 1 <= my nmax;
+}
+
 bool LongSound_haveWindow (LongSound me, double tmin, double tmax) {
 	integer imin, imax;
 	const integer n = Sampled_getWindowSamples (me, tmin, tmax, & imin, & imax);
-	if ((1.0 + 2 * MARGIN) * n + 1 > my nmax)
+	if (! _LongSound_windowFits (me, n))
 		return false;
 	_LongSound_haveSamples (me, imin, imax);
 	return true;
 }
 
-void LongSound_getWindowExtrema (LongSound me, double tmin, double tmax, integer channel, double *minimum, double *maximum) {
+void LongSound_prepareEnvelope (LongSound me) {
+	if (my numberOfEnvelopeLevels > 0)
+		return;
+	autoMelderProgress progress (U"Building the envelope of the long sound...");
+	/*
+		Level 1, in a single pass over the samples.
+	*/
+	constexpr integer numberOfBlocksPerRead = 64;
+	structLongSound::EnvelopeLevel *level = & my envelope [1];
+	level -> samplesPerBlock = LongSound_SAMPLES_PER_ENVELOPE_BLOCK;
+	level -> numberOfBlocks = (my nx - 1) / level -> samplesPerBlock + 1;
+	level -> minima = raw_MAT (my numberOfChannels, level -> numberOfBlocks);
+	level -> maxima = raw_MAT (my numberOfChannels, level -> numberOfBlocks);
+	level -> sumsOfSquares = raw_MAT (my numberOfChannels, level -> numberOfBlocks);
+	autoMAT samples = raw_MAT (my numberOfChannels, numberOfBlocksPerRead * level -> samplesPerBlock);
+	for (integer firstBlock = 1; firstBlock <= level -> numberOfBlocks; firstBlock += numberOfBlocksPerRead) {
+		const integer firstSample = (firstBlock - 1) * level -> samplesPerBlock + 1;
+		const integer numberOfSamples = std::min (samples.ncol, my nx - firstSample + 1);
+		if (numberOfSamples < samples.ncol)
+			samples = raw_MAT (my numberOfChannels, numberOfSamples);   // the last read
+		Melder_progress (double (firstBlock - 1) / level -> numberOfBlocks,
+			U"Building the envelope of the long sound: block ", firstBlock, U" out of ", level -> numberOfBlocks, U".");
+		LongSound_readAudioToFloat (me, samples.get(), firstSample);
+		const integer lastBlock = std::min (firstBlock + numberOfBlocksPerRead - 1, level -> numberOfBlocks);
+		for (integer iblock = firstBlock; iblock <= lastBlock; iblock ++) {
+			const integer firstColumn = (iblock - firstBlock) * level -> samplesPerBlock + 1;
+			const integer lastColumn = std::min (firstColumn + level -> samplesPerBlock - 1, numberOfSamples);
+			for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++) {
+				const constVEC block = samples.row (ichan). part (firstColumn, lastColumn);
+				level -> minima [ichan] [iblock] = NUMmin (block);
+				level -> maxima [ichan] [iblock] = NUMmax (block);
+				level -> sumsOfSquares [ichan] [iblock] = NUMsum2 (block);
+			}
+		}
+	}
+	/*
+		The higher levels, from the level below.
+	*/
+	integer numberOfLevels = 1;
+	while (level -> numberOfBlocks > LongSound_ENVELOPE_FAN_OUT && numberOfLevels < LongSound_MAXIMUM_NUMBER_OF_ENVELOPE_LEVELS) {
+		const structLongSound::EnvelopeLevel *lower = level;
+		level = & my envelope [++ numberOfLevels];
+		level -> samplesPerBlock = lower -> samplesPerBlock * LongSound_ENVELOPE_FAN_OUT;
+		level -> numberOfBlocks = (lower -> numberOfBlocks - 1) / LongSound_ENVELOPE_FAN_OUT + 1;
+		level -> minima = raw_MAT (my numberOfChannels, level -> numberOfBlocks);
+		level -> maxima = raw_MAT (my numberOfChannels, level -> numberOfBlocks);
+		level -> sumsOfSquares = raw_MAT (my numberOfChannels, level -> numberOfBlocks);
+		for (integer iblock = 1; iblock <= level -> numberOfBlocks; iblock ++) {
+			const integer firstLowerBlock = (iblock - 1) * LongSound_ENVELOPE_FAN_OUT + 1;
+			const integer lastLowerBlock = std::min (iblock * LongSound_ENVELOPE_FAN_OUT, lower -> numberOfBlocks);
+			for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++) {
+				level -> minima [ichan] [iblock] = NUMmin (lower -> minima.row (ichan). part (firstLowerBlock, lastLowerBlock));
+				level -> maxima [ichan] [iblock] = NUMmax (lower -> maxima.row (ichan). part (firstLowerBlock, lastLowerBlock));
+				level -> sumsOfSquares [ichan] [iblock] = NUMsum (lower -> sumsOfSquares.row (ichan). part (firstLowerBlock, lastLowerBlock));
+			}
+		}
+	}
+	my numberOfEnvelopeLevels = numberOfLevels;   // only now, so that an interrupted build is not used
+}
+
+namespace {
+	struct LongSound_Summary {
+		double minimum = undefined, maximum = undefined, sumOfSquares = 0.0;
+		integer numberOfValues = 0;
+		void add (double blockMinimum, double blockMaximum, double blockSumOfSquares, integer blockNumberOfValues) {
+			if (numberOfValues == 0 || blockMinimum < minimum)
+				minimum = blockMinimum;
+			if (numberOfValues == 0 || blockMaximum > maximum)
+				maximum = blockMaximum;
+			sumOfSquares += blockSumOfSquares;
+			numberOfValues += blockNumberOfValues;
+		}
+	};
+}
+
+static void _LongSound_summarizeSamples (LongSound me, integer channel, integer imin, integer imax, LongSound_Summary *summary) {
+	if (imin > imax)
+		return;
+	autoMAT samples = raw_MAT (my numberOfChannels, imax - imin + 1);
+	LongSound_readAudioToFloat (me, samples.get(), imin);
+	for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++)
+		if (channel == 0 || ichan == channel)
+			summary -> add (NUMmin (samples.row (ichan)), NUMmax (samples.row (ichan)), NUMsum2 (samples.row (ichan)), samples.ncol);
+}
+
+static void _LongSound_summarizeBlock (LongSound me, integer channel, integer ilevel, integer iblock, LongSound_Summary *summary) {
+	const structLongSound::EnvelopeLevel *level = & my envelope [ilevel];
+	const integer numberOfSamples = std::min (level -> samplesPerBlock, my nx - (iblock - 1) * level -> samplesPerBlock);
+	for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++)
+		if (channel == 0 || ichan == channel)
+			summary -> add (level -> minima [ichan] [iblock], level -> maxima [ichan] [iblock], level -> sumsOfSquares [ichan] [iblock], numberOfSamples);
+}
+
+/*
+	Summarize the samples imin .. imax of `channel` (0 = all channels) from the largest blocks of the envelope
+	that lie within that range, and from the samples themselves at the edges;
+	if not `exact`, the range is first widened to whole blocks of level 1 instead.
+	An exact range that would fit in the buffer is summarized from its samples alone,
+	so that short queries never have to wait for the envelope of the whole file to be built.
+*/
+static LongSound_Summary _LongSound_summarize (LongSound me, integer channel, integer imin, integer imax, bool exact) {
+	LongSound_Summary summary;
+	constexpr integer samplesPerBlock = LongSound_SAMPLES_PER_ENVELOPE_BLOCK;
+	integer firstBlock = ( exact ? (imin - 1 + samplesPerBlock - 1) / samplesPerBlock + 1 : (imin - 1) / samplesPerBlock + 1 );
+	integer lastBlock = ( exact && imax < my nx ? imax / samplesPerBlock : (imax - 1) / samplesPerBlock + 1 );
+	if (firstBlock > lastBlock || (exact && _LongSound_windowFits (me, imax - imin + 1))) {
+		_LongSound_summarizeSamples (me, channel, imin, imax, & summary);   // no whole block, or few enough samples
+		return summary;
+	}
+	LongSound_prepareEnvelope (me);
+	if (exact) {
+		_LongSound_summarizeSamples (me, channel, imin, (firstBlock - 1) * samplesPerBlock, & summary);
+		_LongSound_summarizeSamples (me, channel, lastBlock * samplesPerBlock + 1, imax, & summary);
+	}
+	/*
+		Take the blocks at the edges of the range at the current level,
+		until the rest of the range consists of whole blocks of the next level.
+	*/
+	for (integer ilevel = 1; ilevel <= my numberOfEnvelopeLevels; ilevel ++) {
+		if (ilevel == my numberOfEnvelopeLevels) {
+			for (integer iblock = firstBlock; iblock <= lastBlock; iblock ++)
+				_LongSound_summarizeBlock (me, channel, ilevel, iblock, & summary);
+			break;
+		}
+		while (firstBlock <= lastBlock && (firstBlock - 1) % LongSound_ENVELOPE_FAN_OUT != 0)
+			_LongSound_summarizeBlock (me, channel, ilevel, firstBlock ++, & summary);
+		while (firstBlock <= lastBlock && lastBlock % LongSound_ENVELOPE_FAN_OUT != 0 && lastBlock < my envelope [ilevel]. numberOfBlocks)
+			_LongSound_summarizeBlock (me, channel, ilevel, lastBlock --, & summary);
+		if (firstBlock > lastBlock)
+			break;
+		firstBlock = (firstBlock - 1) / LongSound_ENVELOPE_FAN_OUT + 1;
+		lastBlock = (lastBlock - 1) / LongSound_ENVELOPE_FAN_OUT + 1;
+	}
+	return summary;
+}
+
+void LongSound_getWindowExtrema (LongSound me, double tmin, double tmax, integer channel, bool useEnvelope, double *minimum, double *maximum) {
 	integer imin, imax;
-	(void) Sampled_getWindowSamples (me, tmin, tmax, & imin, & imax);
+	const integer n = Sampled_getWindowSamples (me, tmin, tmax, & imin, & imax);
 	*minimum = 1.0;
 	*maximum = -1.0;
+	if (n > 0 && (useEnvelope || ! _LongSound_windowFits (me, n))) {
+		try {
+			const LongSound_Summary summary = _LongSound_summarize (me, channel, imin, imax, true);
+			*minimum = summary.minimum;
+			*maximum = summary.maximum;
+		} catch (MelderError) {
+			Melder_clearError ();
+		}
+		return;
+	}
 	try {
 		LongSound_haveWindow (me, tmin, tmax);
 	} catch (MelderError) {
@@ -532,6 +813,57 @@ void LongSound_getWindowExtrema (LongSound me, double tmin, double tmax, integer
 	*maximum = maximum_int / 32768.0;
 }
 
+static LongSound_Summary _LongSound_summarizeWindow (LongSound me, double tmin, double tmax) {
+	if (tmax <= tmin) {
+		tmin = my xmin;
+		tmax = my xmax;
+	}
+	integer imin, imax;
+	if (Sampled_getWindowSamples (me, tmin, tmax, & imin, & imax) == 0)
+		return LongSound_Summary ();
+	return _LongSound_summarize (me, 0, imin, imax, true);
+}
+
+double LongSound_getMinimum (LongSound me, double tmin, double tmax) {
+	return _LongSound_summarizeWindow (me, tmin, tmax). minimum;
+}
+
+double LongSound_getMaximum (LongSound me, double tmin, double tmax) {
+	return _LongSound_summarizeWindow (me, tmin, tmax). maximum;
+}
+
+double LongSound_getRootMeanSquare (LongSound me, double tmin, double tmax) {
+	const LongSound_Summary summary = _LongSound_summarizeWindow (me, tmin, tmax);
+	return summary.numberOfValues > 0 ? sqrt (summary.sumOfSquares / summary.numberOfValues) : undefined;
+}
+
+bool LongSound_shouldDrawEnvelope (LongSound me, double tmin, double tmax, integer numberOfPixels) {
+	integer imin, imax;
+	const integer n = Sampled_getWindowSamples (me, tmin, tmax, & imin, & imax);
+	return ! _LongSound_windowFits (me, n) || n >= 4 * LongSound_SAMPLES_PER_ENVELOPE_BLOCK * numberOfPixels;
+}
+
+autoMAT LongSound_getEnvelope (LongSound me, integer channel, double tmin, double tmax, integer numberOfPoints) {
+	Melder_require (channel >= 1 && channel <= my numberOfChannels,
+		U"The channel number should be between 1 and ", my numberOfChannels, U".");
+	Melder_require (numberOfPoints >= 1,
+		U"The number of points should be at least 1.");
+	autoMAT result = raw_MAT (3, numberOfPoints);
+	integer imin, imax;
+	const integer n = Sampled_getWindowSamples (me, tmin, tmax, & imin, & imax);
+	const bool exact = ( n < numberOfPoints * LongSound_SAMPLES_PER_ENVELOPE_BLOCK );
+	for (integer ipoint = 1; ipoint <= numberOfPoints; ipoint ++) {
+		const integer firstSample = imin + (ipoint - 1) * n / numberOfPoints;
+		const integer lastSample = imin + ipoint * n / numberOfPoints - 1;
+		const LongSound_Summary summary = ( firstSample <= lastSample ?
+				_LongSound_summarize (me, channel, firstSample, lastSample, exact) : LongSound_Summary () );
+		result [1] [ipoint] = summary.minimum;
+		result [2] [ipoint] = summary.maximum;
+		result [3] [ipoint] = ( summary.numberOfValues > 0 ? sqrt (summary.sumOfSquares / summary.numberOfValues) : undefined );
+	}
+	return result;
+}
+
 static struct LongSoundPlay {
 	integer numberOfSamples, i1, i2, silenceBefore, silenceAfter;
 	double tmin, tmax, dt, t1;
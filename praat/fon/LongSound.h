@@ -21,8 +21,9 @@
 #include "Sound.h"
 #include "Collection.h"
 
-#define COMPRESSED_MODE_READ_FLOAT 0
-#define COMPRESSED_MODE_READ_SHORT 1
+#define LongSound_SAMPLES_PER_ENVELOPE_BLOCK  1024
+#define LongSound_ENVELOPE_FAN_OUT  8
+#define LongSound_MAXIMUM_NUMBER_OF_ENVELOPE_LEVELS  12
 
 struct FLAC__StreamDecoder;
 struct FLAC__StreamEncoder;
@@ -42,12 +43,47 @@ Thing_define (LongSound, Sampled) {
 	integer imin, imax;
 	void invalidateBuffer () noexcept { our imin = 1; our imax = 0; }
 
+	/*
+		The sample data of an uncompressed file, mapped read-only into memory where the platform allows,
+		so that samples are decoded straight from the page cache instead of being sought and read.
+		The mapping lasts as long as the LongSound. If another program truncates the file meanwhile,
+		touching the pages beyond its new end raises SIGBUS; therefore every read first checks the size of the file
+		(and falls back on reading through the buffer), which leaves only a truncation during the read itself unguarded.
+	*/
+	void *mapping;
+	size_t sizeOfMapping;
+	const uint8 *mappedSamples;   // null if the file is not mapped
+	integer numberOfMappedSamples;   // fewer than nx if the file is shorter than its header claims
+
+	/*
+		The envelope of the samples, for drawing and measuring long stretches without reading all of their samples:
+		for each channel, the minimum, maximum and sum of squares of the samples in blocks of
+		LongSound_SAMPLES_PER_ENVELOPE_BLOCK samples (level 1), of LongSound_ENVELOPE_FAN_OUT such blocks (level 2), and so on.
+		It is built in a single pass over the file, the first time that it is needed.
+	*/
+	struct EnvelopeLevel {
+		integer samplesPerBlock, numberOfBlocks;
+		autoMAT minima, maxima, sumsOfSquares;   // channel x block
+	} envelope [1+LongSound_MAXIMUM_NUMBER_OF_ENVELOPE_LEVELS];
+	integer numberOfEnvelopeLevels;   // 0 if the envelope has not been built yet
+
 	struct FLAC__StreamDecoder *flacDecoder;
 	struct _MP3_FILE *mp3f;
-	int compressedMode;
+	/*
+		The most recently decoded blocks of a compressed (FLAC or MP3) file,
+		kept as the integer samples that the decoder delivers (channel after channel),
+		so that reading a part that lies near a part that was read before is a memory copy instead of a seek and a decode.
+		When all slots are in use, the least recently used block is decoded over.
+	*/
+	autovector <int32> cachedSamples;   // numberOfCacheSlots * numberOfChannels * samplesPerCachedBlock
+	autovector <integer> cachedBlockNumbers;   // 0 if the slot is empty
+	autovector <integer> cachedBlockLastUse;
+	autovector <integer> cachedBlockBitsPerSample;   // FLAC only
+	integer cacheClock;
 	integer compressedSamplesLeft;
-	double *compressedFloats [2];
-	int16 *compressedShorts;
+	int32 *compressedBlock;   // the slot that the decoder is currently writing into
+	integer compressedBlockOffset;   // the number of samples per channel that it has written so far
+	integer compressedBitsPerSample;
 
 	void v_destroy () noexcept
 		override;
@@ -70,7 +106,41 @@ bool LongSound_haveWindow (LongSound me, double tmin, double tmax);
  * Returns 0 if error or if window exceeds buffer, otherwise 1;
  */
 
-void LongSound_getWindowExtrema (LongSound me, double tmin, double tmax, integer channel, double *minimum, double *maximum);
+void LongSound_getWindowExtrema (LongSound me, double tmin, double tmax, integer channel, bool useEnvelope, double *minimum, double *maximum);
+/*
+	Windows that do not fit in the buffer are measured with the help of the envelope,
+	and so are all windows if `useEnvelope` (e.g. if the window is drawn from the envelope),
+	so that the buffer does not have to be filled with the whole window.
+*/
+
+double LongSound_getMinimum (LongSound me, double tmin, double tmax);
+double LongSound_getMaximum (LongSound me, double tmin, double tmax);
+double LongSound_getRootMeanSquare (LongSound me, double tmin, double tmax);
+/*
+	Over the samples of all channels in the window, without interpolation;
+	these use the envelope, so that they are fast for windows of any length.
+	Return undefined if there are no samples in the window.
+*/
+
+void LongSound_prepareEnvelope (LongSound me);
+/*
+	Builds the envelope if that has not been done yet. This reads the whole file, under a progress window;
+	if the user interrupts, the envelope is not built, and an error is thrown.
+*/
+
+bool LongSound_shouldDrawEnvelope (LongSound me, double tmin, double tmax, integer numberOfPixels);
+/*
+	Whether the window has so many samples per pixel that it should be drawn from the envelope
+	instead of from the samples, or does not fit in the buffer.
+*/
+
+autoMAT LongSound_getEnvelope (LongSound me, integer channel, double tmin, double tmax, integer numberOfPoints);
+/*
+	The minimum (row 1), maximum (row 2) and root-mean-square (row 3) of the samples of `channel`
+	in each of `numberOfPoints` equal parts of the window; undefined for parts without samples.
+	If the parts have at least LongSound_SAMPLES_PER_ENVELOPE_BLOCK samples,
+	their edges are rounded to the blocks of the envelope.
+*/
 
 void LongSound_playPart (LongSound me, double tmin, double tmax,
 	Sound_PlayCallback callback, Thing boss);
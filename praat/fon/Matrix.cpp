@@ -691,6 +691,11 @@ void Matrix_formula (Matrix me, conststring32 expression, Interpreter interprete
 		Formula_Result result;
 		if (! target)
 			target = me;
+		if (Formula_isElementwise ()) {
+			for (integer irow = 1; irow <= my ny; irow ++)
+				Formula_runElementwise (irow, 1, my z.row (irow), target -> z.row (irow));
+			return;
+		}
 		for (integer irow = 1; irow <= my ny; irow ++) {
 			for (integer icol = 1; icol <= my nx; icol ++) {
 				Formula_run (irow, icol, & result);
@@ -718,6 +723,12 @@ void Matrix_formula_part (Matrix me, double xmin, double xmax, double ymin, doub
 		Formula_Result result;
 		if (! target)
 			target = me;
+		if (Formula_isElementwise () && ixmax >= ixmin) {
+			for (integer irow = iymin; irow <= iymax; irow ++)
+				Formula_runElementwise (irow, ixmin, my z.row (irow). part (ixmin, ixmax),
+						target -> z.row (irow). part (ixmin, ixmax));
+			return;
+		}
 		for (integer irow = iymin; irow <= iymax; irow ++) {
 			for (integer icol = ixmin; icol <= ixmax; icol ++) {
 				Formula_run (irow, icol, & result);
@@ -521,156 +521,258 @@ autoMAT Pitch_getAllCandidatesInFrame (Pitch me, integer frameNumber) {
 	}
 }
 
-void Pitch_pathFinder (Pitch me, double silenceThreshold, double voicingThreshold,
+void PitchPathFinder_init (PitchPathFinder *me, Pitch pitch, double silenceThreshold, double voicingThreshold,
 	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost,
-	double ceiling, int pullFormants)
+	double ceiling, int pullFormants, integer maximumLookahead)
 {
-	if (Melder_debug == 33)
-		Melder_casual (U"Pitch path finder:"
-			U"\nSilence threshold = ", silenceThreshold,
-			U"\nVoicing threshold = ", voicingThreshold,
-			U"\nOctave cost = ", octaveCost,
-			U"\nOctave jump cost = ", octaveJumpCost,
-			U"\nVoiced/unvoiced cost = ", voicedUnvoicedCost,
-			U"\nCeiling = ", ceiling,
-			U"\nPull formants = ", pullFormants);
-	try {
-		const integer maxnCandidates = Pitch_getMaxnCandidates (me);
-		integer place;
-		volatile double maximum, value;
-		const double ceiling2 = ( pullFormants ? 2.0 * ceiling : ceiling );
-		/* Next three lines 20011015 */
-		const double timeStepCorrection = 0.01 / my dx;
-		octaveJumpCost *= timeStepCorrection;
-		voicedUnvoicedCost *= timeStepCorrection;
+	Melder_require (maximumLookahead >= 0,
+		U"The maximum lookahead should not be negative.");
+	my pitch = pitch;
+	my silenceThreshold = silenceThreshold;
+	my voicingThreshold = voicingThreshold;
+	my octaveCost = octaveCost;
+	/* Next three lines 20011015 */
+	const double timeStepCorrection = 0.01 / pitch -> dx;
+	my octaveJumpCost = octaveJumpCost * timeStepCorrection;
+	my voicedUnvoicedCost = voicedUnvoicedCost * timeStepCorrection;
+	my ceiling = ceiling;
+	my ceiling2 = ( pullFormants ? 2.0 * ceiling : ceiling );
+	my maximumLookahead = maximumLookahead;
+	my maximumNumberOfCandidates = std::max (integer (pitch -> maxnCandidates), Pitch_getMaxnCandidates (pitch));
+	my numberOfAddedFrames = 0;
+	my numberOfDecidedFrames = 0;
+	pitch -> ceiling = ceiling;
+	my delta = zero_MAT (2, my maximumNumberOfCandidates);
+	my psi = zero_INTMAT (maximumLookahead > 0 ? std::min (maximumLookahead + 1, pitch -> nx) : pitch -> nx, my maximumNumberOfCandidates);
+	my isOpen = zero_BOOLVEC (my maximumNumberOfCandidates);
+	my ancestors = zero_INTVEC (my maximumNumberOfCandidates);
+}
 
-		my ceiling = ceiling;
-		autoMAT delta = zero_MAT (my nx, maxnCandidates);
-		autoINTMAT psi = zero_INTMAT (my nx, maxnCandidates);
-
-		for (integer iframe = 1; iframe <= my nx; iframe ++) {
-			const Pitch_Frame frame = & my frames [iframe];
-			double unvoicedStrength = ( silenceThreshold <= 0 ? 0.0 :
-				2.0 - frame -> intensity / (silenceThreshold / (1.0 + voicingThreshold)) );
-			unvoicedStrength = voicingThreshold + std::max (0.0, unvoicedStrength);
-			for (integer icand = 1; icand <= frame -> nCandidates; icand ++) {
-				const Pitch_Candidate candidate = & frame -> candidates [icand];
-				const bool voiceless = ! Pitch_util_frequencyIsVoiced (candidate -> frequency, ceiling2);
-				delta [iframe] [icand] = ( voiceless ? unvoicedStrength :
-					candidate -> strength - octaveCost * NUMlog2 (ceiling / candidate -> frequency) );
+static integer PitchPathFinder_getDeltaRow (integer iframe) {
+	return iframe % 2 + 1;
+}
+
+static integer PitchPathFinder_getPsiRow (PitchPathFinder *me, integer iframe) {
+	return (iframe - 1) % my psi.nrow + 1;
+}
+
+/*
+	Decide the frames from `lastFrame` back to the first undecided frame,
+	following the path back from candidate `place` in `lastFrame`.
+*/
+static void PitchPathFinder_decide (PitchPathFinder *me, integer lastFrame, integer place) {
+	for (integer iframe = lastFrame; iframe > my numberOfDecidedFrames; iframe --) {
+		if (Melder_debug == 33)
+			Melder_casual (
+				U"Frame ", iframe, U":",
+				U" swapping candidates 1 and ", place
+			);
+		const Pitch_Frame frame = & my pitch -> frames [iframe];
+		std::swap (frame -> candidates [1], frame -> candidates [place]);
+		place = my psi [PitchPathFinder_getPsiRow (me, iframe)] [place];
+
+		/* Pull formants: devoice frames with frequencies between ceiling and ceiling2. */
+
+		const Pitch_Candidate winner = & frame -> candidates [1];
+		const double f = winner -> frequency;
+		if (f > my ceiling && f < my ceiling2) {
+			for (integer icand = 2; icand <= frame -> nCandidates; icand ++) {
+				const Pitch_Candidate loser = & frame -> candidates [icand];
+				if (loser -> frequency == 0.0) {
+					std::swap (* winner, * loser);
+					break;
+				}
 			}
 		}
+	}
+	my numberOfDecidedFrames = lastFrame;
+}
 
-		/* Look for the most probable path through the maxima. */
-		/* There is a cost for the voiced/unvoiced transition, */
-		/* and a cost for a frequency jump. */
-
-		for (integer iframe = 2; iframe <= my nx; iframe ++) {
-			const Pitch_Frame prevFrame = & my frames [iframe - 1], curFrame = & my frames [iframe];
-			const constVEC prevDelta = delta [iframe - 1];
-			const VEC curDelta = delta [iframe];
-			const INTVEC curPsi = psi [iframe];
-			for (integer icand2 = 1; icand2 <= curFrame -> nCandidates; icand2 ++) {
-				const double f2 = curFrame -> candidates [icand2]. frequency;
-				maximum = -1e30;
-				place = 0;
-				for (integer icand1 = 1; icand1 <= prevFrame -> nCandidates; icand1 ++) {
-					double f1 = prevFrame -> candidates [icand1]. frequency;
-					double transitionCost;
-					const bool previousVoiceless = ! Pitch_util_frequencyIsVoiced (f1, ceiling2);
-					const bool currentVoiceless = ! Pitch_util_frequencyIsVoiced (f2, ceiling2);
-					if (currentVoiceless) {
-						if (previousVoiceless) {
-							transitionCost = 0.0;   // both voiceless
-						} else {
-							transitionCost = voicedUnvoicedCost;   // voiced-to-unvoiced transition
-						}
+/*
+	Decide the frames on which all open paths into the last frame agree,
+	and, if there are then still more than `maximumLookahead` undecided frames, force a decision.
+*/
+static void PitchPathFinder_decideEarly (PitchPathFinder *me) {
+	const integer lastFrame = my numberOfAddedFrames;
+	const integer numberOfCandidates = my pitch -> frames [lastFrame]. nCandidates;
+	const integer forcedFrame = lastFrame - my maximumLookahead;
+	const constVEC lastDelta = my delta [PitchPathFinder_getDeltaRow (lastFrame)];
+	integer best = 0;
+	for (integer icand = 1; icand <= numberOfCandidates; icand ++) {
+		my ancestors [icand] = icand;
+		if (my isOpen [icand] && (best == 0 || lastDelta [icand] > lastDelta [best]))
+			best = icand;
+	}
+	for (integer iframe = lastFrame; iframe > my numberOfDecidedFrames + 1; iframe --) {
+		/*
+			Invariant: ancestors [icand] is the candidate in `iframe` on the path into candidate `icand` of the last frame.
+		*/
+		const constINTVEC psi = my psi [PitchPathFinder_getPsiRow (me, iframe)];
+		integer commonAncestor = 0;
+		bool haveCommonAncestor = true;
+		for (integer icand = 1; icand <= numberOfCandidates; icand ++) {
+			if (! my isOpen [icand])
+				continue;
+			my ancestors [icand] = psi [my ancestors [icand]];
+			if (commonAncestor == 0)
+				commonAncestor = my ancestors [icand];
+			else if (my ancestors [icand] != commonAncestor)
+				haveCommonAncestor = false;
+		}
+		if (haveCommonAncestor) {
+			PitchPathFinder_decide (me, iframe - 1, commonAncestor);
+			return;
+		}
+		if (iframe - 1 == forcedFrame) {
+			const integer place = my ancestors [best];
+			for (integer icand = 1; icand <= numberOfCandidates; icand ++)
+				if (my ancestors [icand] != place)
+					my isOpen [icand] = false;
+			PitchPathFinder_decide (me, forcedFrame, place);
+			return;
+		}
+	}
+}
+
+void PitchPathFinder_addFrame (PitchPathFinder *me) {
+	const Pitch pitch = my pitch;
+	const integer iframe = ++ my numberOfAddedFrames;
+	Melder_assert (iframe <= pitch -> nx);
+	const Pitch_Frame curFrame = & pitch -> frames [iframe];
+	Melder_require (curFrame -> nCandidates <= my maximumNumberOfCandidates,
+		U"Frame ", iframe, U" has more than ", my maximumNumberOfCandidates, U" candidates.");
+	const VEC curDelta = my delta [PitchPathFinder_getDeltaRow (iframe)];
+	double unvoicedStrength = ( my silenceThreshold <= 0 ? 0.0 :
+		2.0 - curFrame -> intensity / (my silenceThreshold / (1.0 + my voicingThreshold)) );
+	unvoicedStrength = my voicingThreshold + std::max (0.0, unvoicedStrength);
+	for (integer icand = 1; icand <= curFrame -> nCandidates; icand ++) {
+		const Pitch_Candidate candidate = & curFrame -> candidates [icand];
+		const bool voiceless = ! Pitch_util_frequencyIsVoiced (candidate -> frequency, my ceiling2);
+		curDelta [icand] = ( voiceless ? unvoicedStrength :
+			candidate -> strength - my octaveCost * NUMlog2 (my ceiling / candidate -> frequency) );
+	}
+
+	/* Look for the most probable path through the maxima. */
+	/* There is a cost for the voiced/unvoiced transition, */
+	/* and a cost for a frequency jump. */
+
+	if (iframe > 1) {
+		const Pitch_Frame prevFrame = & pitch -> frames [iframe - 1];
+		const constVEC prevDelta = my delta [PitchPathFinder_getDeltaRow (iframe - 1)];
+		const INTVEC curPsi = my psi [PitchPathFinder_getPsiRow (me, iframe)];
+		for (integer icand2 = 1; icand2 <= curFrame -> nCandidates; icand2 ++) {
+			const double f2 = curFrame -> candidates [icand2]. frequency;
+			const bool currentVoiceless = ! Pitch_util_frequencyIsVoiced (f2, my ceiling2);
+			volatile double maximum = -1e30;
+			integer place = 0;
+			for (integer icand1 = 1; icand1 <= prevFrame -> nCandidates; icand1 ++) {
+				if (! my isOpen [icand1])
+					continue;
+				double f1 = prevFrame -> candidates [icand1]. frequency;
+				double transitionCost;
+				const bool previousVoiceless = ! Pitch_util_frequencyIsVoiced (f1, my ceiling2);
+				if (currentVoiceless) {
+					if (previousVoiceless) {
+						transitionCost = 0.0;   // both voiceless
 					} else {
-						if (previousVoiceless) {
-							transitionCost = voicedUnvoicedCost;   // unvoiced-to-voiced transition
-							if (Melder_debug == 30) {
-								/*
-									Try to take into account a frequency jump across a voiceless stretch.
-								*/
-								integer place1 = icand1;
-								for (integer jframe = iframe - 2; jframe >= 1; jframe --) {
-									place1 = psi [jframe + 1] [place1];
-									f1 = my frames [jframe]. candidates [place1]. frequency;
-									if (Pitch_util_frequencyIsVoiced (f1, ceiling)) {
-										transitionCost += octaveJumpCost * fabs (NUMlog2 (f1 / f2)) / (iframe - jframe);
-										break;
-									}
+						transitionCost = my voicedUnvoicedCost;   // voiced-to-unvoiced transition
+					}
+				} else {
+					if (previousVoiceless) {
+						transitionCost = my voicedUnvoicedCost;   // unvoiced-to-voiced transition
+						if (Melder_debug == 30) {
+							/*
+								Try to take into account a frequency jump across a voiceless stretch.
+								The frames that have been decided already lie on every open path.
+							*/
+							integer place1 = icand1;
+							for (integer jframe = iframe - 2; jframe >= 1; jframe --) {
+								if (jframe > my numberOfDecidedFrames) {
+									place1 = my psi [PitchPathFinder_getPsiRow (me, jframe + 1)] [place1];
+									f1 = pitch -> frames [jframe]. candidates [place1]. frequency;
+								} else {
+									f1 = pitch -> frames [jframe]. candidates [1]. frequency;
+								}
+								if (Pitch_util_frequencyIsVoiced (f1, my ceiling)) {
+									transitionCost += my octaveJumpCost * fabs (NUMlog2 (f1 / f2)) / (iframe - jframe);
+									break;
 								}
 							}
-						} else {
-							transitionCost = octaveJumpCost * fabs (NUMlog2 (f1 / f2));   // both voiced
 						}
+					} else {
+						transitionCost = my octaveJumpCost * fabs (NUMlog2 (f1 / f2));   // both voiced
 					}
-					value = prevDelta [icand1] - transitionCost + curDelta [icand2];
-					//if (Melder_debug == 33) Melder_casual (U"Frame ", iframe, U", current candidate ", icand2,
-					//  U" (delta ", curDelta [icand2], U"), previous candidate ", icand1, U" (delta ", prevDelta [icand1], U"), ",
-					//	U"transition cost ", transitionCost, U", value ", value, U", maximum ", maximum);
-					if (value > maximum) {
-						maximum = value;
-						place = icand1;
-					} else if (value == maximum) {
-						if (Melder_debug == 33)
-							Melder_casual (
-								U"A tie in frame ", iframe,
-								U", current candidate ", icand2,
-								U", previous candidate ", icand1
-							);
-					}
 				}
-				curDelta [icand2] = maximum;
-				curPsi [icand2] = place;
+				const volatile double value = prevDelta [icand1] - transitionCost + curDelta [icand2];
+				if (value > maximum) {
+					maximum = value;
+					place = icand1;
+				} else if (value == maximum) {
+					if (Melder_debug == 33)
+						Melder_casual (
+							U"A tie in frame ", iframe,
+							U", current candidate ", icand2,
+							U", previous candidate ", icand1
+						);
+				}
 			}
+			curDelta [icand2] = maximum;
+			curPsi [icand2] = place;
 		}
+	}
+	for (integer icand = 1; icand <= curFrame -> nCandidates; icand ++)
+		my isOpen [icand] = true;
 
-		/* Find the end of the most probable path. */
+	if (my maximumLookahead > 0)
+		PitchPathFinder_decideEarly (me);
+}
 
-		place = 1;
-		maximum = delta [my nx] [place];
-		for (integer icand = 2; icand <= my frames [my nx]. nCandidates; icand ++) {
-			if (delta [my nx] [icand] > maximum) {
-				place = icand;
-				maximum = delta [my nx] [place];
-			}
-		}
+void PitchPathFinder_finish (PitchPathFinder *me) {
+	const integer lastFrame = my numberOfAddedFrames;
+	if (lastFrame <= my numberOfDecidedFrames)
+		return;
 
-		/* Backtracking: follow the path backwards. */
-
-		for (integer iframe = my nx; iframe >= 1; iframe --) {
-			if (Melder_debug == 33)
-				Melder_casual (
-					U"Frame ", iframe, U":",
-					U" swapping candidates 1 and ", place
-				);
-			const Pitch_Frame frame = & my frames [iframe];
-			std::swap (frame -> candidates [1], frame -> candidates [place]);
-			place = psi [iframe] [place];
+	/* Find the end of the most probable path. */
+
+	const constVEC lastDelta = my delta [PitchPathFinder_getDeltaRow (lastFrame)];
+	const integer numberOfCandidates = my pitch -> frames [lastFrame]. nCandidates;
+	integer place = 1;
+	while (place < numberOfCandidates && ! my isOpen [place])
+		place ++;
+	double maximum = lastDelta [place];
+	for (integer icand = place + 1; icand <= numberOfCandidates; icand ++) {
+		if (my isOpen [icand] && lastDelta [icand] > maximum) {
+			place = icand;
+			maximum = lastDelta [place];
 		}
+	}
 
-		/* Pull formants: devoice frames with frequencies between ceiling and ceiling2. */
+	/* Backtracking: follow the path backwards. */
 
-		if (ceiling2 > ceiling) {
-			if (Melder_debug == 33)
-				Melder_casual (U"Pulling formants...");
-			for (integer iframe = my nx; iframe >= 1; iframe --) {
-				const Pitch_Frame frame = & my frames [iframe];
-				const Pitch_Candidate winner = & frame -> candidates [1];
-				const double f = winner -> frequency;
-				if (f > ceiling && f < ceiling2) {
-					for (integer icand = 2; icand <= frame -> nCandidates; icand ++) {
-						const Pitch_Candidate loser = & frame -> candidates [icand];
-						if (loser -> frequency == 0.0) {
-							std::swap (* winner, * loser);
-							break;
-						}
-					}
-				}
-			}
-		}
+	PitchPathFinder_decide (me, lastFrame, place);
+}
+
+void Pitch_pathFinder (Pitch me, double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost,
+	double ceiling, int pullFormants, integer maximumLookahead)
+{
+	if (Melder_debug == 33)
+		Melder_casual (U"Pitch path finder:"
+			U"\nSilence threshold = ", silenceThreshold,
+			U"\nVoicing threshold = ", voicingThreshold,
+			U"\nOctave cost = ", octaveCost,
+			U"\nOctave jump cost = ", octaveJumpCost,
+			U"\nVoiced/unvoiced cost = ", voicedUnvoicedCost,
+			U"\nCeiling = ", ceiling,
+			U"\nPull formants = ", pullFormants,
+			U"\nMaximum lookahead = ", maximumLookahead);
+	try {
+		PitchPathFinder pathFinder;
+		PitchPathFinder_init (& pathFinder, me, silenceThreshold, voicingThreshold,
+				octaveCost, octaveJumpCost, voicedUnvoicedCost, ceiling, pullFormants, maximumLookahead);
+		for (integer iframe = 1; iframe <= my nx; iframe ++)
+			PitchPathFinder_addFrame (& pathFinder);
+		PitchPathFinder_finish (& pathFinder);
 	} catch (MelderError) {
 		Melder_throw (me, U": path not found.");
 	}
@@ -128,7 +128,40 @@ autoMAT Pitch_getAllCandidatesInFrame (Pitch me, integer frameNumber);
 
 void Pitch_pathFinder (Pitch me, double silenceThreshold, double voicingThreshold,
 	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost,
-	double ceiling, int pullFormants);
+	double ceiling, int pullFormants, integer maximumLookahead = 0);
+/*
+	Moves the candidates on the most probable path (Viterbi) to place 1 in each frame.
+	With maximumLookahead = 0 the whole path is optimal;
+	otherwise, see PitchPathFinder.
+*/
+
+/*
+	The path finder, one frame at a time, for streaming use.
+	After PitchPathFinder_init (), call PitchPathFinder_addFrame () for frames 1, 2, ... of the Pitch,
+	each as soon as its intensity and candidates are known, and PitchPathFinder_finish () after the last one.
+	A frame is decided (its candidate on the path is moved to place 1) once `numberOfDecidedFrames` has passed it.
+
+	With maximumLookahead = 0, all frames are decided by PitchPathFinder_finish (), and the path is the optimal one.
+	With a positive maximumLookahead, a frame is decided as soon as all the paths that are still open agree on it,
+	or at the latest when `maximumLookahead` later frames have been added, in which case the paths that do not go through
+	the best candidate at that moment are closed; the path is then optimal only if no frame had to be decided that way.
+*/
+struct PitchPathFinder {
+	Pitch pitch;
+	double silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, ceiling, ceiling2;
+	integer maximumLookahead;
+	integer maximumNumberOfCandidates;
+	integer numberOfAddedFrames, numberOfDecidedFrames;
+	autoMAT delta;   // the scores of the best paths into the candidates of the last two frames that were added
+	autoINTMAT psi;   // for the undecided frames (in a ring): the candidate of the previous frame on the best path into each candidate
+	autoBOOLVEC isOpen;   // for the last frame that was added
+	autoINTVEC ancestors;
+};
+void PitchPathFinder_init (PitchPathFinder *me, Pitch pitch, double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost,
+	double ceiling, int pullFormants, integer maximumLookahead);
+void PitchPathFinder_addFrame (PitchPathFinder *me);
+void PitchPathFinder_finish (PitchPathFinder *me);
 
 /* Drawing methods. */
 #define Pitch_speckle_NO  false
@@ -176,6 +176,11 @@ static double Sound_findMaximumCorrelation (Sound me, double t1, double windowLe
 autoPointProcess Sound_Pitch_to_PointProcess_cc (Sound sound, Pitch pitch) {
 	try {
 		autoPointProcess point = PointProcess_create (sound -> xmin, sound -> xmax, 10);
+		/*
+			The pulses are found outward from the middle of every voiced interval, i.e. partly from right to left;
+			inserting them one by one would shift the later pulses time and again, so we add them all at the end.
+		*/
+		autoVEC pulses;
 		double t = pitch -> xmin;
 		double addedRight = -1e308;
 		const double globalPeak = Vector_getAbsoluteExtremum (sound, sound -> xmin, sound -> xmax, kVector_peakInterpolation :: NONE);
@@ -209,7 +214,7 @@ autoPointProcess Sound_Pitch_to_PointProcess_cc (Sound sound, Pitch pitch) {
 			}
 			double tmax = Sound_findExtremum (sound, tmiddle - 0.5 / f0middle, tmiddle + 0.5 / f0middle, true, true);
 			Melder_assert (isdefined (tmax));
-			PointProcess_addPoint (point.get(), tmax);
+			*pulses. append () = tmax;
 
 			double tsave = tmax;
 			for (;;) {
@@ -222,12 +227,12 @@ autoPointProcess Sound_Pitch_to_PointProcess_cc (Sound sound, Pitch pitch) {
 					/*break*/ tmax -= 1.0 / f0;   // this one period will drop out
 				if (tmax < tleft) {
 					if (correlation > 0.7 && peak > 0.023333 * globalPeak && tmax - addedRight > 0.8 / f0)
-						PointProcess_addPoint (point.get(), tmax);
+						*pulses. append () = tmax;
 					break;
 				}
 				if (correlation > 0.3 && (peak == 0.0 || peak > 0.01 * globalPeak)) {
 					if (tmax - addedRight > 0.8 / f0) {   // do not fill in a short originally unvoiced interval twice
-						PointProcess_addPoint (point.get(), tmax);
+						*pulses. append () = tmax;
 					}
 				}
 			}
@@ -242,18 +247,19 @@ autoPointProcess Sound_Pitch_to_PointProcess_cc (Sound sound, Pitch pitch) {
 					/*break*/ tmax += 1.0 / f0;
 				if (tmax > tright) {
 					if (correlation > 0.7 && peak > 0.023333 * globalPeak) {
-						PointProcess_addPoint (point.get(), tmax);
+						*pulses. append () = tmax;
 						addedRight = tmax;
 					}
 					break;
 				}
 				if (correlation > 0.3 && (peak == 0.0 || peak > 0.01 * globalPeak)) {
-					PointProcess_addPoint (point.get(), tmax);
+					*pulses. append () = tmax;
 					addedRight = tmax;
 				}
 			}
 			t = tright;
 		}
+		PointProcess_addPoints (point.get(), pulses.get());
 		return point;
 	} catch (MelderError) {
 		Melder_throw (sound, U" & ", pitch, U": not converted to PointProcess (cc).");
@@ -263,6 +269,11 @@ autoPointProcess Sound_Pitch_to_PointProcess_cc (Sound sound, Pitch pitch) {
 autoPointProcess Sound_Pitch_to_PointProcess_peaks (Sound sound, Pitch pitch, int includeMaxima, int includeMinima) {
 	try {
 		autoPointProcess point = PointProcess_create (sound -> xmin, sound -> xmax, 10);
+		/*
+			The pulses are found outward from the middle of every voiced interval, i.e. partly from right to left;
+			inserting them one by one would shift the later pulses time and again, so we add them all at the end.
+		*/
+		autoVEC pulses;
 		double t = pitch -> xmin;
 		double addedRight = -1e308;
 		/*
@@ -287,7 +298,7 @@ autoPointProcess Sound_Pitch_to_PointProcess_peaks (Sound sound, Pitch pitch, in
 			Melder_assert (isdefined (f0middle));
 			double tmax = Sound_findExtremum (sound, tmiddle - 0.5 / f0middle, tmiddle + 0.5 / f0middle, includeMaxima, includeMinima);
 			Melder_assert (isdefined (tmax));
-			PointProcess_addPoint (point.get(), tmax);
+			*pulses. append () = tmax;
 
 			double tsave = tmax;
 			for (;;) {
@@ -297,11 +308,11 @@ autoPointProcess Sound_Pitch_to_PointProcess_peaks (Sound sound, Pitch pitch, in
 				tmax = Sound_findExtremum (sound, tmax - 1.25 / f0, tmax - 0.8 / f0, includeMaxima, includeMinima);
 				if (tmax < tleft) {
 					if (tmax - addedRight > 0.8 / f0)
-						PointProcess_addPoint (point.get(), tmax);
+						*pulses. append () = tmax;
 					break;
 				}
 				if (tmax - addedRight > 0.8 / f0)   // do not fill in a short originally unvoiced interval twice
-					PointProcess_addPoint (point.get(), tmax);
+					*pulses. append () = tmax;
 			}
 			tmax = tsave;
 			for (;;) {
@@ -310,15 +321,16 @@ autoPointProcess Sound_Pitch_to_PointProcess_peaks (Sound sound, Pitch pitch, in
 					break;
 				tmax = Sound_findExtremum (sound, tmax + 0.8 / f0, tmax + 1.25 / f0, includeMaxima, includeMinima);
 				if (tmax > tright) {
-					PointProcess_addPoint (point.get(), tmax);
+					*pulses. append () = tmax;
 					addedRight = tmax;
 					break;
 				}
-				PointProcess_addPoint (point.get(), tmax);
+				*pulses. append () = tmax;
 				addedRight = tmax;
 			}
 			t = tright;
 		}
+		PointProcess_addPoints (point.get(), pulses.get());
 		return point;
 	} catch (MelderError) {
 		Melder_throw (sound, U" & ", pitch, U": not converted to PointProcess (peaks).");
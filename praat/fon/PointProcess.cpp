@@ -188,15 +188,15 @@ void PointProcess_addPoint (PointProcess me, double t) {
 		Melder_require (isdefined (t),
 			U"Cannot add a point at an undefined time.");
 		const integer newNumberOfPoints = my nt + 1;
-		my t. resize (newNumberOfPoints);
 		if (my nt == 0 || t >= my t [my nt]) {   // special case that often occurs in practice
+			my t. resize (newNumberOfPoints);   // amortized constant time, because the capacity grows geometrically
 			my nt = newNumberOfPoints;   // maintain invariant
 			my t [newNumberOfPoints] = t;
 		} else {
 			const integer left = PointProcess_getLowIndex (me, t);
 			if (left == 0 || my t [left] != t) {
-				for (integer i = my nt; i > left; i --)
-					my t [i + 1] = my t [i];
+				my t. resize (newNumberOfPoints);
+				std::copy_backward (& my t [left + 1], & my t [my nt] + 1, & my t [newNumberOfPoints] + 1);
 				my nt = newNumberOfPoints;   // maintain invariant
 				my t [left + 1] = t;
 			}
@@ -208,11 +208,42 @@ void PointProcess_addPoint (PointProcess me, double t) {
 
 void PointProcess_addPoints (PointProcess me, constVECVU const& times) {
 	try {
-		const integer newNumberOfPoints = my nt + times.size;
+		for (integer i = 1; i <= times.size; i ++)
+			Melder_require (isdefined (times [i]),
+				U"Cannot add a point at an undefined time.");
+		autoVEC newTimes = copy_VEC (times);
+		bool isSorted = true;
+		for (integer i = 2; i <= newTimes.size; i ++)
+			if (newTimes [i] < newTimes [i - 1]) {
+				isSorted = false;
+				break;
+			}
+		if (! isSorted)
+			sort_VEC_inout (newTimes.get());
+		/*
+			As with PointProcess_addPoint (), times that are already present are not added again.
+			Remove them (and repetitions among the new times) with a linear merge against the existing points...
+		*/
+		integer numberOfNewTimes = 0;
+		for (integer inew = 1, iold = 1; inew <= newTimes.size; inew ++) {
+			const double time = newTimes [inew];
+			if (numberOfNewTimes > 0 && time == newTimes [numberOfNewTimes])
+				continue;
+			while (iold <= my nt && my t [iold] < time)
+				iold ++;
+			if (iold <= my nt && my t [iold] == time)
+				continue;
+			newTimes [++ numberOfNewTimes] = time;
+		}
+		/*
+			...and merge the rest in from the back, so that every existing point moves only once.
+		*/
+		const integer oldNumberOfPoints = my nt, newNumberOfPoints = oldNumberOfPoints + numberOfNewTimes;
 		my t. resize (newNumberOfPoints);
-		my t.part (my nt + 1, newNumberOfPoints)  <<=  times;
+		integer iold = oldNumberOfPoints, inew = numberOfNewTimes;
+		for (integer ipoint = newNumberOfPoints; inew > 0; ipoint --)
+			my t [ipoint] = ( iold > 0 && my t [iold] > newTimes [inew] ? my t [iold --] : newTimes [inew --] );
 		my nt = newNumberOfPoints;   // maintain invariant
-		sort_VEC_inout (my t.get());
 	} catch (MelderError) {
 		Melder_throw (me, U": points not added.");
 	}
@@ -286,14 +317,30 @@ autoPointProcess PointProcesses_union (PointProcess me, PointProcess thee) {
 			his xmin = thy xmin;
 		if (thy xmax > my xmax)
 			his xmax = thy xmax;
-		for (integer i = 1; i <= thy nt; i ++)
-			PointProcess_addPoint (him.get(), thy t [i]);
+		PointProcess_addPoints (him.get(), thy t.part (1, thy nt));
 		return him;
 	} catch (MelderError) {
 		Melder_throw (me, U" & ", thee, U": union not computed.");
 	}
 }
 
+/*
+	Keep only the points that do (or do not) occur in `thee`, with a linear merge over the two sorted arrays.
+*/
+static void PointProcess_keepPoints (PointProcess me, PointProcess thee, bool keepThoseInThee) {
+	integer numberOfKeptPoints = 0;
+	for (integer ipoint = 1, jpoint = 1; ipoint <= my nt; ipoint ++) {
+		const double time = my t [ipoint];
+		while (jpoint <= thy nt && thy t [jpoint] < time)
+			jpoint ++;
+		const bool isInThee = ( jpoint <= thy nt && thy t [jpoint] == time );
+		if (isInThee == keepThoseInThee)
+			my t [++ numberOfKeptPoints] = time;
+	}
+	my t. resize (numberOfKeptPoints);
+	my nt = numberOfKeptPoints;   // maintain invariant
+}
+
 integer PointProcess_findPoint (PointProcess me, double t) {
 	integer left = 1, right = my nt;
 	if (my nt == 0)
@@ -323,9 +370,7 @@ autoPointProcess PointProcesses_intersection (PointProcess me, PointProcess thee
 			his xmin = thy xmin;
 		if (thy xmax < my xmax)
 			his xmax = thy xmax;
-		for (integer i = my nt; i >= 1; i --)
-			if (! PointProcess_findPoint (thee, my t [i]))
-				PointProcess_removePoint (him.get(), i);
+		PointProcess_keepPoints (him.get(), thee, true);
 		return him;
 	} catch (MelderError) {
 		Melder_throw (me, U" & ", thee, U": intersection not computed.");
@@ -335,9 +380,7 @@ autoPointProcess PointProcesses_intersection (PointProcess me, PointProcess thee
 autoPointProcess PointProcesses_difference (PointProcess me, PointProcess thee) {
 	try {
 		autoPointProcess him = Data_copy (me);
-		for (integer i = my nt; i >= 1; i --)
-			if (PointProcess_findPoint (thee, my t [i]))
-				PointProcess_removePoint (him.get(), i);
+		PointProcess_keepPoints (him.get(), thee, false);
 		return him;
 	} catch (MelderError) {
 		Melder_throw (me, U" & ", thee, U": difference not computed.");
@@ -348,9 +391,13 @@ void PointProcess_fill (PointProcess me, double tmin, double tmax, double period
 	try {
 		Function_unidirectionalAutowindow (me, & tmin, & tmax);
 		const integer n = Melder_ifloor ((tmax - tmin) / period);
+		if (n < 1)
+			return;
+		autoVEC times = raw_VEC (n);
 		double t = 0.5 * (tmin + tmax - n * period);
 		for (integer i = 1; i <= n; i ++, t += period)
-			PointProcess_addPoint (me, t);
+			times [i] = t;
+		PointProcess_addPoints (me, times.get());
 	} catch (MelderError) {
 		Melder_throw (me, U": not filled.");
 	}
@@ -380,7 +427,7 @@ MelderIntegerRange PointProcess_getWindowPoints (PointProcess me, double tmin, d
 	return { PointProcess_getHighIndex (me, tmin), PointProcess_getLowIndex (me, tmax) };
 }
 
-static bool PointProcess_isPeriod (PointProcess me, integer ileft, double minimumPeriod, double maximumPeriod, double maximumPeriodFactor) {
+bool PointProcess_isPeriod (PointProcess me, integer ileft, double minimumPeriod, double maximumPeriod, double maximumPeriodFactor) {
 	/*
 		This function answers the question: is the interval from point 'ileft' to point 'ileft+1' a period?
 	*/
@@ -25,6 +25,7 @@
 #include "Sound.h"
 #include "Sound_extensions.h"
 #include "NUM2.h"
+#include "MelderThread.h"
 
 #include "enums_getText.h"
 #include "Sound_enums.h"
@@ -128,6 +129,23 @@ autoSound Sound_create (integer numberOfChannels, double xmin, double xmax, inte
 	}
 }
 
+autoSound Sound_createFromSamples (autoMAT samples, double xmin, double xmax, double dx, double x1) {
+	try {
+		Melder_assert (samples.nrow >= 1 && samples.ncol >= 1);
+		autoSound me = Thing_new (Sound);
+		Sampled_init (me.get(), xmin, xmax, samples.ncol, dx, x1);
+		my ymin = 1.0;
+		my ymax = samples.nrow;
+		my ny = samples.nrow;
+		my dy = 1.0;
+		my y1 = 1.0;
+		my z = std::move (samples);
+		return me;
+	} catch (MelderError) {
+		Melder_throw (U"Sound not created.");
+	}
+}
+
 autoSound Sound_createSimple (integer numberOfChannels, double duration, double samplingFrequency) {
 	Melder_assert (duration >= 0.0);
 	Melder_assert (samplingFrequency > 0.0);
@@ -392,7 +410,145 @@ autoSound Sound_upsample (Sound me) {
 	}
 }
 
-autoSound Sound_resample (Sound me, double samplingFrequency, integer precision) {
+/*
+	The weights with which NUM_interpolate_sinc () multiplies y [midleft - depth + 1 .. midleft + depth]
+	when it interpolates at x = midleft + phase, with 0 <= phase <= 1 and depth >= 3 (far from the edges).
+*/
+static void Sound_resample_computeSincWeights (double phase, integer depth, VEC const& weights) {
+	Melder_assert (weights.size == 2 * depth);
+	if (phase == 0.0 || phase == 1.0) {
+		weights  <<=  0.0;
+		weights [depth + integer (phase)] = 1.0;   // the interpolated curve goes through the points
+		return;
+	}
+	const double leftWindowWidth = depth + phase, rightWindowWidth = depth + 1.0 - phase;
+	for (integer k = 0; k < depth; k ++) {
+		const double a = NUMpi * (phase + k);
+		weights [depth - k] = 0.5 * sin (a) / a * (1.0 + cos (a / leftWindowWidth));
+		const double b = NUMpi * (1.0 - phase + k);
+		weights [depth + 1 + k] = 0.5 * sin (b) / b * (1.0 + cos (b / rightWindowWidth));
+	}
+}
+
+/*
+	Whether `step` is so close to a fraction numberOfSourceSamplesPerCycle / numberOfPhases
+	that treating it as that fraction shifts none of the `numberOfSamples` positions by more than 1e-8 samples.
+*/
+static bool Sound_resample_findRationalStep (double step, integer numberOfSamples, integer maximumNumberOfPhases,
+	integer *out_numberOfPhases, integer *out_numberOfSourceSamplesPerCycle)
+{
+	for (integer numberOfPhases = 1; numberOfPhases <= maximumNumberOfPhases; numberOfPhases ++) {
+		const integer numberOfSourceSamplesPerCycle = Melder_iround (step * numberOfPhases);
+		if (numberOfSourceSamplesPerCycle < 1)
+			continue;
+		const integer numberOfCycles = (numberOfSamples - 1) / numberOfPhases + 1;
+		if (fabs (step * numberOfPhases - numberOfSourceSamplesPerCycle) * numberOfCycles < 1e-8) {
+			*out_numberOfPhases = numberOfPhases;
+			*out_numberOfSourceSamplesPerCycle = numberOfSourceSamplesPerCycle;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+	Sinc interpolation of every row of `from` at the indexes firstIndex + (i - 1) * step, for i = 1 .. to.ncol.
+
+	If the step is a fraction M / L (e.g. 441 / 160 for going from 44100 to 16000 Hz),
+	the output samples cycle through only L different fractional positions ("phases"),
+	so that we can compute the 2 * depth filter weights for each phase in advance (a polyphase filter bank),
+	and every output sample becomes a single contiguous dot product.
+	Any other step is handled with a bank tabulated at a fine grid of phases,
+	between whose neighbouring rows we interpolate linearly.
+	Output samples whose filter would extend beyond the edges of `from` go through NUM_interpolate_sinc ().
+*/
+static void Sound_resample_sinc (constMAT const& from, MAT const& to, double firstIndex, double step, integer depth) {
+	Melder_assert (from.nrow == to.nrow);
+	const integer nx = from.ncol, numberOfSamples = to.ncol, numberOfTaps = 2 * depth;
+	constexpr integer maximumNumberOfBankRows = 4096;
+	integer numberOfPhases, numberOfSourceSamplesPerCycle;
+	const bool isRational = Sound_resample_findRationalStep (step, numberOfSamples, maximumNumberOfBankRows,
+			& numberOfPhases, & numberOfSourceSamplesPerCycle);
+	if (! isRational && numberOfSamples * from.nrow < 4 * maximumNumberOfBankRows) {
+		/*
+			Too few output samples to make tabulation worthwhile.
+		*/
+		for (integer ichan = 1; ichan <= from.nrow; ichan ++)
+			for (integer i = 1; i <= numberOfSamples; i ++)
+				to [ichan] [i] = NUM_interpolate_sinc (from.row (ichan), firstIndex + (i - 1) * step, depth);
+		return;
+	}
+	autoMAT bank;
+	autoINTVEC firstLeftSample;   // for each phase, the sample just left of the first output sample in that phase
+	if (isRational) {
+		bank = raw_MAT (numberOfPhases, numberOfTaps);
+		firstLeftSample = raw_INTVEC (numberOfPhases);
+		for (integer iphase = 1; iphase <= numberOfPhases; iphase ++) {
+			const double index = firstIndex + (iphase - 1) * step;
+			firstLeftSample [iphase] = Melder_ifloor (index);
+			Sound_resample_computeSincWeights (index - firstLeftSample [iphase], depth, bank.row (iphase));
+		}
+	} else {
+		bank = raw_MAT (maximumNumberOfBankRows + 1, numberOfTaps);
+		for (integer irow = 1; irow <= maximumNumberOfBankRows + 1; irow ++)
+			Sound_resample_computeSincWeights (double (irow - 1) / maximumNumberOfBankRows, depth, bank.row (irow));
+	}
+	MelderThread_run (numberOfSamples, MelderThread_computeNumberOfThreads (numberOfSamples, 10000), 1000,
+		[&] (integer /* ithread */, integer firstSample, integer lastSample) {
+			for (integer i = firstSample; i <= lastSample; i ++) {
+				integer midleft;
+				const double *weights, *nextWeights = nullptr;
+				double fraction = 0.0;
+				if (isRational) {
+					const integer iphase = (i - 1) % numberOfPhases + 1, icycle = (i - 1) / numberOfPhases;
+					midleft = firstLeftSample [iphase] + icycle * numberOfSourceSamplesPerCycle;
+					weights = & bank [iphase] [1];
+				} else {
+					const double index = firstIndex + (i - 1) * step;
+					midleft = Melder_ifloor (index);
+					const double position = (index - midleft) * maximumNumberOfBankRows;
+					const integer irow = Melder_clipped (1_integer, Melder_ifloor (position) + 1, maximumNumberOfBankRows);
+					fraction = position - (irow - 1);
+					weights = & bank [irow] [1];
+					nextWeights = & bank [irow + 1] [1];
+				}
+				if (midleft - depth + 1 < 1 || midleft + depth > nx) {
+					for (integer ichan = 1; ichan <= from.nrow; ichan ++)
+						to [ichan] [i] = NUM_interpolate_sinc (from.row (ichan), firstIndex + (i - 1) * step, depth);
+					continue;
+				}
+				for (integer ichan = 1; ichan <= from.nrow; ichan ++) {
+					const double *y = & from [ichan] [midleft - depth + 1];
+					double sum = 0.0;
+					if (nextWeights) {
+						for (integer itap = 0; itap < numberOfTaps; itap ++)
+							sum += y [itap] * (weights [itap] + fraction * (nextWeights [itap] - weights [itap]));
+					} else {
+						for (integer itap = 0; itap < numberOfTaps; itap ++)
+							sum += y [itap] * weights [itap];
+					}
+					to [ichan] [i] = sum;
+				}
+			}
+		}
+	);
+}
+
+static constexpr integer Sound_resample_antiTurnAround = 1000;
+
+autoMAT Sound_computeAntiAliasingSpectra (Sound me) {
+	constexpr integer numberOfPaddingSides = 2;   // namely beginning and end
+	integer nfft = 1;
+	while (nfft < my nx + Sound_resample_antiTurnAround * numberOfPaddingSides) nfft *= 2;
+	autoMAT spectra = zero_MAT (my ny, nfft);
+	for (integer ichan = 1; ichan <= my ny; ichan ++) {
+		spectra.row (ichan).part (Sound_resample_antiTurnAround + 1, Sound_resample_antiTurnAround + my nx)  <<=  my z.row (ichan);
+		NUMrealft (spectra.row (ichan), 1);   // go to the frequency domain
+	}
+	return spectra;
+}
+
+static autoSound Sound_resample_ (Sound me, constMAT antiAliasingSpectra, double samplingFrequency, integer precision) {
 	double upfactor = samplingFrequency * my dx;
 	if (fabs (upfactor - 2.0) < 1e-6)
 		return Sound_upsample (me);
@@ -405,17 +561,17 @@ autoSound Sound_resample (Sound me, double samplingFrequency, integer precision)
 		autoSound filtered;
 		bool weNeedAnAntiAliasingFilter = ( upfactor < 1.0 );
 		if (weNeedAnAntiAliasingFilter) {
-			constexpr integer antiTurnAround = 1000;
-			constexpr integer numberOfPaddingSides = 2;   // namely beginning and end
-			integer nfft = 1;
-			while (nfft < my nx + antiTurnAround * numberOfPaddingSides) nfft *= 2;
-			autoVEC data = raw_VEC (nfft);   // will be zeroed in every turn of the loop
+			autoMAT ownSpectra;
+			if (antiAliasingSpectra.nrow == 0) {
+				ownSpectra = Sound_computeAntiAliasingSpectra (me);
+				antiAliasingSpectra = ownSpectra.get();
+			}
+			Melder_assert (antiAliasingSpectra.nrow == my ny);
+			const integer nfft = antiAliasingSpectra.ncol;
+			autoVEC data = raw_VEC (nfft);   // will be overwritten in every turn of the loop
 			filtered = Sound_create (my ny, my xmin, my xmax, my nx, my dx, my x1);
 			for (integer ichan = 1; ichan <= my ny; ichan ++) {
-				for (integer i = 1; i <= nfft; i ++)
-					data [i] = 0.0;
-				data.part (antiTurnAround + 1, antiTurnAround + my nx)  <<=  my z.row (ichan);
-				NUMrealft (data.get(), 1);   // go to the frequency domain
+				data.all()  <<=  antiAliasingSpectra.row (ichan);
 				for (integer i = Melder_ifloor (upfactor * nfft); i <= nfft; i ++)
 					data [i] = 0.0;   // filter away high frequencies
 				data [2] = 0.0;
@@ -423,12 +579,17 @@ autoSound Sound_resample (Sound me, double samplingFrequency, integer precision)
 				double factor = 1.0 / nfft;
 				VEC to = filtered -> z.row (ichan);
 				for (integer i = 1; i <= my nx; i ++)
-					to [i] = data [i + antiTurnAround] * factor;
+					to [i] = data [i + Sound_resample_antiTurnAround] * factor;
 			}
 			me = filtered.get();   // reference copy; remove at end
 		}
 		autoSound thee = Sound_create (my ny, my xmin, my xmax, numberOfSamples, 1.0 / samplingFrequency,
 				0.5 * (my xmin + my xmax - (numberOfSamples - 1) / samplingFrequency));
+		if (precision > NUM_VALUE_INTERPOLATE_CUBIC) {
+			const double firstIndex = Sampled_xToIndex (me, thy x1);
+			Sound_resample_sinc (my z.get(), thy z.get(), firstIndex, thy dx / my dx, precision);
+			return thee;
+		}
 		for (integer ichan = 1; ichan <= my ny; ichan ++) {
 			if (precision <= 1) {
 				for (integer i = 1; i <= numberOfSamples; i ++) {
@@ -453,6 +614,14 @@ autoSound Sound_resample (Sound me, double samplingFrequency, integer precision)
 	}
 }
 
+autoSound Sound_resample (Sound me, double samplingFrequency, integer precision) {
+	return Sound_resample_ (me, constMAT (), samplingFrequency, precision);
+}
+
+autoSound Sound_resample_fromSpectra (Sound me, constMAT const& antiAliasingSpectra, double samplingFrequency, integer precision) {
+	return Sound_resample_ (me, antiAliasingSpectra, samplingFrequency, precision);
+}
+
 autoSound Sounds_append (Sound me, double silenceDuration, Sound thee) {
 	try {
 		integer nx_silence = Melder_iround (silenceDuration / my dx), nx = my nx + nx_silence + thy nx;
@@ -76,6 +76,18 @@ autoSound Sound_create (integer numberOfChannels, double xmin, double xmax, inte
 		thy z [i] [1..nx] == 0.0;
 */
 
+autoSound Sound_createFromSamples (autoMAT samples, double xmin, double xmax, double dx, double x1);
+/*
+	Function:
+		return a new Sound that takes over `samples` (one row per channel) instead of allocating its own,
+		so that a caller can hand over samples (even borrowed ones; see newmatrixforeign) without copying them.
+	Preconditions:
+		samples.nrow >= 1;
+		samples.ncol >= 1;
+	Postconditions:
+		as for Sound_create, with thy z [i] [1..nx] == samples [i] [1..nx].
+*/
+
 autoSound Sound_createSimple (integer numberOfChannels, double duration, double samplingFrequency);
 /*
 	Function:
@@ -117,6 +129,14 @@ autoSound Sound_resample (Sound me, double samplingFrequency, integer precision)
 		precision >= 2: sinx/x interpolation with maximum depth equal to 'precision'.
 */
 
+autoMAT Sound_computeAntiAliasingSpectra (Sound me);
+autoSound Sound_resample_fromSpectra (Sound me, constMAT const& antiAliasingSpectra, double samplingFrequency, integer precision);
+/*
+	Sound_resample () low-passes a Sound in the frequency domain before it downsamples it.
+	The padded and Fourier-transformed channels (one row per channel) do not depend on the new sampling frequency,
+	so several downsamplings of the same Sound can share them; the result is identical to that of Sound_resample ().
+*/
+
 autoSound Sounds_append (Sound me, double silenceDuration, Sound thee);
 /*
 	Function:
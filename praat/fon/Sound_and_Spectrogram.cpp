@@ -18,17 +18,30 @@
 
 #include "Sound_and_Spectrogram.h"
 #include "NUM2.h"
+#include "MelderThread.h"
+#include <atomic>
+#include <vector>
 
 #include "enums_getText.h"
 #include "Sound_and_Spectrogram_enums.h"
 #include "enums_getValue.h"
 #include "Sound_and_Spectrogram_enums.h"
 
-autoSpectrogram Sound_to_Spectrogram (Sound me, double effectiveAnalysisWidth, double fmax,
+Thing_define (Sound_into_Spectrogram_Workspace, Thing) { public:
+	autoNUMfft_Table fftTable;
+	autoMAT data;
+	autoVEC spectrum;
+};
+
+Thing_implement (Sound_into_Spectrogram_Workspace, Thing, 0);
+
+autoSpectrogram Sound_to_Spectrogram_batched (Sound me, double effectiveAnalysisWidth, double fmax,
 	double minimumTimeStep1, double minimumFreqStep1, kSound_to_Spectrogram_windowShape windowType,
-	double maximumTimeOversampling, double maximumFreqOversampling)
+	double maximumTimeOversampling, double maximumFreqOversampling, integer numberOfFramesPerBatch)
 {
 	try {
+		Melder_require (numberOfFramesPerBatch >= 1,
+			U"The number of frames per batch should be at least 1.");
 		const double nyquist = 0.5 / my dx;
 		const double physicalAnalysisWidth =
 			( windowType == kSound_to_Spectrogram_windowShape::GAUSSIAN ? 2.0 * effectiveAnalysisWidth : effectiveAnalysisWidth );
@@ -118,75 +131,111 @@ autoSpectrogram Sound_to_Spectrogram (Sound me, double effectiveAnalysisWidth, d
 		}
 		const double oneByBinWidth = 1.0 / double (windowssq) / binWidth_samples;
 
-		autoVEC data = zero_VEC (nsampFFT);
-		autoVEC spectrum = zero_VEC (half_nsampFFT + 1);
-		autoNUMfft_Table fftTable;
-		NUMfft_Table_init (& fftTable, nsampFFT);
+		/*
+			Every thread gets its own FFT table (whose first half is scratch space) and frame buffers.
+			A thread windows a batch of frames (all channels) into the rows of its `data` matrix
+			and transforms them in one go.
+		*/
+		const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfTimes, 4 * numberOfFramesPerBatch);
+		std::vector <autoSound_into_Spectrogram_Workspace> workspaces (integer_to_uinteger (numberOfThreads));
+		for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
+			autoSound_into_Spectrogram_Workspace workspace = Thing_new (Sound_into_Spectrogram_Workspace);
+			NUMfft_Table_init (& workspace -> fftTable, nsampFFT);
+			workspace -> data = zero_MAT (numberOfFramesPerBatch * my ny, nsampFFT);
+			workspace -> spectrum = zero_VEC (half_nsampFFT + 1);
+			workspaces [ithread - 1] = std::move (workspace);
+		}
 
 		autoMelderProgress progress (U"Sound to Spectrogram...");
 
-		for (integer iframe = 1; iframe <= numberOfTimes; iframe ++) {
-			const double t = Sampled_indexToX (thee.get(), iframe);
-			const integer leftSample = Sampled_xToLowIndex (me, t), rightSample = leftSample + 1;
-			const integer startSample = rightSample - halfnsamp_window;
-			const integer endSample = leftSample + halfnsamp_window;
-			Melder_assert (startSample >= 1);
-			Melder_assert (endSample <= my nx);
-
-			spectrum.all()  <<=  0.0;
-			/*
-				For multichannel sounds, the power spectrogram should represent the
-				average power in the channels,
-				so that the result for a stereo sound in which the
-				left channel has the same waveform as the right channel,
-				is identical to the result for the corresponding mono (= averaged) sound.
-				Averaging starts by adding up the powers of the channels.
-			*/
-			for (integer channel = 1; channel <= my ny; channel ++) {
-				for (integer j = 1, i = startSample; j <= nsamp_window; j ++)
-					data [j] = my z [channel] [i ++] * window [j];
-				for (integer j = nsamp_window + 1; j <= nsampFFT; j ++)
-					data [j] = 0.0f;
-
-				Melder_progress (iframe / (numberOfTimes + 1.0),
-					U"Sound to Spectrogram: analysis of frame ", iframe, U" out of ", numberOfTimes);
-
-				/*
-					Compute the Fast Fourier Transform of the frame.
-				*/
-				NUMfft_forward (& fftTable, data.get());   // data := complex spectrum
-
-				/*
-					Convert from complex to power spectrum,
-					accumulating the power spectra of the channels.
-				*/
-				spectrum [1] += data [1] * data [1];   // DC component
-				for (integer i = 2; i <= half_nsampFFT; i ++)
-					spectrum [i] += data [i + i - 2] * data [i + i - 2] + data [i + i - 1] * data [i + i - 1];
-				spectrum [half_nsampFFT + 1] += data [nsampFFT] * data [nsampFFT];   // Nyquist frequency. Correct??
-			}
-			/*
-				Power averaging ends by dividing the summed power by the number of channels,
-			*/
-			if (my ny > 1 )
-				spectrum.all()  /=  my ny;
-
-			/*
-				Binning.
-			*/
-			for (integer iband = 1; iband <= numberOfFreqs; iband ++) {
-				const integer lowerSample = (iband - 1) * binWidth_samples + 1;
-				const integer higherSample = lowerSample + binWidth_samples;
-				const double power = NUMsum (spectrum.part (lowerSample, higherSample - 1));
-				thy z [iband] [iframe] = power * oneByBinWidth;
+		std::atomic <integer> numberOfFramesDone (0);
+		MelderThread_run (numberOfTimes, numberOfThreads, numberOfFramesPerBatch,
+			[&] (integer ithread, integer firstFrame, integer lastFrame) {
+				Sound_into_Spectrogram_Workspace workspace = workspaces [ithread - 1].get();
+				for (integer firstFrameOfBatch = firstFrame; firstFrameOfBatch <= lastFrame; firstFrameOfBatch += numberOfFramesPerBatch) {
+					const integer lastFrameOfBatch = std::min (firstFrameOfBatch + numberOfFramesPerBatch - 1, lastFrame);
+					const integer numberOfFramesInBatch = lastFrameOfBatch - firstFrameOfBatch + 1;
+					if (ithread == 1)
+						Melder_progress (numberOfFramesDone / (numberOfTimes + 1.0),
+							U"Sound to Spectrogram: analysis of frame ", firstFrameOfBatch, U" out of ", numberOfTimes);
+					for (integer iframe = firstFrameOfBatch; iframe <= lastFrameOfBatch; iframe ++) {
+						const double t = Sampled_indexToX (thee.get(), iframe);
+						const integer leftSample = Sampled_xToLowIndex (me, t), rightSample = leftSample + 1;
+						const integer startSample = rightSample - halfnsamp_window;
+						const integer endSample = leftSample + halfnsamp_window;
+						Melder_assert (startSample >= 1);
+						Melder_assert (endSample <= my nx);
+						for (integer channel = 1; channel <= my ny; channel ++) {
+							const VEC data = workspace -> data.row ((iframe - firstFrameOfBatch) * my ny + channel);
+							for (integer j = 1, i = startSample; j <= nsamp_window; j ++)
+								data [j] = my z [channel] [i ++] * window [j];
+							for (integer j = nsamp_window + 1; j <= nsampFFT; j ++)
+								data [j] = 0.0f;
+						}
+					}
+
+					/*
+						Compute the Fast Fourier Transforms of all the frames in the batch.
+					*/
+					NUMfft_forward (& workspace -> fftTable,
+							MAT (& workspace -> data [1] [1], numberOfFramesInBatch * my ny, nsampFFT));   // data := complex spectra
+
+					for (integer iframe = firstFrameOfBatch; iframe <= lastFrameOfBatch; iframe ++) {
+						const VEC spectrum = workspace -> spectrum.get();
+						spectrum  <<=  0.0;
+						/*
+							For multichannel sounds, the power spectrogram should represent the
+							average power in the channels,
+							so that the result for a stereo sound in which the
+							left channel has the same waveform as the right channel,
+							is identical to the result for the corresponding mono (= averaged) sound.
+							Averaging starts by adding up the powers of the channels.
+						*/
+						for (integer channel = 1; channel <= my ny; channel ++) {
+							const constVEC data = workspace -> data.row ((iframe - firstFrameOfBatch) * my ny + channel);
+							/*
+								Convert from complex to power spectrum,
+								accumulating the power spectra of the channels.
+							*/
+							spectrum [1] += data [1] * data [1];   // DC component
+							for (integer i = 2; i <= half_nsampFFT; i ++)
+								spectrum [i] += data [i + i - 2] * data [i + i - 2] + data [i + i - 1] * data [i + i - 1];
+							spectrum [half_nsampFFT + 1] += data [nsampFFT] * data [nsampFFT];   // Nyquist frequency. Correct??
+						}
+						/*
+							Power averaging ends by dividing the summed power by the number of channels,
+						*/
+						if (my ny > 1 )
+							spectrum  /=  my ny;
+
+						/*
+							Binning.
+						*/
+						for (integer iband = 1; iband <= numberOfFreqs; iband ++) {
+							const integer lowerSample = (iband - 1) * binWidth_samples + 1;
+							const integer higherSample = lowerSample + binWidth_samples;
+							const double power = NUMsum (spectrum.part (lowerSample, higherSample - 1));
+							thy z [iband] [iframe] = power * oneByBinWidth;
+						}
+					}
+					numberOfFramesDone += numberOfFramesInBatch;
+				}
 			}
-		}
+		);
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": spectrogram analysis not performed.");
 	}
 }
 
+autoSpectrogram Sound_to_Spectrogram (Sound me, double effectiveAnalysisWidth, double fmax,
+	double minimumTimeStep1, double minimumFreqStep1, kSound_to_Spectrogram_windowShape windowType,
+	double maximumTimeOversampling, double maximumFreqOversampling)
+{
+	return Sound_to_Spectrogram_batched (me, effectiveAnalysisWidth, fmax, minimumTimeStep1, minimumFreqStep1, windowType,
+			maximumTimeOversampling, maximumFreqOversampling, 8);
+}
+
 autoSound Spectrogram_to_Sound (Spectrogram me, double fsamp) {
 	try {
 		const double dt = 1.0 / fsamp;
@@ -27,6 +27,15 @@ autoSpectrogram Sound_to_Spectrogram (Sound me, double effectiveAnalysisWidth, d
 	double minimumTimeStep1, double minimumFreqStep1, kSound_to_Spectrogram_windowShape windowShape,
 	double maximumTimeOversampling, double maximumFreqOversampling);
 
+autoSpectrogram Sound_to_Spectrogram_batched (Sound me, double effectiveAnalysisWidth, double fmax,
+	double minimumTimeStep1, double minimumFreqStep1, kSound_to_Spectrogram_windowShape windowShape,
+	double maximumTimeOversampling, double maximumFreqOversampling, integer numberOfFramesPerBatch);
+/*
+	The frames are analysed in parallel; every thread transforms `numberOfFramesPerBatch` frames
+	with a single call to NUMfft_forward (). The result does not depend on the batch size;
+	Sound_to_Spectrogram () uses batches of 8 frames.
+*/
+
 autoSound Spectrogram_to_Sound (Spectrogram me, double fsamp);
 
 /* End of Sound_and_Spectrogram.h */
@@ -32,6 +32,8 @@
 #include "NUM2.h"
 #include "Polynomial.h"
 #include "Roots.h"
+#include "MelderThread.h"
+#include <atomic>
 
 static void burg (constVEC samples, VEC coefficients,
 	Formant_Frame frame, double nyquistFrequency, double safetyMargin)
@@ -293,6 +295,46 @@ void Formant_sort (Formant me) {
 	}
 }
 
+static void Sound_into_Formant_Frame (Sound me, Formant thee, integer iframe, integer halfnsamp_window, constVEC const& window,
+	VEC const& frameBuffer, VEC const& coefficients, int which, integer numberOfPoles, double safetyMargin)
+{
+	const double t = Sampled_indexToX (thee, iframe);
+	const integer leftSample = Sampled_xToLowIndex (me, t);
+	const integer rightSample = leftSample + 1;
+	integer startSample = rightSample - halfnsamp_window;
+	integer endSample = leftSample + halfnsamp_window;
+	double maximumIntensity = 0.0;
+	Melder_clipLeft (1_integer, & startSample);   // this should not be more than a rounding problem
+	Melder_clipRight (& endSample, my nx);   // this should not be more than a rounding problem
+	for (integer i = startSample; i <= endSample; i ++) {
+		const double value = Sampled_getValueAtSample (me, i, Sound_LEVEL_MONO, 0);
+		if (value * value > maximumIntensity)
+			maximumIntensity = value * value;
+	}
+	thy frames [iframe]. intensity = maximumIntensity;
+	if (maximumIntensity == 0.0)
+		return;   // Burg cannot stand all zeroes
+
+	/* Copy a pre-emphasized window to a frame. */
+	const integer actualFrameLength = endSample - startSample + 1;   // should rarely be less than nsamp_window
+	VEC frame = frameBuffer.part (1, actualFrameLength);
+	const integer offset = startSample - 1;
+	for (integer isamp = 1; isamp <= actualFrameLength; isamp ++)
+		frame [isamp] = Sampled_getValueAtSample (me, offset + isamp, Sound_LEVEL_MONO, 0) * window [isamp];
+
+	if (which == 1) {
+		burg (frame, coefficients, & thy frames [iframe], 0.5 / my dx, safetyMargin);
+	} else if (which == 2) {
+		if (! splitLevinson (frame, numberOfPoles, & thy frames [iframe], 0.5 / my dx)) {
+			Melder_clearError ();
+			Melder_casual (U"(Sound_to_Formant:)"
+				U" Analysis results of frame ", iframe,
+				U" will be wrong."
+			);
+		}
+	}
+}
+
 static autoFormant Sound_to_Formant_any_inplace (Sound me, double dt_in, integer numberOfPoles,
 	double halfdt_window, int which, double preemphasisFrequency, double safetyMargin)
 {
@@ -326,45 +368,36 @@ static autoFormant Sound_to_Formant_any_inplace (Sound me, double dt_in, integer
 	}
 
 	integer maximumFrameLength = nsamp_window;
-	auto frameBuffer = raw_VEC (maximumFrameLength);
-	auto coefficients = raw_VEC (numberOfPoles);   // superfluous if which==2, but nobody uses that anyway
-	for (integer iframe = 1; iframe <= nFrames; iframe ++) {
-		const double t = Sampled_indexToX (thee.get(), iframe);
-		const integer leftSample = Sampled_xToLowIndex (me, t);
-		const integer rightSample = leftSample + 1;
-		integer startSample = rightSample - halfnsamp_window;
-		integer endSample = leftSample + halfnsamp_window;
-		double maximumIntensity = 0.0;
-		Melder_clipLeft (1_integer, & startSample);   // this should not be more than a rounding problem
-		Melder_clipRight (& endSample, my nx);   // this should not be more than a rounding problem
-		for (integer i = startSample; i <= endSample; i ++) {
-			const double value = Sampled_getValueAtSample (me, i, Sound_LEVEL_MONO, 0);
-			if (value * value > maximumIntensity)
-				maximumIntensity = value * value;
-		}
-		thy frames [iframe]. intensity = maximumIntensity;
-		if (maximumIntensity == 0.0)
-			continue;   // Burg cannot stand all zeroes
-
-		/* Copy a pre-emphasized window to a frame. */
-		const integer actualFrameLength = endSample - startSample + 1;   // should rarely be less than nsamp_window
-		VEC frame = frameBuffer.part (1, actualFrameLength);
-		const integer offset = startSample - 1;
-		for (integer isamp = 1; isamp <= actualFrameLength; isamp ++)
-			frame [isamp] = Sampled_getValueAtSample (me, offset + isamp, Sound_LEVEL_MONO, 0) * window [isamp];
-
-		if (which == 1) {
-			burg (frame, coefficients.get(), & thy frames [iframe], 0.5 / my dx, safetyMargin);
-		} else if (which == 2) {
-			if (! splitLevinson (frame, numberOfPoles, & thy frames [iframe], 0.5 / my dx)) {
-				Melder_clearError ();
-				Melder_casual (U"(Sound_to_Formant:)"
-					U" Analysis results of frame ", iframe,
-					U" will be wrong."
-				);
+	if (which == 1) {
+		/*
+			The frames are independent, so we can analyse them in parallel;
+			every thread gets its own frame buffer and coefficients.
+		*/
+		const integer numberOfThreads = MelderThread_computeNumberOfThreads (nFrames, 20);
+		autoMAT frameBuffers = raw_MAT (numberOfThreads, maximumFrameLength);
+		autoMAT coefficientBuffers = raw_MAT (numberOfThreads, numberOfPoles);
+		std::atomic <integer> numberOfFramesDone (0);
+		MelderThread_run (nFrames, numberOfThreads, 5,
+			[&] (integer ithread, integer firstFrame, integer lastFrame) {
+				for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
+					Sound_into_Formant_Frame (me, thee.get(), iframe, halfnsamp_window, window.get(),
+						frameBuffers.row (ithread), coefficientBuffers.row (ithread), which, numberOfPoles, safetyMargin);
+					++ numberOfFramesDone;
+					if (ithread == 1)
+						Melder_progress ((double) numberOfFramesDone / (double) nFrames, U"Formant analysis: frame ", iframe);
+				}
 			}
+		);
+	} else {
+		/*
+			splitLevinson () reports its problems with Melder_casual (), so we stay in the calling thread.
+		*/
+		auto frameBuffer = raw_VEC (maximumFrameLength);
+		for (integer iframe = 1; iframe <= nFrames; iframe ++) {
+			Sound_into_Formant_Frame (me, thee.get(), iframe, halfnsamp_window, window.get(),
+				frameBuffer.get(), VEC (), which, numberOfPoles, safetyMargin);
+			Melder_progress ((double) iframe / (double) nFrames, U"Formant analysis: frame ", iframe);
 		}
-		Melder_progress ((double) iframe / (double) nFrames, U"Formant analysis: frame ", iframe);
 	}
 	Formant_sort (thee.get());
 	return thee;
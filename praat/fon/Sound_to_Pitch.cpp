@@ -35,13 +35,19 @@
 #include "Sound_to_Pitch.h"
 #include "NUM2.h"
 #include "MelderThread.h"
+#include <atomic>
+#include <vector>
 
 #define AC_HANNING  0
 #define AC_GAUSS  1
 #define FCC_NORMAL  2
 #define FCC_ACCURATE  3
 
-static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
+/*
+	The samples of `me` (a Sound or a LongSound) that a frame needs are in `z`:
+	column j of `z` holds sample `sampleOffset + j`.
+*/
+static void Sound_into_PitchFrame (Sampled me, constMAT const& z, integer sampleOffset, Pitch_Frame pitchFrame, double t,
 	double minimumPitch, int maxnCandidates, int method, double voicingThreshold, double octaveCost,
 	NUMfft_Table fftTable, double dt_window, integer nsamp_window, integer halfnsamp_window,
 	integer maximumLag, integer nsampFFT, integer nsamp_period, integer halfnsamp_period,
@@ -52,7 +58,7 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 	integer leftSample = Sampled_xToLowIndex (me, t), rightSample = leftSample + 1;
 	integer startSample, endSample;
 
-	for (integer channel = 1; channel <= my ny; channel ++) {
+	for (integer channel = 1; channel <= z.nrow; channel ++) {
 		/*
 			Compute the local mean; look one longest period to both sides.
 		*/
@@ -60,9 +66,10 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 		endSample = leftSample + nsamp_period;
 		Melder_assert (startSample >= 1);
 		Melder_assert (endSample <= my nx);
+		Melder_assert (startSample > sampleOffset && endSample <= sampleOffset + z.ncol);
 		localMean [channel] = 0.0;
 		for (integer i = startSample; i <= endSample; i ++)
-			localMean [channel] += my z [channel] [i];
+			localMean [channel] += z [channel] [i - sampleOffset];
 		localMean [channel] /= 2 * nsamp_period;
 
 		/*
@@ -73,14 +80,15 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 		endSample = leftSample + halfnsamp_window;
 		Melder_assert (startSample >= 1);
 		Melder_assert (endSample <= my nx);
+		Melder_assert (startSample > sampleOffset && endSample <= sampleOffset + z.ncol);
 		if (method < FCC_NORMAL) {
-			for (integer j = 1, i = startSample; j <= nsamp_window; j ++)
-				frame [channel] [j] = (my z [channel] [i ++] - localMean [channel]) * window [j];
+			for (integer j = 1, i = startSample - sampleOffset; j <= nsamp_window; j ++)
+				frame [channel] [j] = (z [channel] [i ++] - localMean [channel]) * window [j];
 			for (integer j = nsamp_window + 1; j <= nsampFFT; j ++)
 				frame [channel] [j] = 0.0;
 		} else {
-			for (integer j = 1, i = startSample; j <= nsamp_window; j ++)
-				frame [channel] [j] = my z [channel] [i ++] - localMean [channel];
+			for (integer j = 1, i = startSample - sampleOffset; j <= nsamp_window; j ++)
+				frame [channel] [j] = z [channel] [i ++] - localMean [channel];
 		}
 	}
 
@@ -92,7 +100,7 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 		startSample = 1;
 	if ((endSample = halfnsamp_window + halfnsamp_period) > nsamp_window)
 		endSample = nsamp_window;
-	for (integer channel = 1; channel <= my ny; channel ++) {
+	for (integer channel = 1; channel <= z.nrow; channel ++) {
 		for (integer j = startSample; j <= endSample; j ++) {
 			double value = fabs (frame [channel] [j]);
 			if (value > localPeak)
@@ -113,9 +121,10 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 			localSpan = my nx + 1 - startSample;
 		localMaximumLag = localSpan - nsamp_window;
 		offset = startSample - 1;
+		Melder_assert (offset >= sampleOffset && offset + localSpan <= sampleOffset + z.ncol);
 		longdouble sumx2 = 0.0;   // sum of squares
-		for (integer channel = 1; channel <= my ny; channel ++) {
-			double *amp = & my z [channel] [0] + offset;
+		for (integer channel = 1; channel <= z.nrow; channel ++) {
+			const double *amp = & z [channel] [0] + (offset - sampleOffset);
 			for (integer i = 1; i <= nsamp_window; i ++) {
 				const double x = amp [i] - localMean [channel];
 				sumx2 += x * x;
@@ -125,8 +134,8 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 		r [0] = 1.0;
 		for (integer i = 1; i <= localMaximumLag; i ++) {
 			longdouble product = 0.0;
-			for (integer channel = 1; channel <= my ny; channel ++) {
-				double *amp = & my z [channel] [0] + offset;
+			for (integer channel = 1; channel <= z.nrow; channel ++) {
+				const double *amp = & z [channel] [0] + (offset - sampleOffset);
 				double y0 = amp [i] - localMean [channel];
 				double yZ = amp [i + nsamp_window] - localMean [channel];
 				sumy2 += yZ * yZ - y0 * y0;
@@ -145,7 +154,7 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 		*/
 		for (integer i = 1; i <= nsampFFT; i ++)
 			ac [i] = 0.0;
-		for (integer channel = 1; channel <= my ny; channel ++) {
+		for (integer channel = 1; channel <= z.nrow; channel ++) {
 			NUMfft_forward (fftTable, VEC (& frame [channel] [1], fftTable->n));   // complex spectrum
 			ac [1] += frame [channel] [1] * frame [channel] [1];   // DC component
 			for (integer i = 2; i < nsampFFT; i += 2)
@@ -259,17 +268,17 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 }
 
 Thing_define (Sound_into_Pitch_Args, Thing) { public:
-	Sound sound;
+	Sampled sound;   // a Sound or a LongSound
+	constMAT samples;   // the samples of the current block
+	integer sampleOffset;
 	Pitch pitch;
-	integer firstFrame, lastFrame;
 	double minimumPitch;
 	int maxnCandidates, method;
 	double voicingThreshold, octaveCost, dt_window;
 	integer nsamp_window, halfnsamp_window, maximumLag, nsampFFT, nsamp_period, halfnsamp_period, brent_ixmax, brent_depth;
 	double globalPeak;
 	VEC window, windowR;
-	bool isMainThread;
-	volatile int *cancelled;
+	std::atomic <integer> *numberOfFramesDone;
 	autoNUMfft_Table fftTable;
 	autoMAT frame;
 	autoVEC ac, rbuffer, localMean;
@@ -279,23 +288,15 @@ Thing_define (Sound_into_Pitch_Args, Thing) { public:
 
 Thing_implement (Sound_into_Pitch_Args, Thing, 0);
 
-static void Sound_into_Pitch (Sound_into_Pitch_Args me)
+static void Sound_into_Pitch (Sound_into_Pitch_Args me, integer firstFrame, integer lastFrame, bool isMainThread)
 {
-	for (integer iframe = my firstFrame; iframe <= my lastFrame; iframe ++) {
+	for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
 		const Pitch_Frame pitchFrame = & my pitch -> frames [iframe];
 		const double t = Sampled_indexToX (my pitch, iframe);
-		if (my isMainThread) {
-			try {
-				Melder_progress (0.1 + 0.8 * (iframe - my firstFrame) / (my lastFrame - my firstFrame),
-					U"Sound to Pitch: analysing ", my lastFrame, U" frames");
-			} catch (MelderError) {
-				*my cancelled = 1;
-				throw;
-			}
-		} else if (*my cancelled) {
-			return;
-		}
-		Sound_into_PitchFrame (my sound, pitchFrame, t,
+		if (isMainThread)
+			Melder_progress (0.1 + 0.8 * *my numberOfFramesDone / my pitch -> nx,
+				U"Sound to Pitch: analysing ", my pitch -> nx, U" frames");
+		Sound_into_PitchFrame (my sound, my samples, my sampleOffset, pitchFrame, t,
 			my minimumPitch, my maxnCandidates, my method, my voicingThreshold, my octaveCost,
 			& my fftTable, my dt_window, my nsamp_window, my halfnsamp_window,
 			my maximumLag, my nsampFFT, my nsamp_period, my halfnsamp_period,
@@ -303,16 +304,60 @@ static void Sound_into_Pitch (Sound_into_Pitch_Args me)
 			my frame.get(), my ac.get(), my window, my windowR,
 			my r, my imax.get(), my localMean.get()
 		);
+		++ *my numberOfFramesDone;
 	}
 }
 
-autoPitch Sound_to_Pitch_any (Sound me,
+/*
+	The global absolute peak of a LongSound, as Sampled_to_Pitch_any computes it for a Sound,
+	but in a single pass through the file: the largest deviation from the mean
+	is the deviation of either the maximum or the minimum.
+	For integer sample formats the long double sum is exact, so the result equals that of the in-memory path.
+*/
+static double LongSound_getGlobalPeak (LongSound me) {
+	const integer numberOfSamplesPerBlock = Melder_clippedRight (Melder_iceiling (my bufferLength / my dx), my nx);
+	autovector <longdouble> sum = newvectorzero <longdouble> (my numberOfChannels);
+	autoVEC minimum = zero_VEC (my numberOfChannels), maximum = zero_VEC (my numberOfChannels);
+	for (integer firstSample = 1; firstSample <= my nx; firstSample += numberOfSamplesPerBlock) {
+		const integer numberOfSamples = std::min (numberOfSamplesPerBlock, my nx - firstSample + 1);
+		autoMAT part = raw_MAT (my numberOfChannels, numberOfSamples);
+		LongSound_readAudioToFloat (me, part.get(), firstSample);
+		for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++) {
+			if (firstSample == 1)
+				minimum [ichan] = maximum [ichan] = part [ichan] [1];
+			for (integer i = 1; i <= numberOfSamples; i ++) {
+				const double value = part [ichan] [i];
+				sum [ichan] += value;
+				if (value < minimum [ichan])
+					minimum [ichan] = value;
+				if (value > maximum [ichan])
+					maximum [ichan] = value;
+			}
+		}
+	}
+	double globalPeak = 0.0;
+	for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++) {
+		const double mean = double (sum [ichan] / my nx);
+		globalPeak = std::max ({ globalPeak, fabs (maximum [ichan] - mean), fabs (minimum [ichan] - mean) });
+	}
+	return globalPeak;
+}
+
+/*
+	`me` is a Sound, whose samples are all in memory, or a LongSound,
+	whose samples are read in blocks of about the LongSound's buffer length;
+	consecutive blocks overlap by the duration of an analysis window, so every frame sees the same samples as in memory.
+*/
+static autoPitch Sampled_to_Pitch_any (Sampled me,
 	double dt, double minimumPitch, double periodsPerWindow, integer maxnCandidates,
 	int method,
 	double silenceThreshold, double voicingThreshold,
 	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost, double ceiling)
 {
 	try {
+		const Sound sound = ( Thing_isa (me, classSound) ? static_cast <Sound> (me) : nullptr );
+		const LongSound longSound = ( sound ? nullptr : static_cast <LongSound> (me) );
+		const integer numberOfChannels = ( sound ? sound -> ny : longSound -> numberOfChannels );
 		autoNUMfft_Table fftTable;
 		double t1;
 		integer numberOfFrames;
@@ -407,14 +452,18 @@ autoPitch Sound_to_Pitch_any (Sound me,
 		/*
 			Compute the global absolute peak for determination of silence threshold.
 		*/
-		globalPeak = 0.0;
-		for (integer ichan = 1; ichan <= my ny; ichan ++) {
-			const double mean = NUMmean (my z.row (ichan));
-			for (integer i = 1; i <= my nx; i ++) {
-				double value = fabs (my z [ichan] [i] - mean);
-				if (value > globalPeak)
-					globalPeak = value;
+		if (sound) {
+			globalPeak = 0.0;
+			for (integer ichan = 1; ichan <= sound -> ny; ichan ++) {
+				const double mean = NUMmean (sound -> z.row (ichan));
+				for (integer i = 1; i <= sound -> nx; i ++) {
+					double value = fabs (sound -> z [ichan] [i] - mean);
+					if (value > globalPeak)
+						globalPeak = value;
+				}
 			}
+		} else {
+			globalPeak = LongSound_getGlobalPeak (longSound);
 		}
 		if (globalPeak == 0.0)
 			return thee;
@@ -481,25 +530,26 @@ autoPitch Sound_to_Pitch_any (Sound me,
 
 		autoMelderProgress progress (U"Sound to Pitch...");
 
-		integer numberOfFramesPerThread = 20;
-		integer numberOfThreads = (numberOfFrames - 1) / numberOfFramesPerThread + 1;
-		const integer numberOfProcessors = MelderThread_getNumberOfProcessors ();
-		trace (numberOfProcessors, U" processors");
-		Melder_clipRight (& numberOfThreads, numberOfProcessors);
-		Melder_clip (1_integer, & numberOfThreads, 16_integer);
-		numberOfFramesPerThread = (numberOfFrames - 1) / numberOfThreads + 1;
-
-		autoSound_into_Pitch_Args args [16];
-		integer firstFrame = 1, lastFrame = numberOfFramesPerThread;
-		volatile int cancelled = 0;
-		for (int ithread = 1; ithread <= numberOfThreads; ithread ++) {
-			if (ithread == numberOfThreads)
-				lastFrame = numberOfFrames;
+		/*
+			The samples that a frame can look at lie within `reach` samples of the frame centre.
+		*/
+		const integer reach = nsamp_period + nsamp_window + maximumLag + 2;
+		const integer numberOfFramesPerBlock = ( sound ? numberOfFrames :
+				Melder_clipped (1_integer, Melder_ifloor (longSound -> bufferLength / dt), numberOfFrames) );
+
+		/*
+			Every thread gets at least 20 frames, which it analyses in chunks of 5;
+			threads that are done early steal frames from the others.
+		*/
+		const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfFramesPerBlock, 20);
+		trace (MelderThread_getNumberOfProcessors (), U" processors, ", numberOfThreads, U" threads");
+
+		std::vector <autoSound_into_Pitch_Args> args (integer_to_uinteger (numberOfThreads));
+		std::atomic <integer> numberOfFramesDone (0);
+		for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
 			autoSound_into_Pitch_Args arg = Thing_new (Sound_into_Pitch_Args);
 			arg -> sound = me;
 			arg -> pitch = thee.get();
-			arg -> firstFrame = firstFrame;
-			arg -> lastFrame = lastFrame;
 			arg -> minimumPitch = minimumPitch;
 			arg -> maxnCandidates = maxnCandidates;
 			arg -> method = method;
@@ -517,24 +567,49 @@ autoPitch Sound_to_Pitch_any (Sound me,
 			arg -> globalPeak = globalPeak;
 			arg -> window = window.get();
 			arg -> windowR = windowR.get();
-			arg -> isMainThread = ( ithread == numberOfThreads );
-			arg -> cancelled = & cancelled;
+			arg -> numberOfFramesDone = & numberOfFramesDone;
 			if (method >= FCC_NORMAL) {   // cross-correlation
-				arg -> frame = zero_MAT (my ny, nsamp_window);
+				arg -> frame = zero_MAT (numberOfChannels, nsamp_window);
 			} else {   // autocorrelation
 				NUMfft_Table_init (& arg -> fftTable, nsampFFT);
-				arg -> frame = zero_MAT (my ny, nsampFFT);
+				arg -> frame = zero_MAT (numberOfChannels, nsampFFT);
 				arg -> ac = zero_VEC (nsampFFT);
 			}
 			arg -> rbuffer = zero_VEC (2 * nsamp_window + 1);
 			arg -> r = & arg -> rbuffer [1 + nsamp_window];
 			arg -> imax = zero_INTVEC (maxnCandidates);
-			arg -> localMean = zero_VEC (my ny);
+			arg -> localMean = zero_VEC (numberOfChannels);
 			args [ithread - 1] = std::move (arg);
-			firstFrame = lastFrame + 1;
-			lastFrame += numberOfFramesPerThread;
 		}
-		MelderThread_run (Sound_into_Pitch, args, numberOfThreads);
+		for (integer firstFrameOfBlock = 1; firstFrameOfBlock <= numberOfFrames; firstFrameOfBlock += numberOfFramesPerBlock) {
+			const integer lastFrameOfBlock = std::min (firstFrameOfBlock + numberOfFramesPerBlock - 1, numberOfFrames);
+			autoMAT block;
+			constMAT samples;
+			integer sampleOffset;
+			if (sound) {
+				samples = sound -> z.get();
+				sampleOffset = 0;
+			} else {
+				const integer firstSample = std::max (1_integer,
+						Sampled_xToLowIndex (me, Sampled_indexToX (thee.get(), firstFrameOfBlock)) - reach);
+				const integer lastSample = std::min (my nx,
+						Sampled_xToLowIndex (me, Sampled_indexToX (thee.get(), lastFrameOfBlock)) + 1 + reach);
+				block = raw_MAT (numberOfChannels, lastSample - firstSample + 1);
+				LongSound_readAudioToFloat (longSound, block.get(), firstSample);
+				samples = block.get();
+				sampleOffset = firstSample - 1;
+			}
+			for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
+				args [ithread - 1] -> samples = samples;
+				args [ithread - 1] -> sampleOffset = sampleOffset;
+			}
+			MelderThread_run (lastFrameOfBlock - firstFrameOfBlock + 1, numberOfThreads, 5,
+				[& args, firstFrameOfBlock] (integer ithread, integer firstFrame, integer lastFrame) {
+					Sound_into_Pitch (args [ithread - 1].get(),
+							firstFrameOfBlock - 1 + firstFrame, firstFrameOfBlock - 1 + lastFrame, ithread == 1);
+				}
+			);
+		}
 
 		Melder_progress (0.95, U"Sound to Pitch: path finder");
 		Pitch_pathFinder (thee.get(), silenceThreshold, voicingThreshold,
@@ -546,6 +621,26 @@ autoPitch Sound_to_Pitch_any (Sound me,
 	}
 }
 
+autoPitch Sound_to_Pitch_any (Sound me,
+	double dt, double minimumPitch, double periodsPerWindow, integer maxnCandidates,
+	int method,
+	double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost, double ceiling)
+{
+	return Sampled_to_Pitch_any (me, dt, minimumPitch, periodsPerWindow, maxnCandidates, method,
+		silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, ceiling);
+}
+
+autoPitch LongSound_to_Pitch_any (LongSound me,
+	double dt, double minimumPitch, double periodsPerWindow, integer maxnCandidates,
+	int method,
+	double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost, double ceiling)
+{
+	return Sampled_to_Pitch_any (me, dt, minimumPitch, periodsPerWindow, maxnCandidates, method,
+		silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, ceiling);
+}
+
 autoPitch Sound_to_Pitch (Sound me, double timeStep, double minimumPitch, double maximumPitch) {
 	return Sound_to_Pitch_ac (me, timeStep, minimumPitch,
 		3.0, 15, false, 0.03, 0.45, 0.01, 0.35, 0.14, maximumPitch);
@@ -569,4 +664,27 @@ autoPitch Sound_to_Pitch_cc (Sound me,
 		silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, ceiling);
 }
 
+autoPitch LongSound_to_Pitch (LongSound me, double timeStep, double minimumPitch, double maximumPitch) {
+	return LongSound_to_Pitch_ac (me, timeStep, minimumPitch,
+		3.0, 15, false, 0.03, 0.45, 0.01, 0.35, 0.14, maximumPitch);
+}
+
+autoPitch LongSound_to_Pitch_ac (LongSound me,
+	double dt, double minimumPitch, double periodsPerWindow, integer maxnCandidates, int accurate,
+	double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost, double ceiling)
+{
+	return LongSound_to_Pitch_any (me, dt, minimumPitch, periodsPerWindow, maxnCandidates, accurate,
+		silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, ceiling);
+}
+
+autoPitch LongSound_to_Pitch_cc (LongSound me,
+	double dt, double minimumPitch, double periodsPerWindow, integer maxnCandidates, int accurate,
+	double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost, double ceiling)
+{
+	return LongSound_to_Pitch_any (me, dt, minimumPitch, periodsPerWindow, maxnCandidates, 2 + accurate,
+		silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, ceiling);
+}
+
 /* End of file Sound_to_Pitch.cpp */
@@ -16,7 +16,7 @@
  * along with this work. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "Sound.h"
+#include "LongSound.h"
 #include "Pitch.h"
 
 autoPitch Sound_to_Pitch (Sound me, double timeStep,
@@ -84,4 +84,28 @@ autoPitch Sound_to_Pitch_any (Sound me,
 		pitches above a certain value "voiceless".
 */
 
+autoPitch LongSound_to_Pitch (LongSound me, double timeStep,
+	double minimumPitch, double maximumPitch);
+
+autoPitch LongSound_to_Pitch_ac (LongSound me, double timeStep, double minimumPitch,
+	double periodsPerWindow, integer maxnCandidates, int accurate,
+	double silenceThreshold, double voicingThreshold, double octaveCost,
+	double octaveJumpCost, double voicedUnvoicedCost, double maximumPitch);
+
+autoPitch LongSound_to_Pitch_cc (LongSound me, double timeStep, double minimumPitch,
+	double periodsPerWindow, integer maxnCandidates, int accurate,
+	double silenceThreshold, double voicingThreshold, double octaveCost,
+	double octaveJumpCost, double voicedUnvoicedCost, double maximumPitch);
+
+autoPitch LongSound_to_Pitch_any (LongSound me,
+	double dt, double minimumPitch, double periodsPerWindow, integer maxnCandidates, int method,
+	double silenceThreshold, double voicingThreshold, double octaveCost,
+	double octaveJumpCost, double voicedUnvoicedCost, double maximumPitch);
+/*
+	As Sound_to_Pitch_any, but without reading the whole file into memory:
+	the candidates are computed block by block (each block about as long as the LongSound's buffer),
+	after which the path finder runs over the whole Pitch.
+	The result is identical to that of Sound_to_Pitch_any on the Sound that the file contains.
+*/
+
 /* End of file Sound_to_Pitch.h */
@@ -27,10 +27,6 @@
 #include "TextGrid_def.h"
 #include "oo_CAN_WRITE_AS_ENCODING.h"
 #include "TextGrid_def.h"
-#include "oo_WRITE_TEXT.h"
-#include "TextGrid_def.h"
-#include "oo_READ_TEXT.h"
-#include "TextGrid_def.h"
 #include "oo_WRITE_BINARY.h"
 #include "TextGrid_def.h"
 #include "oo_READ_BINARY.h"
@@ -42,6 +38,28 @@
 
 Thing_implement (TextPoint, AnyPoint, 0);
 
+/*
+	The text I/O methods of the five classes in TextGrid_def.h are written out by hand,
+	so that the tiers can treat their items in a single loop rather than one virtual call per item.
+	The layout of the files is exactly the one that oo_WRITE_TEXT.h and oo_READ_TEXT.h would give.
+*/
+
+void structTextPoint :: v_writeText (MelderFile file) {
+	TextPoint_Parent :: v_writeText (file);
+	texputw16 (file, our mark.get(), U"mark");
+}
+
+void structTextPoint :: v_readText (MelderReadText text, int formatVersion) {
+	Melder_require (formatVersion <= our classInfo -> version,
+		U"The format of this file is too new. Download a newer version of Praat.");
+	TextPoint_Parent :: v_readText (text, formatVersion);
+	try {
+		our mark = texgetw16 (text);
+	} catch (MelderError) {
+		Melder_throw (U"String \"mark\" not read.");
+	}
+}
+
 autoTextPoint TextPoint_create (double time, conststring32 mark) {
 	try {
 		autoTextPoint me = Thing_new (TextPoint);
@@ -63,6 +81,22 @@ void TextPoint_setText (TextPoint me, conststring32 text) {
 
 Thing_implement (TextInterval, Function, 0);
 
+void structTextInterval :: v_writeText (MelderFile file) {
+	TextInterval_Parent :: v_writeText (file);
+	texputw16 (file, our text.get(), U"text");
+}
+
+void structTextInterval :: v_readText (MelderReadText text, int formatVersion) {
+	Melder_require (formatVersion <= our classInfo -> version,
+		U"The format of this file is too new. Download a newer version of Praat.");
+	TextInterval_Parent :: v_readText (text, formatVersion);
+	try {
+		our text = texgetw16 (text);
+	} catch (MelderError) {
+		Melder_throw (U"String \"text\" not read.");
+	}
+}
+
 autoTextInterval TextInterval_create (double tmin, double tmax, conststring32 text) {
 	try {
 		autoTextInterval me = Thing_new (TextInterval);
@@ -85,6 +119,105 @@ void TextInterval_setText (TextInterval me, conststring32 text) {
 
 Thing_implement (TextTier, AnyTier, 0);
 
+/*
+	A tier from a forced alignment can have hundreds of thousands of items.
+	Instead of sending every number and every label through its own series of MelderFile_write calls,
+	as texputr64 () and texputw16 () do, the tiers format their items into a buffer
+	and hand that to the file in chunks of a few thousand characters.
+	The functions below mimic texputintro (), texputr64 () and texputw16 () character for character.
+*/
+static void tierBuffer_appendIndent (MelderString *me, MelderFile file) {
+	static const char32 spaces [] = U"                                ";
+	constexpr integer maximumIndent = integer (sizeof (spaces) / sizeof (char32)) - 1;
+	if (file -> indent <= maximumIndent)
+		MelderString_append (me, & spaces [maximumIndent - file -> indent]);
+	else
+		for (integer ispace = 1; ispace <= file -> indent; ispace ++)
+			MelderString_appendCharacter (me, U' ');
+}
+
+static void tierBuffer_appendIntro (MelderString *me, MelderFile file, conststring32 name, integer index) {
+	if (file -> verbose) {
+		MelderString_appendCharacter (me, U'\n');
+		tierBuffer_appendIndent (me, file);
+		MelderString_append (me, name, U" [", index, U"]:");
+	}
+	texindent (file);
+}
+
+static void tierBuffer_appendNumber (MelderString *me, MelderFile file, conststring32 name, double value) {
+	MelderString_appendCharacter (me, U'\n');
+	if (file -> verbose) {
+		tierBuffer_appendIndent (me, file);
+		MelderString_append (me, name, U" = ", value, U" ");
+	} else
+		MelderString_append (me, value);
+}
+
+static void tierBuffer_appendString (MelderString *me, MelderFile file, conststring32 name, conststring32 string) {
+	MelderString_appendCharacter (me, U'\n');
+	if (file -> verbose) {
+		tierBuffer_appendIndent (me, file);
+		MelderString_append (me, name, U" = ");
+	}
+	MelderString_appendCharacter (me, U'\"');
+	if (string && ! str32chr (string, U'\"')) {
+		MelderString_append (me, string);
+	} else if (string) {
+		for (const char32 *p = string; *p != U'\0'; p ++) {
+			MelderString_appendCharacter (me, *p);
+			if (*p == U'\"')
+				MelderString_appendCharacter (me, U'\"');   // double any internal quotes
+		}
+	}
+	MelderString_append (me, file -> verbose ? U"\" " : U"\"");
+}
+
+static void tierBuffer_flush (MelderString *me, MelderFile file, integer minimumLength) {
+	if (my length >= minimumLength && my length > 0) {
+		MelderFile_write (file, my string);
+		MelderString_empty (me);
+	}
+}
+
+constexpr integer tierBuffer_CHUNK_LENGTH = 2000;   // characters; small enough for MelderString_empty () to keep the buffer
+
+void structTextTier :: v_writeText (MelderFile file) {
+	TextTier_Parent :: v_writeText (file);
+	texputinteger (file, our points.size, U"points: size");
+	autoMelderString buffer;
+	for (integer ipoint = 1; ipoint <= our points.size; ipoint ++) {
+		const TextPoint point = our points.at [ipoint];
+		tierBuffer_appendIntro (& buffer, file, U"points", ipoint);
+		tierBuffer_appendNumber (& buffer, file, U"number", point -> number);
+		tierBuffer_appendString (& buffer, file, U"mark", point -> mark.get());
+		texexdent (file);
+		tierBuffer_flush (& buffer, file, tierBuffer_CHUNK_LENGTH);
+	}
+	tierBuffer_flush (& buffer, file, 0);
+}
+
+void structTextTier :: v_readText (MelderReadText text, int formatVersion) {
+	Melder_require (formatVersion <= our classInfo -> version,
+		U"The format of this file is too new. Download a newer version of Praat.");
+	TextTier_Parent :: v_readText (text, formatVersion);
+	const integer numberOfPoints = texgetinteger (text);
+	for (integer ipoint = 1; ipoint <= numberOfPoints; ipoint ++) {
+		autoTextPoint point = Thing_new (TextPoint);
+		try {
+			point -> number = texgetr64 (text);
+		} catch (MelderError) {
+			Melder_throw (U"\"number\" not read.");
+		}
+		try {
+			point -> mark = texgetw16 (text);
+		} catch (MelderError) {
+			Melder_throw (U"String \"mark\" not read.");
+		}
+		our points. addItem_move (point.move());   // at the end if the times increase, as they do in a file we wrote
+	}
+}
+
 autoTextTier TextTier_create (double tmin, double tmax) {
 	try {
 		autoTextTier me = Thing_new (TextTier);
@@ -107,6 +240,50 @@ void TextTier_addPoint (TextTier me, double time, conststring32 mark) {
 
 Thing_implement (IntervalTier, Function, 0);
 
+void structIntervalTier :: v_writeText (MelderFile file) {
+	IntervalTier_Parent :: v_writeText (file);
+	texputinteger (file, our intervals.size, U"intervals: size");
+	autoMelderString buffer;
+	for (integer iinterval = 1; iinterval <= our intervals.size; iinterval ++) {
+		const TextInterval interval = our intervals.at [iinterval];
+		tierBuffer_appendIntro (& buffer, file, U"intervals", iinterval);
+		tierBuffer_appendNumber (& buffer, file, U"xmin", interval -> xmin);
+		tierBuffer_appendNumber (& buffer, file, U"xmax", interval -> xmax);
+		tierBuffer_appendString (& buffer, file, U"text", interval -> text.get());
+		texexdent (file);
+		tierBuffer_flush (& buffer, file, tierBuffer_CHUNK_LENGTH);
+	}
+	tierBuffer_flush (& buffer, file, 0);
+}
+
+void structIntervalTier :: v_readText (MelderReadText text, int formatVersion) {
+	Melder_require (formatVersion <= our classInfo -> version,
+		U"The format of this file is too new. Download a newer version of Praat.");
+	IntervalTier_Parent :: v_readText (text, formatVersion);
+	const integer numberOfIntervals = texgetinteger (text);
+	for (integer iinterval = 1; iinterval <= numberOfIntervals; iinterval ++) {
+		autoTextInterval interval = Thing_new (TextInterval);
+		try {
+			interval -> xmin = texgetr64 (text);
+		} catch (MelderError) {
+			Melder_throw (U"\"xmin\" not read.");
+		}
+		try {
+			interval -> xmax = texgetr64 (text);
+		} catch (MelderError) {
+			Melder_throw (U"\"xmax\" not read.");
+		}
+		if (interval -> xmin > interval -> xmax)
+			Melder_throw (U"Wrong xmin ", interval -> xmin, U" and xmax ", interval -> xmax, U".");
+		try {
+			interval -> text = texgetw16 (text);
+		} catch (MelderError) {
+			Melder_throw (U"String \"text\" not read.");
+		}
+		our intervals. addItem_move (interval.move());   // at the end if the times increase, as they do in a file we wrote
+	}
+}
+
 void structIntervalTier :: v_shiftX (double xfrom, double xto) {
 	IntervalTier_Parent :: v_shiftX (xfrom, xto);
 	for (integer i = 1; i <= our intervals.size; i ++) {
@@ -297,6 +474,23 @@ Thing_implement (FunctionList, Ordered, 0);
 
 Thing_implement (TextGrid, Function, 0);
 
+void structTextGrid :: v_writeText (MelderFile file) {
+	TextGrid_Parent :: v_writeText (file);
+	texputex (file, !! our tiers, U"tiers");
+	if (our tiers)
+		Data_writeText (our tiers.get(), file);
+}
+
+void structTextGrid :: v_readText (MelderReadText text, int formatVersion) {
+	Melder_require (formatVersion <= our classInfo -> version,
+		U"The format of this file is too new. Download a newer version of Praat.");
+	TextGrid_Parent :: v_readText (text, formatVersion);
+	if (texgetex (text)) {
+		our tiers = Thing_new (FunctionList);
+		our tiers -> v_readText (text, 0);
+	}
+}
+
 autoTextGrid TextGrid_createWithoutTiers (double tmin, double tmax) {
 	try {
 		autoTextGrid me = Thing_new (TextGrid);
@@ -460,9 +460,17 @@ void TimeSoundEditor_drawSound (TimeSoundEditor me, double globalMinimum, double
 	const integer numberOfChannels = ( sound ? sound -> ny : longSound -> numberOfChannels );
 	const bool cursorVisible = ( my startSelection == my endSelection && my startSelection >= my startWindow && my startSelection <= my endWindow );
 	Graphics_setColour (my graphics.get(), Melder_BLACK);
-	bool fits;
+	/*
+		When zoomed out far on a LongSound, draw the minimum and maximum per pixel from its envelope,
+		so that we do not have to read all the samples in the window.
+	*/
+	Graphics_setWindow (my graphics.get(), my startWindow, my endWindow, 0.0, 1.0);
+	const integer numberOfPixels = Melder_clippedLeft (1_integer,
+			Melder_iroundUp (Graphics_dxWCtoMM (my graphics.get(), my endWindow - my startWindow) * Graphics_getResolution (my graphics.get()) / 25.4));
+	bool drawEnvelope = false, fits;
 	try {
-		fits = ( sound ? true : LongSound_haveWindow (longSound, my startWindow, my endWindow) );
+		drawEnvelope = ( longSound && LongSound_shouldDrawEnvelope (longSound, my startWindow, my endWindow, numberOfPixels) );
+		fits = ( sound || drawEnvelope ? true : LongSound_haveWindow (longSound, my startWindow, my endWindow) );
 	} catch (MelderError) {
 		bool outOfMemory = !! str32str (Melder_getError (), U"memory");
 		if (Melder_debug == 9) Melder_flushError (); else Melder_clearError ();
@@ -471,6 +479,17 @@ void TimeSoundEditor_drawSound (TimeSoundEditor me, double globalMinimum, double
 		Graphics_text (my graphics.get(), 0.5, 0.5, outOfMemory ? U"(out of memory)" : U"(cannot read sound file)");
 		return;
 	}
+	if (drawEnvelope) {
+		/*
+			The first time, this reads the whole file; the user can interrupt that.
+		*/
+		try {
+			LongSound_prepareEnvelope (longSound);
+		} catch (MelderError) {
+			Melder_clearError ();
+			fits = false;
+		}
+	}
 	if (! fits) {
 		Graphics_setWindow (my graphics.get(), 0.0, 1.0, 0.0, 1.0);
 		Graphics_setTextAlignment (my graphics.get(), Graphics_CENTRE, Graphics_HALF);
@@ -490,13 +509,13 @@ void TimeSoundEditor_drawSound (TimeSoundEditor me, double globalMinimum, double
 	double maximumExtent = 0.0, visibleMinimum = 0.0, visibleMaximum = 0.0;
 	if (my p_sound_scalingStrategy == kTimeSoundEditor_scalingStrategy::BY_WINDOW) {
 		if (longSound)
-			LongSound_getWindowExtrema (longSound, my startWindow, my endWindow, firstVisibleChannel, & visibleMinimum, & visibleMaximum);
+			LongSound_getWindowExtrema (longSound, my startWindow, my endWindow, firstVisibleChannel, drawEnvelope, & visibleMinimum, & visibleMaximum);
 		else
 			Matrix_getWindowExtrema (sound, first, last, firstVisibleChannel, firstVisibleChannel, & visibleMinimum, & visibleMaximum);
 		for (integer ichan = firstVisibleChannel + 1; ichan <= lastVisibleChannel; ichan ++) {
 			double visibleChannelMinimum, visibleChannelMaximum;
 			if (longSound)
-				LongSound_getWindowExtrema (longSound, my startWindow, my endWindow, ichan, & visibleChannelMinimum, & visibleChannelMaximum);
+				LongSound_getWindowExtrema (longSound, my startWindow, my endWindow, ichan, drawEnvelope, & visibleChannelMinimum, & visibleChannelMaximum);
 			else
 				Matrix_getWindowExtrema (sound, first, last, ichan, ichan, & visibleChannelMinimum, & visibleChannelMaximum);
 			if (visibleChannelMinimum < visibleMinimum)
@@ -517,7 +536,7 @@ void TimeSoundEditor_drawSound (TimeSoundEditor me, double globalMinimum, double
 		if (my p_sound_scalingStrategy == kTimeSoundEditor_scalingStrategy::BY_WINDOW) {
 			if (numberOfChannels > 2) {
 				if (longSound)
-					LongSound_getWindowExtrema (longSound, my startWindow, my endWindow, ichan, & minimum, & maximum);
+					LongSound_getWindowExtrema (longSound, my startWindow, my endWindow, ichan, drawEnvelope, & minimum, & maximum);
 				else
 					Matrix_getWindowExtrema (sound, first, last, ichan, ichan, & minimum, & maximum);
 				if (maximumExtent > 0.0) {
@@ -531,12 +550,12 @@ void TimeSoundEditor_drawSound (TimeSoundEditor me, double globalMinimum, double
 			}
 		} else if (my p_sound_scalingStrategy == kTimeSoundEditor_scalingStrategy::BY_WINDOW_AND_CHANNEL) {
 			if (longSound)
-				LongSound_getWindowExtrema (longSound, my startWindow, my endWindow, ichan, & minimum, & maximum);
+				LongSound_getWindowExtrema (longSound, my startWindow, my endWindow, ichan, drawEnvelope, & minimum, & maximum);
 			else
 				Matrix_getWindowExtrema (sound, first, last, ichan, ichan, & minimum, & maximum);
 		} else if (my p_sound_scalingStrategy == kTimeSoundEditor_scalingStrategy::FIXED_HEIGHT) {
 			if (longSound)
-				LongSound_getWindowExtrema (longSound, my startWindow, my endWindow, ichan, & minimum, & maximum);
+				LongSound_getWindowExtrema (longSound, my startWindow, my endWindow, ichan, drawEnvelope, & minimum, & maximum);
 			else
 				Matrix_getWindowExtrema (sound, first, last, ichan, ichan, & minimum, & maximum);
 			const double channelExtent = my p_sound_scaling_height;
@@ -619,6 +638,29 @@ void TimeSoundEditor_drawSound (TimeSoundEditor me, double globalMinimum, double
 			Graphics_setColour (my graphics.get(), Melder_BLACK);
 			Graphics_function (my graphics.get(), & sound -> z [ichan] [0], first, last,
 					Sampled_indexToX (sound, first), Sampled_indexToX (sound, last));
+		} else if (drawEnvelope) {
+			Graphics_setWindow (my graphics.get(), my startWindow, my endWindow, minimum, maximum);
+			try {
+				autoMAT envelope = LongSound_getEnvelope (longSound, ichan, my startWindow, my endWindow, numberOfPixels);
+				autoVEC x = raw_VEC (2 * numberOfPixels), y = raw_VEC (2 * numberOfPixels);
+				integer numberOfPoints = 0;
+				for (integer ipixel = 1; ipixel <= numberOfPixels; ipixel ++) {
+					if (isundef (envelope [1] [ipixel]))
+						continue;
+					const double time = my startWindow + (ipixel - 0.5) * (my endWindow - my startWindow) / numberOfPixels;
+					const bool upward = ( ipixel % 2 == 1 );   // zigzag, so that neighbouring pixels connect like Graphics_function does
+					x [++ numberOfPoints] = time;
+					y [numberOfPoints] = envelope [upward ? 1 : 2] [ipixel];
+					x [++ numberOfPoints] = time;
+					y [numberOfPoints] = envelope [upward ? 2 : 1] [ipixel];
+				}
+				Graphics_polyline (my graphics.get(), numberOfPoints, & x [1], & y [1]);
+			} catch (MelderError) {
+				Melder_clearError ();
+				Graphics_setWindow (my graphics.get(), 0.0, 1.0, 0.0, 1.0);
+				Graphics_setTextAlignment (my graphics.get(), Graphics_CENTRE, Graphics_HALF);
+				Graphics_text (my graphics.get(), 0.5, 0.5, U"(cannot read sound file)");
+			}
 		} else {
 			Graphics_setWindow (my graphics.get(), my startWindow, my endWindow, minimum * 32768, maximum * 32768);
 			Graphics_function16 (my graphics.get(),
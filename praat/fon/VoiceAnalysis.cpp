@@ -232,129 +232,327 @@ double PointProcess_Sound_getShimmer_dda (PointProcess me, Sound thee, double tm
 	}
 }
 
+/*
+	All shimmer measures in one pass over the peaks; every sum is accumulated in the same order
+	as in AmplitudeTier_getShimmer_local () and its relatives, so the results are the same.
+*/
+static void AmplitudeTier_getShimmer_multi (AmplitudeTier me, double pmin, double pmax, double maximumAmplitudeFactor,
+	double *out_local, double *out_local_dB, double *out_apq3, double *out_apq5, double *out_apq11, double *out_dda)
+{
+	const integer numberOfPoints = my points.size;
+	integer numberOfPeaks_local = 0, numberOfPeaks_local_dB = 0, numberOfPeaks_apq3 = 0, numberOfPeaks_apq5 = 0, numberOfPeaks_apq11 = 0;
+	longdouble numerator_local = 0.0, sum_local_dB = 0.0, numerator_apq3 = 0.0, numerator_apq5 = 0.0, numerator_apq11 = 0.0;
+	RealPoint *points = & my points.at [0];
+	for (integer i = 2; i <= numberOfPoints; i ++) {
+		{
+			double p = points [i] -> number - points [i - 1] -> number;
+			if (pmin == pmax || (p >= pmin && p <= pmax)) {
+				double a1 = points [i - 1] -> value, a2 = points [i] -> value;
+				double amplitudeFactor = a1 > a2 ? a1 / a2 : a2 / a1;
+				if (amplitudeFactor <= maximumAmplitudeFactor) {
+					numerator_local += fabs (a1 - a2);
+					numberOfPeaks_local ++;
+					sum_local_dB += fabs (log10 (a1 / a2));
+					numberOfPeaks_local_dB ++;
+				}
+			}
+		}
+		if (i <= numberOfPoints - 1) {
+			double
+				p1 = points [i] -> number - points [i - 1] -> number,
+				p2 = points [i + 1] -> number - points [i] -> number;
+			if (pmin == pmax || (p1 >= pmin && p1 <= pmax && p2 >= pmin && p2 <= pmax)) {
+				double a1 = points [i - 1] -> value, a2 = points [i] -> value, a3 = points [i + 1] -> value;
+				double f1 = a1 > a2 ? a1 / a2 : a2 / a1, f2 = a2 > a3 ? a2 / a3 : a3 / a2;
+				if (f1 <= maximumAmplitudeFactor && f2 <= maximumAmplitudeFactor) {
+					double threePointAverage = (a1 + a2 + a3) / 3.0;
+					numerator_apq3 += fabs (a2 - threePointAverage);
+					numberOfPeaks_apq3 ++;
+				}
+			}
+		}
+		if (i >= 3 && i <= numberOfPoints - 2) {
+			double
+				p1 = points [i - 1] -> number - points [i - 2] -> number,
+				p2 = points [i] -> number - points [i - 1] -> number,
+				p3 = points [i + 1] -> number - points [i] -> number,
+				p4 = points [i + 2] -> number - points [i + 1] -> number;
+			if (pmin == pmax || (p1 >= pmin && p1 <= pmax && p2 >= pmin && p2 <= pmax
+				&& p3 >= pmin && p3 <= pmax && p4 >= pmin && p4 <= pmax))
+			{
+				double a1 = points [i - 2] -> value, a2 = points [i - 1] -> value, a3 = points [i] -> value,
+					a4 = points [i + 1] -> value, a5 = points [i + 2] -> value;
+				double f1 = a1 > a2 ? a1 / a2 : a2 / a1, f2 = a2 > a3 ? a2 / a3 : a3 / a2,
+					f3 = a3 > a4 ? a3 / a4 : a4 / a3, f4 = a4 > a5 ? a4 / a5 : a5 / a4;
+				if (f1 <= maximumAmplitudeFactor && f2 <= maximumAmplitudeFactor &&
+				    f3 <= maximumAmplitudeFactor && f4 <= maximumAmplitudeFactor)
+				{
+					double fivePointAverage = ((a1 + a2 + a3) + (a4 + a5)) / 5.0;
+					numerator_apq5 += fabs (a3 - fivePointAverage);
+					numberOfPeaks_apq5 ++;
+				}
+			}
+		}
+		if (i >= 6 && i <= numberOfPoints - 5) {
+			double
+				p1 = points [i - 4] -> number - points [i - 5] -> number,
+				p2 = points [i - 3] -> number - points [i - 4] -> number,
+				p3 = points [i - 2] -> number - points [i - 3] -> number,
+				p4 = points [i - 1] -> number - points [i - 2] -> number,
+				p5 = points [i] -> number - points [i - 1] -> number,
+				p6 = points [i + 1] -> number - points [i] -> number,
+				p7 = points [i + 2] -> number - points [i + 1] -> number,
+				p8 = points [i + 3] -> number - points [i + 2] -> number,
+				p9 = points [i + 4] -> number - points [i + 3] -> number,
+				p10 = points [i + 5] -> number - points [i + 4] -> number;
+			if (pmin == pmax || (p1 >= pmin && p1 <= pmax && p2 >= pmin && p2 <= pmax
+				&& p3 >= pmin && p3 <= pmax && p4 >= pmin && p4 <= pmax && p5 >= pmin && p5 <= pmax
+				&& p6 >= pmin && p6 <= pmax && p7 >= pmin && p7 <= pmax && p8 >= pmin && p8 <= pmax
+				&& p9 >= pmin && p9 <= pmax && p10 >= pmin && p10 <= pmax))
+			{
+				double a1 = points [i - 5] -> value, a2 = points [i - 4] -> value, a3 = points [i - 3] -> value,
+					a4 = points [i - 2] -> value, a5 = points [i - 1] -> value, a6 = points [i] -> value,
+					a7 = points [i + 1] -> value, a8 = points [i + 2] -> value, a9 = points [i + 3] -> value,
+					a10 = points [i + 4] -> value, a11 = points [i + 5] -> value;
+				double f1 = a1 > a2 ? a1 / a2 : a2 / a1, f2 = a2 > a3 ? a2 / a3 : a3 / a2,
+					f3 = a3 > a4 ? a3 / a4 : a4 / a3, f4 = a4 > a5 ? a4 / a5 : a5 / a4,
+					f5 = a5 > a6 ? a5 / a6 : a6 / a5, f6 = a6 > a7 ? a6 / a7 : a7 / a6,
+					f7 = a7 > a8 ? a7 / a8 : a8 / a7, f8 = a8 > a9 ? a8 / a9 : a9 / a8,
+					f9 = a9 > a10 ? a9 / a10 : a10 / a9, f10 = a10 > a11 ? a10 / a11 : a11 / a10;
+				if (f1 <= maximumAmplitudeFactor && f2 <= maximumAmplitudeFactor &&
+				    f3 <= maximumAmplitudeFactor && f4 <= maximumAmplitudeFactor &&
+				    f5 <= maximumAmplitudeFactor && f6 <= maximumAmplitudeFactor &&
+				    f7 <= maximumAmplitudeFactor && f8 <= maximumAmplitudeFactor &&
+				    f9 <= maximumAmplitudeFactor && f10 <= maximumAmplitudeFactor)
+				{
+					double elevenPointAverage = (((a1 + a2 + a3) + (a4 + a5 + a6)) + ((a7 + a8 + a9) + (a10 + a11))) / 11.0;
+					numerator_apq11 += fabs (a6 - elevenPointAverage);
+					numberOfPeaks_apq11 ++;
+				}
+			}
+		}
+	}
+	/*
+		The local and apq shimmers are relative to the mean amplitude of all peaks but the last.
+	*/
+	longdouble denominator = 0.0;
+	for (integer i = 1; i < numberOfPoints; i ++)
+		denominator += points [i] -> value;
+	denominator /= numberOfPoints - 1;
+	auto relativeShimmer = [&] (longdouble numerator, integer numberOfPeaks) -> double {
+		if (numberOfPeaks < 1 || denominator == 0.0)
+			return undefined;
+		return double ((numerator / numberOfPeaks) / denominator);
+	};
+	*out_local = relativeShimmer (numerator_local, numberOfPeaks_local);
+	*out_local_dB = ( numberOfPeaks_local_dB < 1 ? undefined : double (20.0 * (sum_local_dB / numberOfPeaks_local_dB)) );
+	*out_apq3 = relativeShimmer (numerator_apq3, numberOfPeaks_apq3);
+	*out_apq5 = relativeShimmer (numerator_apq5, numberOfPeaks_apq5);
+	*out_apq11 = relativeShimmer (numerator_apq11, numberOfPeaks_apq11);
+	*out_dda = 3.0 * *out_apq3;
+}
+
 void PointProcess_Sound_getShimmer_multi (PointProcess me, Sound thee, double tmin, double tmax,
 	double pmin, double pmax, double maximumPeriodFactor, double maximumAmplitudeFactor,
 	double *local, double *local_dB, double *apq3, double *apq5, double *apq11, double *dda)
 {
+	double shimmer_local, shimmer_local_dB, shimmer_apq3, shimmer_apq5, shimmer_apq11, shimmer_dda;
 	try {
 		Function_unidirectionalAutowindow (me, & tmin, & tmax);
 		autoAmplitudeTier peaks = PointProcess_Sound_to_AmplitudeTier_period (me, thee, tmin, tmax, pmin, pmax, maximumPeriodFactor);
-		if (local)    *local    =       AmplitudeTier_getShimmer_local    (peaks.get(), pmin, pmax, maximumAmplitudeFactor);
-		if (local_dB) *local_dB =       AmplitudeTier_getShimmer_local_dB (peaks.get(), pmin, pmax, maximumAmplitudeFactor);
-		if (apq3)     *apq3     =       AmplitudeTier_getShimmer_apq3     (peaks.get(), pmin, pmax, maximumAmplitudeFactor);
-		if (apq5)     *apq5     =       AmplitudeTier_getShimmer_apq5     (peaks.get(), pmin, pmax, maximumAmplitudeFactor);
-		if (apq11)    *apq11    =       AmplitudeTier_getShimmer_apq11    (peaks.get(), pmin, pmax, maximumAmplitudeFactor);
-		if (dda)      *dda      = 3.0 * AmplitudeTier_getShimmer_apq3     (peaks.get(), pmin, pmax, maximumAmplitudeFactor);
+		AmplitudeTier_getShimmer_multi (peaks.get(), pmin, pmax, maximumAmplitudeFactor,
+			& shimmer_local, & shimmer_local_dB, & shimmer_apq3, & shimmer_apq5, & shimmer_apq11, & shimmer_dda);
 	} catch (MelderError) {
 		if (Melder_hasError (U"Too few pulses between ")) {
 			Melder_clearError ();
-			if (local)    *local    = undefined;
-			if (local_dB) *local_dB = undefined;
-			if (apq3)     *apq3     = undefined;
-			if (apq5)     *apq5     = undefined;
-			if (apq11)    *apq11    = undefined;
-			if (dda)      *dda      = undefined;
+			shimmer_local = shimmer_local_dB = shimmer_apq3 = shimmer_apq5 = shimmer_apq11 = shimmer_dda = undefined;
 		} else {
 			Melder_throw (me, U" & ", thee, U": shimmer measures not computed.");
 		}
 	}
+	if (local)    *local    = shimmer_local;
+	if (local_dB) *local_dB = shimmer_local_dB;
+	if (apq3)     *apq3     = shimmer_apq3;
+	if (apq5)     *apq5     = shimmer_apq5;
+	if (apq11)    *apq11    = shimmer_apq11;
+	if (dda)      *dda      = shimmer_dda;
 }
 
-void Sound_Pitch_PointProcess_voiceReport (Sound sound, Pitch pitch, PointProcess pulses, double tmin, double tmax,
+/*
+	All jitter measures in one pass over the periods; every sum is accumulated in the same order
+	as in PointProcess_getJitter_local () and its relatives, so the results are the same.
+*/
+static void PointProcess_getJitter_multi (PointProcess me, MelderIntegerRange pointNumbers,
+	double pmin, double pmax, double maximumPeriodFactor, double meanPeriod,
+	double *out_local, double *out_local_absolute, double *out_rap, double *out_ppq5, double *out_ddp)
+{
+	integer numberOfPeriods_local = pointNumbers.size() - 1, numberOfPeriods_rap = numberOfPeriods_local, numberOfPeriods_ppq5 = numberOfPeriods_local;
+	longdouble sum_local = 0.0, sum_rap = 0.0, sum_ppq5 = 0.0;
+	for (integer i = pointNumbers.first + 1; i <= pointNumbers.last; i ++) {
+		if (i < pointNumbers.last) {
+			const double p1 = my t [i] - my t [i - 1], p2 = my t [i + 1] - my t [i];
+			const double intervalFactor = p1 > p2 ? p1 / p2 : p2 / p1;
+			if (pmin == pmax || (p1 >= pmin && p1 <= pmax && p2 >= pmin && p2 <= pmax && intervalFactor <= maximumPeriodFactor))
+				sum_local += fabs (p1 - p2);
+			else
+				numberOfPeriods_local --;
+		}
+		if (i >= pointNumbers.first + 2 && i < pointNumbers.last) {
+			const double p1 = my t [i - 1] - my t [i - 2], p2 = my t [i] - my t [i - 1], p3 = my t [i + 1] - my t [i];
+			const double intervalFactor1 = p1 > p2 ? p1 / p2 : p2 / p1, intervalFactor2 = p2 > p3 ? p2 / p3 : p3 / p2;
+			if (pmin == pmax || (p1 >= pmin && p1 <= pmax && p2 >= pmin && p2 <= pmax && p3 >= pmin && p3 <= pmax
+			    && intervalFactor1 <= maximumPeriodFactor && intervalFactor2 <= maximumPeriodFactor))
+			{
+				sum_rap += fabs (p2 - (p1 + p2 + p3) / 3.0);
+			} else {
+				numberOfPeriods_rap --;
+			}
+		}
+		if (i >= pointNumbers.first + 5) {
+			const double
+				p1 = my t [i - 4] - my t [i - 5],
+				p2 = my t [i - 3] - my t [i - 4],
+				p3 = my t [i - 2] - my t [i - 3],
+				p4 = my t [i - 1] - my t [i - 2],
+				p5 = my t [i] - my t [i - 1];
+			const double
+				f1 = p1 > p2 ? p1 / p2 : p2 / p1,
+				f2 = p2 > p3 ? p2 / p3 : p3 / p2,
+				f3 = p3 > p4 ? p3 / p4 : p4 / p3,
+				f4 = p4 > p5 ? p4 / p5 : p5 / p4;
+			if (pmin == pmax || (p1 >= pmin && p1 <= pmax && p2 >= pmin && p2 <= pmax && p3 >= pmin && p3 <= pmax &&
+				p4 >= pmin && p4 <= pmax && p5 >= pmin && p5 <= pmax &&
+				f1 <= maximumPeriodFactor && f2 <= maximumPeriodFactor && f3 <= maximumPeriodFactor && f4 <= maximumPeriodFactor))
+			{
+				sum_ppq5 += fabs (p3 - (p1 + p2 + p3 + p4 + p5) / 5.0);
+			} else {
+				numberOfPeriods_ppq5 --;
+			}
+		}
+	}
+	*out_local_absolute = ( numberOfPeriods_local < 2 ? undefined : double (sum_local / (numberOfPeriods_local - 1)) );
+	*out_local = ( numberOfPeriods_local < 2 ? undefined : *out_local_absolute / meanPeriod );
+	*out_rap = ( numberOfPeriods_rap < 3 ? undefined : double (sum_rap / (numberOfPeriods_rap - 2)) / meanPeriod );
+	*out_ppq5 = ( numberOfPeriods_ppq5 < 5 ? undefined : double (sum_ppq5 / (numberOfPeriods_ppq5 - 4)) / meanPeriod );
+	*out_ddp = ( isdefined (*out_rap) ? 3.0 * *out_rap : undefined );
+}
+
+VoiceReport Sound_Pitch_PointProcess_getVoiceReport (Sound sound, Pitch pitch, PointProcess pulses, double tmin, double tmax,
 	double floor, double ceiling, double maximumPeriodFactor, double maximumAmplitudeFactor, double silenceThreshold, double voicingThreshold)
 {
 	try {
+		VoiceReport report;
 		Function_unidirectionalAutowindow (sound, & tmin, & tmax);
-		/*
-			Time domain. Should be preceded by something like "Time range of SELECTION:" or so.
-		*/
-		MelderInfo_writeLine (U"   From ", Melder_fixed (tmin, 6), U" to ", Melder_fixed (tmax, 6), U" seconds",
-			U" (duration: ", Melder_fixed (tmax - tmin, 6), U" seconds)"
-		);
+		report.startTime = tmin;
+		report.endTime = tmax;
 		/*
 			Pitch statistics.
 		*/
-		const double medianPitch = Pitch_getQuantile (pitch, tmin, tmax, 0.50, kPitch_unit::HERTZ);
-		const double meanPitch = Pitch_getMean (pitch, tmin, tmax, kPitch_unit::HERTZ);
-		const double stdevPitch = Pitch_getStandardDeviation (pitch, tmin, tmax, kPitch_unit::HERTZ);
-		const double minimumPitch = Pitch_getMinimum (pitch, tmin, tmax, kPitch_unit::HERTZ, 1);
-		const double maximumPitch = Pitch_getMaximum (pitch, tmin, tmax, kPitch_unit::HERTZ, 1);
-		MelderInfo_writeLine (U"Pitch:");
-		MelderInfo_writeLine (U"   Median pitch: ", Melder_fixed (medianPitch, 3), U" Hz");
-		MelderInfo_writeLine (U"   Mean pitch: ", Melder_fixed (meanPitch, 3), U" Hz");
-		MelderInfo_writeLine (U"   Standard deviation: ", Melder_fixed (stdevPitch, 3), U" Hz");
-		MelderInfo_writeLine (U"   Minimum pitch: ", Melder_fixed (minimumPitch, 3), U" Hz");
-		MelderInfo_writeLine (U"   Maximum pitch: ", Melder_fixed (maximumPitch, 3), U" Hz");
+		report.medianPitch = Pitch_getQuantile (pitch, tmin, tmax, 0.50, kPitch_unit::HERTZ);
+		report.meanPitch = Pitch_getMean (pitch, tmin, tmax, kPitch_unit::HERTZ);
+		report.standardDeviationOfPitch = Pitch_getStandardDeviation (pitch, tmin, tmax, kPitch_unit::HERTZ);
+		report.minimumPitch = Pitch_getMinimum (pitch, tmin, tmax, kPitch_unit::HERTZ, 1);
+		report.maximumPitch = Pitch_getMaximum (pitch, tmin, tmax, kPitch_unit::HERTZ, 1);
 		/*
-			Pulses statistics.
+			Pulses statistics: the periods are collected in one pass, as in PointProcess_getStdevPeriod ().
 		*/
 		const double pmin = 0.8 / ceiling, pmax = 1.25 / floor;   // minimum period, maximum period (abbreviated for space)
 		const MelderIntegerRange pulseNumbers = PointProcess_getWindowPoints (pulses, tmin, tmax);
-		const integer numberOfPeriods = PointProcess_getNumberOfPeriods (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor);
-		const double meanPeriod = PointProcess_getMeanPeriod (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor);
-		const double stdevPeriod = PointProcess_getStdevPeriod (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor);
-		MelderInfo_writeLine (U"Pulses:");
-		MelderInfo_writeLine (U"   Number of pulses: ", pulseNumbers.size());
-		MelderInfo_writeLine (U"   Number of periods: ", numberOfPeriods);
-		MelderInfo_writeLine (U"   Mean period: ", Melder_fixedExponent (meanPeriod, -3, 6), U" seconds");
-		MelderInfo_writeLine (U"   Standard deviation of period: ", Melder_fixedExponent (stdevPeriod, -3, 6), U" seconds");
+		report.numberOfPulses = pulseNumbers.size();
+		autoVEC periods;
+		longdouble sum = 0.0;
+		for (integer ipoint = pulseNumbers.first; ipoint < pulseNumbers.last; ipoint ++) {
+			if (PointProcess_isPeriod (pulses, ipoint, pmin, pmax, maximumPeriodFactor)) {
+				const double period = pulses -> t [ipoint + 1] - pulses -> t [ipoint];
+				*periods. append () = period;
+				sum += period;
+			}
+		}
+		report.numberOfPeriods = periods.size;
+		report.meanPeriod = ( periods.size > 0 ? double (sum / periods.size) : undefined );
+		report.standardDeviationOfPeriod = undefined;
+		if (periods.size >= 2) {
+			longdouble sum2 = 0.0;
+			for (integer iperiod = 1; iperiod <= periods.size; iperiod ++) {
+				const double dperiod = periods [iperiod] - report.meanPeriod;
+				sum2 += dperiod * dperiod;
+			}
+			report.standardDeviationOfPeriod = sqrt (double (sum2 / (periods.size - 1)));
+		}
 		/*
 			Voicing.
 		*/
-		const MelderFraction unvoicedFraction =
-				Pitch_getFractionOfLocallyUnvoicedFrames (pitch, tmin, tmax, ceiling, silenceThreshold, voicingThreshold);
-		const MelderCountAndFraction breaks =
-				PointProcess_getCountAndFractionOfVoiceBreaks (pulses, tmin, tmax, pmax);
-		MelderInfo_writeLine (U"Voicing:");
-		MelderInfo_writeLine (U"   Fraction of locally unvoiced frames: ", Melder_percent (unvoicedFraction.get(), 3),
-			U"   (", unvoicedFraction.numerator, U" / ", unvoicedFraction.denominator, U")"
-		);
-		MelderInfo_writeLine (U"   Number of voice breaks: ", breaks.count);
-		MelderInfo_writeLine (U"   Degree of voice breaks: ", Melder_percent (breaks.getFraction (), 3),
-			U"   (", Melder_fixed (breaks.numerator, 6), U" seconds / ", Melder_fixed (breaks.denominator, 6), U" seconds)"
-		);
-		/*
-			Jitter.
-		*/
-		const double jitterLocal = PointProcess_getJitter_local (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor);
-		const double jitterLocal_s = PointProcess_getJitter_local_absolute (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor);
-		const double rap = PointProcess_getJitter_rap (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor);
-		const double ppq5 = PointProcess_getJitter_ppq5 (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor);
-		const double ddp = PointProcess_getJitter_ddp (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor);
-		MelderInfo_writeLine (U"Jitter:");
-		MelderInfo_writeLine (U"   Jitter (local): ", Melder_percent (jitterLocal, 3));
-		MelderInfo_writeLine (U"   Jitter (local, absolute): ", Melder_fixedExponent (jitterLocal_s, -6, 3), U" seconds");
-		MelderInfo_writeLine (U"   Jitter (rap): ", Melder_percent (rap, 3));
-		MelderInfo_writeLine (U"   Jitter (ppq5): ", Melder_percent (ppq5, 3));
-		MelderInfo_writeLine (U"   Jitter (ddp): ", Melder_percent (ddp, 3));
+		report.unvoicedFrames = Pitch_getFractionOfLocallyUnvoicedFrames (pitch, tmin, tmax, ceiling, silenceThreshold, voicingThreshold);
+		report.voiceBreaks = PointProcess_getCountAndFractionOfVoiceBreaks (pulses, tmin, tmax, pmax);
 		/*
-			Shimmer.
+			Jitter and shimmer.
 		*/
-		double shimmerLocal, shimmerLocal_dB, apq3, apq5, apq11, dda;
+		PointProcess_getJitter_multi (pulses, pulseNumbers, pmin, pmax, maximumPeriodFactor, report.meanPeriod,
+			& report.jitter_local, & report.jitter_local_absolute, & report.jitter_rap, & report.jitter_ppq5, & report.jitter_ddp
+		);
 		PointProcess_Sound_getShimmer_multi (pulses, sound, tmin, tmax, pmin, pmax,
 			maximumPeriodFactor, maximumAmplitudeFactor,
-			& shimmerLocal, & shimmerLocal_dB, & apq3, & apq5, & apq11, & dda
+			& report.shimmer_local, & report.shimmer_local_dB, & report.shimmer_apq3, & report.shimmer_apq5, & report.shimmer_apq11, & report.shimmer_dda
 		);
-		MelderInfo_writeLine (U"Shimmer:");
-		MelderInfo_writeLine (U"   Shimmer (local): ", Melder_percent (shimmerLocal, 3));
-		MelderInfo_writeLine (U"   Shimmer (local, dB): ", Melder_fixed (shimmerLocal_dB, 3), U" dB");
-		MelderInfo_writeLine (U"   Shimmer (apq3): ", Melder_percent (apq3, 3));
-		MelderInfo_writeLine (U"   Shimmer (apq5): ", Melder_percent (apq5, 3));
-		MelderInfo_writeLine (U"   Shimmer (apq11): ", Melder_percent (apq11, 3));
-		MelderInfo_writeLine (U"   Shimmer (dda): ", Melder_percent (dda, 3));
 		/*
 			Harmonicity.
 		*/
-		const double meanAutocorrelation = Pitch_getMeanStrength (pitch, tmin, tmax, Pitch_STRENGTH_UNIT_AUTOCORRELATION);
-		const double meanNHR = Pitch_getMeanStrength (pitch, tmin, tmax, Pitch_STRENGTH_UNIT_NOISE_HARMONICS_RATIO);
-		const double meanHNR_dB = Pitch_getMeanStrength (pitch, tmin, tmax, Pitch_STRENGTH_UNIT_HARMONICS_NOISE_DB);
-		MelderInfo_writeLine (U"Harmonicity of the voiced parts only:");
-		MelderInfo_writeLine (U"   Mean autocorrelation: ", Melder_fixed (meanAutocorrelation, 6));
-		MelderInfo_writeLine (U"   Mean noise-to-harmonics ratio: ", Melder_fixed (meanNHR, 6));
-		MelderInfo_writeLine (U"   Mean harmonics-to-noise ratio: ", Melder_fixed (meanHNR_dB, 3), U" dB");
+		report.meanAutocorrelation = Pitch_getMeanStrength (pitch, tmin, tmax, Pitch_STRENGTH_UNIT_AUTOCORRELATION);
+		report.meanNoiseToHarmonicsRatio = Pitch_getMeanStrength (pitch, tmin, tmax, Pitch_STRENGTH_UNIT_NOISE_HARMONICS_RATIO);
+		report.meanHarmonicsToNoiseRatio_dB = Pitch_getMeanStrength (pitch, tmin, tmax, Pitch_STRENGTH_UNIT_HARMONICS_NOISE_DB);
+		return report;
 	} catch (MelderError) {
 		Melder_throw (sound, U" & ", pitch, U" & ", pulses, U": voice report not computed.");
 	}
 }
 
+void Sound_Pitch_PointProcess_voiceReport (Sound sound, Pitch pitch, PointProcess pulses, double tmin, double tmax,
+	double floor, double ceiling, double maximumPeriodFactor, double maximumAmplitudeFactor, double silenceThreshold, double voicingThreshold)
+{
+	const VoiceReport report = Sound_Pitch_PointProcess_getVoiceReport (sound, pitch, pulses, tmin, tmax,
+			floor, ceiling, maximumPeriodFactor, maximumAmplitudeFactor, silenceThreshold, voicingThreshold);
+	/*
+		Time domain. Should be preceded by something like "Time range of SELECTION:" or so.
+	*/
+	MelderInfo_writeLine (U"   From ", Melder_fixed (report.startTime, 6), U" to ", Melder_fixed (report.endTime, 6), U" seconds",
+		U" (duration: ", Melder_fixed (report.endTime - report.startTime, 6), U" seconds)"
+	);
+	MelderInfo_writeLine (U"Pitch:");
+	MelderInfo_writeLine (U"   Median pitch: ", Melder_fixed (report.medianPitch, 3), U" Hz");
+	MelderInfo_writeLine (U"   Mean pitch: ", Melder_fixed (report.meanPitch, 3), U" Hz");
+	MelderInfo_writeLine (U"   Standard deviation: ", Melder_fixed (report.standardDeviationOfPitch, 3), U" Hz");
+	MelderInfo_writeLine (U"   Minimum pitch: ", Melder_fixed (report.minimumPitch, 3), U" Hz");
+	MelderInfo_writeLine (U"   Maximum pitch: ", Melder_fixed (report.maximumPitch, 3), U" Hz");
+	MelderInfo_writeLine (U"Pulses:");
+	MelderInfo_writeLine (U"   Number of pulses: ", report.numberOfPulses);
+	MelderInfo_writeLine (U"   Number of periods: ", report.numberOfPeriods);
+	MelderInfo_writeLine (U"   Mean period: ", Melder_fixedExponent (report.meanPeriod, -3, 6), U" seconds");
+	MelderInfo_writeLine (U"   Standard deviation of period: ", Melder_fixedExponent (report.standardDeviationOfPeriod, -3, 6), U" seconds");
+	MelderInfo_writeLine (U"Voicing:");
+	MelderInfo_writeLine (U"   Fraction of locally unvoiced frames: ", Melder_percent (report.unvoicedFrames.get(), 3),
+		U"   (", report.unvoicedFrames.numerator, U" / ", report.unvoicedFrames.denominator, U")"
+	);
+	MelderInfo_writeLine (U"   Number of voice breaks: ", report.voiceBreaks.count);
+	MelderInfo_writeLine (U"   Degree of voice breaks: ", Melder_percent (report.voiceBreaks.getFraction (), 3),
+		U"   (", Melder_fixed (report.voiceBreaks.numerator, 6), U" seconds / ", Melder_fixed (report.voiceBreaks.denominator, 6), U" seconds)"
+	);
+	MelderInfo_writeLine (U"Jitter:");
+	MelderInfo_writeLine (U"   Jitter (local): ", Melder_percent (report.jitter_local, 3));
+	MelderInfo_writeLine (U"   Jitter (local, absolute): ", Melder_fixedExponent (report.jitter_local_absolute, -6, 3), U" seconds");
+	MelderInfo_writeLine (U"   Jitter (rap): ", Melder_percent (report.jitter_rap, 3));
+	MelderInfo_writeLine (U"   Jitter (ppq5): ", Melder_percent (report.jitter_ppq5, 3));
+	MelderInfo_writeLine (U"   Jitter (ddp): ", Melder_percent (report.jitter_ddp, 3));
+	MelderInfo_writeLine (U"Shimmer:");
+	MelderInfo_writeLine (U"   Shimmer (local): ", Melder_percent (report.shimmer_local, 3));
+	MelderInfo_writeLine (U"   Shimmer (local, dB): ", Melder_fixed (report.shimmer_local_dB, 3), U" dB");
+	MelderInfo_writeLine (U"   Shimmer (apq3): ", Melder_percent (report.shimmer_apq3, 3));
+	MelderInfo_writeLine (U"   Shimmer (apq5): ", Melder_percent (report.shimmer_apq5, 3));
+	MelderInfo_writeLine (U"   Shimmer (apq11): ", Melder_percent (report.shimmer_apq11, 3));
+	MelderInfo_writeLine (U"   Shimmer (dda): ", Melder_percent (report.shimmer_dda, 3));
+	MelderInfo_writeLine (U"Harmonicity of the voiced parts only:");
+	MelderInfo_writeLine (U"   Mean autocorrelation: ", Melder_fixed (report.meanAutocorrelation, 6));
+	MelderInfo_writeLine (U"   Mean noise-to-harmonics ratio: ", Melder_fixed (report.meanNoiseToHarmonicsRatio, 6));
+	MelderInfo_writeLine (U"   Mean harmonics-to-noise ratio: ", Melder_fixed (report.meanHarmonicsToNoiseRatio_dB, 3), U" dB");
+}
+
 /* End of file VoiceAnalysis.cpp */
@@ -47,6 +47,29 @@ void PointProcess_Sound_getShimmer_multi (PointProcess me, Sound thee, double tm
 	double minimumPeriod, double maximumPeriod, double maximumPeriodFactor, double maximumAmplitudeFactor,
 	double *local, double *local_dB, double *apq3, double *apq5, double *apq11, double *dda);
 
+/*
+	All the measures of the voice report.
+	The periods and their amplitudes are derived once, and all jitter and shimmer measures
+	are accumulated together in a single pass over them;
+	the values are the same as those of the separate functions above.
+*/
+struct VoiceReport {
+	double startTime, endTime;
+	double medianPitch, meanPitch, standardDeviationOfPitch, minimumPitch, maximumPitch;
+	integer numberOfPulses, numberOfPeriods;
+	double meanPeriod, standardDeviationOfPeriod;
+	MelderFraction unvoicedFrames;
+	MelderCountAndFraction voiceBreaks;
+	double jitter_local, jitter_local_absolute, jitter_rap, jitter_ppq5, jitter_ddp;
+	double shimmer_local, shimmer_local_dB, shimmer_apq3, shimmer_apq5, shimmer_apq11, shimmer_dda;
+	double meanAutocorrelation, meanNoiseToHarmonicsRatio, meanHarmonicsToNoiseRatio_dB;
+};
+
+VoiceReport Sound_Pitch_PointProcess_getVoiceReport (Sound sound, Pitch pitch, PointProcess pulses,
+	double tmin, double tmax,
+	double floor, double ceiling, double maximumPeriodFactor, double maximumAmplitudeFactor,
+	double silenceThreshold, double voicingThreshold);
+
 void Sound_Pitch_PointProcess_voiceReport (Sound sound, Pitch pitch, PointProcess pulses,
 	double tmin, double tmax,
 	double floor, double ceiling, double maximumPeriodFactor, double maximumAmplitudeFactor,
@@ -99,6 +99,36 @@ DIRECT (INTEGER_LongSound_getNumberOfSamples) {
 	NUMBER_ONE_END (U" samples")
 }
 
+FORM (REAL_LongSound_getMinimum, U"LongSound: Get minimum", nullptr) {
+	REAL (fromTime, U"left Time range (s)", U"0.0")
+	REAL (toTime, U"right Time range (s)", U"0.0 (= all)")
+	OK
+DO
+	NUMBER_ONE (LongSound)
+		const double result = LongSound_getMinimum (me, fromTime, toTime);
+	NUMBER_ONE_END (U" (minimum sample value)")
+}
+
+FORM (REAL_LongSound_getMaximum, U"LongSound: Get maximum", nullptr) {
+	REAL (fromTime, U"left Time range (s)", U"0.0")
+	REAL (toTime, U"right Time range (s)", U"0.0 (= all)")
+	OK
+DO
+	NUMBER_ONE (LongSound)
+		const double result = LongSound_getMaximum (me, fromTime, toTime);
+	NUMBER_ONE_END (U" (maximum sample value)")
+}
+
+FORM (REAL_LongSound_getRootMeanSquare, U"LongSound: Get root-mean-square", nullptr) {
+	REAL (fromTime, U"left Time range (s)", U"0.0")
+	REAL (toTime, U"right Time range (s)", U"0.0 (= all)")
+	OK
+DO
+	NUMBER_ONE (LongSound)
+		const double result = LongSound_getRootMeanSquare (me, fromTime, toTime);
+	NUMBER_ONE_END (U" Pascal")
+}
+
 DIRECT (HELP_LongSound_help) {
 	HELP (U"LongSound")
 }
@@ -158,6 +188,17 @@ DO
 	CONVERT_EACH_END (my name.get())
 }
 
+FORM (NEW_LongSound_to_Pitch, U"LongSound: To Pitch", U"Sound: To Pitch...") {
+	REAL (timeStep, U"Time step (s)", U"0.0 (= auto)")
+	POSITIVE (pitchFloor, U"Pitch floor (Hz)", U"75.0")
+	POSITIVE (pitchCeiling, U"Pitch ceiling (Hz)", U"600.0")
+	OK
+DO
+	CONVERT_EACH (LongSound)
+		autoPitch result = LongSound_to_Pitch (me, timeStep, pitchFloor, pitchCeiling);
+	CONVERT_EACH_END (my name.get())
+}
+
 DIRECT (WINDOW_LongSound_view) {
 	if (theCurrentPraatApplication -> batch) Melder_throw (U"Cannot view or edit a LongSound from batch.");
 	FIND_ONE_WITH_IOBJECT (LongSound)
@@ -2197,10 +2238,17 @@ void praat_Sound_init () {
 		praat_addAction1 (classLongSound, 1,   U"Get time from index...", U"*Get time from sample number...", praat_DEPTH_2 | praat_DEPRECATED_2004, REAL_LongSound_getTimeFromIndex);
 		praat_addAction1 (classLongSound, 1, U"Get sample number from time...", nullptr, 2, REAL_LongSound_getIndexFromTime);
 		praat_addAction1 (classLongSound, 1,   U"Get index from time...", U"*Get sample number from time...", praat_DEPTH_2 | praat_DEPRECATED_2004, REAL_LongSound_getIndexFromTime);
+		praat_addAction1 (classLongSound, 1, U"-- get extreme --", nullptr, 1, nullptr);
+		praat_addAction1 (classLongSound, 1, U"Get minimum...", nullptr, 1, REAL_LongSound_getMinimum);
+		praat_addAction1 (classLongSound, 1, U"Get maximum...", nullptr, 1, REAL_LongSound_getMaximum);
+		praat_addAction1 (classLongSound, 1, U"-- get energy --", nullptr, 1, nullptr);
+		praat_addAction1 (classLongSound, 1, U"Get root-mean-square...", nullptr, 1, REAL_LongSound_getRootMeanSquare);
 	praat_addAction1 (classLongSound, 0, U"Annotate -", nullptr, 0, nullptr);
 		praat_addAction1 (classLongSound, 0, U"Annotation tutorial", nullptr, 1, HELP_AnnotationTutorial);
 		praat_addAction1 (classLongSound, 0, U"-- to text grid --", nullptr, 1, nullptr);
 		praat_addAction1 (classLongSound, 0, U"To TextGrid...", nullptr, 1, NEW_LongSound_to_TextGrid);
+	praat_addAction1 (classLongSound, 0, U"Analyse periodicity -", nullptr, 0, nullptr);
+		praat_addAction1 (classLongSound, 0, U"To Pitch...", nullptr, 1, NEW_LongSound_to_Pitch);
 	praat_addAction1 (classLongSound, 0, U"Convert to Sound", nullptr, 0, nullptr);
 	praat_addAction1 (classLongSound, 0, U"Extract part...", nullptr, 0, NEW_LongSound_extractPart);
 	praat_addAction1 (classLongSound, 0, U"Concatenate?", nullptr, 0, INFO_LongSound_concatenate);
@@ -37,8 +37,8 @@ char * MelderFile_readLine8 (MelderFile me) {
 		return nullptr;
 	if (feof (my filePointer))
 		return nullptr;
-	static char *buffer;
-	static integer capacity;
+	static thread_local char *buffer;
+	static thread_local integer capacity;
 	if (! buffer)
 		buffer = Melder_malloc (char, capacity = 100);
 	integer i = 0;
@@ -88,34 +88,48 @@ void MelderFile_write (MelderFile file, conststring32 string) {
 		return;
 	int64 length = str32len (string);
 	FILE *f = file -> filePointer;
-	if (file -> outputEncoding == kMelder_textOutputEncoding_ASCII || file -> outputEncoding == kMelder_textOutputEncoding_ISO_LATIN1) {
-		for (int64 i = 0; i < length; i ++) {
-			char kar = (char) (char8) string [i];   // truncate
-			if (kar == '\n' && file -> requiresCRLF)
-				putc (13, f);
-			putc (kar, f);
-		}
-	} else if (file -> outputEncoding == (unsigned long) kMelder_textOutputEncoding::UTF8) {
+	if (file -> outputEncoding == kMelder_textOutputEncoding_ASCII || file -> outputEncoding == kMelder_textOutputEncoding_ISO_LATIN1 ||
+		file -> outputEncoding == (unsigned long) kMelder_textOutputEncoding::UTF8)
+	{
+		/*
+			Encode into a local buffer and hand it to the file in one fwrite per chunk,
+			rather than calling putc for every byte.
+		*/
+		const bool utf8 = ( file -> outputEncoding == (unsigned long) kMelder_textOutputEncoding::UTF8 );
+		constexpr integer chunkSize = 4096;
+		char chunk [chunkSize + 4];   // room for one more character of at most four bytes
+		integer chunkLength = 0;
 		for (int64 i = 0; i < length; i ++) {
 			char32 kar = string [i];
-			if (kar <= 0x00'007F) {
+			if (! utf8) {
+				char kar8 = (char) (char8) kar;   // truncate
+				if (kar8 == '\n' && file -> requiresCRLF)
+					chunk [chunkLength ++] = 13;
+				chunk [chunkLength ++] = kar8;
+			} else if (kar <= 0x00'007F) {
 				if (kar == U'\n' && file -> requiresCRLF)
-					putc (13, f);
-				putc ((int) kar, f);   // guarded conversion down
+					chunk [chunkLength ++] = 13;
+				chunk [chunkLength ++] = (char) kar;   // guarded conversion down
 			} else if (kar <= 0x00'07FF) {
-				putc (0xC0 | (kar >> 6), f);
-				putc (0x80 | (kar & 0x00'003F), f);
+				chunk [chunkLength ++] = (char) (0xC0 | (kar >> 6));
+				chunk [chunkLength ++] = (char) (0x80 | (kar & 0x00'003F));
 			} else if (kar <= 0x00'FFFF) {
-				putc (0xE0 | (kar >> 12), f);
-				putc (0x80 | ((kar >> 6) & 0x00'003F), f);
-				putc (0x80 | (kar & 0x00'003F), f);
+				chunk [chunkLength ++] = (char) (0xE0 | (kar >> 12));
+				chunk [chunkLength ++] = (char) (0x80 | ((kar >> 6) & 0x00'003F));
+				chunk [chunkLength ++] = (char) (0x80 | (kar & 0x00'003F));
 			} else {
-				putc (0xF0 | (kar >> 18), f);
-				putc (0x80 | ((kar >> 12) & 0x00'003F), f);
-				putc (0x80 | ((kar >> 6) & 0x00'003F), f);
-				putc (0x80 | (kar & 0x00'003F), f);
+				chunk [chunkLength ++] = (char) (0xF0 | (kar >> 18));
+				chunk [chunkLength ++] = (char) (0x80 | ((kar >> 12) & 0x00'003F));
+				chunk [chunkLength ++] = (char) (0x80 | ((kar >> 6) & 0x00'003F));
+				chunk [chunkLength ++] = (char) (0x80 | (kar & 0x00'003F));
+			}
+			if (chunkLength >= chunkSize) {
+				fwrite (chunk, 1, integer_to_uinteger (chunkLength), f);
+				chunkLength = 0;
 			}
 		}
+		if (chunkLength > 0)
+			fwrite (chunk, 1, integer_to_uinteger (chunkLength), f);
 	} else {
 		for (int64 i = 0; i < length; i ++) {
 			char32 kar = string [i];
@@ -17,26 +17,216 @@
  */
 
 #include "melder.h"
+#include <cfloat>   // FLT_EVAL_METHOD
+#include <charconv>   // std::from_chars
 #ifdef macintosh
 	#include <TargetConditionals.h>
 #endif
 
 /********** text I/O **********/
 
+/*
+	Most text files are read as 8-bit text (UTF-8 or one of the single-byte encodings),
+	in which every byte below 128 stands for the ASCII character with the same code.
+	The readers below therefore look at those bytes directly,
+	and leave only the other characters to be decoded by MelderReadText_getChar ().
+	Numbers are parsed where they stand in the text, without being copied into a buffer first.
+*/
+
+static inline char32 getChar (MelderReadText me) {
+	if (my readPointer8) {
+		const char8 byte = (char8) * my readPointer8;
+		if (byte < 0x80) {
+			if (byte != '\0')
+				my readPointer8 ++;
+			return (char32) byte;
+		}
+	}
+	return MelderReadText_getChar (me);
+}
+
+/*
+	Skip the rest of an end-of-line comment, including the line break, which is returned;
+	returns U'\0' if the text ends before the end of the line.
+*/
+static char32 skipComment (MelderReadText me) {
+	if (my readPointer8) {
+		my readPointer8 += strcspn (my readPointer8, "\n\r");   // no byte of a multibyte UTF-8 character looks like a line break
+		return getChar (me);
+	}
+	char32 c;
+	while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r' && c != U'\0') { }
+	return c;
+}
+
+static void appendAsciiCharacters (MelderString *me, const char *first, const char *last) {
+	const int64 sizeNeeded = my length + (last - first) + 1;
+	if (sizeNeeded > my bufferSize)
+		MelderString_expand (me, sizeNeeded);
+	for (const char *p = first; p < last; p ++)
+		my string [my length ++] = (char32) (char8) *p;
+	my string [my length] = U'\0';
+}
+
+/*
+	Having read the first character `c` of a number, find the rest of it, up to the next space or the end of the text,
+	and read past that space. Returns the number of characters, which point into the text in the case of 8-bit text,
+	and are copied into `buffer` (of at least 41 characters) otherwise.
+*/
+static integer getNumberText (MelderReadText me, char32 c, char *buffer, const char **out_first, conststring32 what) {
+	constexpr integer maximumLength = 40;
+	if (my readPointer8) {
+		const char *first = my readPointer8 - 1;   // `c` is the ASCII character just read
+		char *last = my readPointer8;
+		while ((char8) *last != '\0' && (char8) *last < 0x80 && ! Melder_isHorizontalOrVerticalSpace ((char32) (char8) *last))
+			last ++;
+		if (last - first > maximumLength)
+			Melder_throw (U"Found long text while looking for ", what, U" in text (line ", MelderReadText_getLineNumber (me), U").");
+		my readPointer8 = last;
+		if (*last != '\0' && ! Melder_isHorizontalOrVerticalSpace (getChar (me)))   // the space may be non-ASCII, e.g. a no-break space
+			Melder_throw (U"Found ", last - first == maximumLength ? U"long" : U"strange",
+				U" text while looking for ", what, U" in text (line ", MelderReadText_getLineNumber (me), U").");
+		*out_first = first;
+		return last - first;
+	}
+	integer i = 0;
+	for (; i < maximumLength; i ++) {
+		if (c > 127)
+			Melder_throw (U"Found strange text while looking for ", what, U" in text (line ", MelderReadText_getLineNumber (me), U").");
+		buffer [i] = (char) (char8) c;   // guarded conversion down
+		c = MelderReadText_getChar (me);
+		if (c == U'\0') { break; }   // this may well be OK here
+		if (Melder_isHorizontalOrVerticalSpace (c)) break;
+	}
+	if (i >= maximumLength)
+		Melder_throw (U"Found long text while looking for ", what, U" in text (line ", MelderReadText_getLineNumber (me), U").");
+	buffer [i + 1] = '\0';
+	*out_first = buffer;
+	return i + 1;
+}
+
+static int64 parseInteger (const char *first, integer length) {
+	/*
+		Fast path: an optional sign and at most 18 digits, which cannot overflow.
+	*/
+	const char *p = first, *last = first + length;
+	const bool isNegative = ( p < last && *p == '-' );
+	if (p < last && (*p == '-' || *p == '+'))
+		p ++;
+	if (p < last && last - p <= 18) {
+		int64 value = 0;
+		for (; p < last && Melder_isAsciiDecimalNumber (*p); p ++)
+			value = 10 * value + (*p - '0');
+		if (p == last)
+			return isNegative ? - value : value;
+	}
+	char buffer [41];
+	memcpy (buffer, first, (size_t) length);
+	buffer [length] = '\0';
+	return strtoll (buffer, nullptr, 10);
+}
+
+static uint64 parseUnsigned (const char *first, integer length) {
+	/*
+		Fast path: an optional plus sign and at most 19 digits, which cannot overflow.
+	*/
+	const char *p = first, *last = first + length;
+	if (p < last && *p == '+')
+		p ++;
+	if (p < last && last - p <= 19) {
+		uint64 value = 0;
+		for (; p < last && Melder_isAsciiDecimalNumber (*p); p ++)
+			value = 10 * value + (uint64) (*p - '0');
+		if (p == last)
+			return value;
+	}
+	char buffer [41];
+	memcpy (buffer, first, (size_t) length);
+	buffer [length] = '\0';
+	return strtoull (buffer, nullptr, 10);
+}
+
+/*
+	Parse the text of a real number with the same result as Melder_a8tof ().
+	Most numbers in text files are plain decimal numbers with at most 15 or so significant digits:
+	if the digits fit in 53 bits and the power of ten is at most 22, the digits and the power of ten are exact doubles,
+	so that a single multiplication or division gives the correctly rounded result (Clinger's fast path).
+	This holds only if that operation is done in double precision itself; with x87 arithmetic
+	(FLT_EVAL_METHOD 2, e.g. on i686) the result would be rounded twice, so there we skip the fast path.
+	Other plain decimal numbers go to std::from_chars () where the C++ library has it, and everything else
+	(percentages, overflow, text that is not a number at all) to Melder_a8tof ().
+*/
+static double parseReal (const char *first, integer length) {
+	const char *p = first, *last = first + length;
+	const bool isNegative = ( p < last && *p == '-' );
+	if (p < last && (*p == '-' || *p == '+'))
+		p ++;
+	bool isPlainDecimal = ( p < last && Melder_isAsciiDecimalNumber (*p) );   // as in Melder_a8tof (), no ".5"
+	uint64 mantissa = 0;
+	integer numberOfSignificantDigits = 0, exponent = 0;
+	for (; p < last && Melder_isAsciiDecimalNumber (*p); p ++) {
+		mantissa = 10 * mantissa + (uint64) (*p - '0');
+		if (mantissa != 0)
+			numberOfSignificantDigits ++;
+	}
+	if (p < last && *p == '.') {
+		for (p ++; p < last && Melder_isAsciiDecimalNumber (*p); p ++) {
+			mantissa = 10 * mantissa + (uint64) (*p - '0');
+			if (mantissa != 0)
+				numberOfSignificantDigits ++;
+			exponent --;
+		}
+	}
+	if (p < last && (*p == 'e' || *p == 'E')) {
+		p ++;
+		const bool exponentIsNegative = ( p < last && *p == '-' );
+		if (p < last && (*p == '-' || *p == '+'))
+			p ++;
+		if (! (p < last && Melder_isAsciiDecimalNumber (*p)))
+			isPlainDecimal = false;
+		integer explicitExponent = 0;
+		for (; p < last && Melder_isAsciiDecimalNumber (*p); p ++)
+			if (explicitExponent < 100'000)   // more would be out of range anyway
+				explicitExponent = 10 * explicitExponent + (*p - '0');
+		exponent += ( exponentIsNegative ? - explicitExponent : explicitExponent );
+	}
+	if (isPlainDecimal && p == last) {
+		#if defined (FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+			static constexpr double exactPowersOfTen [] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+				1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+			if (numberOfSignificantDigits <= 19 && mantissa <= (uint64) 1 << 53 && exponent >= -22 && exponent <= 22) {
+				const double value = ( exponent < 0 ?
+					(double) mantissa / exactPowersOfTen [- exponent] :
+					(double) mantissa * exactPowersOfTen [exponent]
+				);
+				return isNegative ? - value : value;
+			}
+		#endif
+		#if defined (__cpp_lib_to_chars)
+			double value;
+			const std::from_chars_result result = std::from_chars (*first == '+' ? first + 1 : first, last, value);
+			if (result.ec == std::errc () && result.ptr == last)
+				return value;
+		#endif
+	}
+	char buffer [41];
+	memcpy (buffer, first, (size_t) length);
+	buffer [length] = '\0';
+	return Melder_a8tof (buffer);
+}
+
 static int64 getInteger (MelderReadText me) {
 	char buffer [41];
 	char32 c;
 	/*
 	 * Look for the first numeric character.
 	 */
-	for (c = MelderReadText_getChar (me); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = MelderReadText_getChar (me)) {
+	for (c = getChar (me); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = getChar (me)) {
 		if (c == U'\0')
 			Melder_throw (U"Early end of text detected while looking for an integer (line ", MelderReadText_getLineNumber (me), U").");
 		if (c == U'!') {   // end-of-line comment?
-			while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r') {
-				if (c == 0)
-					Melder_throw (U"Early end of text detected in comment while looking for an integer (line ", MelderReadText_getLineNumber (me), U").");
-			}
+			if ((c = skipComment (me)) == U'\0')
+				Melder_throw (U"Early end of text detected in comment while looking for an integer (line ", MelderReadText_getLineNumber (me), U").");
 		}
 		if (c == U'\"')
 			Melder_throw (U"Found a string while looking for an integer in text (line ", MelderReadText_getLineNumber (me), U").");
@@ -45,35 +235,23 @@ static int64 getInteger (MelderReadText me) {
 		while (! Melder_isHorizontalOrVerticalSpace (c)) {
 			if (c == U'\0')
 				Melder_throw (U"Early end of text detected in comment (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+			c = getChar (me);
 		}
 	}
-	int i = 0;
-	for (; i < 40; i ++) {
-		if (c > 127)
-			Melder_throw (U"Found strange text while looking for an integer in text (line ", MelderReadText_getLineNumber (me), U").");
-		buffer [i] = (char) (char8) c;   // guarded conversion down
-		c = MelderReadText_getChar (me);
-		if (c == U'\0') { break; }   // this may well be OK here
-		if (Melder_isHorizontalOrVerticalSpace (c)) break;
-	}
-	if (i >= 40)
-		Melder_throw (U"Found long text while looking for an integer in text (line ", MelderReadText_getLineNumber (me), U").");
-	buffer [i + 1] = '\0';
-	return strtoll (buffer, nullptr, 10);
+	const char *first;
+	const integer length = getNumberText (me, c, buffer, & first, U"an integer");
+	return parseInteger (first, length);
 }
 
 static uint64 getUnsigned (MelderReadText me) {
 	char buffer [41];
 	char32 c;
-	for (c = MelderReadText_getChar (me); ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = MelderReadText_getChar (me)) {
+	for (c = getChar (me); ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = getChar (me)) {
 		if (c == U'\0')
 			Melder_throw (U"Early end of text detected while looking for an unsigned integer (line ", MelderReadText_getLineNumber (me), U").");
 		if (c == U'!') {   // end-of-line comment?
-			while ((c = MelderReadText_getChar (me)) != '\n' && c != '\r') {
-				if (c == U'\0')
-					Melder_throw (U"Early end of text detected in comment while looking for an unsigned integer (line ", MelderReadText_getLineNumber (me), U").");
-			}
+			if ((c = skipComment (me)) == U'\0')
+				Melder_throw (U"Early end of text detected in comment while looking for an unsigned integer (line ", MelderReadText_getLineNumber (me), U").");
 		}
 		if (c == U'\"')
 			Melder_throw (U"Found a string while looking for an unsigned integer in text (line ", MelderReadText_getLineNumber (me), U").");
@@ -84,37 +262,26 @@ static uint64 getUnsigned (MelderReadText me) {
 		while (! Melder_isHorizontalOrVerticalSpace (c)) {
 			if (c == U'\0')
 				Melder_throw (U"Early end of text detected in comment (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+			c = getChar (me);
 		}
 	}
-	int i = 0;
-	for (i = 0; i < 40; i ++) {
-		if (c > 127)
-			Melder_throw (U"Found strange text while looking for an unsigned integer in text (line ", MelderReadText_getLineNumber (me), U").");
-		buffer [i] = (char) (char8) c;   // guarded conversion down
-		c = MelderReadText_getChar (me);
-		if (c == U'\0') { break; }   // this may well be OK here
-		if (Melder_isHorizontalOrVerticalSpace (c)) break;
-	}
-	if (i >= 40)
-		Melder_throw (U"Found long text while searching for an unsigned integer in text (line ", MelderReadText_getLineNumber (me), U").");
-	buffer [i + 1] = '\0';
-	return strtoull (buffer, nullptr, 10);
+	const char *first;
+	const integer length = getNumberText (me, c, buffer, & first, U"an unsigned integer");
+	return parseUnsigned (first, length);
 }
 
 static double getReal (MelderReadText me) {
-	int i;
-	char buffer [41], *slash;
-	char32 c;
+	char buffer [41];
+	const char *first;
+	integer length;
 	do {
-		for (c = MelderReadText_getChar (me); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = MelderReadText_getChar (me)) {
+		char32 c;
+		for (c = getChar (me); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = getChar (me)) {
 			if (c == U'\0')
 				Melder_throw (U"Early end of text detected while looking for a real number (line ", MelderReadText_getLineNumber (me), U").");
 			if (c == U'!') {   // end-of-line comment?
-				while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r') {
-					if (c == U'\0')
-						Melder_throw (U"Early end of text detected in comment while looking for a real number (line ", MelderReadText_getLineNumber (me), U").");
-				}
+				if ((c = skipComment (me)) == U'\0')
+					Melder_throw (U"Early end of text detected in comment while looking for a real number (line ", MelderReadText_getLineNumber (me), U").");
 			}
 			if (c == U'\"')
 				Melder_throw (U"Found a string while looking for a real number in text (line ", MelderReadText_getLineNumber (me), U").");
@@ -123,30 +290,20 @@ static double getReal (MelderReadText me) {
 			while (! Melder_isHorizontalOrVerticalSpace (c)) {
 				if (c == U'\0')
 					Melder_throw (U"Early end of text detected in comment while looking for a real number (line ", MelderReadText_getLineNumber (me), U").");
-				c = MelderReadText_getChar (me);
+				c = getChar (me);
 			}
 		}
-		for (i = 0; i < 40; i ++) {
-			if (c > 127)
-				Melder_throw (U"Found strange text while looking for a real number in text (line ", MelderReadText_getLineNumber (me), U").");
-			buffer [i] = (char) (char8) c;   // guarded conversion down
-			c = MelderReadText_getChar (me);
-			if (c == U'\0') { break; }   // this may well be OK here
-			if (Melder_isHorizontalOrVerticalSpace (c)) break;
-		}
-		if (i >= 40)
-			Melder_throw (U"Found long text while searching for a real number in text (line ", MelderReadText_getLineNumber (me), U").");
-	} while (i == 0 && buffer [0] == '+');   // guard against single '+' symbols, which occur in complex numbers
-	buffer [i + 1] = '\0';
-	slash = strchr (buffer, '/');
+		length = getNumberText (me, c, buffer, & first, U"a real number");
+	} while (length == 1 && first [0] == '+');   // guard against single '+' symbols, which occur in complex numbers
+	const char *slash = (const char *) memchr (first, '/', (size_t) length);
 	if (slash) {
-		*slash = '\0';
-		double numerator = Melder_a8tof (buffer), denominator = Melder_a8tof (slash + 1);
+		const double numerator = parseReal (first, slash - first);
+		const double denominator = parseReal (slash + 1, first + length - (slash + 1));
 		if (isundef (numerator) || isundef (denominator) || denominator == 0.0)
 			return undefined;
 		return numerator / denominator;
 	}
-	return Melder_a8tof (buffer);
+	return parseReal (first, length);
 }
 
 static dcomplex getComplex (MelderReadText me) {
@@ -155,14 +312,12 @@ static dcomplex getComplex (MelderReadText me) {
 	integer ireal = 0, iimag = 0;
 	char32 c;
 	bool inExponent = false, inExponentNumber = false, separatorIsMinus = false;
-	for (c = MelderReadText_getChar (me); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = MelderReadText_getChar (me)) {
+	for (c = getChar (me); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = getChar (me)) {
 		if (c == U'\0')
 			Melder_throw (U"Early end of text detected while looking for a complex number (line ", MelderReadText_getLineNumber (me), U").");
 		if (c == U'!') {   // end-of-line comment?
-			while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r') {
-				if (c == U'\0')
-					Melder_throw (U"Early end of text detected in comment while looking for a complex number (line ", MelderReadText_getLineNumber (me), U").");
-			}
+			if ((c = skipComment (me)) == U'\0')
+				Melder_throw (U"Early end of text detected in comment while looking for a complex number (line ", MelderReadText_getLineNumber (me), U").");
 		}
 		if (c == U'\"')
 			Melder_throw (U"Found a string while looking for a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
@@ -171,7 +326,7 @@ static dcomplex getComplex (MelderReadText me) {
 		while (! Melder_isHorizontalOrVerticalSpace (c)) {
 			if (c == U'\0')
 				Melder_throw (U"Early end of text detected in comment while looking for a complex number (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+			c = getChar (me);
 		}
 	}
 	for (; ireal < 40; ireal ++) {
@@ -205,7 +360,7 @@ static dcomplex getComplex (MelderReadText me) {
 		if (c == 'e' || c == 'E')
 			inExponent = true;
 		realBuffer [ireal] = (char) (char8) c;   // guarded conversion down
-		c = MelderReadText_getChar (me);
+		c = getChar (me);
 		if (c == U'\0')
 			Melder_throw (U"Missing imaginary part in complex number (line ", MelderReadText_getLineNumber (me), U").");
 		if (Melder_isHorizontalOrVerticalSpace (c))
@@ -215,7 +370,7 @@ static dcomplex getComplex (MelderReadText me) {
 		Melder_throw (U"Found long text while searching for a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
 	realBuffer [ireal + 1] = '\0';
 	result. real (Melder_a8tof (realBuffer));
-	c = MelderReadText_getChar (me);
+	c = getChar (me);
 	if (c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+')
 		Melder_throw (U"Found strange text while looking for the imaginary part of a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
 	if (c == U'\0')
@@ -223,10 +378,8 @@ static dcomplex getComplex (MelderReadText me) {
 	if (Melder_isHorizontalOrVerticalSpace (c))
 		Melder_throw (U"Found a space within a complex number (line ", MelderReadText_getLineNumber (me), U").");
 	if (c == U'!') {   // end-of-line comment?
-		while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r') {
-			if (c == U'\0')
-				Melder_throw (U"Early end of text detected in comment while looking for the imaginary part of a complex number (line ", MelderReadText_getLineNumber (me), U").");
-		}
+		if ((c = skipComment (me)) == U'\0')
+			Melder_throw (U"Early end of text detected in comment while looking for the imaginary part of a complex number (line ", MelderReadText_getLineNumber (me), U").");
 	}
 	if (c == U'\"')
 		Melder_throw (U"Found a string while looking for the imaginary part of a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
@@ -236,7 +389,7 @@ static dcomplex getComplex (MelderReadText me) {
 		if (c > 127)
 			Melder_throw (U"Found strange text while looking for the imaginary part of a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
 		imaginaryBuffer [iimag] = (char) (char8) c;   // guarded conversion down
-		c = MelderReadText_getChar (me);
+		c = getChar (me);
 		if (c == U'\0')
 			Melder_throw (U"Missing i in a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
 		if (Melder_isHorizontalOrVerticalSpace (c))
@@ -253,14 +406,12 @@ static dcomplex getComplex (MelderReadText me) {
 
 static int getEnum (MelderReadText me, int (*getValue) (conststring32)) {
 	char32 buffer [41], c;
-	for (c = MelderReadText_getChar (me); c != U'<'; c = MelderReadText_getChar (me)) {
+	for (c = getChar (me); c != U'<'; c = getChar (me)) {
 		if (c == U'\0')
 			Melder_throw (U"Early end of text detected while looking for an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
 		if (c == U'!') {   /* End-of-line comment? */
-			while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r') {
-				if (c == U'\0')
-					Melder_throw (U"Early end of text detected in comment while looking for an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
-			}
+			if ((c = skipComment (me)) == U'\0')
+				Melder_throw (U"Early end of text detected in comment while looking for an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
 		}
 		if (c == U'-' || Melder_isAsciiDecimalNumber (c) || c == U'+')
 			Melder_throw (U"Found a number while looking for an enumerated value in text (line ", MelderReadText_getLineNumber (me), U").");
@@ -269,12 +420,12 @@ static int getEnum (MelderReadText me, int (*getValue) (conststring32)) {
 		while (! Melder_isHorizontalOrVerticalSpace (c)) {
 			if (c == U'\0')
 				Melder_throw (U"Early end of text detected in comment while looking for an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+			c = getChar (me);
 		}
 	}
 	int i = 0;
 	for (; i < 40; i ++) {
-		c = MelderReadText_getChar (me);   // read past first '<'
+		c = getChar (me);   // read past first '<'
 		if (c == U'\0')
 			Melder_throw (U"Early end of text detected while reading an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
 		constexpr char32 theOnlySpaceAllowedInAnEnum = U' ';
@@ -294,16 +445,14 @@ static int getEnum (MelderReadText me, int (*getValue) (conststring32)) {
 }
 
 static char32 * peekString (MelderReadText me) {
-	static MelderString buffer;
+	static thread_local MelderString buffer;
 	MelderString_empty (& buffer);
-	for (char32 c = MelderReadText_getChar (me); c != U'\"'; c = MelderReadText_getChar (me)) {
+	for (char32 c = getChar (me); c != U'\"'; c = getChar (me)) {
 		if (c == U'\0')
 			Melder_throw (U"Early end of text detected while looking for a string (line ", MelderReadText_getLineNumber (me), U").");
 		if (c == U'!') {   // end-of-line comment?
-			while ((c = MelderReadText_getChar (me)) != '\n' && c != '\r') {
-				if (c == U'\0')
-					Melder_throw (U"Early end of text detected in comment while looking for a string (line ", MelderReadText_getLineNumber (me), U").");
-			}
+			if ((c = skipComment (me)) == U'\0')
+				Melder_throw (U"Early end of text detected in comment while looking for a string (line ", MelderReadText_getLineNumber (me), U").");
 		}
 		if (c == U'-' || Melder_isAsciiDecimalNumber (c) || c == U'+')
 			Melder_throw (U"Found a number while looking for a string in text (line ", MelderReadText_getLineNumber (me), U").");
@@ -312,15 +461,25 @@ static char32 * peekString (MelderReadText me) {
 		while (! Melder_isHorizontalOrVerticalSpace (c)) {
 			if (c == U'\0')
 				Melder_throw (U"Early end of text detected while looking for a string (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+			c = getChar (me);
 		}
 	}
-	for (int i = 0; 1; i ++) {
-		char32 c = MelderReadText_getChar (me);   // read past first '"'
+	for (;;) {
+		if (my readPointer8) {
+			/*
+				Copy the ASCII characters up to the next quote in one go.
+			*/
+			char *last = my readPointer8;
+			while ((char8) *last != '\0' && (char8) *last < 0x80 && *last != '\"')
+				last ++;
+			appendAsciiCharacters (& buffer, my readPointer8, last);
+			my readPointer8 = last;
+		}
+		char32 c = getChar (me);   // read past first '"'
 		if (c == U'\0')
 			Melder_throw (U"Early end of text detected while reading a string (line ", MelderReadText_getLineNumber (me), U").");
 		if (c == U'\"') {
-			char32 next = MelderReadText_getChar (me);
+			char32 next = getChar (me);
 			if (next == U'\0') { break; }   // closing quote is last character in file: OK
 			if (next != U'\"') {
 				if (Melder_isHorizontalOrVerticalSpace (next)) {
@@ -1754,6 +1913,153 @@ void binputc128 (dcomplex z, FILE *f) {
 	}
 }
 
+/*
+	Bulk versions of bingetr32, bingetr64, binputr32 and binputr64 for the tensor I/O routines.
+	They read or write the bytes of a whole chunk of numbers at once, and swap them in a simple loop
+	that the compiler can vectorize. Their results are bit-identical to those of the portable
+	(Melder_debug == 18) versions of the single-number routines above:
+	when reading, NaN's and infinities become `undefined`;
+	when writing, -0.0 becomes +0.0, NaN's become +infinity, and 32-bit mantissas are truncated rather than rounded.
+	This relies on `double` and `uint64` having the same byte order, which is true on all IEEE machines.
+*/
+static_assert (std::numeric_limits <double>::is_iec559, "The bulk binary I/O routines need IEEE doubles.");
+static constexpr integer binario_numberOfNumbersPerChunk = 1024;
+
+void bingetr32 (VEC const& x, FILE *f) {
+	if (binario_floatIEEE4msb || Melder_debug == 18) {
+		for (integer i = 1; i <= x.size; i ++)
+			x [i] = bingetr32 (f);
+		return;
+	}
+	try {
+		uint8 bytes [4 * binario_numberOfNumbersPerChunk];
+		for (integer offset = 0; offset < x.size; offset += binario_numberOfNumbersPerChunk) {
+			const integer numberOfNumbers = std::min (binario_numberOfNumbersPerChunk, x.size - offset);
+			if (fread (bytes, 4, integer_to_uinteger (numberOfNumbers), f) != integer_to_uinteger (numberOfNumbers))
+				readError (f, U"a series of 32-bit floating-point numbers.");
+			for (integer i = 0; i < numberOfNumbers; i ++) {
+				const uint8 *b = & bytes [4 * i];
+				const uint32 bits = (uint32) b [0] << 24 | (uint32) b [1] << 16 | (uint32) b [2] << 8 | (uint32) b [3];
+				float value;
+				memcpy (& value, & bits, 4);
+				x.cells [offset + i] = ( (bits & 0x7F80'0000) == 0x7F80'0000 ? undefined : (double) value );
+			}
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not read from 4 bytes each in binary file.");
+	}
+}
+
+void bingetr64 (VEC const& x, FILE *f) {
+	if (binario_doubleIEEE8msb || Melder_debug == 18 || Melder_debug == 181) {
+		for (integer i = 1; i <= x.size; i ++)
+			x [i] = bingetr64 (f);
+		return;
+	}
+	try {
+		uint8 bytes [8 * binario_numberOfNumbersPerChunk];
+		for (integer offset = 0; offset < x.size; offset += binario_numberOfNumbersPerChunk) {
+			const integer numberOfNumbers = std::min (binario_numberOfNumbersPerChunk, x.size - offset);
+			if (fread (bytes, 8, integer_to_uinteger (numberOfNumbers), f) != integer_to_uinteger (numberOfNumbers))
+				readError (f, U"a series of 64-bit floating-point numbers.");
+			for (integer i = 0; i < numberOfNumbers; i ++) {
+				const uint8 *b = & bytes [8 * i];
+				const uint64 bits =
+					(uint64) b [0] << 56 | (uint64) b [1] << 48 | (uint64) b [2] << 40 | (uint64) b [3] << 32 |
+					(uint64) b [4] << 24 | (uint64) b [5] << 16 | (uint64) b [6] << 8 | (uint64) b [7];
+				double value;
+				memcpy (& value, & bits, 8);
+				x.cells [offset + i] = ( (bits & 0x7FF0'0000'0000'0000) == 0x7FF0'0000'0000'0000 ? undefined : value );
+			}
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not read from 8 bytes each in binary file.");
+	}
+}
+
+void binputr32 (constVEC const& x, FILE *f) {
+	if (binario_floatIEEE4msb || Melder_debug == 18) {
+		for (integer i = 1; i <= x.size; i ++)
+			binputr32 (x [i], f);
+		return;
+	}
+	try {
+		uint8 bytes [4 * binario_numberOfNumbersPerChunk];
+		for (integer offset = 0; offset < x.size; offset += binario_numberOfNumbersPerChunk) {
+			const integer numberOfNumbers = std::min (binario_numberOfNumbersPerChunk, x.size - offset);
+			for (integer i = 0; i < numberOfNumbers; i ++) {
+				const double value = x.cells [offset + i];
+				const uint32 sign = ( value < 0.0 ? 0x8000'0000 : 0 );
+				const double magnitude = fabs (value);
+				uint32 bits;
+				if (magnitude == 0.0)
+					bits = 0;
+				else if (! (magnitude < 0x1p128))   // too large, infinity, or Not-a-Number
+					bits = sign | 0x7F80'0000;   // infinity
+				else if (magnitude >= 0x1p-126) {   // normalized: truncate the mantissa
+					uint64 doubleBits;
+					memcpy (& doubleBits, & magnitude, 8);
+					const uint32 exponent = (uint32) (doubleBits >> 52) - (1023 - 127);
+					bits = sign | exponent << 23 | ((uint32) (doubleBits >> 29) & 0x007F'FFFF);
+				} else   // denormalized: truncate as well
+					bits = sign | (uint32) (magnitude * 0x1p149);
+				uint8 *b = & bytes [4 * i];
+				b [0] = (uint8) (bits >> 24);
+				b [1] = (uint8) (bits >> 16);
+				b [2] = (uint8) (bits >> 8);
+				b [3] = (uint8) bits;
+			}
+			if (fwrite (bytes, 4, integer_to_uinteger (numberOfNumbers), f) != integer_to_uinteger (numberOfNumbers))
+				writeError (U"a series of 32-bit floating-point numbers.");
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not written to 4 bytes each in binary file.");
+	}
+}
+
+void binputr64 (constVEC const& x, FILE *f) {
+	if (binario_doubleIEEE8msb || Melder_debug == 18 || Melder_debug == 181) {
+		for (integer i = 1; i <= x.size; i ++)
+			binputr64 (x [i], f);
+		return;
+	}
+	try {
+		/*
+			On machines where binputr64 merely swaps the bytes of a native double,
+			-0.0 and NaN's are written as they are, so we do the same here.
+		*/
+		constexpr bool normalize = ! binario_doubleIEEE8lsb;
+		uint8 bytes [8 * binario_numberOfNumbersPerChunk];
+		for (integer offset = 0; offset < x.size; offset += binario_numberOfNumbersPerChunk) {
+			const integer numberOfNumbers = std::min (binario_numberOfNumbersPerChunk, x.size - offset);
+			for (integer i = 0; i < numberOfNumbers; i ++) {
+				const double value = x.cells [offset + i];
+				uint64 bits;
+				memcpy (& bits, & value, 8);
+				if (normalize) {
+					if (value == 0.0)
+						bits = 0;
+					else if (isnan (value))
+						bits = 0x7FF0'0000'0000'0000;   // infinity
+				}
+				uint8 *b = & bytes [8 * i];
+				b [0] = (uint8) (bits >> 56);
+				b [1] = (uint8) (bits >> 48);
+				b [2] = (uint8) (bits >> 40);
+				b [3] = (uint8) (bits >> 32);
+				b [4] = (uint8) (bits >> 24);
+				b [5] = (uint8) (bits >> 16);
+				b [6] = (uint8) (bits >> 8);
+				b [7] = (uint8) bits;
+			}
+			if (fwrite (bytes, 8, integer_to_uinteger (numberOfNumbers), f) != integer_to_uinteger (numberOfNumbers))
+				writeError (U"a series of 64-bit floating-point numbers.");
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not written to 8 bytes each in binary file.");
+	}
+}
+
 autostring8 bingets8 (FILE *f) {
 	try {
 		unsigned int length = bingetu8 (f);
@@ -187,6 +187,13 @@ dcomplex bingetc128 (FILE *f);
 void binputc64 (dcomplex z, FILE *f);
 void binputc128 (dcomplex z, FILE *f);
 
+void bingetr32 (VEC const& x, FILE *f);   void binputr32 (constVEC const& x, FILE *f);
+void bingetr64 (VEC const& x, FILE *f);   void binputr64 (constVEC const& x, FILE *f);
+/*
+	Read or write `x.size` real numbers in the same format as bingetr32/binputr32 or bingetr64/binputr64,
+	with a single fread or fwrite for every 1024 numbers.
+*/
+
 autostring8 bingets8 (FILE *f);   void binputs8 (const char *s, FILE *f);   // 0..255 characters
 autostring8 bingets16 (FILE *f);   void binputs16 (const char *s, FILE *f);   // 0..65535 characters
 autostring8 bingets32 (FILE *f);   void binputs32 (const char *s, FILE *f);   // 0..4294967295 characters
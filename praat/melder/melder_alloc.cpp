@@ -19,6 +19,9 @@
 #include "melder.h"
 #include <wctype.h>
 #include <assert.h>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 static int64 totalNumberOfAllocations = 0, totalNumberOfDeallocations = 0, totalAllocationSize = 0,
 	totalNumberOfMovingReallocs = 0, totalNumberOfReallocsInSitu = 0;
@@ -304,9 +307,43 @@ byte * MelderArray:: _alloc_generic (integer cellSize, integer numberOfCells, kI
 	}
 }
 
+namespace MelderArray { // reopen
+	struct ForeignCells {
+		void (*release) (void *closure);
+		void *closure;
+	};
+	static std::mutex theForeignCellsMutex;
+	static std::unordered_multimap <byte *, ForeignCells> theForeignCells;
+	static std::atomic <integer> theNumberOfForeignCells (0);   // lets _free_generic skip the lookup in the common case
+}
+
+void MelderArray:: _registerForeignCells_generic (byte *cells, void (*release) (void *closure), void *closure) {
+	Melder_assert (cells);
+	Melder_assert (release);
+	std::lock_guard <std::mutex> lock (theForeignCellsMutex);
+	theForeignCells. emplace (cells, ForeignCells { release, closure });
+	++ theNumberOfForeignCells;
+}
+
 void MelderArray:: _free_generic (byte *cells, integer numberOfCells) noexcept {
 	if (! cells)
 		return;   // not an error
+	if (theNumberOfForeignCells > 0) {
+		ForeignCells foreign { nullptr, nullptr };
+		{
+			std::lock_guard <std::mutex> lock (theForeignCellsMutex);
+			auto found = theForeignCells. find (cells);
+			if (found != theForeignCells. end ()) {
+				foreign = found -> second;
+				theForeignCells. erase (found);
+				-- theNumberOfForeignCells;
+			}
+		}
+		if (foreign. release) {
+			foreign. release (foreign. closure);
+			return;
+		}
+	}
 	Melder_free (cells);
 	MelderArray::deallocationCount += 1;
 	MelderArray::cellDeallocationCount += numberOfCells;
@@ -87,6 +87,18 @@ namespace MelderArray {
 		_free_generic (reinterpret_cast <byte *> (cells), numberOfCells);
 	}
 
+	/*
+		Cells that belong to somebody else (e.g. to a NumPy array) can be lent to a vector or matrix.
+		When the tensor lets go of them (on destruction, on resizing, or on assignment),
+		`release (closure)` is called instead of freeing them.
+	*/
+	void _registerForeignCells_generic (byte *cells, void (*release) (void *closure), void *closure);
+
+	template <class T>
+	void _registerForeignCells (T* cells, void (*release) (void *closure), void *closure) {
+		_registerForeignCells_generic (reinterpret_cast <byte *> (cells), release, closure);
+	}
+
 }
 
 int64 MelderArray_allocationCount ();
@@ -17,6 +17,11 @@
  */
 
 #include "melder.h"
+#if defined (UNIX) || defined (macintosh)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 #include "../external/flac/flac_FLAC_metadata.h"
 #include "../external/flac/flac_FLAC_stream_decoder.h"
 #include "../external/flac/flac_FLAC_stream_encoder.h"
@@ -880,378 +885,315 @@ static void Melder_readMp3File (FILE *f, MAT buffer) {
 		Melder_throw (U"Error decoding MP3 file.");
 }
 
+/*
+	Uncompressed samples are decoded in blocks of about a megabyte:
+	one fread (or a memory mapping of the file) per block, after which the block is converted channel by channel,
+	in loops that are simple enough for the compiler to vectorize.
+*/
+
+template <typename Decode>
+static void decodeSamples (const uint8 *bytes, integer numberOfBytesPerSamplePoint, MAT const& buffer,
+	integer firstSample, integer numberOfSamples, Decode decode)
+{
+	const integer numberOfChannels = buffer.nrow;
+	const integer stride = numberOfChannels * numberOfBytesPerSamplePoint;
+	for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
+		const uint8 *from = bytes + (ichan - 1) * numberOfBytesPerSamplePoint;
+		double *to = & buffer [ichan] [firstSample];
+		for (integer isamp = 0; isamp < numberOfSamples; isamp ++)
+			to [isamp] = decode (from + isamp * stride);
+	}
+}
+
+static inline double floatFromBits (uint32 bits) {
+	float value;
+	memcpy (& value, & bits, sizeof (float));
+	return isfinite (value) ? value : undefined;
+}
+
+static inline double doubleFromBits (uint64 bits) {
+	double value;
+	memcpy (& value, & bits, sizeof (double));
+	return isfinite (value) ? value : undefined;
+}
+
+static void decodeUncompressedAudio (const uint8 *bytes, int encoding, MAT const& buffer, integer firstSample, integer numberOfSamples) {
+	const integer b = Melder_bytesPerSamplePoint (encoding);
+	switch (encoding) {
+		case Melder_LINEAR_8_SIGNED:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				return (int8) p [0] * (1.0 / 128);
+			});
+			break;
+		case Melder_LINEAR_8_UNSIGNED:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				return p [0] * (1.0 / 128) - 1.0;
+			});
+			break;
+		case Melder_LINEAR_16_BIG_ENDIAN:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				return (int16) (uint16) ((uint16) p [0] << 8 | (uint16) p [1]) * (1.0 / 32768);
+			});
+			break;
+		case Melder_LINEAR_16_LITTLE_ENDIAN:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				return (int16) (uint16) ((uint16) p [1] << 8 | (uint16) p [0]) * (1.0 / 32768);
+			});
+			break;
+		case Melder_LINEAR_24_BIG_ENDIAN:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				return (int32) ((uint32) p [0] << 24 | (uint32) p [1] << 16 | (uint32) p [2] << 8) * (1.0 / 32768 / 65536);
+			});
+			break;
+		case Melder_LINEAR_24_LITTLE_ENDIAN:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				return (int32) ((uint32) p [2] << 24 | (uint32) p [1] << 16 | (uint32) p [0] << 8) * (1.0 / 32768 / 65536);
+			});
+			break;
+		case Melder_LINEAR_32_BIG_ENDIAN:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				return (int32) ((uint32) p [0] << 24 | (uint32) p [1] << 16 | (uint32) p [2] << 8 | (uint32) p [3]) * (1.0 / 32768 / 65536);
+			});
+			break;
+		case Melder_LINEAR_32_LITTLE_ENDIAN:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				return (int32) ((uint32) p [3] << 24 | (uint32) p [2] << 16 | (uint32) p [1] << 8 | (uint32) p [0]) * (1.0 / 32768 / 65536);
+			});
+			break;
+		case Melder_IEEE_FLOAT_32_BIG_ENDIAN:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				return floatFromBits ((uint32) p [0] << 24 | (uint32) p [1] << 16 | (uint32) p [2] << 8 | (uint32) p [3]);
+			});
+			break;
+		case Melder_IEEE_FLOAT_32_LITTLE_ENDIAN:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				return floatFromBits ((uint32) p [3] << 24 | (uint32) p [2] << 16 | (uint32) p [1] << 8 | (uint32) p [0]);
+			});
+			break;
+		case Melder_IEEE_FLOAT_64_BIG_ENDIAN:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				uint64 bits = 0;
+				for (int ibyte = 0; ibyte < 8; ibyte ++)
+					bits = bits << 8 | (uint64) p [ibyte];
+				return doubleFromBits (bits);
+			});
+			break;
+		case Melder_IEEE_FLOAT_64_LITTLE_ENDIAN:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				uint64 bits = 0;
+				for (int ibyte = 7; ibyte >= 0; ibyte --)
+					bits = bits << 8 | (uint64) p [ibyte];
+				return doubleFromBits (bits);
+			});
+			break;
+		case Melder_MULAW:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				return ulaw2linear [p [0]] * (1.0 / 32768);
+			});
+			break;
+		case Melder_ALAW:
+			decodeSamples (bytes, b, buffer, firstSample, numberOfSamples, [] (const uint8 *p) {
+				return alaw2linear [p [0]] * (1.0 / 32768);
+			});
+			break;
+		default:
+			Melder_fatal (U"decodeUncompressedAudio: unknown encoding ", encoding, U".");
+	}
+}
+
+static conststring32 uncompressedEncodingDescription (int encoding) {
+	return
+		encoding == Melder_LINEAR_8_SIGNED || encoding == Melder_LINEAR_8_UNSIGNED ? U"8-bit" :
+		encoding == Melder_IEEE_FLOAT_32_BIG_ENDIAN || encoding == Melder_IEEE_FLOAT_32_LITTLE_ENDIAN ? U"32-bit floating point" :
+		encoding == Melder_IEEE_FLOAT_64_BIG_ENDIAN || encoding == Melder_IEEE_FLOAT_64_LITTLE_ENDIAN ? U"64-bit floating point" :
+		encoding == Melder_MULAW ? U"8-bit µ-law" :
+		encoding == Melder_ALAW ? U"8-bit A-law" :
+		encoding == Melder_LINEAR_16_BIG_ENDIAN || encoding == Melder_LINEAR_16_LITTLE_ENDIAN ? U"16-bit" :
+		encoding == Melder_LINEAR_24_BIG_ENDIAN || encoding == Melder_LINEAR_24_LITTLE_ENDIAN ? U"24-bit" : U"32-bit";
+}
+
+constexpr integer theNumberOfBytesPerDecodingBlock = 1 << 20;
+
+/*
+	Decodes samples 1 .. numberOfSamples from bytes that are already in memory (e.g. a mapping of the file),
+	a block at a time, so that each block stays in the cache while it is converted channel by channel.
+*/
+static void decodeUncompressedAudioInBlocks (const uint8 *bytes, int encoding, MAT const& buffer, integer numberOfSamples) {
+	const integer numberOfBytesPerSample = buffer.nrow * Melder_bytesPerSamplePoint (encoding);   // all channels
+	const integer numberOfSamplesPerBlock = Melder_clipped (1_integer, theNumberOfBytesPerDecodingBlock / numberOfBytesPerSample, numberOfSamples);
+	for (integer numberOfSamplesDecoded = 0; numberOfSamplesDecoded < numberOfSamples; numberOfSamplesDecoded += numberOfSamplesPerBlock) {
+		const integer numberOfSamplesToDecode = std::min (numberOfSamplesPerBlock, numberOfSamples - numberOfSamplesDecoded);
+		decodeUncompressedAudio (bytes + numberOfSamplesDecoded * numberOfBytesPerSample, encoding, buffer,
+				numberOfSamplesDecoded + 1, numberOfSamplesToDecode);
+	}
+}
+
+static void setMissingSamplesToZero (int encoding, MAT const& buffer, integer numberOfSamplesRead) {
+	if (numberOfSamplesRead >= buffer.ncol)
+		return;
+	buffer.verticalBand (numberOfSamplesRead + 1, buffer.ncol)  <<=  0.0;
+	Melder_warning (U"File too small (", buffer.nrow, U"-channel ", uncompressedEncodingDescription (encoding), U").\n"
+		U"Missing samples set to zero.");
+}
+
+static void Melder_readUncompressedAudioToFloat (FILE *f, int encoding, MAT buffer) {
+	const integer numberOfChannels = buffer.nrow, numberOfSamples = buffer.ncol;
+	if (numberOfChannels <= 0 || numberOfSamples <= 0)
+		return;
+	const integer numberOfBytesPerSample = numberOfChannels * Melder_bytesPerSamplePoint (encoding);   // all channels
+	const double numberOfBytes_f = (double) numberOfSamples * (double) numberOfBytesPerSample;
+	if (isinf (numberOfBytes_f) || numberOfBytes_f > (double) (1LL << 53))
+		Melder_throw (U"Cannot read ", numberOfBytes_f, U" bytes, because that crosses the 9-petabyte limit.");
+	if (numberOfBytes_f > (double) SIZE_MAX)
+		Melder_throw (U"Cannot read ", numberOfBytes_f, U" bytes. Perhaps try a 64-bit edition of Praat?");
+	integer numberOfSamplesRead = 0;
+	bool haveMappedTheFile = false;
+	#if defined (UNIX) || defined (macintosh)
+		/*
+			A large read from a regular file is decoded straight from a read-only mapping of the file,
+			which saves copying the bytes into a block first.
+		*/
+		const off_t position = ftello (f);
+		struct stat fileStatus;
+		if (numberOfBytes_f >= theNumberOfBytesPerDecodingBlock && position >= 0 &&
+			fstat (fileno (f), & fileStatus) == 0 && S_ISREG (fileStatus.st_mode) && fileStatus.st_size > position)
+		{
+			const off_t pageSize = sysconf (_SC_PAGESIZE);
+			const off_t startOfMapping = position - position % pageSize;
+			const integer numberOfAvailableSamples = std::min (numberOfSamples,
+					integer ((fileStatus.st_size - position) / numberOfBytesPerSample));
+			const size_t sizeOfMapping = size_t (position - startOfMapping) + size_t (numberOfAvailableSamples) * size_t (numberOfBytesPerSample);
+			void *mapping = ( numberOfAvailableSamples > 0 ?
+					mmap (nullptr, sizeOfMapping, PROT_READ, MAP_PRIVATE, fileno (f), startOfMapping) : MAP_FAILED );
+			if (mapping != MAP_FAILED) {
+				posix_madvise (mapping, sizeOfMapping, POSIX_MADV_SEQUENTIAL);
+				decodeUncompressedAudioInBlocks ((const uint8 *) mapping + (position - startOfMapping), encoding, buffer, numberOfAvailableSamples);
+				numberOfSamplesRead = numberOfAvailableSamples;
+				munmap (mapping, sizeOfMapping);
+				fseeko (f, position + off_t (numberOfSamplesRead) * numberOfBytesPerSample, SEEK_SET);
+				haveMappedTheFile = true;
+			}
+		}
+	#endif
+	if (! haveMappedTheFile) {
+		const integer numberOfSamplesPerBlock = Melder_clipped (1_integer, theNumberOfBytesPerDecodingBlock / numberOfBytesPerSample, numberOfSamples);
+		autovector <uint8> block = newvectorraw <uint8> (numberOfSamplesPerBlock * numberOfBytesPerSample);
+		while (numberOfSamplesRead < numberOfSamples) {
+			const integer numberOfSamplesToRead = std::min (numberOfSamplesPerBlock, numberOfSamples - numberOfSamplesRead);
+			const size_t numberOfBytesToRead = size_t (numberOfSamplesToRead) * size_t (numberOfBytesPerSample);
+			const size_t numberOfBytesRead = fread (block.asArgumentToFunctionThatExpectsZeroBasedArray(), 1, numberOfBytesToRead, f);
+			const integer numberOfCompleteSamples = integer (numberOfBytesRead / size_t (numberOfBytesPerSample));
+			decodeUncompressedAudio (block.asArgumentToFunctionThatExpectsZeroBasedArray(), encoding, buffer,
+					numberOfSamplesRead + 1, numberOfCompleteSamples);
+			numberOfSamplesRead += numberOfCompleteSamples;
+			if (numberOfBytesRead < numberOfBytesToRead)
+				break;
+		}
+	}
+	setMissingSamplesToZero (encoding, buffer, numberOfSamplesRead);
+}
+
+void Melder_decodeAudioToFloat (const uint8 *bytes, integer numberOfBytes, int encoding, MAT buffer) {
+	const integer numberOfChannels = buffer.nrow, numberOfSamples = buffer.ncol;
+	if (numberOfChannels <= 0 || numberOfSamples <= 0)
+		return;
+	const integer numberOfBytesPerSample = numberOfChannels * Melder_bytesPerSamplePoint (encoding);   // all channels
+	const integer numberOfAvailableSamples = Melder_clipped (0_integer, numberOfBytes / numberOfBytesPerSample, numberOfSamples);
+	decodeUncompressedAudioInBlocks (bytes, encoding, buffer, numberOfAvailableSamples);
+	setMissingSamplesToZero (encoding, buffer, numberOfAvailableSamples);
+}
+
+void Melder_decodeAudioToShort (const uint8 *bytes, integer numberOfBytes, integer numberOfChannels, int encoding, short *buffer, integer numberOfSamples) {
+	const integer numberOfBytesPerSamplePoint = Melder_bytesPerSamplePoint (encoding);
+	const integer numberOfAvailableSamples = Melder_clipped (0_integer, numberOfBytes / (numberOfChannels * numberOfBytesPerSamplePoint), numberOfSamples);
+	const integer numberOfValues = numberOfAvailableSamples * numberOfChannels;   // the channels are interleaved, both in the file and in the buffer
+	/*
+		The same conversions (and truncations) as in Melder_readAudioToShort ().
+	*/
+	auto decode = [&] (auto decodeValue) {
+		for (integer i = 0; i < numberOfValues; i ++)
+			buffer [i] = decodeValue (bytes + i * numberOfBytesPerSamplePoint);
+	};
+	switch (encoding) {
+		case Melder_LINEAR_8_SIGNED:
+			decode ([] (const uint8 *p) { return (short) ((int8) p [0] * 256); });
+			break;
+		case Melder_LINEAR_8_UNSIGNED:
+			decode ([] (const uint8 *p) { return (short) (p [0] * 256L - 32768); });
+			break;
+		case Melder_LINEAR_16_BIG_ENDIAN:
+			decode ([] (const uint8 *p) { return (short) (int16) (uint16) ((uint16) p [0] << 8 | (uint16) p [1]); });
+			break;
+		case Melder_LINEAR_16_LITTLE_ENDIAN:
+			decode ([] (const uint8 *p) { return (short) (int16) (uint16) ((uint16) p [1] << 8 | (uint16) p [0]); });
+			break;
+		case Melder_LINEAR_24_BIG_ENDIAN:
+			decode ([] (const uint8 *p) { return (short) (((int32) ((uint32) p [0] << 24 | (uint32) p [1] << 16 | (uint32) p [2] << 8) >> 8) / 256); });
+			break;
+		case Melder_LINEAR_24_LITTLE_ENDIAN:
+			decode ([] (const uint8 *p) { return (short) (((int32) ((uint32) p [2] << 24 | (uint32) p [1] << 16 | (uint32) p [0] << 8) >> 8) / 256); });
+			break;
+		case Melder_LINEAR_32_BIG_ENDIAN:
+			decode ([] (const uint8 *p) { return (short) ((int32) ((uint32) p [0] << 24 | (uint32) p [1] << 16 | (uint32) p [2] << 8 | (uint32) p [3]) / 65536); });
+			break;
+		case Melder_LINEAR_32_LITTLE_ENDIAN:
+			decode ([] (const uint8 *p) { return (short) ((int32) ((uint32) p [3] << 24 | (uint32) p [2] << 16 | (uint32) p [1] << 8 | (uint32) p [0]) / 65536); });
+			break;
+		case Melder_IEEE_FLOAT_32_BIG_ENDIAN:
+			decode ([] (const uint8 *p) { return (short) (floatFromBits ((uint32) p [0] << 24 | (uint32) p [1] << 16 | (uint32) p [2] << 8 | (uint32) p [3]) * 32768); });
+			break;
+		case Melder_IEEE_FLOAT_32_LITTLE_ENDIAN:
+			decode ([] (const uint8 *p) { return (short) (floatFromBits ((uint32) p [3] << 24 | (uint32) p [2] << 16 | (uint32) p [1] << 8 | (uint32) p [0]) * 32768); });
+			break;
+		case Melder_IEEE_FLOAT_64_BIG_ENDIAN:
+			decode ([] (const uint8 *p) {
+				uint64 bits = 0;
+				for (int ibyte = 0; ibyte < 8; ibyte ++)
+					bits = bits << 8 | (uint64) p [ibyte];
+				return (short) (doubleFromBits (bits) * 32768);
+			});
+			break;
+		case Melder_IEEE_FLOAT_64_LITTLE_ENDIAN:
+			decode ([] (const uint8 *p) {
+				uint64 bits = 0;
+				for (int ibyte = 7; ibyte >= 0; ibyte --)
+					bits = bits << 8 | (uint64) p [ibyte];
+				return (short) (doubleFromBits (bits) * 32768);
+			});
+			break;
+		case Melder_MULAW:
+			decode ([] (const uint8 *p) { return (short) ulaw2linear [p [0]]; });
+			break;
+		case Melder_ALAW:
+			decode ([] (const uint8 *p) { return (short) alaw2linear [p [0]]; });
+			break;
+		default:
+			Melder_fatal (U"Melder_decodeAudioToShort: unknown or compressed encoding ", encoding, U".");
+	}
+	if (numberOfAvailableSamples < numberOfSamples) {
+		std::fill (buffer + numberOfValues, buffer + numberOfSamples * numberOfChannels, (short) 0);
+		Melder_warning (U"Audio file too short. Missing samples were set to zero.");
+	}
+}
+
 void Melder_readAudioToFloat (FILE *f, int encoding, MAT buffer) {
 	try {
-		integer numberOfChannels = buffer.nrow;
-		integer numberOfSamples = buffer.ncol;
 		switch (encoding) {
-			case Melder_LINEAR_8_SIGNED: {
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							int8 value;
-							if (fread (& value, 1, 1, f) < 1) throw MelderError ();
-							buffer [ichan] [isamp] = value * (1.0 / 128);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 8-bit).\nMissing samples set to zero.");
-				}
-			} break;
+			case Melder_LINEAR_8_SIGNED:
 			case Melder_LINEAR_8_UNSIGNED:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++)
-							buffer [ichan] [isamp] = bingetu8 (f) * (1.0 / 128) - 1.0;
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 8-bit).\nMissing samples set to zero.");
-				}
-				break;
 			case Melder_LINEAR_16_BIG_ENDIAN:
 			case Melder_LINEAR_16_LITTLE_ENDIAN:
 			case Melder_LINEAR_24_BIG_ENDIAN:
 			case Melder_LINEAR_24_LITTLE_ENDIAN:
 			case Melder_LINEAR_32_BIG_ENDIAN:
 			case Melder_LINEAR_32_LITTLE_ENDIAN:
-			{
-				int numberOfBytesPerSamplePerChannel =
-					encoding == Melder_LINEAR_16_BIG_ENDIAN || encoding == Melder_LINEAR_16_LITTLE_ENDIAN ? 2 :
-					encoding == Melder_LINEAR_24_BIG_ENDIAN || encoding == Melder_LINEAR_24_LITTLE_ENDIAN ? 3 : 4;
-				double numberOfBytes_f = (double) numberOfChannels * (double) numberOfSamples * (double) numberOfBytesPerSamplePerChannel;
-				if (isinf (numberOfBytes_f) || numberOfBytes_f > (double) (1LL << 53)) {
-					Melder_throw (U"Cannot read ", numberOfBytes_f, U" bytes, "
-						U"because that crosses the 9-petabyte limit.");
-				}
-				if (numberOfBytes_f > (double) SIZE_MAX) {
-					Melder_throw (U"Cannot read ", numberOfBytes_f, U" bytes. "
-						U"Perhaps try a 64-bit edition of Praat?");
-				}
-				Melder_assert (numberOfBytes_f >= 0.0);
-				size_t numberOfBytes = (size_t) numberOfBytes_f;   // cast is safe because overflow and signedness have been checked
-				uint8 *bytes = (uint8 *) & buffer [numberOfChannels] [numberOfSamples] + sizeof (double) - numberOfBytes;
-				/*
-				 * Read 16-bit data into the last quarter of the buffer,
-				 * or 24-bit data into the last three-eighths of the buffer,
-				 * or 32-bit data into the last half of the buffer.
-				 */
-				size_t numberOfBytesRead = fread (bytes, 1, numberOfBytes, f);
-				if (numberOfChannels == 1) {
-					switch (encoding) {
-						case Melder_LINEAR_16_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								unsigned char byte1 = * bytes ++, byte2 = * bytes ++;
-								int value = (int) (int16) (((uint16) byte1 << 8) | (uint16) byte2);   // extend sign
-								buffer [1] [isamp] = value * (1.0 / 32768);
-							}
-						} break;
-						case Melder_LINEAR_16_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								unsigned char byte1 = * bytes ++, byte2 = * bytes ++;
-								int value = (int) (int16) (((uint16) byte2 << 8) | (uint16) byte1);   // extend sign
-								buffer [1] [isamp] = value * (1.0 / 32768);
-							}
-						} break;
-						case Melder_LINEAR_24_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								unsigned char byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++;
-								int32 value = (int32)
-									((uint32) ((uint32) byte1 << 24) |
-									 (uint32) ((uint32) byte2 << 16) |
-											  ((uint32) byte3 << 8));
-								buffer [1] [isamp] = value * (1.0 / 32768 / 65536);
-							}
-						} break;
-						case Melder_LINEAR_24_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								unsigned char byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++;
-								int32 value = (int32)
-									((uint32) ((uint32) byte3 << 24) |
-									 (uint32) ((uint32) byte2 << 16) |
-											  ((uint32) byte1 << 8));
-								buffer [1] [isamp] = value * (1.0 / 32768 / 65536);
-							}
-						} break;
-						case Melder_LINEAR_32_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								unsigned char byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++, byte4 = * bytes ++;
-								int32 value = (int32)
-									((uint32) ((uint32) byte1 << 24) |
-									 (uint32) ((uint32) byte2 << 16) |
-									 (uint32) ((uint32) byte3 << 8) |
-											   (uint32) byte4);
-								buffer [1] [isamp] = value * (1.0 / 32768 / 65536);
-							}
-						} break;
-						case Melder_LINEAR_32_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								unsigned char byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++, byte4 = * bytes ++;
-								int32 value = (int32)
-									((uint32) ((uint32) byte4 << 24) |
-									 (uint32) ((uint32) byte3 << 16) |
-									 (uint32) ((uint32) byte2 << 8) |
-											   (uint32) byte1);
-								buffer [1] [isamp] = value * (1.0 / 32768 / 65536);
-							}
-						} break;
-					}
-				} else if (numberOfChannels <= (int) sizeof (double) / numberOfBytesPerSamplePerChannel) {
-					switch (encoding) {
-						case Melder_LINEAR_16_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++;
-									int value = (int) (int16) (uint16) ((uint16) ((uint16) byte1 << 8) | (uint16) byte2);
-									buffer [ichan] [isamp] = value * (1.0 / 32768);
-								}
-							}
-						} break;
-						case Melder_LINEAR_16_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++;
-									int value = (int) (int16) (uint16) ((uint16) ((uint16) byte2 << 8) | (uint16) byte1);
-									buffer [ichan] [isamp] = value * (1.0 / 32768);
-								}
-							}
-						} break;
-						case Melder_LINEAR_24_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++;
-									uint32 unsignedValue =
-										(uint32) ((uint32) byte1 << 16) |
-										(uint32) ((uint32) byte2 << 8) |
-												  (uint32) byte3;
-									if ((byte1 & 128) != 0) unsignedValue |= 0xFF000000;   // extend sign
-									buffer [ichan] [isamp] = (int32) unsignedValue * (1.0 / 8388608);
-								}
-							}
-						} break;
-						case Melder_LINEAR_24_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++;
-									uint32 unsignedValue = ((uint32) byte3 << 16) | ((uint32) byte2 << 8) | (uint32) byte1;
-									if ((byte3 & 128) != 0) unsignedValue |= 0xFF000000;
-									buffer [ichan] [isamp] = (int32) unsignedValue * (1.0 / 8388608);
-								}
-							}
-						} break;
-						case Melder_LINEAR_32_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++, byte4 = * bytes ++;
-									int32 value = (int32)
-										((uint32) ((uint32) byte1 << 24) |
-										 (uint32) ((uint32) byte2 << 16) |
-										 (uint32) ((uint32) byte3 << 8) |
-												   (uint32) byte4);
-									buffer [ichan] [isamp] = value * (1.0 / 32768 / 65536);
-								}
-							}
-						} break;
-						case Melder_LINEAR_32_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++, byte4 = * bytes ++;
-									int32 value = (int32)
-										((uint32) ((uint32) byte4 << 24) |
-										 (uint32) ((uint32) byte3 << 16) |
-										 (uint32) ((uint32) byte2 << 8) |
-												   (uint32) byte1);
-									buffer [ichan] [isamp] = value * (1.0 / 32768 / 65536);
-								}
-							}
-						} break;
-					}
-				} else {
-					Melder_assert (sizeof (double) == 8);
-					int32 *ints = (int32 *) & buffer [1] [1];
-					switch (encoding) {
-						case Melder_LINEAR_16_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++;
-									int32 value = (int32)
-										((uint32) ((uint32) byte1 << 24) |
-										 (uint32) ((uint32) byte2 << 16));
-									* ints ++ = value;
-									* ints ++ = 0;   // the marker
-								}
-							}
-						} break;
-						case Melder_LINEAR_16_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++;
-									int32 value = (int32)
-										(((uint32) byte2 << 24) |
-										 ((uint32) byte1 << 16));
-									* ints ++ = value;
-									* ints ++ = 0;   // the marker
-								}
-							}
-						} break;
-						case Melder_LINEAR_24_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++;
-									int32 value = (int32)
-										(((uint32) byte1 << 24) |
-										 ((uint32) byte2 << 16) |
-										 ((uint32) byte3 << 8));
-									* ints ++ = value;
-									* ints ++ = 0;   // the marker
-								}
-							}
-						} break;
-						case Melder_LINEAR_24_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++;
-									int32 value = (int32)
-										(((uint32) byte3 << 24) |
-										 ((uint32) byte2 << 16) |
-										 ((uint32) byte1 << 8));
-									* ints ++ = value;
-									* ints ++ = 0;   // the marker
-								}
-							}
-						} break;
-						case Melder_LINEAR_32_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++, byte4 = * bytes ++;
-									int32 value = (int32)
-										(((uint32) byte1 << 24) |
-										 ((uint32) byte2 << 16) |
-										 ((uint32) byte3 << 8) |
-										  (uint32) byte4);
-									* ints ++ = value;
-									* ints ++ = 0;   // the marker
-								}
-							}
-						} break;
-						case Melder_LINEAR_32_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++, byte4 = * bytes ++;
-									int32 value = (int32)
-										(((uint32) byte4 << 24) |
-										 ((uint32) byte3 << 16) |
-										 ((uint32) byte2 << 8) |
-										  (uint32) byte1);
-									* ints ++ = value;
-									* ints ++ = 0;   // the marker
-								}
-							}
-						}
-					}
-					double *doubles = & buffer [1] [1];
-					integer n = numberOfSamples * numberOfChannels;
-					for (integer i = 0; i < n; i ++) {
-						int32 *valuePosition = (int32 *) & doubles [i];
-						int32 *markerPosition = valuePosition + 1;
-						if (! *markerPosition) {
-							int32 value = *valuePosition;
-							integer ichan = i / numberOfSamples, isamp = i % numberOfSamples;
-							for (integer other = isamp * numberOfChannels + ichan; other != i; ) {
-								int32 *otherValuePosition = (int32 *) & doubles [other];
-								*valuePosition = *otherValuePosition;
-								*markerPosition = 1;
-								valuePosition = otherValuePosition;
-								markerPosition = valuePosition + 1;
-								ichan = other / numberOfSamples, isamp = other % numberOfSamples;
-								other = isamp * numberOfChannels + ichan;
-							}
-							*valuePosition = value;
-							*markerPosition = 1;
-						}
-					}
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = * (int32 *) & buffer [ichan] [isamp] * (1.0 / 32768 / 65536);
-						}
-					}
-				}
-				if (numberOfBytesRead < numberOfBytes)
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel ", numberOfBytesPerSamplePerChannel * 8, U"-bit).\n"
-						U"Missing samples were set to zero.");
-			} break;
 			case Melder_IEEE_FLOAT_32_BIG_ENDIAN:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = bingetr32 (f);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 32-bit floating point).\nMissing samples set to zero.");
-				}
-				break;
 			case Melder_IEEE_FLOAT_32_LITTLE_ENDIAN:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = bingetr32LE (f);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 32-bit floating point).\nMissing samples set to zero.");
-				}
-				break;
 			case Melder_IEEE_FLOAT_64_BIG_ENDIAN:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = bingetr64 (f);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 64-bit floating point).\nMissing samples set to zero.");
-				}
-				break;
 			case Melder_IEEE_FLOAT_64_LITTLE_ENDIAN:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = bingetr64LE (f);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 64-bit floating point).\nMissing samples set to zero.");
-				}
-				break;
 			case Melder_MULAW:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = ulaw2linear [bingetu8 (f)] * (1.0 / 32768);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 8-bit " "-law).\nMissing samples set to zero.");
-				}
-				break;
 			case Melder_ALAW:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = alaw2linear [bingetu8 (f)] * (1.0 / 32768);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 8-bit A-law).\nMissing samples set to zero.");
-				}
+				Melder_readUncompressedAudioToFloat (f, encoding, buffer);
 				break;
 			case Melder_FLAC_COMPRESSION_16:
 			case Melder_FLAC_COMPRESSION_24:
@@ -72,6 +72,11 @@ void Melder_readAudioToShort (FILE *f, integer numberOfChannels, int encoding, s
 /* If stereo, buffer will contain alternating left and right values.
  * Buffer is base-0.
  */
+void Melder_decodeAudioToFloat (const uint8 *bytes, integer numberOfBytes, int encoding, MAT buffer);
+void Melder_decodeAudioToShort (const uint8 *bytes, integer numberOfBytes, integer numberOfChannels, int encoding, short *buffer, integer numberOfSamples);
+/* The same as the two above, but from uncompressed sample data that are already in memory (e.g. a mapped file).
+ * Samples for which there are no complete bytes are set to zero, with a warning, as for a file that is too short.
+ */
 void MelderFile_writeFloatToAudio (MelderFile file, constMATVU const& buffer, int encoding, bool warnIfClipped);
 void MelderFile_writeShortToAudio (MelderFile file, integer numberOfChannels, int encoding, const short *buffer, integer numberOfSamples);
 
@@ -32,7 +32,7 @@ void Melder_setErrorProc (void (*p_errorProc) (conststring32)) {
 
 constexpr integer BUFFER_LENGTH = 2000;
 
-static char32 buffer [BUFFER_LENGTH];   // safe in low-memory situations
+static thread_local char32 buffer [BUFFER_LENGTH];   // safe in low-memory situations; one per thread
 
 void MelderError::_append (conststring32 message) {
 	if (! message)
@@ -71,7 +71,7 @@ void Melder_flushError () {
 		and some operating systems may force an immediate redraw event as soon as
 		the message dialog is closed. We want "errors" to be empty when redrawing!
 	*/
-	static char32 temp [BUFFER_LENGTH];
+	static thread_local char32 temp [BUFFER_LENGTH];
 	str32cpy (temp, buffer);
 	Melder_clearError ();
 	(*p_theErrorProc) (temp);
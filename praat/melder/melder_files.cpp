@@ -725,8 +725,8 @@ void MelderFile_delete (MelderFile file) {
 }
 
 char32 * Melder_peekExpandBackslashes (conststring32 message) {
-	static char32 names [11] [kMelder_MAXPATH+1];
-	static int index = 0;
+	static thread_local char32 names [11] [kMelder_MAXPATH+1];
+	static thread_local int index = 0;
 	if (++ index == 11) index = 0;
 	char32 *to = & names [index] [0];
 	for (const char32 *from = & message [0]; *from != '\0'; from ++, to ++) {
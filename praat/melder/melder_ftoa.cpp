@@ -17,6 +17,7 @@
  */
 
 #include "melder.h"
+#include <charconv>   // std::to_chars, std::from_chars
 
 /********** NUMBER TO STRING CONVERSION **********/
 
@@ -25,9 +26,9 @@
 #define MAXIMUM_NUMERIC_STRING_LENGTH  800
 	/* = sign + 324 + point + 60 + e + sign + 3 + null byte + ("·10^^" - "e"), times 2, + i, + 7 extra */
 
-static char   buffers8  [NUMBER_OF_BUFFERS] [MAXIMUM_NUMERIC_STRING_LENGTH + 1];
-static char32 buffers32 [NUMBER_OF_BUFFERS] [MAXIMUM_NUMERIC_STRING_LENGTH + 1];
-static int ibuffer = 0;
+static thread_local char   buffers8  [NUMBER_OF_BUFFERS] [MAXIMUM_NUMERIC_STRING_LENGTH + 1];
+static thread_local char32 buffers32 [NUMBER_OF_BUFFERS] [MAXIMUM_NUMERIC_STRING_LENGTH + 1];
+static thread_local int ibuffer = 0;
 
 #define CONVERT_BUFFER_TO_CHAR32 \
 	char32 *q = buffers32 [ibuffer]; \
@@ -155,17 +156,123 @@ conststring32 Melder_kleenean (kleenean valueK) noexcept {
 	assert string$ (1000000000000) = "1000000000000"
 	assert string$ (undefined) = "--undefined--"
 @*/
+/*
+	Melder8_double writes the shortest of %.15g, %.16g and %.17g that reads back as the same number.
+
+	Where the C++ library has std::to_chars, we need neither printf nor, mostly, a reading back.
+	The shortest scientific notation that reads back as the value (std::to_chars without a precision)
+	tells us how many digits are needed. If that is at most 15, %.15g has exactly those digits,
+	because a normal double lies well within half a unit in the 15th digit of them.
+	If it is 17, %.16g cannot read back, and %.17g has the digits of std::to_chars with precision 16.
+	Only if it is 16 can %.16g have other digits and still read back, which std::from_chars then decides.
+	The digits are then laid out as %g would: fixed or with exponent, and without trailing zeroes.
+	Subnormal numbers, which have fewer digits of precision, and numbers near the largest double,
+	where Melder8_strtod clips a %.15g that overflows, are written by trying %.15g, %.16g and %.17g in turn.
+*/
+#if defined (__cpp_lib_to_chars)
+static bool roundTrips (const char *first, const char *last, double value) noexcept {
+	double readBack;
+	const std::from_chars_result result = std::from_chars (first, last, readBack);
+	if (result.ec != std::errc ())
+		return Melder8_strtod (first, nullptr) == value;
+	return readBack == value;
+}
+
+static void writeDouble (char *buffer, char *bufferEnd, double value) noexcept {
+	if ((value != 0.0 && fabs (value) < std::numeric_limits <double>::min ()) || fabs (value) >= 1e308) {
+		for (int precision = 15; precision <= 17; precision ++) {
+			char *end = std::to_chars (buffer, bufferEnd, value, std::chars_format::general, precision).ptr;
+			*end = '\0';
+			if (precision == 17 || roundTrips (buffer, end, value))
+				return;
+		}
+	}
+	/*
+		Find the digits and the exponent.
+	*/
+	char scientific [40], rounded [40];
+	const char *endOfScientific = std::to_chars (scientific, scientific + sizeof (scientific), value, std::chars_format::scientific).ptr;
+	int numberOfDigits = 0;
+	for (const char *p = scientific; *p != 'e'; p ++)
+		if (*p >= '0' && *p <= '9')
+			numberOfDigits ++;
+	const char *digitsText = scientific, *endOfDigitsText = endOfScientific;
+	if (numberOfDigits >= 16) {
+		const char *endOfRounded = std::to_chars (rounded, rounded + sizeof (rounded), value, std::chars_format::scientific, numberOfDigits - 1).ptr;
+		const bool roundedHasTheShortestDigits = ( endOfRounded - rounded == endOfScientific - scientific &&
+				memcmp (rounded, scientific, size_t (endOfRounded - rounded)) == 0 );
+		if (numberOfDigits == 16 && ! roundedHasTheShortestDigits && ! roundTrips (rounded, endOfRounded, value)) {
+			numberOfDigits = 17;
+			endOfRounded = std::to_chars (rounded, rounded + sizeof (rounded), value, std::chars_format::scientific, 16).ptr;
+		}
+		digitsText = rounded;
+		endOfDigitsText = endOfRounded;
+	}
+	const int precision = std::max (numberOfDigits, 15);
+	char digits [20];
+	int numberOfSignificantDigits = 0;
+	const char *p = digitsText;
+	const bool negative = ( *p == '-' );
+	for (; *p != 'e'; p ++)
+		if (*p >= '0' && *p <= '9')
+			digits [numberOfSignificantDigits ++] = *p;
+	while (numberOfSignificantDigits > 1 && digits [numberOfSignificantDigits - 1] == '0')
+		numberOfSignificantDigits --;   // %g removes trailing zeroes
+	int exponent = 0;
+	std::from_chars (p [1] == '+' ? p + 2 : p + 1, endOfDigitsText, exponent);
+	/*
+		Lay them out as %g would.
+	*/
+	char *q = buffer;
+	if (negative)
+		*q ++ = '-';
+	if (exponent < -4 || exponent >= precision) {
+		*q ++ = digits [0];
+		if (numberOfSignificantDigits > 1) {
+			*q ++ = '.';
+			for (int idigit = 1; idigit < numberOfSignificantDigits; idigit ++)
+				*q ++ = digits [idigit];
+		}
+		*q ++ = 'e';
+		*q ++ = ( exponent < 0 ? '-' : '+' );
+		if (abs (exponent) < 10)
+			*q ++ = '0';
+		q = std::to_chars (q, bufferEnd, abs (exponent)).ptr;
+	} else if (exponent < 0) {
+		*q ++ = '0';
+		*q ++ = '.';
+		for (int izero = 1; izero < - exponent; izero ++)
+			*q ++ = '0';
+		for (int idigit = 0; idigit < numberOfSignificantDigits; idigit ++)
+			*q ++ = digits [idigit];
+	} else {
+		for (int idigit = 0; idigit <= exponent; idigit ++)
+			*q ++ = ( idigit < numberOfSignificantDigits ? digits [idigit] : '0' );
+		if (numberOfSignificantDigits > exponent + 1) {
+			*q ++ = '.';
+			for (int idigit = exponent + 1; idigit < numberOfSignificantDigits; idigit ++)
+				*q ++ = digits [idigit];
+		}
+	}
+	*q = '\0';
+}
+#endif
+
 const char * Melder8_double (double value) noexcept {
 	if (isundef (value))
 		return "--undefined--";
 	if (++ ibuffer == NUMBER_OF_BUFFERS)
 		ibuffer = 0;
-	fmt_sprintf (buffers8 [ibuffer], "%.15g", value);
-	if (Melder8_strtod (buffers8 [ibuffer], nullptr) != value) {
-		fmt_sprintf (buffers8 [ibuffer], "%.16g", value);
-		if (Melder8_strtod (buffers8 [ibuffer], nullptr) != value)
-			fmt_sprintf (buffers8 [ibuffer], "%.17g", value);
-	}
+	#if defined (__cpp_lib_to_chars)
+		writeDouble (buffers8 [ibuffer], buffers8 [ibuffer] + MAXIMUM_NUMERIC_STRING_LENGTH, value);
+	#else
+		fmt_sprintf (buffers8 [ibuffer], "%.15g", value);
+		if (Melder8_strtod (buffers8 [ibuffer], nullptr) != value) {
+			fmt_sprintf (buffers8 [ibuffer], "%.16g", value);
+			if (Melder8_strtod (buffers8 [ibuffer], nullptr) != value)
+				fmt_sprintf (buffers8 [ibuffer], "%.17g", value);
+		}
+	#endif
 	return buffers8 [ibuffer];
 }
 conststring32 Melder_double (double value) noexcept {
@@ -458,8 +565,8 @@ conststring32 Melder_colour (MelderColour colour) noexcept {
 /********** TENSOR TO STRING CONVERSION **********/
 
 #define NUMBER_OF_TENSOR_BUFFERS  3
-static MelderString theTensorBuffers [NUMBER_OF_TENSOR_BUFFERS];
-static int iTensorBuffer { 0 };
+static thread_local MelderString theTensorBuffers [NUMBER_OF_TENSOR_BUFFERS];
+static thread_local int iTensorBuffer { 0 };
 
 conststring32 Melder_VEC (constVECVU const& value) {
 	if (++ iTensorBuffer == NUMBER_OF_TENSOR_BUFFERS)
@@ -502,8 +609,8 @@ conststring32 Melder_STRVEC (constSTRVEC const& value) {
 
 /********** STRING TO STRING CONVERSION **********/
 
-static MelderString thePadBuffers [NUMBER_OF_BUFFERS];
-static int iPadBuffer { 0 };
+static thread_local MelderString thePadBuffers [NUMBER_OF_BUFFERS];
+static thread_local int iPadBuffer { 0 };
 
 conststring32 Melder_pad (int64 width, conststring32 string) {
 	if (++ iPadBuffer == NUMBER_OF_BUFFERS)
@@ -25,7 +25,7 @@ static void * defaultMonitor (double /*progress*/, conststring32 /*message*/) {
 	return nullptr;
 }
 
-int MelderProgress::_depth = 0;
+thread_local int MelderProgress::_depth = 0;
 
 MelderProgress::ProgressProc MelderProgress::_p_progressProc = & defaultProgress;
 MelderProgress::MonitorProc MelderProgress::_p_monitorProc = & defaultMonitor;
@@ -38,7 +38,7 @@ void MelderProgress::_doProgress (double progress, conststring32 message) {
 		MelderProgress::_p_progressProc (progress, message);
 }
 
-MelderString MelderProgress::_buffer;
+thread_local MelderString MelderProgress::_buffer;
 
 void * MelderProgress::_doMonitor (double progress, conststring32 message) {
 	if (! Melder_batch && MelderProgress::_depth >= 0) {
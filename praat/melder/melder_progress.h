@@ -100,14 +100,14 @@
 */
 
 namespace MelderProgress {
-	extern int _depth;
+	extern thread_local int _depth;   // Melder_progressOff () silences only the calling thread
 	using ProgressProc = void (*) (double progress, conststring32 message);
 	using MonitorProc = void * (*) (double progress, conststring32 message);
 	extern ProgressProc _p_progressProc;
 	extern MonitorProc _p_monitorProc;
 	void _doProgress (double progress, conststring32 message);
 	void * _doMonitor (double progress, conststring32 message);
-	extern MelderString _buffer;
+	extern thread_local MelderString _buffer;
 }
 
 void Melder_progressOff ();
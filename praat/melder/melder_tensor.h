@@ -837,6 +837,18 @@ template <typename T>
 automatrix<T> newmatrixzero (integer nrow, integer ncol) {
 	return automatrix<T> (nrow, ncol, MelderArray::kInitializationType::ZERO);
 }
+/*
+	A matrix that borrows the cells of somebody else (see MelderArray::_registerForeignCells):
+	`release (closure)` is called when the matrix lets go of them.
+*/
+template <typename T>
+automatrix<T> newmatrixforeign (T *cells, integer nrow, integer ncol, void (*release) (void *closure), void *closure) {
+	Melder_assert (cells && nrow > 0 && ncol > 0);
+	MelderArray::_registerForeignCells (cells, release, closure);
+	automatrix<T> result;
+	result. adoptFromAmbiguousOwner (matrix<T> (cells, nrow, ncol));
+	return result;
+}
 template <typename T>
 void matrixcopy (matrixview<T> const& target, constmatrixview<T> const& source) {
 	Melder_assert (source.nrow == target.nrow && source.ncol == target.ncol);
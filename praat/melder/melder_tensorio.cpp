@@ -20,6 +20,67 @@
 
 /*** Typed I/O functions for vectors and matrices. ***/
 
+/*
+	Binary I/O of the contiguous cells of a tensor, one number at a time,
+	except for bytes and for real and complex numbers, which are read and written in bulk.
+*/
+#define FUNCTION(T,storage)  \
+	static void cells_readBinary_##storage (T *cells, integer numberOfCells, FILE *f) { \
+		for (integer i = 0; i < numberOfCells; i ++) \
+			cells [i] = binget##storage (f); \
+	} \
+	static void cells_writeBinary_##storage (const T *cells, integer numberOfCells, FILE *f) { \
+		for (integer i = 0; i < numberOfCells; i ++) \
+			binput##storage (cells [i], f); \
+	}
+FUNCTION (signed char, i8)
+FUNCTION (int, i16)
+FUNCTION (long, i32)
+FUNCTION (integer, integer32BE)
+FUNCTION (integer, integer16BE)
+FUNCTION (unsigned int, u16)
+FUNCTION (unsigned long, u32)
+FUNCTION (bool, eb)
+#undef FUNCTION
+
+static void cells_readBinary_u8 (unsigned char *cells, integer numberOfCells, FILE *f) {
+	if (fread (cells, 1, integer_to_uinteger (numberOfCells), f) != integer_to_uinteger (numberOfCells))
+		Melder_throw (feof (f) ? U"Reached end of file" : U"Error in file", U" while trying to read ", numberOfCells, U" bytes.");
+}
+static void cells_writeBinary_u8 (const unsigned char *cells, integer numberOfCells, FILE *f) {
+	if (fwrite (cells, 1, integer_to_uinteger (numberOfCells), f) != integer_to_uinteger (numberOfCells))
+		Melder_throw (U"Error in file while trying to write ", numberOfCells, U" bytes.");
+}
+
+static void cells_readBinary_r32 (double *cells, integer numberOfCells, FILE *f) {
+	bingetr32 (VEC (cells, numberOfCells), f);
+}
+static void cells_writeBinary_r32 (const double *cells, integer numberOfCells, FILE *f) {
+	binputr32 (constVEC (cells, numberOfCells), f);
+}
+static void cells_readBinary_r64 (double *cells, integer numberOfCells, FILE *f) {
+	bingetr64 (VEC (cells, numberOfCells), f);
+}
+static void cells_writeBinary_r64 (const double *cells, integer numberOfCells, FILE *f) {
+	binputr64 (constVEC (cells, numberOfCells), f);
+}
+/*
+	A std::complex<double> is laid out as two doubles (real part first),
+	which is also the order in which bingetc64 and bingetc128 read them.
+*/
+static void cells_readBinary_c64 (dcomplex *cells, integer numberOfCells, FILE *f) {
+	bingetr32 (VEC (reinterpret_cast <double *> (cells), 2 * numberOfCells), f);
+}
+static void cells_writeBinary_c64 (const dcomplex *cells, integer numberOfCells, FILE *f) {
+	binputr32 (constVEC (reinterpret_cast <const double *> (cells), 2 * numberOfCells), f);
+}
+static void cells_readBinary_c128 (dcomplex *cells, integer numberOfCells, FILE *f) {
+	bingetr64 (VEC (reinterpret_cast <double *> (cells), 2 * numberOfCells), f);
+}
+static void cells_writeBinary_c128 (const dcomplex *cells, integer numberOfCells, FILE *f) {
+	binputr64 (constVEC (reinterpret_cast <const double *> (cells), 2 * numberOfCells), f);
+}
+
 #define FUNCTION(T,storage)  \
 	void vector_writeText_##storage (const constvector<T>& vec, MelderFile file, conststring32 name) { \
 		texputintro (file, name, U" []: ", vec.size >= 1 ? nullptr : U"(empty)", 0,0,0); \
@@ -29,8 +90,7 @@
 		if (feof (file -> filePointer) || ferror (file -> filePointer)) Melder_throw (U"Write error."); \
 	} \
 	void vector_writeBinary_##storage (const constvector<T>& vec, FILE *f) { \
-		for (integer i = 1; i <= vec.size; i ++) \
-			binput##storage (vec [i], f); \
+		cells_writeBinary_##storage (vec.cells, vec.size, f); \
 		if (feof (f) || ferror (f)) Melder_throw (U"Write error."); \
 	} \
 	autovector<T> vector_readText_##storage (integer size, MelderReadText text, const char *name) { \
@@ -46,9 +106,7 @@
 	} \
 	autovector<T> vector_readBinary_##storage (integer size, FILE *f) { \
 		autovector<T> result = newvectorzero<T> (size); \
-		for (integer i = 1; i <= size; i ++) { \
-			result [i] = binget##storage (f); \
-		} \
+		cells_readBinary_##storage (result.cells, result.size, f); \
 		return result; \
 	} \
 	void matrix_writeText_##storage (const constmatrix<T>& mat, MelderFile file, conststring32 name) { \
@@ -64,10 +122,7 @@
 		if (feof (file -> filePointer) || ferror (file -> filePointer)) Melder_throw (U"Write error."); \
 	} \
 	void matrix_writeBinary_##storage (const constmatrix<T>& mat, FILE *f) { \
-		for (integer irow = 1; irow <= mat.nrow; irow ++) { \
-			for (integer icol = 1; icol <= mat.ncol; icol ++) \
-				binput##storage (mat [irow] [icol], f); \
-		} \
+		cells_writeBinary_##storage (mat.cells, mat.nrow * mat.ncol, f); \
 		if (feof (f) || ferror (f)) Melder_throw (U"Write error."); \
 	} \
 	automatrix<T> matrix_readText_##storage (integer nrow, integer ncol, MelderReadText text, const char *name) { \
@@ -83,8 +138,7 @@
 	} \
 	automatrix<T> matrix_readBinary_##storage (integer nrow, integer ncol, FILE *f) { \
 		automatrix<T> result = newmatrixzero<T> (nrow, ncol); \
-		for (integer irow = 1; irow <= nrow; irow ++) for (integer icol = 1; icol <= ncol; icol ++) \
-			result [irow] [icol] = binget##storage (f); \
+		cells_readBinary_##storage (result.cells, result.nrow * result.ncol, f); \
 		return result; \
 	} \
 	void tensor3_writeText_##storage (const consttensor3<T>& ten3, MelderFile file, conststring32 name) { \
@@ -103,6 +157,11 @@
 		if (feof (file -> filePointer) || ferror (file -> filePointer)) Melder_throw (U"Write error."); \
 	} \
 	void tensor3_writeBinary_##storage (const consttensor3<T>& ten3, FILE *f) { \
+		if (ten3.stride3 == 1 && ten3.stride2 == ten3.ndim3 && ten3.stride1 == ten3.ndim2 * ten3.ndim3) { \
+			cells_writeBinary_##storage (ten3.cells, ten3.ndim1 * ten3.ndim2 * ten3.ndim3, f); \
+			if (feof (f) || ferror (f)) Melder_throw (U"Write error."); \
+			return; \
+		} \
 		for (integer idim1 = 1; idim1 <= ten3.ndim1; idim1 ++) { \
 			for (integer idim2 = 1; idim2 <= ten3.ndim2; idim2 ++) { \
 				for (integer idim3 = 1; idim3 <= ten3.ndim3; idim3 ++) { \
@@ -129,13 +188,7 @@
 	} \
 	autotensor3<T> tensor3_readBinary_##storage (integer ndim1, integer ndim2, integer ndim3, FILE *f) { \
 		autotensor3<T> result = newtensor3zero<T> (ndim1, ndim2, ndim3); \
-		for (integer idim1 = 1; idim1 <= result.ndim1; idim1 ++) { \
-			for (integer idim2 = 1; idim2 <= result.ndim2; idim2 ++) { \
-				for (integer idim3 = 1; idim3 <= result.ndim3; idim3 ++) { \
-					result [idim1] [idim2] [idim3] = binget##storage (f); \
-				} \
-			} \
-		} \
+		cells_readBinary_##storage (result.cells, result.ndim1 * result.ndim2 * result.ndim3, f); \
 		return result; \
 	}
 
@@ -200,8 +200,8 @@ size_t str32len_utf16 (conststring32 string, bool nativizeNewlines) {
 conststring32 Melder_peek8to32 (conststring8 textA) {
 	if (! textA)
 		return nullptr;
-	static MelderString buffers [19];
-	static int ibuffer = 0;
+	static thread_local MelderString buffers [19];
+	static thread_local int ibuffer = 0;
 	if (++ ibuffer == 11)
 		ibuffer = 0;
 	MelderString_empty (& buffers [ibuffer]);
@@ -433,8 +433,8 @@ autostring32 Melder_8to32 (const char *string) {
 
 conststring32 Melder_peek16to32 (conststring16 text) {
 	if (! text) return nullptr;
-	static MelderString buffers [19];
-	static int bufferNumber = 0;
+	static thread_local MelderString buffers [19];
+	static thread_local int bufferNumber = 0;
 	if (++ bufferNumber == 19)
 		bufferNumber = 0;
 	MelderString_empty (& buffers [bufferNumber]);
@@ -499,9 +499,9 @@ void Melder_32to8_inplace (conststring32 string, mutablestring8 utf8) {;
 conststring8 Melder_peek32to8 (conststring32 text) {
 	if (! text)
 		return nullptr;
-	static mutablestring8 buffers [19] { nullptr };
-	static int64 bufferSizes [19] { 0 };
-	static int bufferNumber = 0;
+	static thread_local mutablestring8 buffers [19] { nullptr };
+	static thread_local int64 bufferSizes [19] { 0 };
+	static thread_local int bufferNumber = 0;
 	if (++ bufferNumber == 19)
 		bufferNumber = 0;
 	constexpr int64 maximumNumberOfUTF8bytesPerUTF32point = 4;   // becausse we use only the lower 21 bits
@@ -531,8 +531,8 @@ autostring8 Melder_32to8 (conststring32 string) {
 conststring16 Melder_peek32to16 (conststring32 text, bool nativizeNewlines) {
 	if (! text)
 		return nullptr;
-	static MelderString16 buffers [19] { };
-	static int bufferNumber = 0;
+	static thread_local MelderString16 buffers [19] { };
+	static thread_local int bufferNumber = 0;
 	if (++ bufferNumber == 19)
 		bufferNumber = 0;
 	MelderString16_empty (& buffers [bufferNumber]);
@@ -572,7 +572,7 @@ autostringW Melder_32toW (conststring32 text) {
 	return result;
 }
 conststringW Melder_peek32toW_fileSystem (conststring32 string) {
-	static wchar_t buffer [1 + kMelder_MAXPATH];
+	static thread_local wchar_t buffer [1 + kMelder_MAXPATH];
 	//NormalizeStringW (NormalizationKC, -1, Melder_peek32toW (string), 1 + kMelder_MAXPATH, buffer);
 	FoldStringW (MAP_PRECOMPOSED, Melder_peek32toW (string), -1, buffer, 1 + kMelder_MAXPATH);   // this works even on XP
 	return buffer;
@@ -627,7 +627,7 @@ void Melder_32to8_fileSystem_inplace (conststring32 string, char *utf8) {
 	#endif
 }
 conststring8 Melder_peek32to8_fileSystem (conststring32 string) {
-	static char buffer [1 + kMelder_MAXPATH];
+	static thread_local char buffer [1 + kMelder_MAXPATH];
 	Melder_32to8_fileSystem_inplace (string, buffer);
 	return buffer;
 }
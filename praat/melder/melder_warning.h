@@ -28,11 +28,16 @@
 */
 
 namespace MelderWarning {
-	extern int _depth;
-	extern MelderString _buffer;
+	extern thread_local int _depth;   // Melder_warningOff () silences only the calling thread
+	extern thread_local MelderString _buffer;
 	using Proc = void (*) (conststring32 message);
 	void _defaultProc (conststring32 message);
 	extern Proc _p_currentProc;
+	/*
+		A thread that should not show its warnings itself (e.g. a pool thread of MelderThread_run ())
+		collects them here, one per line, for the thread that it works for to show later.
+	*/
+	extern thread_local MelderString *_p_collectedWarnings;
 }
 
 template <typename... Args>
@@ -43,6 +48,10 @@ void Melder_warning (const MelderArg& first, Args... rest) {
 	if (MelderWarning::_depth < 0)
 		return;
 	MelderString_copy (& MelderWarning::_buffer, first, rest...);
+	if (MelderWarning::_p_collectedWarnings) {
+		MelderString_append (MelderWarning::_p_collectedWarnings, MelderWarning::_buffer.string, U"\n");
+		return;
+	}
 	(*MelderWarning::_p_currentProc) (MelderWarning::_buffer.string);
 }
 
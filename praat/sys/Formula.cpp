@@ -30,16 +30,9 @@
 #include "UiPause.h"
 #include "DemoEditor.h"
 
-static Interpreter theInterpreter;
-static autoInterpreter theLocalInterpreter;
-static Daata theSource;
-static conststring32 theExpression;
-static int theLevel = 1;
-#define MAXIMUM_NUMBER_OF_LEVELS  20
-static int theExpressionType [1 + MAXIMUM_NUMBER_OF_LEVELS];
-static bool theOptimize;
-
-typedef struct structFormulaInstruction {
+Thing_implement (FormulaContext, Thing, 0);
+
+struct structFormulaInstruction {
 	int symbol;
 	int position;
 	union {
@@ -49,10 +42,21 @@ typedef struct structFormulaInstruction {
 		Daata object;
 		InterpreterVariable variable;
 	} content;
-} *FormulaInstruction;
+};
 
-static FormulaInstruction lexan, parse;
-static int ilabel, ilexan, iparse, numberOfInstructions, numberOfStringConstants;
+/*
+	The context of the formula that is being compiled or run in this thread.
+*/
+static thread_local FormulaContext theFormula;
+/*
+	The context of the formula that was compiled last in this thread,
+	i.e. the one that the following Formula_run () will run.
+*/
+static thread_local FormulaContext theCompiledFormula;
+/*
+	The interpreter for formulas that are compiled without one.
+*/
+static thread_local autoInterpreter theLocalInterpreter;
 
 enum { NO_SYMBOL_,
 
@@ -320,17 +324,17 @@ static const conststring32 Formula_instructionNames [1 + highestSymbol] = { U"",
 	U"the end of the formula"
 };
 
-#define newlabel (-- ilabel)
-#define newread (lexan [++ ilexan]. symbol)
-#define oldread  (-- ilexan)
+#define newlabel (-- theFormula -> ilabel)
+#define newread (theFormula -> lexan [++ theFormula -> ilexan]. symbol)
+#define oldread  (-- theFormula -> ilexan)
 
 static void formulaError (conststring32 message, int position) {
-	static MelderString truncatedExpression;
-	MelderString_ncopy (& truncatedExpression, theExpression, position + 1);
+	static thread_local MelderString truncatedExpression;
+	MelderString_ncopy (& truncatedExpression, theFormula -> expression, position + 1);
 	Melder_throw (message, U":\n« ", truncatedExpression.string);
 }
 
-static conststring32 languageNameCompare_searchString;
+static thread_local conststring32 languageNameCompare_searchString;
 
 static int languageNameCompare (const void *first, const void *second) {
 	integer i = * (integer *) first, j = * (integer *) second;
@@ -339,11 +343,11 @@ static int languageNameCompare (const void *first, const void *second) {
 }
 
 static integer Formula_hasLanguageName (conststring32 f) {
-	static autoINTVEC index;
-	if (NUMisEmpty (index)) {
-		index = to_INTVEC (highestInputSymbol);
-		qsort (& index [1], highestInputSymbol, sizeof (integer), languageNameCompare);
-	}
+	static const autoINTVEC index = [] {   // initialized only once, even if several threads get here at the same time
+		autoINTVEC result = to_INTVEC (highestInputSymbol);
+		qsort (& result [1], highestInputSymbol, sizeof (integer), languageNameCompare);
+		return result;
+	} ();
 	integer dummy = 0, *found;
 	languageNameCompare_searchString = f;
 	found = (integer *) bsearch (& dummy, & index [1], highestInputSymbol, sizeof (integer), languageNameCompare);
@@ -371,20 +375,20 @@ static void Formula_lexan () {
 */
 	char32 kar;   /* The character most recently read from theExpression. */
 	int ikar = -1;   /* The position of that character in theExpression. */
-#define newchar kar = theExpression [++ ikar]
+#define newchar kar = theFormula -> expression [++ ikar]
 #define oldchar -- ikar
 
 	int itok = 0;   /* Position of most recent symbol in "lexan". */
-#define newtok(s)  { lexan [++ itok]. symbol = s; lexan [itok]. position = ikar; }
-#define toknumber(g)  lexan [itok]. content.number = (g)
-#define tokmatrix(m)  lexan [itok]. content.object = (m)
+#define newtok(s)  { theFormula -> lexan [++ itok]. symbol = s; theFormula -> lexan [itok]. position = ikar; }
+#define toknumber(g)  theFormula -> lexan [itok]. content.number = (g)
+#define tokmatrix(m)  theFormula -> lexan [itok]. content.object = (m)
 
-	static MelderString token;   // string to collect a symbol name in
+	static thread_local MelderString token;   // string to collect a symbol name in
 #define stringtokon MelderString_empty (& token);
 #define stringtokchar { MelderString_appendCharacter (& token, kar); newchar; }
 #define stringtokoff (void) 0
 
-	ilexan = iparse = ilabel = numberOfStringConstants = 0;
+	theFormula -> ilexan = theFormula -> iparse = theFormula -> ilabel = theFormula -> numberOfStringConstants = 0;
 	do {
 		newchar;
 		if (Melder_isHorizontalOrVerticalSpace (kar)) {
@@ -430,9 +434,9 @@ static void Formula_lexan () {
 				toknumber (Melder_atof (token.string));
 			}
 		} else if (Melder_isLetter (kar) && ! Melder_isUpperCaseLetter (kar) ||
-				(kar == U'.' && Melder_isLetter (theExpression [ikar + 1]) && ! Melder_isUpperCaseLetter (theExpression [ikar + 1])
-				&& (itok == 0 || (lexan [itok]. symbol != MATRIX_ && lexan [itok]. symbol != MATRIX_STR_
-					&& lexan [itok]. symbol != CLOSING_BRACKET_)))) {
+				(kar == U'.' && Melder_isLetter (theFormula -> expression [ikar + 1]) && ! Melder_isUpperCaseLetter (theFormula -> expression [ikar + 1])
+				&& (itok == 0 || (theFormula -> lexan [itok]. symbol != MATRIX_ && theFormula -> lexan [itok]. symbol != MATRIX_STR_
+					&& theFormula -> lexan [itok]. symbol != CLOSING_BRACKET_)))) {
 			int tok;
 			bool isString = false;
 			int rank = 0;
@@ -501,27 +505,27 @@ static void Formula_lexan () {
 					*/
 					int jkar;
 					jkar = ikar + 1;
-					while (Melder_isHorizontalSpace (theExpression [jkar]))
+					while (Melder_isHorizontalSpace (theFormula -> expression [jkar]))
 						jkar ++;
-					if (theExpression [jkar] == U'(' || theExpression [jkar] == U':') {
+					if (theFormula -> expression [jkar] == U'(' || theFormula -> expression [jkar] == U':') {
 						newtok (tok)   // this must be a function name
-					} else if (theExpression [jkar] == U'[' && rank == 0) {
+					} else if (theFormula -> expression [jkar] == U'[' && rank == 0) {
 						if (isString) {
 							newtok (INDEXED_STRING_VARIABLE_)
 						} else {
 							newtok (INDEXED_NUMERIC_VARIABLE_)
 						}
-						lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
-						numberOfStringConstants ++;
+						theFormula -> lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
+						theFormula -> numberOfStringConstants ++;
 					} else {
 						/*
 							This could be a variable with the same name as a function.
 						*/
-						InterpreterVariable var = Interpreter_hasVariable (theInterpreter, token.string);
+						InterpreterVariable var = Interpreter_hasVariable (theFormula -> interpreter, token.string);
 						if (! var) {
 							newtok (VARIABLE_NAME_)
-							lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
-							numberOfStringConstants ++;
+							theFormula -> lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
+							theFormula -> numberOfStringConstants ++;
 						} else {
 							if (rank == 0) {
 								if (isString) {
@@ -546,7 +550,7 @@ static void Formula_lexan () {
 							} else {
 								formulaError (U"Rank-4 tensors not implemented.", ikar);
 							}
-							lexan [itok]. content.variable = var;
+							theFormula -> lexan [itok]. content.variable = var;
 						}
 					}
 				/*
@@ -558,16 +562,16 @@ static void Formula_lexan () {
 					/*
 						Look back to find out whether this is an attribute.
 					*/
-					if (itok > 0 && lexan [itok]. symbol == PERIOD_) {
+					if (itok > 0 && theFormula -> lexan [itok]. symbol == PERIOD_) {
 						/*
 							This must be an attribute that follows a period.
 						*/
 						newtok (tok)
-					} else if (theSource) {
+					} else if (theFormula -> source) {
 						/*
 							Look for ambiguity.
 						*/
-						if (Interpreter_hasVariable (theInterpreter, token.string))
+						if (Interpreter_hasVariable (theFormula -> interpreter, token.string))
 							Melder_throw (
 								U"«", token.string,
 								U"» is ambiguous: a variable or an attribute of the current object. "
@@ -576,7 +580,7 @@ static void Formula_lexan () {
 							newtok (tok)
 						} else {
 							newtok (MATRIX_)
-							tokmatrix (theSource);
+							tokmatrix (theFormula -> source);
 							newtok (PERIOD_)
 							newtok (tok)
 						}
@@ -585,21 +589,21 @@ static void Formula_lexan () {
 							This must be a variable, since there is no "current object" here.
 						*/
 						int jkar = ikar + 1;
-						while (Melder_isHorizontalSpace (theExpression [jkar])) jkar ++;
-						if (theExpression [jkar] == U'[' && rank == 0) {
+						while (Melder_isHorizontalSpace (theFormula -> expression [jkar])) jkar ++;
+						if (theFormula -> expression [jkar] == U'[' && rank == 0) {
 							if (isString) {
 								newtok (INDEXED_STRING_VARIABLE_)
 							} else {
 								newtok (INDEXED_NUMERIC_VARIABLE_)
 							}
-							lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
-							numberOfStringConstants ++;
+							theFormula -> lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
+							theFormula -> numberOfStringConstants ++;
 						} else {
-							InterpreterVariable var = Interpreter_hasVariable (theInterpreter, token.string);
+							InterpreterVariable var = Interpreter_hasVariable (theFormula -> interpreter, token.string);
 							if (! var) {
 								newtok (VARIABLE_NAME_)
-								lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
-								numberOfStringConstants ++;
+								theFormula -> lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
+								theFormula -> numberOfStringConstants ++;
 							} else {
 								if (rank == 0) {
 									if (isString) {
@@ -624,7 +628,7 @@ static void Formula_lexan () {
 								} else {
 									formulaError (U"Rank-4 tensors not implemented.", ikar);
 								}
-								lexan [itok]. content.variable = var;
+								theFormula -> lexan [itok]. content.variable = var;
 							}
 						}
 					}
@@ -636,24 +640,24 @@ static void Formula_lexan () {
 					token.string is not a language name
 				*/
 				int jkar = ikar + 1;
-				while (Melder_isHorizontalSpace (theExpression [jkar])) jkar ++;
-				if (theExpression [jkar] == U'(' || theExpression [jkar] == U':') {
+				while (Melder_isHorizontalSpace (theFormula -> expression [jkar])) jkar ++;
+				if (theFormula -> expression [jkar] == U'(' || theFormula -> expression [jkar] == U':') {
 					Melder_throw (
 						U"Unknown function «", token.string, U"» in formula.");
-				} else if (theExpression [jkar] == '[' && rank == 0) {
+				} else if (theFormula -> expression [jkar] == '[' && rank == 0) {
 					if (isString) {
 						newtok (INDEXED_STRING_VARIABLE_)
 					} else {
 						newtok (INDEXED_NUMERIC_VARIABLE_)
 					}
-					lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
-					numberOfStringConstants ++;
+					theFormula -> lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
+					theFormula -> numberOfStringConstants ++;
 				} else {
-					InterpreterVariable var = Interpreter_hasVariable (theInterpreter, token.string);
+					InterpreterVariable var = Interpreter_hasVariable (theFormula -> interpreter, token.string);
 					if (! var) {
 						newtok (VARIABLE_NAME_)
-						lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
-						numberOfStringConstants ++;
+						theFormula -> lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
+						theFormula -> numberOfStringConstants ++;
 					} else {
 						if (rank == 0) {
 							if (isString) {
@@ -678,7 +682,7 @@ static void Formula_lexan () {
 						} else {
 							formulaError (U"Rank-4 tensors not implemented.", ikar);
 						}
-						lexan [itok]. content.variable = var;
+						theFormula -> lexan [itok]. content.variable = var;
 					}
 				}
 			}
@@ -694,15 +698,15 @@ static void Formula_lexan () {
 			 */
 			char32 *underscore = str32chr (token.string, '_');
 			if (str32equ (token.string, U"Self")) {
-				if (! theSource)
+				if (! theFormula -> source)
 					formulaError (U"Cannot use \"Self\" if there is no current object.", ikar);
 				newtok (MATRIX_)
-				tokmatrix (theSource);
+				tokmatrix (theFormula -> source);
 			} else if (str32equ (token.string, U"Self$")) {
-				if (! theSource)
+				if (! theFormula -> source)
 					formulaError (U"Cannot use \"Self$\" if there is no current object.", ikar);
 				newtok (MATRIX_STR_)
-				tokmatrix (theSource);
+				tokmatrix (theFormula -> source);
 			} else if (! underscore) {
 				Melder_throw (
 					U"Unknown symbol «", token.string, U"» in formula "
@@ -735,7 +739,7 @@ static void Formula_lexan () {
 		} else if (kar == U'+') {
 			newtok (ADD_)
 		} else if (kar == U'-') {
-			if (itok == 0 || lexan [itok]. symbol <= MINUS_) {
+			if (itok == 0 || theFormula -> lexan [itok]. symbol <= MINUS_) {
 				newtok (MINUS_)
 			} else {
 				newtok (SUB_)
@@ -805,8 +809,8 @@ static void Formula_lexan () {
 			stringtokoff;
 			oldchar;
 			newtok (CALL_)
-			lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
-			numberOfStringConstants ++;
+			theFormula -> lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
+			theFormula -> numberOfStringConstants ++;
 		} else if (kar == U'\"') {
 			/*
 			 * String constant.
@@ -827,8 +831,8 @@ static void Formula_lexan () {
 			stringtokoff;
 			oldchar;
 			newtok (STRING_)
-			lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
-			numberOfStringConstants ++;
+			theFormula -> lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
+			theFormula -> numberOfStringConstants ++;
 		} else if (kar == U'~') {
 			/*
 				The content of the remainder of the line,
@@ -844,8 +848,8 @@ static void Formula_lexan () {
 			stringtokoff;
 			oldchar;
 			newtok (STRING_)
-			lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
-			numberOfStringConstants ++;
+			theFormula -> lexan [itok]. content.string = Melder_dup_f (token.string).transfer();
+			theFormula -> numberOfStringConstants ++;
 		} else if (kar == U'|') {
 			newtok (OR_)   /* "|" = "or" */
 			newchar;
@@ -871,7 +875,7 @@ static void Formula_lexan () {
 		} else {
 			formulaError (U"Unknown symbol", ikar);
 		}
-	} while (lexan [itok]. symbol != END_);
+	} while (theFormula -> lexan [itok]. symbol != END_);
 }
 
 static void fit (int symbol) {
@@ -879,14 +883,14 @@ static void fit (int symbol) {
 		return;   // success
 	} else {
 		const conststring32 symbolName1 = Formula_instructionNames [symbol];
-		const conststring32 symbolName2 = Formula_instructionNames [lexan [ilexan]. symbol];
+		const conststring32 symbolName2 = Formula_instructionNames [theFormula -> lexan [theFormula -> ilexan]. symbol];
 		const bool needQuotes1 = ! str32chr (symbolName1, U' ');
 		const bool needQuotes2 = ! str32chr (symbolName2, U' ');
-		static MelderString message;
+		static thread_local MelderString message;
 		MelderString_copy (& message,
 			U"Expected ", ( needQuotes1 ? U"\"" : nullptr ), symbolName1, ( needQuotes1 ? U"\"" : nullptr ),
 			U", but found ", ( needQuotes2 ? U"\"" : nullptr ), symbolName2, ( needQuotes2 ? U"\"" : nullptr ));
-		formulaError (message.string, lexan [ilexan]. position);
+		formulaError (message.string, theFormula -> lexan [theFormula -> ilexan]. position);
 	}
 }
 
@@ -894,18 +898,18 @@ static bool fitArguments () {
     int symbol = newread;
     if (symbol == OPENING_PARENTHESIS_) return true;   // success: a function call like: myFunction (...)
     if (symbol == COLON_) return false;   // success: a function call like: myFunction: ...
-    const conststring32 symbolName2 = Formula_instructionNames [lexan [ilexan]. symbol];
+    const conststring32 symbolName2 = Formula_instructionNames [theFormula -> lexan [theFormula -> ilexan]. symbol];
     bool needQuotes2 = ! str32chr (symbolName2, U' ');
-    static MelderString message;
+    static thread_local MelderString message;
     MelderString_copy (& message,
 		U"Expected \"(\" or \":\", but found ", ( needQuotes2 ? U"\"" : nullptr ), symbolName2, ( needQuotes2 ? U"\"" : nullptr ));
-    formulaError (message.string, lexan [ilexan]. position);
+    formulaError (message.string, theFormula -> lexan [theFormula -> ilexan]. position);
     return false;   // will never occur
 }
 
-#define newparse(s)  parse [++ iparse]. symbol = (s)
-#define parsenumber(g)  parse [iparse]. content.number = (g)
-#define parselabel(l)  parse [iparse]. content.label = (l)
+#define newparse(s)  theFormula -> parse [++ theFormula -> iparse]. symbol = (s)
+#define parsenumber(g)  theFormula -> parse [theFormula -> iparse]. content.number = (g)
+#define parselabel(l)  theFormula -> parse [theFormula -> iparse]. content.label = (l)
 
 static void parseExpression ();
 
@@ -914,24 +918,24 @@ static void parsePowerFactor () {
 
 	if (symbol >= LOW_VALUE && symbol <= HIGH_VALUE) {
 		newparse (symbol);
-		if (symbol == NUMBER_) parsenumber (lexan [ilexan]. content.number);
+		if (symbol == NUMBER_) parsenumber (theFormula -> lexan [theFormula -> ilexan]. content.number);
 		return;
 	}
 
 	if (symbol == STRING_) {
 		newparse (symbol);
-		parse [iparse]. content.string = lexan [ilexan]. content.string;   // reference copy!
+		theFormula -> parse [theFormula -> iparse]. content.string = theFormula -> lexan [theFormula -> ilexan]. content.string;   // reference copy!
 		return;
 	}
 
 	if (symbol == NUMERIC_VARIABLE_ || symbol == STRING_VARIABLE_) {
 		newparse (symbol);
-		parse [iparse]. content.variable = lexan [ilexan]. content.variable;
+		theFormula -> parse [theFormula -> iparse]. content.variable = theFormula -> lexan [theFormula -> ilexan]. content.variable;
 		return;
 	}
 
 	if (symbol == INDEXED_NUMERIC_VARIABLE_ || symbol == INDEXED_STRING_VARIABLE_) {
-		char32 *var = lexan [ilexan]. content.string;   // Save before incrementing ilexan.
+		char32 *var = theFormula -> lexan [theFormula -> ilexan]. content.string;   // Save before incrementing ilexan.
 		if (newread == OPENING_BRACKET_) {
 			int n = 0;
 			if (newread != CLOSING_BRACKET_) {
@@ -950,12 +954,12 @@ static void parsePowerFactor () {
 		} else {
 			Melder_fatal (U"Formula:parsePowerFactor (indexed variable): No '['; cannot happen.");
 		}
-		parse [iparse]. content.string = var;
+		theFormula -> parse [theFormula -> iparse]. content.string = var;
 		return;
 	}
 
 	if (symbol == NUMERIC_VECTOR_VARIABLE_) {
-		InterpreterVariable var = lexan [ilexan]. content.variable;   // save before incrementing ilexan
+		InterpreterVariable var = theFormula -> lexan [theFormula -> ilexan]. content.variable;   // save before incrementing ilexan
 		if (newread == OPENING_BRACKET_) {
 			parseExpression ();
 			fit (CLOSING_BRACKET_);
@@ -964,12 +968,12 @@ static void parsePowerFactor () {
 			oldread;
 			newparse (NUMERIC_VECTOR_VARIABLE_);
 		}
-		parse [iparse]. content.variable = var;
+		theFormula -> parse [theFormula -> iparse]. content.variable = var;
 		return;
 	}
 
 	if (symbol == NUMERIC_MATRIX_VARIABLE_) {
-		InterpreterVariable var = lexan [ilexan]. content.variable;   // save before incrementing ilexan
+		InterpreterVariable var = theFormula -> lexan [theFormula -> ilexan]. content.variable;   // save before incrementing ilexan
 		if (newread == OPENING_BRACKET_) {
 			parseExpression ();
 			fit (COMMA_);
@@ -980,12 +984,12 @@ static void parsePowerFactor () {
 			oldread;
 			newparse (NUMERIC_MATRIX_VARIABLE_);
 		}
-		parse [iparse]. content.variable = var;
+		theFormula -> parse [theFormula -> iparse]. content.variable = var;
 		return;
 	}
 
 	if (symbol == STRING_ARRAY_VARIABLE_) {
-		InterpreterVariable var = lexan [ilexan]. content.variable;   // save before incrementing ilexan
+		InterpreterVariable var = theFormula -> lexan [theFormula -> ilexan]. content.variable;   // save before incrementing ilexan
 		if (newread == OPENING_BRACKET_) {
 			parseExpression ();
 			fit (CLOSING_BRACKET_);
@@ -994,16 +998,16 @@ static void parsePowerFactor () {
 			oldread;
 			newparse (STRING_ARRAY_VARIABLE_);
 		}
-		parse [iparse]. content.variable = var;
+		theFormula -> parse [theFormula -> iparse]. content.variable = var;
 		return;
 	}
 
 	if (symbol == VARIABLE_NAME_) {
-		InterpreterVariable var = Interpreter_hasVariable (theInterpreter, lexan [ilexan]. content.string);
+		InterpreterVariable var = Interpreter_hasVariable (theFormula -> interpreter, theFormula -> lexan [theFormula -> ilexan]. content.string);
 		if (! var)
-			formulaError (U"Unknown variable", lexan [ilexan]. position);
+			formulaError (U"Unknown variable", theFormula -> lexan [theFormula -> ilexan]. position);
 		newparse (NUMERIC_VARIABLE_);
-		parse [iparse]. content.variable = var;
+		theFormula -> parse [theFormula -> iparse]. content.variable = var;
 		return;
 	}
 
@@ -1126,7 +1130,7 @@ static void parsePowerFactor () {
 							return;
 						default:
 							formulaError (U"After \"object [number].\" there should be \"xmin\", \"xmax\", \"ymin\", "
-								"\"ymax\", \"nx\", \"ny\", \"dx\", \"dy\", \"nrow\" or \"ncol\"", lexan [ilexan]. position);
+								"\"ymax\", \"nx\", \"ny\", \"dx\", \"dy\", \"nrow\" or \"ncol\"", theFormula -> lexan [theFormula -> ilexan]. position);
 					}
 				} else if (symbol == OPENING_BRACKET_) {
 					parseExpression ();
@@ -1177,7 +1181,7 @@ static void parsePowerFactor () {
 				}
 			}
 		} else {
-			formulaError (U"After \"object\" there should be \"(\" or \"[\"", lexan [ilexan]. position);
+			formulaError (U"After \"object\" there should be \"(\" or \"[\"", theFormula -> lexan [theFormula -> ilexan]. position);
 		}
 		return;
 	}
@@ -1223,7 +1227,7 @@ static void parsePowerFactor () {
 				}
 			}
 		} else {
-			formulaError (U"After \"object$\" there should be \"(\" or \"[\"", lexan [ilexan]. position);
+			formulaError (U"After \"object$\" there should be \"(\" or \"[\"", theFormula -> lexan [theFormula -> ilexan]. position);
 		}
 		return;
 	}
@@ -1251,44 +1255,44 @@ static void parsePowerFactor () {
 	}
 
 	if (symbol == MATRIX_) {
-		Daata thee = lexan [ilexan]. content.object;
+		Daata thee = theFormula -> lexan [theFormula -> ilexan]. content.object;
 		Melder_assert (thee != nullptr);
 		symbol = newread;
 		if (symbol == OPENING_BRACKET_) {
 			if (newread == CLOSING_BRACKET_) {
 				newparse (MATRIX0_);
-				parse [iparse]. content.object = thee;
+				theFormula -> parse [theFormula -> iparse]. content.object = thee;
 			} else {
 				oldread;
 				parseExpression ();
 				if (newread == COMMA_) {
 					parseExpression ();
 					newparse (MATRIX2_);
-					parse [iparse]. content.object = thee;
+					theFormula -> parse [theFormula -> iparse]. content.object = thee;
 					fit (CLOSING_BRACKET_);
 				} else {
 					oldread;
 					newparse (MATRIX1_);
-					parse [iparse]. content.object = thee;
+					theFormula -> parse [theFormula -> iparse]. content.object = thee;
 					fit (CLOSING_BRACKET_);
 				}
 			}
 		} else if (symbol == OPENING_PARENTHESIS_) {
 			if (newread == CLOSING_PARENTHESIS_) {
 				newparse (FUNCTION0_);
-				parse [iparse]. content.object = thee;
+				theFormula -> parse [theFormula -> iparse]. content.object = thee;
 			} else {
 				oldread;
 				parseExpression ();
 				if (newread == COMMA_) {
 					parseExpression ();
 					newparse (FUNCTION2_);
-					parse [iparse]. content.object = thee;
+					theFormula -> parse [theFormula -> iparse]. content.object = thee;
 					fit (CLOSING_PARENTHESIS_);
 				} else {
 					oldread;
 					newparse (FUNCTION1_);
-					parse [iparse]. content.object = thee;
+					theFormula -> parse [theFormula -> iparse]. content.object = thee;
 					fit (CLOSING_PARENTHESIS_);
 				}
 			}
@@ -1296,7 +1300,7 @@ static void parsePowerFactor () {
 			switch (newread) {
 				case XMIN_:
 					if (! thy v_hasGetXmin ()) {
-						formulaError (U"Attribute \"xmin\" not defined for this object", lexan [ilexan]. position);
+						formulaError (U"Attribute \"xmin\" not defined for this object", theFormula -> lexan [theFormula -> ilexan]. position);
 					} else {
 						newparse (NUMBER_);
 						parsenumber (thy v_getXmin ());
@@ -1304,7 +1308,7 @@ static void parsePowerFactor () {
 					}
 				case XMAX_:
 					if (! thy v_hasGetXmax ()) {
-						formulaError (U"Attribute \"xmax\" not defined for this object", lexan [ilexan]. position);
+						formulaError (U"Attribute \"xmax\" not defined for this object", theFormula -> lexan [theFormula -> ilexan]. position);
 					} else {
 						newparse (NUMBER_);
 						parsenumber (thy v_getXmax ());
@@ -1312,7 +1316,7 @@ static void parsePowerFactor () {
 					}
 				case YMIN_:
 					if (! thy v_hasGetYmin ()) {
-						formulaError (U"Attribute \"ymin\" not defined for this object", lexan [ilexan]. position);
+						formulaError (U"Attribute \"ymin\" not defined for this object", theFormula -> lexan [theFormula -> ilexan]. position);
 					} else {
 						newparse (NUMBER_);
 						parsenumber (thy v_getYmin ());
@@ -1320,7 +1324,7 @@ static void parsePowerFactor () {
 					}
 				case YMAX_:
 					if (! thy v_hasGetYmax ()) {
-						formulaError (U"Attribute \"ymax\" not defined for this object", lexan [ilexan]. position);
+						formulaError (U"Attribute \"ymax\" not defined for this object", theFormula -> lexan [theFormula -> ilexan]. position);
 					} else {
 						newparse (NUMBER_);
 						parsenumber (thy v_getYmax ());
@@ -1328,7 +1332,7 @@ static void parsePowerFactor () {
 					}
 				case NX_:
 					if (! thy v_hasGetNx ()) {
-						formulaError (U"Attribute \"nx\" not defined for this object", lexan [ilexan]. position);
+						formulaError (U"Attribute \"nx\" not defined for this object", theFormula -> lexan [theFormula -> ilexan]. position);
 					} else {
 						newparse (NUMBER_);
 						parsenumber (thy v_getNx ());
@@ -1336,7 +1340,7 @@ static void parsePowerFactor () {
 					}
 				case NY_:
 					if (! thy v_hasGetNy ()) {
-						formulaError (U"Attribute \"ny\" not defined for this object", lexan [ilexan]. position);
+						formulaError (U"Attribute \"ny\" not defined for this object", theFormula -> lexan [theFormula -> ilexan]. position);
 					} else {
 						newparse (NUMBER_);
 						parsenumber (thy v_getNy ());
@@ -1344,7 +1348,7 @@ static void parsePowerFactor () {
 					}
 				case DX_:
 					if (! thy v_hasGetDx ()) {
-						formulaError (U"Attribute \"dx\" not defined for this object", lexan [ilexan]. position);
+						formulaError (U"Attribute \"dx\" not defined for this object", theFormula -> lexan [theFormula -> ilexan]. position);
 					} else {
 						newparse (NUMBER_);
 						parsenumber (thy v_getDx ());
@@ -1352,7 +1356,7 @@ static void parsePowerFactor () {
 					}
 				case DY_:
 					if (! thy v_hasGetDy ()) {
-						formulaError (U"Attribute \"dy\" not defined for this object", lexan [ilexan]. position);
+						formulaError (U"Attribute \"dy\" not defined for this object", theFormula -> lexan [theFormula -> ilexan]. position);
 					} else {
 						newparse (NUMBER_);
 						parsenumber (thy v_getDy ());
@@ -1360,7 +1364,7 @@ static void parsePowerFactor () {
 					}
 				case NCOL_:
 					if (! thy v_hasGetNcol ()) {
-						formulaError (U"Attribute \"ncol\" not defined for this object", lexan [ilexan]. position);
+						formulaError (U"Attribute \"ncol\" not defined for this object", theFormula -> lexan [theFormula -> ilexan]. position);
 					} else {
 						newparse (NUMBER_);
 						parsenumber (thy v_getNcol ());
@@ -1368,7 +1372,7 @@ static void parsePowerFactor () {
 					}
 				case NROW_:
 					if (! thy v_hasGetNrow ()) {
-						formulaError (U"Attribute \"nrow\" not defined for this object", lexan [ilexan]. position);
+						formulaError (U"Attribute \"nrow\" not defined for this object", theFormula -> lexan [theFormula -> ilexan]. position);
 					} else {
 						newparse (NUMBER_);
 						parsenumber (thy v_getNrow ());
@@ -1376,59 +1380,59 @@ static void parsePowerFactor () {
 					}
 				case ROW_STR_:
 					if (! thy v_hasGetRowStr ()) {
-						formulaError (U"Attribute \"row$\" not defined for this object", lexan [ilexan]. position);
+						formulaError (U"Attribute \"row$\" not defined for this object", theFormula -> lexan [theFormula -> ilexan]. position);
 					} else {
 						fit (OPENING_BRACKET_);
 						parseExpression ();
 						newparse (ROW_STR_);
-						parse [iparse]. content.object = thee;
+						theFormula -> parse [theFormula -> iparse]. content.object = thee;
 						fit (CLOSING_BRACKET_);
 						return;
 					}
 				case COL_STR_:
 					if (! thy v_hasGetColStr ()) {
-						formulaError (U"Attribute \"col$\" not defined for this object", lexan [ilexan]. position);
+						formulaError (U"Attribute \"col$\" not defined for this object", theFormula -> lexan [theFormula -> ilexan]. position);
 					} else {
 						fit (OPENING_BRACKET_);
 						parseExpression ();
 						newparse (COL_STR_);
-						parse [iparse]. content.object = thee;
+						theFormula -> parse [theFormula -> iparse]. content.object = thee;
 						fit (CLOSING_BRACKET_);
 						return;
 					}
-				default: formulaError (U"Unknown attribute.", lexan [ilexan]. position);
+				default: formulaError (U"Unknown attribute.", theFormula -> lexan [theFormula -> ilexan]. position);
 			}
 		} else {
-			formulaError (U"After a name of a matrix there should be \"(\", \"[\", or \".\"", lexan [ilexan]. position);
+			formulaError (U"After a name of a matrix there should be \"(\", \"[\", or \".\"", theFormula -> lexan [theFormula -> ilexan]. position);
 		}
 		return;
 	}
 
 	if (symbol == MATRIX_STR_) {
-		Daata thee = lexan [ilexan]. content.object;
+		Daata thee = theFormula -> lexan [theFormula -> ilexan]. content.object;
 		Melder_assert (thee != nullptr);
 		symbol = newread;
 		if (symbol == OPENING_BRACKET_) {
 			if (newread == CLOSING_BRACKET_) {
 				newparse (MATRIX0_STR_);
-				parse [iparse]. content.object = thee;
+				theFormula -> parse [theFormula -> iparse]. content.object = thee;
 			} else {
 				oldread;
 				parseExpression ();
 				if (newread == COMMA_) {
 					parseExpression ();
 					newparse (MATRIX2_STR_);
-					parse [iparse]. content.object = thee;
+					theFormula -> parse [theFormula -> iparse]. content.object = thee;
 					fit (CLOSING_BRACKET_);
 				} else {
 					oldread;
 					newparse (MATRIX1_STR_);
-					parse [iparse]. content.object = thee;
+					theFormula -> parse [theFormula -> iparse]. content.object = thee;
 					fit (CLOSING_BRACKET_);
 				}
 			}
 		} else {
-			formulaError (U"After a name of a matrix$ there should be \"[\"", lexan [ilexan]. position);
+			formulaError (U"After a name of a matrix$ there should be \"[\"", theFormula -> lexan [theFormula -> ilexan]. position);
 		}
 		return;
 	}
@@ -1512,7 +1516,7 @@ static void parsePowerFactor () {
 	}
 
 	if (symbol == CALL_) {
-		char32 *procedureName = lexan [ilexan]. content.string;   // reference copy!
+		char32 *procedureName = theFormula -> lexan [theFormula -> ilexan]. content.string;   // reference copy!
 		int n = 0;
 		bool isParenthesis = fitArguments ();
 		if (newread != CLOSING_PARENTHESIS_) {
@@ -1528,7 +1532,7 @@ static void parsePowerFactor () {
 		}
 		newparse (NUMBER_); parsenumber (n);
 		newparse (CALL_);
-		parse [iparse]. content.string = procedureName;
+		theFormula -> parse [theFormula -> iparse]. content.string = procedureName;
 		return;
 	}
 
@@ -1573,7 +1577,7 @@ static void parsePowerFactor () {
 			if (isParenthesis) fit (CLOSING_PARENTHESIS_);
 		} else {
 			oldread;   // needed for retry if we are going to be in a string comparison?
-			formulaError (U"Function expected", lexan [ilexan + 1]. position);
+			formulaError (U"Function expected", theFormula -> lexan [theFormula -> ilexan + 1]. position);
 		}
 		newparse (symbol);
 		return;
@@ -1587,14 +1591,14 @@ static void parsePowerFactor () {
 			int symbol2 = newread;
 			if (symbol2 == NUMERIC_VARIABLE_) {   // an existing variable
 				newparse (VARIABLE_REFERENCE_);
-				InterpreterVariable loopVariable = lexan [ilexan]. content.variable;
-				parse [iparse]. content.variable = loopVariable;
+				InterpreterVariable loopVariable = theFormula -> lexan [theFormula -> ilexan]. content.variable;
+				theFormula -> parse [theFormula -> iparse]. content.variable = loopVariable;
 			} else if (symbol2 == VARIABLE_NAME_) {   // a new variable
-				InterpreterVariable loopVariable = Interpreter_lookUpVariable (theInterpreter, lexan [ilexan]. content.string);
+				InterpreterVariable loopVariable = Interpreter_lookUpVariable (theFormula -> interpreter, theFormula -> lexan [theFormula -> ilexan]. content.string);
 				newparse (VARIABLE_REFERENCE_);
-				parse [iparse]. content.variable = loopVariable;
+				theFormula -> parse [theFormula -> iparse]. content.variable = loopVariable;
 			} else {
-				formulaError (U"Numeric variable expected", lexan [ilexan]. position);
+				formulaError (U"Numeric variable expected", theFormula -> lexan [theFormula -> ilexan]. position);
 			}
 			// now on stack: sum, loop variable
 			if (newread == FROM_) {
@@ -1632,16 +1636,16 @@ static void parsePowerFactor () {
 	}
 
 	oldread;   // needed for retry if we are going to be in a string comparison
-	formulaError (U"Symbol misplaced", lexan [ilexan + 1]. position);
+	formulaError (U"Symbol misplaced", theFormula -> lexan [theFormula -> ilexan + 1]. position);
 }
 
 static void parseFactor ();
 
 static void parsePowerFactors () {
 	if (newread == POWER_) {
-		if (ilexan > 2 && lexan [ilexan - 2]. symbol == MINUS_ && lexan [ilexan - 1]. symbol == NUMBER_) {
+		if (theFormula -> ilexan > 2 && theFormula -> lexan [theFormula -> ilexan - 2]. symbol == MINUS_ && theFormula -> lexan [theFormula -> ilexan - 1]. symbol == NUMBER_) {
 			oldread;
-			formulaError (U"Expressions like -3^4 are ambiguous; use (-3)^4 or -(3^4) or -(3)^4", lexan [ilexan + 1]. position);
+			formulaError (U"Expressions like -3^4 are ambiguous; use (-3)^4 or -(3^4) or -(3)^4", theFormula -> lexan [theFormula -> ilexan + 1]. position);
 		}
 		parseFactor ();   // like a^-b
 		newparse (POWER_);
@@ -1766,24 +1770,24 @@ static void parseExpression () {
 */
 
 static void Formula_parseExpression () {
-	ilabel = ilexan = iparse = 0;
-	if (lexan [1]. symbol == END_) Melder_throw (U"Empty formula.");
+	theFormula -> ilabel = theFormula -> ilexan = theFormula -> iparse = 0;
+	if (theFormula -> lexan [1]. symbol == END_) Melder_throw (U"Empty formula.");
 	parseExpression ();
 	fit (END_);
 	newparse (END_);
-	numberOfInstructions = iparse;
+	theFormula -> numberOfInstructions = theFormula -> iparse;
 }
 
 static void shift (int begin, int distance) {
-	numberOfInstructions -= distance;
-	for (int j = begin; j <= numberOfInstructions; j ++)
-		parse [j] = parse [j + distance];
+	theFormula -> numberOfInstructions -= distance;
+	for (int j = begin; j <= theFormula -> numberOfInstructions; j ++)
+		theFormula -> parse [j] = theFormula -> parse [j + distance];
 }
 
 static int findLabel (int label) {
-	int result = numberOfInstructions;
-	while (parse [result]. symbol != LABEL_ ||
-			 parse [result]. content.label != label)
+	int result = theFormula -> numberOfInstructions;
+	while (theFormula -> parse [result]. symbol != LABEL_ ||
+			 theFormula -> parse [result]. content.label != label)
 		result --;
 	return result;
 }
@@ -1801,26 +1805,26 @@ static void Formula_optimizeFlow ()
 	int i, j, volg;
 	for (;;) {
 		bool improved = false;
-		for (i = 1; i <= numberOfInstructions; i ++)
+		for (i = 1; i <= theFormula -> numberOfInstructions; i ++)
 		{
 
 /* Optimalisatie 1: */
 /*    true   goto x  ->  goto y  /  __  ...  label x  iftrue y    */
 /*    false  goto x  ->  goto y  /  __  ...  label x  iffalse y   */
 
-			if ((parse [i]. symbol == TRUE_ &&
-				 parse [i + 1]. symbol == GOTO_ &&
-				 parse [volg = findLabel (parse [i + 1]. content.label) + 1]
+			if ((theFormula -> parse [i]. symbol == TRUE_ &&
+				 theFormula -> parse [i + 1]. symbol == GOTO_ &&
+				 theFormula -> parse [volg = findLabel (theFormula -> parse [i + 1]. content.label) + 1]
 							. symbol == IFTRUE_)
 				 ||
-				 (parse [i]. symbol == FALSE_ &&
-				  parse [i + 1]. symbol == GOTO_ &&
-				  parse [volg = findLabel (parse [i + 1]. content.label) + 1]
+				 (theFormula -> parse [i]. symbol == FALSE_ &&
+				  theFormula -> parse [i + 1]. symbol == GOTO_ &&
+				  theFormula -> parse [volg = findLabel (theFormula -> parse [i + 1]. content.label) + 1]
 							. symbol == IFFALSE_))
 			{
 				 improved = true;
-				 parse [i]. symbol = GOTO_;
-				 parse [i]. content.label = parse [volg]. content.label;
+				 theFormula -> parse [i]. symbol = GOTO_;
+				 theFormula -> parse [i]. content.label = theFormula -> parse [volg]. content.label;
 				 shift (i + 1, 1);
 			}
 
@@ -1829,71 +1833,71 @@ static void Formula_optimizeFlow ()
 /*          goto z  ...  label x  iffalse y  label z   */
 /*    en analoog met false en iftrue. */
 
-			if ((parse [i]. symbol == TRUE_ &&
-				 parse [i + 1]. symbol == GOTO_ &&
-				 parse [volg = findLabel (parse [i + 1]. content.label) + 1]
+			if ((theFormula -> parse [i]. symbol == TRUE_ &&
+				 theFormula -> parse [i + 1]. symbol == GOTO_ &&
+				 theFormula -> parse [volg = findLabel (theFormula -> parse [i + 1]. content.label) + 1]
 							. symbol == IFFALSE_)
 				 ||
-				 (parse [i]. symbol == FALSE_ &&
-				  parse [i + 1]. symbol == GOTO_ &&
-				  parse [volg = findLabel (parse [i + 1]. content.label) + 1]
+				 (theFormula -> parse [i]. symbol == FALSE_ &&
+				  theFormula -> parse [i + 1]. symbol == GOTO_ &&
+				  theFormula -> parse [volg = findLabel (theFormula -> parse [i + 1]. content.label) + 1]
 							. symbol == IFTRUE_))
 			{
 				improved = true;
-				parse [i]. symbol = GOTO_;
-				parse [i]. content.label = newlabel;
+				theFormula -> parse [i]. symbol = GOTO_;
+				theFormula -> parse [i]. content.label = newlabel;
 				for (j = i + 1; j < volg; j ++)
-					parse [j] = parse [j + 1];
-				parse [volg]. symbol = LABEL_;
-				parse [volg]. content.label = ilabel;
+					theFormula -> parse [j] = theFormula -> parse [j + 1];
+				theFormula -> parse [volg]. symbol = LABEL_;
+				theFormula -> parse [volg]. content.label = theFormula -> ilabel;
 			}
 
 /* Optimalisatie 3a: */
 /*    iftrue x  goto y  label x  ->  iffalse y  label x   */
 
-			if (parse [i]. symbol == IFTRUE_ &&
-				 parse [i + 1]. symbol == GOTO_ &&
-				 parse [i + 2]. symbol == LABEL_ &&
-				 parse [i]. content.label == parse [i + 2]. content.label)
+			if (theFormula -> parse [i]. symbol == IFTRUE_ &&
+				 theFormula -> parse [i + 1]. symbol == GOTO_ &&
+				 theFormula -> parse [i + 2]. symbol == LABEL_ &&
+				 theFormula -> parse [i]. content.label == theFormula -> parse [i + 2]. content.label)
 			{
 				improved = true;
-				parse [i]. symbol = IFFALSE_;
-				parse [i]. content.label = parse [i + 1]. content.label;
+				theFormula -> parse [i]. symbol = IFFALSE_;
+				theFormula -> parse [i]. content.label = theFormula -> parse [i + 1]. content.label;
 				shift (i + 1, 1);
 			}
 
 /* Optimalisatie 3b: */
 /*    iffalse x  goto y  label x  ->  iftrue y  label x   */
 
-			if (parse [i]. symbol == IFFALSE_ &&
-				 parse [i + 1]. symbol == GOTO_ &&
-				 parse [i + 2]. symbol == LABEL_ &&
-				 parse [i]. content.label == parse [i + 2]. content.label)
+			if (theFormula -> parse [i]. symbol == IFFALSE_ &&
+				 theFormula -> parse [i + 1]. symbol == GOTO_ &&
+				 theFormula -> parse [i + 2]. symbol == LABEL_ &&
+				 theFormula -> parse [i]. content.label == theFormula -> parse [i + 2]. content.label)
 			{
 				improved = true;
-				parse [i]. symbol = IFTRUE_;
-				parse [i]. content.label = parse [i + 1]. content.label;
+				theFormula -> parse [i]. symbol = IFTRUE_;
+				theFormula -> parse [i]. content.label = theFormula -> parse [i + 1]. content.label;
 				shift (i + 1, 1);
 			}
 
 /* Optimalisatie 4: */
 /*    verwijder onbereikbare kode: na een GOTO_ hoort een LABEL_. */
 
-			if (parse [i]. symbol == GOTO_ &&
-				 parse [i + 1]. symbol != LABEL_)
+			if (theFormula -> parse [i]. symbol == GOTO_ &&
+				 theFormula -> parse [i + 1]. symbol != LABEL_)
 			{
 				improved = true;
 				j = i + 2;
-				while (parse [j]. symbol != LABEL_) j ++;
+				while (theFormula -> parse [j]. symbol != LABEL_) j ++;
 				shift (i + 1, j - i - 1);
 			}
 
 /* Optimalisatie 5: */
 /*    goto x  ->  0  /  __  label x   */
 
-			if (parse [i]. symbol == GOTO_ &&
-				 parse [i]. symbol == LABEL_ &&
-				 parse [i]. content.label == parse [i + 1]. content.label)
+			if (theFormula -> parse [i]. symbol == GOTO_ &&
+				 theFormula -> parse [i]. symbol == LABEL_ &&
+				 theFormula -> parse [i]. content.label == theFormula -> parse [i + 1]. content.label)
 			{
 				improved = true;
 				shift (i, 1);
@@ -1903,8 +1907,8 @@ static void Formula_optimizeFlow ()
 /*    true   iffalse x  ->  0  */
 /*    false  iftrue x   ->  0  */
 
-			if ((parse [i]. symbol == TRUE_ && parse [i + 1]. symbol == IFFALSE_)
-				|| (parse [i]. symbol == FALSE_ && parse [i + 1]. symbol == IFTRUE_))
+			if ((theFormula -> parse [i]. symbol == TRUE_ && theFormula -> parse [i + 1]. symbol == IFFALSE_)
+				|| (theFormula -> parse [i]. symbol == FALSE_ && theFormula -> parse [i + 1]. symbol == IFTRUE_))
 			{
 				improved = true;
 				shift (i, 2);
@@ -1914,12 +1918,12 @@ static void Formula_optimizeFlow ()
 /*    true   iftrue x   ->  goto x    */
 /*    false  iffalse x  ->  goto x    */
 
-			if ((parse [i]. symbol == TRUE_ && parse [i + 1]. symbol == IFTRUE_)
-				|| (parse [i]. symbol == FALSE_ && parse [i + 1]. symbol == IFFALSE_))
+			if ((theFormula -> parse [i]. symbol == TRUE_ && theFormula -> parse [i + 1]. symbol == IFTRUE_)
+				|| (theFormula -> parse [i]. symbol == FALSE_ && theFormula -> parse [i + 1]. symbol == IFFALSE_))
 			{
 				improved = true;
-				parse [i]. symbol = GOTO_;
-				parse [i]. content.label = parse [i + 1]. content.label;
+				theFormula -> parse [i]. symbol = GOTO_;
+				theFormula -> parse [i]. content.label = theFormula -> parse [i + 1]. content.label;
 				shift (i + 1, 1);
 			}
 
@@ -1927,32 +1931,32 @@ static void Formula_optimizeFlow ()
 /*    iftrue x   ->  iftrue y   /  __  ...  label x  goto y   */
 /*    iffalse x  ->  iffalse y  /  __  ...  label x  goto y   */
 
-			if ((parse [i]. symbol == IFTRUE_ || parse [i]. symbol == IFFALSE_)
-				&& parse [volg = findLabel (parse [i]. content.label) + 1]. symbol == GOTO_)
+			if ((theFormula -> parse [i]. symbol == IFTRUE_ || theFormula -> parse [i]. symbol == IFFALSE_)
+				&& theFormula -> parse [volg = findLabel (theFormula -> parse [i]. content.label) + 1]. symbol == GOTO_)
 			{
 				improved = true;
-				parse [i]. content.label = parse [volg]. content.label;
+				theFormula -> parse [i]. content.label = theFormula -> parse [volg]. content.label;
 			}
 
 /* Optimalisatie 9a: */
 /*    not  iftrue x  ->  iffalse x   */
 
-			if (parse [i]. symbol == NOT_ && parse [i + 1]. symbol == IFTRUE_)
+			if (theFormula -> parse [i]. symbol == NOT_ && theFormula -> parse [i + 1]. symbol == IFTRUE_)
 			{
 				improved = true;
-				parse [i]. symbol = IFFALSE_;
-				parse [i]. content.label = parse [i + 1]. content.label;
+				theFormula -> parse [i]. symbol = IFFALSE_;
+				theFormula -> parse [i]. content.label = theFormula -> parse [i + 1]. content.label;
 				shift (i + 1, 1);
 			}
 
 /* Optimalisatie 9b: */
 /*    not  iffalse x  ->  iftrue x   */
 
-			if (parse [i]. symbol == NOT_ && parse [i + 1]. symbol == IFFALSE_)
+			if (theFormula -> parse [i]. symbol == NOT_ && theFormula -> parse [i + 1]. symbol == IFFALSE_)
 			{
 				improved = true;
-				parse [i]. symbol = IFTRUE_;
-				parse [i]. content.label = parse [i + 1]. content.label;
+				theFormula -> parse [i]. symbol = IFTRUE_;
+				theFormula -> parse [i]. content.label = theFormula -> parse [i + 1]. content.label;
 				shift (i + 1, 1);
 			}
 
@@ -1964,14 +1968,14 @@ static void Formula_optimizeFlow ()
 
 		/* Verwijder labels waar niet naar verwezen wordt. */
 
-		for (i = 1; i <= numberOfInstructions; i ++)
-			if (parse [i]. symbol == LABEL_)
+		for (i = 1; i <= theFormula -> numberOfInstructions; i ++)
+			if (theFormula -> parse [i]. symbol == LABEL_)
 			{
 				int gevonden = 0;
-				for (j = 1; j <= numberOfInstructions; j ++)
-					if ((parse [j]. symbol == GOTO_ || parse [j]. symbol == IFFALSE_ || parse [j]. symbol == IFTRUE_
-						|| parse [j]. symbol == INCREMENT_GREATER_GOTO_)
-						&& parse [i]. content.label == parse [j]. content.label)
+				for (j = 1; j <= theFormula -> numberOfInstructions; j ++)
+					if ((theFormula -> parse [j]. symbol == GOTO_ || theFormula -> parse [j]. symbol == IFFALSE_ || theFormula -> parse [j]. symbol == IFTRUE_
+						|| theFormula -> parse [j]. symbol == INCREMENT_GREATER_GOTO_)
+						&& theFormula -> parse [i]. content.label == theFormula -> parse [j]. content.label)
 						gevonden = 1;
 				if (! gevonden)
 				{
@@ -1993,7 +1997,7 @@ static int praat_findObjectById (integer id) {
 static int praat_findObjectByName (conststring32 name) {
 	int IOBJECT;
 	if (*name >= U'A' && *name <= U'Z') {
-		static MelderString buffer;
+		static thread_local MelderString buffer;
 		MelderString_copy (& buffer, name);
 		char32 *spaceLocation = str32chr (buffer.string, U' ');
 		if (! spaceLocation)
@@ -2015,57 +2019,60 @@ static int praat_findObjectByName (conststring32 name) {
 	Melder_throw (U"No object with name \"", name, U"\".");
 }
 
+static int Formula_elementwiseArity (int symbol);
+static integer Formula_computeElementwiseStackDepth ();
+static void Formula_applyElementwise1 (int symbol, VEC const& x);
+static void Formula_applyElementwise2 (int symbol, VEC const& x, constVEC const& y);
+
 static void Formula_evaluateConstants () {
 	for (;;) {
 		bool improved = false;
-		for (int i = 1; i <= numberOfInstructions; i ++) {
+		for (int i = 1; i <= theFormula -> numberOfInstructions; i ++) {
 			int gain = 0;
-			if (parse [i]. symbol == NUMBER_) {
-				if (parse [i]. content.number == 2.0 && parse [i + 1]. symbol == POWER_)
-					{ gain = 1; parse [i]. symbol = SQR_; }
-				else if (parse [i + 1]. symbol == MINUS_)
-					{ gain = 1; parse [i]. content.number = - parse [i]. content.number; }
-				else if (parse [i + 1]. symbol == SQR_)
-					{ gain = 1; parse [i]. content.number *= parse [i]. content.number; }
-				else if (parse [i + 1]. symbol == NUMBER_) {
-					if (parse [i + 2]. symbol == ADD_)
-						{ gain = 2; parse [i]. content.number += parse [i + 1]. content.number; }
-					else if (parse [i + 2]. symbol == SUB_)
-						{ gain = 2; parse [i]. content.number -= parse [i + 1]. content.number; }
-					else if (parse [i + 2]. symbol == MUL_)
-						{ gain = 2; parse [i]. content.number *= parse [i + 1]. content.number; }
-					else if (parse [i + 2]. symbol == RDIV_)
-						{ gain = 2; parse [i]. content.number /= parse [i + 1]. content.number; }
-				} else if (parse [i + 1]. symbol == TO_OBJECT_) {
-					parse [i]. symbol = OBJECT_;
-					int IOBJECT = praat_findObjectById (Melder_iround (parse [i]. content.number));
-					parse [i]. content.object = OBJECT;
+			if (theFormula -> parse [i]. symbol == NUMBER_) {
+				if (theFormula -> parse [i]. content.number == 2.0 && theFormula -> parse [i + 1]. symbol == POWER_)
+					{ gain = 1; theFormula -> parse [i]. symbol = SQR_; }
+				else if (Formula_elementwiseArity (theFormula -> parse [i + 1]. symbol) == 1) {
+					/*
+						A function of a constant, e.g. `-3`, `sqrt (2)`, `ln (10)`;
+						we use the same kernel as at run time, so that e.g. `sqrt (-1)` still becomes undefined.
+					*/
+					gain = 1;
+					Formula_applyElementwise1 (theFormula -> parse [i + 1]. symbol, VEC (& theFormula -> parse [i]. content.number, 1));
+				} else if (theFormula -> parse [i + 1]. symbol == NUMBER_ && Formula_elementwiseArity (theFormula -> parse [i + 2]. symbol) == 2) {
+					gain = 2;
+					Formula_applyElementwise2 (theFormula -> parse [i + 2]. symbol,
+							VEC (& theFormula -> parse [i]. content.number, 1), constVEC (& theFormula -> parse [i + 1]. content.number, 1));
+				} else if (theFormula -> parse [i + 1]. symbol == TO_OBJECT_) {
+					theFormula -> parse [i]. symbol = OBJECT_;
+					int IOBJECT = praat_findObjectById (Melder_iround (theFormula -> parse [i]. content.number));
+					theFormula -> parse [i]. content.object = OBJECT;
 					gain = 1;
 				}
-			} else if (parse [i]. symbol == STRING_) {
-				if (parse [i + 1]. symbol == TO_OBJECT_) {
-					parse [i]. symbol = OBJECT_;
-					int IOBJECT = praat_findObjectByName (parse [i]. content.string);
-					parse [i]. content.object = OBJECT;
+			} else if (theFormula -> parse [i]. symbol == STRING_) {
+				if (theFormula -> parse [i + 1]. symbol == TO_OBJECT_) {
+					theFormula -> parse [i]. symbol = OBJECT_;
+					int IOBJECT = praat_findObjectByName (theFormula -> parse [i]. content.string);
+					theFormula -> parse [i]. content.object = OBJECT;
 					gain = 1;
 				}
-			} else if (parse [i]. symbol == NUMERIC_VARIABLE_) {
-				parse [i]. symbol = NUMBER_;
-				parse [i]. content.number = parse [i]. content.variable -> numericValue;
+			} else if (theFormula -> parse [i]. symbol == NUMERIC_VARIABLE_) {
+				theFormula -> parse [i]. symbol = NUMBER_;
+				theFormula -> parse [i]. content.number = theFormula -> parse [i]. content.variable -> numericValue;
 				gain = 0;
 				improved = true;
-			} else if (parse [i]. symbol == STRING_VARIABLE_) {
-				parse [i]. symbol = STRING_;
-				parse [i]. content.string = parse [i]. content.variable -> stringValue.get();   // again a reference copy (lexan is still the owner)
+			} else if (theFormula -> parse [i]. symbol == STRING_VARIABLE_) {
+				theFormula -> parse [i]. symbol = STRING_;
+				theFormula -> parse [i]. content.string = theFormula -> parse [i]. content.variable -> stringValue.get();   // again a reference copy (lexan is still the owner)
 				gain = 0;
 				improved = true;
 			#if 0
-			} else if (parse [i]. symbol == ROW_) {
-				if (parse [i + 1]. symbol == COL_ && parse [i + 2]. symbol == SELFMATRIX2_)
-					{ gain = 2; parse [i]. symbol = SELF0_; }   // TODO: SELF0_ may not have the same restrictions as SELFMATRIX2_
-			} else if (parse [i]. symbol == COL_) {
-				if (parse [i + 1]. symbol == SELFMATRIX1_)
-					{ gain = 1; parse [i]. symbol = SELF0_; }
+			} else if (theFormula -> parse [i]. symbol == ROW_) {
+				if (theFormula -> parse [i + 1]. symbol == COL_ && theFormula -> parse [i + 2]. symbol == SELFMATRIX2_)
+					{ gain = 2; theFormula -> parse [i]. symbol = SELF0_; }   // TODO: SELF0_ may not have the same restrictions as SELFMATRIX2_
+			} else if (theFormula -> parse [i]. symbol == COL_) {
+				if (theFormula -> parse [i + 1]. symbol == SELFMATRIX1_)
+					{ gain = 1; theFormula -> parse [i]. symbol = SELF0_; }
 			#endif
 			}
 			if (gain > 0) {
@@ -2081,13 +2088,13 @@ static void Formula_removeLabels () {
 	/*
 	 * First translate symbolic labels (< 0) into instructions locations (> 0).
 	 */
-	for (int i = 1; i <= numberOfInstructions; i ++) {
-		int symboli = parse [i]. symbol;
+	for (int i = 1; i <= theFormula -> numberOfInstructions; i ++) {
+		int symboli = theFormula -> parse [i]. symbol;
 		if (symboli == GOTO_ || symboli == IFTRUE_ || symboli == IFFALSE_ || symboli == INCREMENT_GREATER_GOTO_) {
-			int label = parse [i]. content.label;
-			for (int j = 1; j <= numberOfInstructions; j ++) {
-				if (parse [j]. symbol == LABEL_ && parse [j]. content.label == label) {
-					parse [i]. content.label = j;
+			int label = theFormula -> parse [i]. content.label;
+			for (int j = 1; j <= theFormula -> numberOfInstructions; j ++) {
+				if (theFormula -> parse [j]. symbol == LABEL_ && theFormula -> parse [j]. content.label == label) {
+					theFormula -> parse [i]. content.label = j;
 				}
 			}
 		}
@@ -2096,23 +2103,23 @@ static void Formula_removeLabels () {
 		Then remove the labels,
 		which have become superfluous.
 	*/
-	if (theOptimize) {
+	if (theFormula -> optimize) {
 		int i = 1;
-		while (i <= numberOfInstructions) {
-			int symboli = parse [i]. symbol;
+		while (i <= theFormula -> numberOfInstructions) {
+			int symboli = theFormula -> parse [i]. symbol;
 			if (symboli == LABEL_) {
 				shift (i, 1);   // remove one label
-				for (int j = 1; j <= numberOfInstructions; j ++) {
-					int symbolj = parse [j]. symbol;
-					if ((symbolj == GOTO_ || symbolj == IFTRUE_ || symbolj == IFFALSE_ || symbolj == INCREMENT_GREATER_GOTO_) && parse [j]. content.label > i)
-						parse [j]. content.label --;  /* Pas een label aan. */
+				for (int j = 1; j <= theFormula -> numberOfInstructions; j ++) {
+					int symbolj = theFormula -> parse [j]. symbol;
+					if ((symbolj == GOTO_ || symbolj == IFTRUE_ || symbolj == IFFALSE_ || symbolj == INCREMENT_GREATER_GOTO_) && theFormula -> parse [j]. content.label > i)
+						theFormula -> parse [j]. content.label --;  /* Pas een label aan. */
 				}
 				i --;   // voorkom ophogen i (overbodig?)
 			}
 			i ++;
 		}
 	}
-	numberOfInstructions --;   /* Het END_-symbol hoeft niet geinterpreteerd. */
+	theFormula -> numberOfInstructions --;   /* Het END_-symbol hoeft niet geinterpreteerd. */
 }
 
 #include <inttypes.h>
@@ -2153,59 +2160,112 @@ static void Formula_print (FormulaInstruction f) {
 	} while (symbol != END_);
 }
 
-void Formula_compile (Interpreter interpreter, Daata data, conststring32 expression, int expressionType, bool optimize) {
-	theInterpreter = interpreter;
-	if (! theInterpreter) {
-		if (! theLocalInterpreter)
-			theLocalInterpreter = Interpreter_create (nullptr, nullptr);
-		theInterpreter = theLocalInterpreter.get();
-		theInterpreter -> variablesMap. clear ();
-	}
-	theSource = data;
-	theExpression = expression;
-	theExpressionType [theLevel] = expressionType;
-	theOptimize = optimize;
-	if (! lexan) {
-		lexan = Melder_calloc_f (structFormulaInstruction, Formula_MAXIMUM_STACK_SIZE);
-		lexan [Formula_MAXIMUM_STACK_SIZE - 1]. symbol = END_;   // make sure that cleaning up always terminates
-	}
-	if (! parse)
-		parse = Melder_calloc_f (structFormulaInstruction, Formula_MAXIMUM_STACK_SIZE);
-
+static void FormulaContext_freeStringConstants (FormulaContext me) {
 	/*
-		Clean up strings from the previous call.
 		These strings are in a union, that's why this cannot be done later, when a new string is created.
 	*/
-	if (numberOfStringConstants) {
-		ilexan = 1;
+	if (my numberOfStringConstants) {
+		my ilexan = 1;
 		for (;;) {
-			int symbol = lexan [ilexan]. symbol;
+			int symbol = my lexan [my ilexan]. symbol;
 			if (symbol == STRING_ ||
 				symbol == VARIABLE_NAME_ ||
 				symbol == INDEXED_NUMERIC_VARIABLE_ ||
 				symbol == INDEXED_STRING_VARIABLE_ ||
 				symbol == CALL_
 			) {
-				Melder_free (lexan [ilexan]. content.string);
+				Melder_free (my lexan [my ilexan]. content.string);
 			}
 			else if (symbol == END_) break;   // either the end of a formula, or the end of lexan
-			ilexan ++;
+			my ilexan ++;
 		}
-		numberOfStringConstants = 0;
+		my numberOfStringConstants = 0;
 	}
+}
+
+void structFormulaContext :: v_destroy () noexcept {
+	if (our lexan)
+		FormulaContext_freeStringConstants (this);
+	Melder_free (our lexan);
+	Melder_free (our parse);
+	Melder_free (our stack);   // every element has been reset at the end of the last run
+	FormulaContext_Parent :: v_destroy ();
+}
+
+namespace {
+	/*
+		Makes a formula context the current one in this thread for as long as it is in scope.
+		A context that is made current for running is marked as running,
+		so that a formula that is compiled in the meantime (e.g. by evaluate ()) gets a nested context,
+		and becomes the compiled formula again afterwards, so that the next run of the same formula finds it.
+	*/
+	class autoFormulaContextActivation {
+		FormulaContext _context, _previous;
+		bool _running;
+	public:
+		autoFormulaContextActivation (FormulaContext context, bool running)
+			: _context (context), _previous (theFormula), _running (running)
+		{
+			theFormula = context;
+			if (running)
+				context -> isRunning = true;
+		}
+		~ autoFormulaContextActivation () {
+			if (_running) {
+				_context -> isRunning = false;
+				theCompiledFormula = _context;
+			}
+			theFormula = _previous;
+		}
+	};
+}
+
+void Formula_compile (Interpreter interpreter, Daata data, conststring32 expression, int expressionType, bool optimize) {
+	if (! interpreter) {
+		if (! theLocalInterpreter)
+			theLocalInterpreter = Interpreter_create (nullptr, nullptr);
+		interpreter = theLocalInterpreter.get();
+		interpreter -> variablesMap. clear ();
+	}
+	autoFormulaContext *slot = & interpreter -> formulaContext;
+	while (*slot && (*slot) -> isRunning)
+		slot = & (*slot) -> nested;
+	if (! *slot)
+		*slot = Thing_new (FormulaContext);
+	theCompiledFormula = slot -> get();
+	autoFormulaContextActivation activation (theCompiledFormula, false);
+
+	theFormula -> interpreter = interpreter;
+	theFormula -> source = data;
+	theFormula -> expression = expression;
+	theFormula -> expressionType = expressionType;
+	theFormula -> optimize = optimize;
+	theFormula -> elementwiseStackDepth = 0;
+	if (! theFormula -> lexan) {
+		theFormula -> lexan = Melder_calloc_f (structFormulaInstruction, Formula_MAXIMUM_STACK_SIZE);
+		theFormula -> lexan [Formula_MAXIMUM_STACK_SIZE - 1]. symbol = END_;   // make sure that cleaning up always terminates
+	}
+	if (! theFormula -> parse)
+		theFormula -> parse = Melder_calloc_f (structFormulaInstruction, Formula_MAXIMUM_STACK_SIZE);
+
+	/*
+		Clean up strings from the previous call.
+	*/
+	FormulaContext_freeStringConstants (theFormula);
 
 	Formula_lexan ();
-	if (Melder_debug == 17) Formula_print (lexan);
+	if (Melder_debug == 17) Formula_print (theFormula -> lexan);
 	Formula_parseExpression ();
-	if (Melder_debug == 17) Formula_print (parse);
-	if (theOptimize) {
+	if (Melder_debug == 17) Formula_print (theFormula -> parse);
+	if (theFormula -> optimize) {
 		Formula_optimizeFlow ();
-		if (Melder_debug == 17) Formula_print (parse);
+		if (Melder_debug == 17) Formula_print (theFormula -> parse);
 		Formula_evaluateConstants ();
-		if (Melder_debug == 17) Formula_print (parse);
+		if (Melder_debug == 17) Formula_print (theFormula -> parse);
 	}
 	Formula_removeLabels ();
-	if (Melder_debug == 17) Formula_print (parse);
+	if (Melder_debug == 17) Formula_print (theFormula -> parse);
+	theFormula -> elementwiseStackDepth = Formula_computeElementwiseStackDepth ();
 }
 
 /*
@@ -2223,12 +2283,8 @@ conststring32 structStackel :: whichText () {
 		U"???";
 }
 
-static int programPointer;
-
-static Stackel theStack;
-static integer w, wmax;   /* w = stack pointer; */
-#define pop  & theStack [w --]
-#define topOfStack  & theStack [w]
+#define pop  & theFormula -> stack [theFormula -> w --]
+#define topOfStack  & theFormula -> stack [theFormula -> w]
 inline static void pushNumber (double x) {
 	/* inline runs 10 to 20 percent faster; here's the test script:
 		stopwatch
@@ -2237,10 +2293,10 @@ inline static void pushNumber (double x) {
 		Remove
 	 * Mac: 3.76 -> 3.20 seconds
 	 */
-	if (++ w > wmax)
-		if (++ wmax > Formula_MAXIMUM_STACK_SIZE)
+	if (++ theFormula -> w > theFormula -> wmax)
+		if (++ theFormula -> wmax > Formula_MAXIMUM_STACK_SIZE)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
-	Stackel stackel = & theStack [w];
+	Stackel stackel = & theFormula -> stack [theFormula -> w];
 	stackel -> reset();
 	stackel -> which = Stackel_NUMBER;
 	stackel -> number = ( isdefined (x) ? x : undefined );
@@ -2248,89 +2304,89 @@ inline static void pushNumber (double x) {
 	//stackel -> owned = true;   // superfluous, because never checked (2020-12-20)
 }
 static void pushNumericVector (autoVEC x) {
-	if (++ w > wmax)
-		if (++ wmax > Formula_MAXIMUM_STACK_SIZE)
+	if (++ theFormula -> w > theFormula -> wmax)
+		if (++ theFormula -> wmax > Formula_MAXIMUM_STACK_SIZE)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
-	Stackel stackel = & theStack [w];
+	Stackel stackel = & theFormula -> stack [theFormula -> w];
 	stackel -> reset();
 	stackel -> which = Stackel_NUMERIC_VECTOR;
 	stackel -> numericVector = x.releaseToAmbiguousOwner();
 	stackel -> owned = true;
 }
 static void pushNumericVectorReference (VEC x) {
-	if (++ w > wmax)
-		if (++ wmax > Formula_MAXIMUM_STACK_SIZE)
+	if (++ theFormula -> w > theFormula -> wmax)
+		if (++ theFormula -> wmax > Formula_MAXIMUM_STACK_SIZE)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
-	Stackel stackel = & theStack [w];
+	Stackel stackel = & theFormula -> stack [theFormula -> w];
 	stackel -> reset();
 	stackel -> which = Stackel_NUMERIC_VECTOR;
 	stackel -> numericVector = x;
 	stackel -> owned = false;
 }
 static void pushNumericMatrix (autoMAT x) {
-	if (++ w > wmax)
-		if (++ wmax > Formula_MAXIMUM_STACK_SIZE)
+	if (++ theFormula -> w > theFormula -> wmax)
+		if (++ theFormula -> wmax > Formula_MAXIMUM_STACK_SIZE)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
-	Stackel stackel = & theStack [w];
+	Stackel stackel = & theFormula -> stack [theFormula -> w];
 	stackel -> reset();
 	stackel -> which = Stackel_NUMERIC_MATRIX;
 	stackel -> numericMatrix = x.releaseToAmbiguousOwner();
 	stackel -> owned = true;
 }
 static void pushNumericMatrixReference (MAT x) {
-	if (++ w > wmax)
-		if (++ wmax > Formula_MAXIMUM_STACK_SIZE)
+	if (++ theFormula -> w > theFormula -> wmax)
+		if (++ theFormula -> wmax > Formula_MAXIMUM_STACK_SIZE)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
-	Stackel stackel = & theStack [w];
+	Stackel stackel = & theFormula -> stack [theFormula -> w];
 	stackel -> reset();
 	stackel -> which = Stackel_NUMERIC_MATRIX;
 	stackel -> numericMatrix = x;
 	stackel -> owned = false;
 }
 static void pushString (autostring32 x) {
-	if (++ w > wmax)
-		if (++ wmax > Formula_MAXIMUM_STACK_SIZE)
+	if (++ theFormula -> w > theFormula -> wmax)
+		if (++ theFormula -> wmax > Formula_MAXIMUM_STACK_SIZE)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
-	Stackel stackel = & theStack [w];
+	Stackel stackel = & theFormula -> stack [theFormula -> w];
 	//stackel -> reset();   // incorporated in next statement
 	stackel -> setString (x.move());
 	//stackel -> owned = true;   // superfluous, because never checked (2020-12-20)
 }
 static void pushStringVector (autoSTRVEC x) {
-	if (++ w > wmax)
-		if (++ wmax > Formula_MAXIMUM_STACK_SIZE)
+	if (++ theFormula -> w > theFormula -> wmax)
+		if (++ theFormula -> wmax > Formula_MAXIMUM_STACK_SIZE)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
-	Stackel stackel = & theStack [w];
+	Stackel stackel = & theFormula -> stack [theFormula -> w];
 	stackel -> reset();
 	stackel -> which = Stackel_STRING_ARRAY;
 	stackel -> stringArray = x.releaseToAmbiguousOwner();
 	stackel -> owned = true;
 }
 static void pushStringVectorReference (STRVEC x) {
-	if (++ w > wmax)
-		if (++ wmax > Formula_MAXIMUM_STACK_SIZE)
+	if (++ theFormula -> w > theFormula -> wmax)
+		if (++ theFormula -> wmax > Formula_MAXIMUM_STACK_SIZE)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
-	Stackel stackel = & theStack [w];
+	Stackel stackel = & theFormula -> stack [theFormula -> w];
 	stackel -> reset();
 	stackel -> which = Stackel_STRING_ARRAY;
 	stackel -> stringArray = x;
 	stackel -> owned = false;
 }
 static void pushObject (Daata object) {
-	if (++ w > wmax)
-		if (++ wmax > Formula_MAXIMUM_STACK_SIZE)
+	if (++ theFormula -> w > theFormula -> wmax)
+		if (++ theFormula -> wmax > Formula_MAXIMUM_STACK_SIZE)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
-	Stackel stackel = & theStack [w];
+	Stackel stackel = & theFormula -> stack [theFormula -> w];
 	stackel -> reset();
 	stackel -> which = Stackel_OBJECT;
 	stackel -> object = object;
 	//stackel -> owned = false;   // superfluous, because never checked (2020-12-20)
 }
 static void pushVariable (InterpreterVariable var) {
-	if (++ w > wmax)
-		if (++ wmax > Formula_MAXIMUM_STACK_SIZE)
+	if (++ theFormula -> w > theFormula -> wmax)
+		if (++ theFormula -> wmax > Formula_MAXIMUM_STACK_SIZE)
 			Melder_throw (U"Formula: stack overflow. Please simplify your formulas.");
-	Stackel stackel = & theStack [w];
+	Stackel stackel = & theFormula -> stack [theFormula -> w];
 	stackel -> reset();
 	stackel -> which = Stackel_VARIABLE;
 	stackel -> variable = var;
@@ -3245,7 +3301,7 @@ static void do_function_n_n (double (*f) (double)) {
 	if (x->which == Stackel_NUMBER) {
 		pushNumber (isundef (x->number) ? undefined : f (x->number));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires a numeric argument, not ", x->whichText(), U".");
 	}
 }
@@ -3265,7 +3321,7 @@ static void do_functionvec_n_n (double (*f) (double)) {
 			x->owned = true;
 		}
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires a numeric vector argument, not ", x->whichText(), U".");
 	}
 }
@@ -3292,7 +3348,7 @@ static void do_softmax_VEC () {
 		for (integer i = 1; i <= nelm; i ++)
 			x->numericVector [i] /= (double) sum;
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires a numeric vector argument, not ", x->whichText(), U".");
 	}
 }
@@ -3321,7 +3377,7 @@ static void do_softmaxPerRow_MAT () {
 				x->numericMatrix [irow] [icol] /= (double) sum;
 		}
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires a numeric matrix argument, not ", x->whichText(), U".");
 	}
 }
@@ -3592,7 +3648,7 @@ static void do_function_dd_d (double (*f) (double, double)) {
 	if (x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		pushNumber (isundef (x->number) || isundef (y->number) ? undefined : f (x->number, y->number));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires two numeric arguments, not ",
 			x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -3601,7 +3657,7 @@ static void do_function_VECdd_d (double (*f) (double, double)) {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	Melder_require (narg->number == 3,
-		U"The function ", Formula_instructionNames [parse [programPointer]. symbol], U" requires three arguments.");
+		U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol], U" requires three arguments.");
 	Stackel y = pop, x = pop, a = pop;
 	if ((a->which == Stackel_NUMERIC_VECTOR || a->which == Stackel_NUMBER) && x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		integer numberOfElements = ( a->which == Stackel_NUMBER ? Melder_iround (a->number) : a->numericVector.size );
@@ -3610,7 +3666,7 @@ static void do_function_VECdd_d (double (*f) (double, double)) {
 			newData [ielem] = f (x->number, y->number);
 		pushNumericVector (newData.move());
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires either three numeric arguments, or one vector argument and two numeric arguments, not ",
 			a->whichText(), U", ", x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -3629,7 +3685,7 @@ static void do_function_MATdd_d (double (*f) (double, double)) {
 					newData [irow] [icol] = f (x->number, y->number);
 			pushNumericMatrix (newData.move());
 		} else {
-			Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+			Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 				U" requires one matrix argument and two numeric arguments, not ",
 				model->whichText(), U", ", x->whichText(), U" and ", y->whichText(), U".");
 		}
@@ -3644,19 +3700,19 @@ static void do_function_MATdd_d (double (*f) (double, double)) {
 					newData [irow] [icol] = f (x->number, y->number);
 			pushNumericMatrix (newData.move());
 		} else {
-			Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+			Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 				U" requires four numeric arguments, not ",
 				nrow->whichText(), U", ", ncol->whichText(), U", ", x->whichText(), U" and ", y->whichText(), U".");
 		}
 	} else
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol], U" requires three or four arguments.");
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol], U" requires three or four arguments.");
 }
 
 static void do_function_VECll_l (integer (*f) (integer, integer)) {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	Melder_require (narg-> number == 3,
-		U"The function ", Formula_instructionNames [parse [programPointer]. symbol], U" requires three arguments.");
+		U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol], U" requires three arguments.");
 	Stackel y = pop, x = pop, a = pop;
 	if ((a->which == Stackel_NUMERIC_VECTOR || a->which == Stackel_NUMBER) && x->which == Stackel_NUMBER) {
 		integer numberOfElements = ( a->which == Stackel_NUMBER ? Melder_iround (a->number) : a->numericVector.size );
@@ -3665,7 +3721,7 @@ static void do_function_VECll_l (integer (*f) (integer, integer)) {
 			newData [ielem] = f (Melder_iround (x->number), Melder_iround (y->number));
 		pushNumericVector (newData.move());
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires either three numeric arguments, or one vector argument and two numeric arguments, not ",
 			a->whichText(), U", ", x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -3674,7 +3730,7 @@ static void do_function_MATll_l (integer (*f) (integer, integer)) {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	Melder_require (narg->number == 3,
-		U"The function ", Formula_instructionNames [parse [programPointer]. symbol], U" requires three arguments.");
+		U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol], U" requires three arguments.");
 	Stackel y = pop, x = pop, a = pop;
 	if (a->which == Stackel_NUMERIC_MATRIX && x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		integer numberOfRows = a->numericMatrix.nrow;
@@ -3685,7 +3741,7 @@ static void do_function_MATll_l (integer (*f) (integer, integer)) {
 				newData [irow] [icol] = f (Melder_iround (x->number), Melder_iround (y->number));
 		pushNumericMatrix (newData.move());
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires one matrix argument and two numeric arguments, not ",
 			a->whichText(), U", ", x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -3696,7 +3752,7 @@ static void do_function_dl_d (double (*f) (double, integer)) {
 		pushNumber (isundef (x->number) || isundef (y->number) ? undefined :
 			f (x->number, Melder_iround (y->number)));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires two numeric arguments, not ",
 			x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -3707,7 +3763,7 @@ static void do_function_ld_d (double (*f) (integer, double)) {
 		pushNumber (isundef (x->number) || isundef (y->number) ? undefined :
 			f (Melder_iround (x->number), y->number));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires two numeric arguments, not ",
 			x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -3718,7 +3774,7 @@ static void do_function_ll_l (integer (*f) (integer, integer)) {
 		pushNumber (isundef (x->number) || isundef (y->number) ? undefined :
 			f (Melder_iround (x->number), Melder_iround (y->number)));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires two numeric arguments, not ",
 			x->whichText(), U" and ", y->whichText(), U".");
 	}
@@ -3751,7 +3807,7 @@ static void do_function_ddd_d (double (*f) (double, double, double)) {
 		pushNumber (isundef (x->number) || isundef (y->number) || isundef (z->number) ? undefined :
 			f (x->number, y->number, z->number));
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires three numeric arguments, not ", x->whichText(), U", ",
 			y->whichText(), U", and ", z->whichText(), U".");
 	}
@@ -3776,7 +3832,7 @@ static void do_do () {
 		MelderString_appendCharacter (& valueString, 1);   // TODO: check whether this is needed at all, or is just MelderString_empty enough?
 		autoMelderDivertInfo divert (& valueString);
 		autostring32 command2 = Melder_dup (command);   // allow the menu command to reuse the stack (?)
-		Editor_doMenuCommand (praatP. editor, command2.get(), numberOfArguments, & stack [0], nullptr, theInterpreter);
+		Editor_doMenuCommand (praatP. editor, command2.get(), numberOfArguments, & stack [0], nullptr, theFormula -> interpreter);
 		pushNumber (Melder_atof (valueString.string));
 		return;
 	} else if (theCurrentPraatObjects != & theForegroundPraatObjects &&
@@ -3788,8 +3844,8 @@ static void do_do () {
 		MelderString_appendCharacter (& valueString, 1);   // a semaphor to check whether praat_doAction or praat_doMenuCommand wrote anything with MelderInfo
 		autoMelderDivertInfo divert (& valueString);
 		autostring32 command2 = Melder_dup (command);   // allow the menu command to reuse the stack (?)
-		if (! praat_doAction (command2.get(), numberOfArguments, & stack [0], theInterpreter) &&
-		    ! praat_doMenuCommand (command2.get(), numberOfArguments, & stack [0], theInterpreter))
+		if (! praat_doAction (command2.get(), numberOfArguments, & stack [0], theFormula -> interpreter) &&
+		    ! praat_doMenuCommand (command2.get(), numberOfArguments, & stack [0], theFormula -> interpreter))
 		{
 			Melder_throw (U"Command \"", command, U"\" not available for current selection.");
 		}
@@ -3816,7 +3872,7 @@ static void do_evaluate () {
 	Stackel expression = pop;
 	if (expression->which == Stackel_STRING) {
 		double result;
-		Interpreter_numericExpression (theInterpreter, expression->getString(), & result);
+		Interpreter_numericExpression (theFormula -> interpreter, expression->getString(), & result);
 		pushNumber (result);
 	} else Melder_throw (U"The argument of the function \"evaluate\" should be a string with a numeric expression, not ", expression->whichText());
 }
@@ -3825,7 +3881,7 @@ static void do_evaluate_nocheck () {
 	if (expression->which == Stackel_STRING) {
 		try {
 			double result;
-			Interpreter_numericExpression (theInterpreter, expression->getString(), & result);
+			Interpreter_numericExpression (theFormula -> interpreter, expression->getString(), & result);
 			pushNumber (result);
 		} catch (MelderError) {
 			Melder_clearError ();
@@ -3836,7 +3892,7 @@ static void do_evaluate_nocheck () {
 static void do_evaluate_STR () {
 	Stackel expression = pop;
 	if (expression->which == Stackel_STRING) {
-		autostring32 result = Interpreter_stringExpression (theInterpreter, expression->getString());
+		autostring32 result = Interpreter_stringExpression (theFormula -> interpreter, expression->getString());
 		pushString (result.move());
 	} else Melder_throw (U"The argument of the function \"evaluate$\" should be a string with a string expression, not ", expression->whichText());
 }
@@ -3844,7 +3900,7 @@ static void do_evaluate_nocheck_STR () {
 	Stackel expression = pop;
 	if (expression->which == Stackel_STRING) {
 		try {
-			autostring32 result = Interpreter_stringExpression (theInterpreter, expression->getString());
+			autostring32 result = Interpreter_stringExpression (theFormula -> interpreter, expression->getString());
 			pushString (result.move());
 		} catch (MelderError) {
 			Melder_clearError ();
@@ -3868,11 +3924,11 @@ static void do_do_STR () {
 		Melder_throw (U"The first argument of the function \"do$\" should be a string, namely a menu command, and not ", stack [0]. whichText(), U".");
 	conststring32 command = stack [0]. getString();
 	if (theCurrentPraatObjects == & theForegroundPraatObjects && praatP. editor != nullptr) {
-		static MelderString info;
+		static thread_local MelderString info;
 		MelderString_empty (& info);
 		autoMelderDivertInfo divert (& info);
 		autostring32 command2 = Melder_dup (command);
-		Editor_doMenuCommand (praatP. editor, command2.get(), numberOfArguments, & stack [0], nullptr, theInterpreter);
+		Editor_doMenuCommand (praatP. editor, command2.get(), numberOfArguments, & stack [0], nullptr, theFormula -> interpreter);
 		pushString (Melder_dup (info.string));
 		return;
 	} else if (theCurrentPraatObjects != & theForegroundPraatObjects &&
@@ -3880,12 +3936,12 @@ static void do_do_STR () {
 	{
 		Melder_throw (U"Commands that write files (including Quit) are not available inside manuals.");
 	} else {
-		static MelderString info;
+		static thread_local MelderString info;
 		MelderString_empty (& info);
 		autoMelderDivertInfo divert (& info);
 		autostring32 command2 = Melder_dup (command);
-		if (! praat_doAction (command2.get(), numberOfArguments, & stack [0], theInterpreter) &&
-		    ! praat_doMenuCommand (command2.get(), numberOfArguments, & stack [0], theInterpreter))
+		if (! praat_doAction (command2.get(), numberOfArguments, & stack [0], theFormula -> interpreter) &&
+		    ! praat_doMenuCommand (command2.get(), numberOfArguments, & stack [0], theFormula -> interpreter))
 		{
 			Melder_throw (U"Command \"", command, U"\" not available for current selection.");
 		}
@@ -3898,7 +3954,7 @@ static void do_do_STR () {
 }
 static void shared_do_writeInfo (integer numberOfArguments) {
 	for (integer iarg = 1; iarg <= numberOfArguments; iarg ++) {
-		Stackel arg = & theStack [w + iarg];
+		Stackel arg = & theFormula -> stack [theFormula -> w + iarg];
 		if (arg->which == Stackel_NUMBER) {
 			MelderInfo_write (arg->number);
 		} else if (arg->which == Stackel_STRING) {
@@ -3925,7 +3981,7 @@ static void do_writeInfo () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	integer numberOfArguments = Melder_iround (narg->number);
-	w -= numberOfArguments;
+	theFormula -> w -= numberOfArguments;
 	MelderInfo_open ();
 	shared_do_writeInfo (numberOfArguments);
 	MelderInfo_drain ();
@@ -3935,7 +3991,7 @@ static void do_writeInfoLine () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	integer numberOfArguments = Melder_iround (narg->number);
-	w -= numberOfArguments;
+	theFormula -> w -= numberOfArguments;
 	MelderInfo_open ();
 	shared_do_writeInfo (numberOfArguments);
 	MelderInfo_write (U"\n");
@@ -3946,7 +4002,7 @@ static void do_appendInfo () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	integer numberOfArguments = Melder_iround (narg->number);
-	w -= numberOfArguments;
+	theFormula -> w -= numberOfArguments;
 	shared_do_writeInfo (numberOfArguments);
 	MelderInfo_drain ();
 	pushNumber (1);
@@ -3955,7 +4011,7 @@ static void do_appendInfoLine () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	integer numberOfArguments = Melder_iround (narg->number);
-	w -= numberOfArguments;
+	theFormula -> w -= numberOfArguments;
 	shared_do_writeInfo (numberOfArguments);
 	MelderInfo_write (U"\n");
 	MelderInfo_drain ();
@@ -3963,7 +4019,7 @@ static void do_appendInfoLine () {
 }
 static void shared_do_writeFile (autoMelderString *text, integer numberOfArguments) {
 	for (int iarg = 2; iarg <= numberOfArguments; iarg ++) {
-		Stackel arg = & theStack [w + iarg];
+		Stackel arg = & theFormula -> stack [theFormula -> w + iarg];
 		if (arg->which == Stackel_NUMBER) {
 			MelderString_append (text, arg->number);
 		} else if (arg->which == Stackel_STRING) {
@@ -3988,8 +4044,8 @@ static void do_writeFile () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	integer numberOfArguments = Melder_iround (narg->number);
-	w -= numberOfArguments;
-	Stackel fileName = & theStack [w + 1];
+	theFormula -> w -= numberOfArguments;
+	Stackel fileName = & theFormula -> stack [theFormula -> w + 1];
 	Melder_require (fileName->which == Stackel_STRING,
 		U"The first argument of \"writeFile\" should be a string (a file name), not ", fileName->whichText(), U".");
 	autoMelderString text;
@@ -4005,8 +4061,8 @@ static void do_writeFileLine () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	integer numberOfArguments = Melder_iround (narg->number);
-	w -= numberOfArguments;
-	Stackel fileName = & theStack [w + 1];
+	theFormula -> w -= numberOfArguments;
+	Stackel fileName = & theFormula -> stack [theFormula -> w + 1];
 	Melder_require (fileName->which == Stackel_STRING,
 		U"The first argument of \"writeFileLine\" should be a string (a file name), not ", fileName->whichText(), U".");
 	autoMelderString text;
@@ -4023,8 +4079,8 @@ static void do_appendFile () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	integer numberOfArguments = Melder_iround (narg->number);
-	w -= numberOfArguments;
-	Stackel fileName = & theStack [w + 1];
+	theFormula -> w -= numberOfArguments;
+	Stackel fileName = & theFormula -> stack [theFormula -> w + 1];
 	Melder_require (fileName->which == Stackel_STRING,
 		U"The first argument of \"appendFile\" should be a string (a file name), not ", fileName->whichText(), U".");
 	autoMelderString text;
@@ -4040,8 +4096,8 @@ static void do_appendFileLine () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	integer numberOfArguments = Melder_iround (narg->number);
-	w -= numberOfArguments;
-	Stackel fileName = & theStack [w + 1];
+	theFormula -> w -= numberOfArguments;
+	Stackel fileName = & theFormula -> stack [theFormula -> w + 1];
 	Melder_require (fileName->which == Stackel_STRING,
 		U"The first argument of \"appendFileLine\" should be a string (a file name), not ", fileName->whichText(), U".");
 	autoMelderString text;
@@ -4058,19 +4114,19 @@ static void do_pauseScript () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	integer numberOfArguments = Melder_iround (narg->number);
-	w -= numberOfArguments;
+	theFormula -> w -= numberOfArguments;
 	if (! theCurrentPraatApplication -> batch) {   // in batch we ignore pause statements
 		autoMelderString buffer;
 		for (int iarg = 1; iarg <= numberOfArguments; iarg ++) {
-			Stackel arg = & theStack [w + iarg];
+			Stackel arg = & theFormula -> stack [theFormula -> w + iarg];
 			if (arg->which == Stackel_NUMBER)
 				MelderString_append (& buffer, arg->number);
 			else if (arg->which == Stackel_STRING)
 				MelderString_append (& buffer, arg->getString());
 		}
-		UiPause_begin (theCurrentPraatApplication -> topShell, U"stop or continue", theInterpreter);
+		UiPause_begin (theCurrentPraatApplication -> topShell, U"stop or continue", theFormula -> interpreter);
 		UiPause_comment (numberOfArguments == 0 ? U"..." : buffer.string);
-		UiPause_end (1, 1, 0, U"Continue", nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, theInterpreter);
+		UiPause_end (1, 1, 0, U"Continue", nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, theFormula -> interpreter);
 	}
 	pushNumber (1);
 }
@@ -4078,9 +4134,9 @@ static void do_exitScript () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	integer numberOfArguments = Melder_iround (narg->number);
-	w -= numberOfArguments;
+	theFormula -> w -= numberOfArguments;
 	for (int iarg = 1; iarg <= numberOfArguments; iarg ++) {
-		Stackel arg = & theStack [w + iarg];
+		Stackel arg = & theFormula -> stack [theFormula -> w + iarg];
 		if (arg->which == Stackel_NUMBER)
 			Melder_appendError_noLine (arg->number);
 		else if (arg->which == Stackel_STRING)
@@ -4095,18 +4151,11 @@ static void do_runScript () {
 	integer numberOfArguments = Melder_iround (narg->number);
 	if (numberOfArguments < 1)
 		Melder_throw (U"The function \"runScript\" requires at least one argument, namely the file name.");
-	w -= numberOfArguments;
-	Stackel fileName = & theStack [w + 1];
+	theFormula -> w -= numberOfArguments;
+	Stackel fileName = & theFormula -> stack [theFormula -> w + 1];
 	Melder_require (fileName->which == Stackel_STRING,
 		U"The first argument to \"runScript\" should be a string (the file name), not ", fileName->whichText());
-	theLevel += 1;
-	try {
-		praat_executeScriptFromFileName (fileName->getString(), numberOfArguments - 1, & theStack [w + 1]);
-		theLevel -= 1;
-	} catch (MelderError) {
-		theLevel -= 1;
-		throw;
-	}
+	praat_executeScriptFromFileName (fileName->getString(), numberOfArguments - 1, & theFormula -> stack [theFormula -> w + 1]);   // in an interpreter, hence a formula context, of its own
 	pushNumber (1);
 }
 static void do_runSystem () {
@@ -4115,10 +4164,10 @@ static void do_runSystem () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	integer numberOfArguments = Melder_iround (narg->number);
-	w -= numberOfArguments;
+	theFormula -> w -= numberOfArguments;
 	autoMelderString text;
 	for (integer iarg = 1; iarg <= numberOfArguments; iarg ++) {
-		Stackel arg = & theStack [w + iarg];
+		Stackel arg = & theFormula -> stack [theFormula -> w + iarg];
 		if (arg->which == Stackel_NUMBER)
 			MelderString_append (& text, arg->number);
 		else if (arg->which == Stackel_STRING)
@@ -4138,10 +4187,10 @@ static void do_runSystem_nocheck () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	integer numberOfArguments = Melder_iround (narg->number);
-	w -= numberOfArguments;
+	theFormula -> w -= numberOfArguments;
 	autoMelderString text;
 	for (int iarg = 1; iarg <= numberOfArguments; iarg ++) {
-		Stackel arg = & theStack [w + iarg];
+		Stackel arg = & theFormula -> stack [theFormula -> w + iarg];
 		if (arg->which == Stackel_NUMBER)
 			MelderString_append (& text, arg->number);
 		else if (arg->which == Stackel_STRING)
@@ -4160,13 +4209,13 @@ static void do_runSubprocess () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	integer numberOfArguments = Melder_iround (narg->number);
-	w -= numberOfArguments;
-	Stackel commandFile = & theStack [w + 1];
+	theFormula -> w -= numberOfArguments;
+	Stackel commandFile = & theFormula -> stack [theFormula -> w + 1];
 	Melder_require (commandFile->which == Stackel_STRING,
 		U"The first argument to \"runSubprocess\" should be a command name.");
 	autoSTRVEC arguments (numberOfArguments - 1);
 	for (int iarg = 1; iarg < numberOfArguments; iarg ++) {
-		Stackel arg = & theStack [w + 1 + iarg];
+		Stackel arg = & theFormula -> stack [theFormula -> w + 1 + iarg];
 		if (arg->which == Stackel_NUMBER)
 			arguments [iarg] = Melder_dup (Melder_double (arg->number));
 		else if (arg->which == Stackel_STRING)
@@ -4541,7 +4590,7 @@ static void do_numberOfRows () {
 	if (array->which == Stackel_NUMERIC_MATRIX) {
 		pushNumber (array->numericMatrix.nrow);
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires a matrix argument, not ", array->whichText(), U".");
 	}
 }
@@ -4554,7 +4603,7 @@ static void do_numberOfColumns () {
 	if (array->which == Stackel_NUMERIC_MATRIX) {
 		pushNumber (array->numericMatrix.ncol);
 	} else {
-		Melder_throw (U"The function ", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function ", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U" requires a matrix argument, not ", array->whichText(), U".");
 	}
 }
@@ -4562,8 +4611,8 @@ static void do_editor () {
 	Stackel narg = pop;
 	Melder_assert (narg->which == Stackel_NUMBER);
 	if (narg->number == 0) {
-		if (theInterpreter && theInterpreter -> editorClass) {
-			praatP. editor = praat_findEditorFromString (theInterpreter -> environmentName.get());
+		if (theFormula -> interpreter && theFormula -> interpreter -> editorClass) {
+			praatP. editor = praat_findEditorFromString (theFormula -> interpreter -> environmentName.get());
 		} else {
 			Melder_throw (U"The function \"editor\" requires an argument when called from outside an editor.");
 		}
@@ -4740,7 +4789,7 @@ static void do_splitByWhitespace_STRVEC () {
 	pushStringVector (result.move());
 }
 static void do_numericVectorElement () {
-	InterpreterVariable vector = parse [programPointer]. content.variable;
+	InterpreterVariable vector = theFormula -> parse [theFormula -> programPointer]. content.variable;
 	integer element = 1;   // default
 	Stackel r = pop;
 	Melder_require (r->which == Stackel_NUMBER,
@@ -4755,7 +4804,7 @@ static void do_numericVectorElement () {
 	pushNumber (vector->numericVectorValue [element]);
 }
 static void do_numericMatrixElement () {
-	InterpreterVariable matrix = parse [programPointer]. content.variable;
+	InterpreterVariable matrix = theFormula -> parse [theFormula -> programPointer]. content.variable;
 	integer row = 1, column = 1;   // default
 	Stackel c = pop;
 	Melder_require (c->which == Stackel_NUMBER,
@@ -4780,7 +4829,7 @@ static void do_numericMatrixElement () {
 	pushNumber (matrix->numericMatrixValue [row] [column]);
 }
 static void do_stringVectorElement () {
-	InterpreterVariable vector = parse [programPointer]. content.variable;
+	InterpreterVariable vector = theFormula -> parse [theFormula -> programPointer]. content.variable;
 	integer element = 1;   // default
 	Stackel r = pop;
 	Melder_require (r->which == Stackel_NUMBER,
@@ -4800,12 +4849,12 @@ static void do_indexedNumericVariable () {
 	integer nindex = Melder_iround (narg->number);
 	Melder_require (nindex >= 1,
 		U"Indexed variables require at least one index.");
-	char32 *indexedVariableName = parse [programPointer]. content.string;
-	static MelderString totalVariableName;
+	char32 *indexedVariableName = theFormula -> parse [theFormula -> programPointer]. content.string;
+	static thread_local MelderString totalVariableName;
 	MelderString_copy (& totalVariableName, indexedVariableName, U"[");
-	w -= nindex;
+	theFormula -> w -= nindex;
 	for (int iindex = 1; iindex <= nindex; iindex ++) {
-		Stackel index = & theStack [w + iindex];
+		Stackel index = & theFormula -> stack [theFormula -> w + iindex];
 		if (index->which == Stackel_NUMBER) {
 			MelderString_append (& totalVariableName, index->number, iindex == nindex ? U"]" : U",");
 		} else if (index -> which == Stackel_STRING) {
@@ -4814,7 +4863,7 @@ static void do_indexedNumericVariable () {
 			Melder_throw (U"In indexed variables, the index should be a number or a string, not ", index->whichText(), U".");
 		}
 	}
-	InterpreterVariable var = Interpreter_hasVariable (theInterpreter, totalVariableName.string);
+	InterpreterVariable var = Interpreter_hasVariable (theFormula -> interpreter, totalVariableName.string);
 	Melder_require (!! var,
 		U"Undefined indexed variable «", totalVariableName.string, U"».");
 	pushNumber (var -> numericValue);
@@ -4825,12 +4874,12 @@ static void do_indexedStringVariable () {
 	integer nindex = Melder_iround (narg->number);
 	Melder_require (nindex >= 1,
 		U"Indexed variables require at least one index.");
-	char32 *indexedVariableName = parse [programPointer]. content.string;
-	static MelderString totalVariableName;
+	char32 *indexedVariableName = theFormula -> parse [theFormula -> programPointer]. content.string;
+	static thread_local MelderString totalVariableName;
 	MelderString_copy (& totalVariableName, indexedVariableName, U"[");
-	w -= nindex;
+	theFormula -> w -= nindex;
 	for (int iindex = 1; iindex <= nindex; iindex ++) {
-		Stackel index = & theStack [w + iindex];
+		Stackel index = & theFormula -> stack [theFormula -> w + iindex];
 		if (index->which == Stackel_NUMBER) {
 			MelderString_append (& totalVariableName, index -> number, iindex == nindex ? U"]" : U",");
 		} else if (index -> which == Stackel_STRING) {
@@ -4839,7 +4888,7 @@ static void do_indexedStringVariable () {
 			Melder_throw (U"In indexed variables, the index should be a number or a string, not ", index->whichText(), U".");
 		}
 	}
-	InterpreterVariable var = Interpreter_hasVariable (theInterpreter, totalVariableName.string);
+	InterpreterVariable var = Interpreter_hasVariable (theFormula -> interpreter, totalVariableName.string);
 	Melder_require (!! var,
 		U"Undefined indexed variable «", totalVariableName.string, U"».");
 	autostring32 result = Melder_dup (var -> stringValue.get());
@@ -5039,7 +5088,7 @@ static void do_stringMatchesCriterion (kMelder_string criterion) {
 		int result = Melder_stringMatchesCriterion (s->getString(), criterion, t->getString(), true);
 		pushNumber (result);
 	} else {
-		Melder_throw (U"The function \"", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function \"", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U"\" requires two strings, not ", s->whichText(), U" and ", t->whichText(), U".");
 	}
 }
@@ -5060,7 +5109,7 @@ static void do_index_regex (int backward) {
 			}
 		}
 	} else {
-		Melder_throw (U"The function \"", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function \"", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U"\" requires two strings, not ", s->whichText(), U" and ", t->whichText(), U".");
 	}
 }
@@ -5127,7 +5176,7 @@ static void do_extractNumber () {
 			}
 		}
 	} else {
-		Melder_throw (U"The function \"", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function \"", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U"\" requires two strings, not ", s->whichText(), U" and ", t->whichText(), U".");
 	}
 }
@@ -5160,7 +5209,7 @@ static void do_extractText_STR (bool singleWord) {
 		}
 		pushString (result.move());
 	} else {
-		Melder_throw (U"The function \"", Formula_instructionNames [parse [programPointer]. symbol],
+		Melder_throw (U"The function \"", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol],
 			U"\" requires two strings, not ", s->whichText(), U" and ", t->whichText(), U".");
 	}
 }
@@ -5577,7 +5626,7 @@ static void do_createDirectory () {
 static void do_variableExists () {
 	Stackel f = pop;
 	if (f->which == Stackel_STRING) {
-		bool result = !! Interpreter_hasVariable (theInterpreter, f->getString());
+		bool result = !! Interpreter_hasVariable (theFormula -> interpreter, f->getString());
 		pushNumber (result);
 	} else {
 		Melder_throw (U"The function \"variableExists\" requires a string, not ", f->whichText(), U".");
@@ -6055,7 +6104,7 @@ static void do_beginPauseForm () {
 	if (n->number == 1) {
 		Stackel title = pop;
 		if (title->which == Stackel_STRING) {
-			UiPause_begin (theCurrentPraatApplication -> topShell, title->getString(), theInterpreter);
+			UiPause_begin (theCurrentPraatApplication -> topShell, title->getString(), theFormula -> interpreter);
 		} else {
 			Melder_throw (U"The function \"beginPauseForm\" requires a string (the title), not ", title->whichText(), U".");
 		}
@@ -6350,7 +6399,7 @@ static void do_endPauseForm () {
 		! co [5] ? nullptr : co[5]->getString(), ! co [6] ? nullptr : co[6]->getString(),
 		! co [7] ? nullptr : co[7]->getString(), ! co [8] ? nullptr : co[8]->getString(),
 		! co [9] ? nullptr : co[9]->getString(), ! co [10] ? nullptr : co[10]->getString(),
-		theInterpreter);
+		theFormula -> interpreter);
 	//Melder_casual (U"Button ", buttonClicked);
 	pushNumber (buttonClicked);
 }
@@ -6454,14 +6503,14 @@ static void do_demoWaitForInput () {
 	Stackel n = pop;
 	if (n->number != 0)
 		Melder_throw (U"The function \"demoWaitForInput\" requires 0 arguments, not ", n->number, U".");
-	Demo_waitForInput (theInterpreter);
+	Demo_waitForInput (theFormula -> interpreter);
 	pushNumber (1);
 }
 static void do_demoPeekInput () {
 	Stackel n = pop;
 	if (n->number != 0)
 		Melder_throw (U"The function \"demoPeekInput\" requires 0 arguments, not ", n->number, U".");
-	Demo_peekInput (theInterpreter);
+	Demo_peekInput (theFormula -> interpreter);
 	pushNumber (1);
 }
 static void do_demoInput () {
@@ -6580,7 +6629,7 @@ static integer Stackel_getColumnNumber (Stackel column, Daata thee) {
 	return result;
 }
 static void do_self0 (integer irow, integer icol) {
-	Daata me = theSource;
+	Daata me = theFormula -> source;
 	if (! me) Melder_throw (U"The name \"self\" is restricted to formulas for objects.");
 	if (my v_hasGetCell ()) {
 		pushNumber (my v_getCell ());
@@ -6612,7 +6661,7 @@ static void do_self0 (integer irow, integer icol) {
 	}
 }
 static void do_selfStr0 (integer irow, integer icol) {
-	Daata me = theSource;
+	Daata me = theFormula -> source;
 	if (! me) Melder_throw (U"The name \"self$\" is restricted to formulas for objects.");
 	if (my v_hasGetCellStr ()) {
 		pushString (Melder_dup (my v_getCellStr ()));
@@ -6697,7 +6746,7 @@ static void do_objectCell0 (integer irow, integer icol) {
 	}
 }
 static void do_matrix0 (integer irow, integer icol) {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theFormula -> parse [theFormula -> programPointer]. content.object;
 	if (thy v_hasGetCell ()) {
 		pushNumber (thy v_getCell ());
 	} else if (thy v_hasGetVector ()) {
@@ -6727,7 +6776,7 @@ static void do_matrix0 (integer irow, integer icol) {
 	}
 }
 static void do_selfMatrix1 (integer irow) {
-	Daata me = theSource;
+	Daata me = theFormula -> source;
 	Stackel column = pop;
 	if (! me) Melder_throw (U"The name \"self\" is restricted to formulas for objects.");
 	integer icol = Stackel_getColumnNumber (column, me);
@@ -6746,7 +6795,7 @@ static void do_selfMatrix1 (integer irow) {
 	}
 }
 static void do_selfMatrix1_STR (integer irow) {
-	Daata me = theSource;
+	Daata me = theFormula -> source;
 	Stackel column = pop;
 	if (! me) Melder_throw (U"The name \"self$\" is restricted to formulas for objects.");
 	integer icol = Stackel_getColumnNumber (column, me);
@@ -6783,7 +6832,7 @@ static void do_objectCell1 (integer irow) {
 	}
 }
 static void do_matrix1 (integer irow) {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theFormula -> parse [theFormula -> programPointer]. content.object;
 	Stackel column = pop;
 	integer icol = Stackel_getColumnNumber (column, thee);
 	if (thy v_hasGetVector ()) {
@@ -6819,7 +6868,7 @@ static void do_objectCell1_STR (integer irow) {
 	}
 }
 static void do_matrix1_STR (integer irow) {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theFormula -> parse [theFormula -> programPointer]. content.object;
 	Stackel column = pop;
 	integer icol = Stackel_getColumnNumber (column, thee);
 	if (thy v_hasGetVectorStr ()) {
@@ -6837,7 +6886,7 @@ static void do_matrix1_STR (integer irow) {
 	}
 }
 static void do_selfMatrix2 () {
-	Daata me = theSource;
+	Daata me = theFormula -> source;
 	Stackel column = pop, row = pop;
 	if (! me) Melder_throw (U"The name \"self\" is restricted to formulas for objects.");
 	integer irow = Stackel_getRowNumber (row, me);
@@ -6847,7 +6896,7 @@ static void do_selfMatrix2 () {
 	pushNumber (my v_getMatrix (irow, icol));
 }
 static void do_selfMatrix2_STR () {
-	Daata me = theSource;
+	Daata me = theFormula -> source;
 	Stackel column = pop, row = pop;
 	if (! me) Melder_throw (U"The name \"self$\" is restricted to formulas for objects.");
 	integer irow = Stackel_getRowNumber (row, me);
@@ -6866,7 +6915,7 @@ static void do_objectCell2 () {
 	pushNumber (thy v_getMatrix (irow, icol));
 }
 static void do_matrix2 () {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theFormula -> parse [theFormula -> programPointer]. content.object;
 	Stackel column = pop, row = pop;
 	integer irow = Stackel_getRowNumber (row, thee);
 	integer icol = Stackel_getColumnNumber (column, thee);
@@ -6884,7 +6933,7 @@ static void do_objectCell2_STR () {
 	pushString (Melder_dup (thy v_getMatrixStr (irow, icol)));
 }
 static void do_matrix2_STR () {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theFormula -> parse [theFormula -> programPointer]. content.object;
 	Stackel column = pop, row = pop;
 	integer irow = Stackel_getRowNumber (row, thee);
 	integer icol = Stackel_getColumnNumber (column, thee);
@@ -6898,7 +6947,7 @@ static void do_objectLocation0 (integer irow, integer icol) {
 	if (thy v_hasGetFunction0 ()) {
 		pushNumber (thy v_getFunction0 ());
 	} else if (thy v_hasGetFunction1 ()) {
-		Daata me = theSource;
+		Daata me = theFormula -> source;
 		if (! me)
 			Melder_throw (U"No current object (we are not in a Formula command),\n"
 				U"hence no implicit x value for this ", Thing_className (thee), U" object.\n"
@@ -6911,7 +6960,7 @@ static void do_objectLocation0 (integer irow, integer icol) {
 		double x = my v_getX (icol);
 		pushNumber (thy v_getFunction1 (irow, x));
 	} else if (thy v_hasGetFunction2 ()) {
-		Daata me = theSource;
+		Daata me = theFormula -> source;
 		if (! me)
 			Melder_throw (U"No current object (we are not in a Formula command),\n"
 				U"hence no implicit x or y values for this ", Thing_className (thee), U" object.\n"
@@ -6932,11 +6981,11 @@ static void do_objectLocation0 (integer irow, integer icol) {
 	}
 }
 static void do_function0 (integer irow, integer icol) {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theFormula -> parse [theFormula -> programPointer]. content.object;
 	if (thy v_hasGetFunction0 ()) {
 		pushNumber (thy v_getFunction0 ());
 	} else if (thy v_hasGetFunction1 ()) {
-		Daata me = theSource;
+		Daata me = theFormula -> source;
 		if (!me)
 			Melder_throw (U"No current object (we are not in a Formula command),\n"
 				U"hence no implicit x value for this ", Thing_className (thee), U" object.\n"
@@ -6949,7 +6998,7 @@ static void do_function0 (integer irow, integer icol) {
 		double x = my v_getX (icol);
 		pushNumber (thy v_getFunction1 (irow, x));
 	} else if (thy v_hasGetFunction2 ()) {
-		Daata me = theSource;
+		Daata me = theFormula -> source;
 		if (! me)
 			Melder_throw (U"No current object (we are not in a Formula command),\n"
 				U"hence no implicit x or y values for this ", Thing_className (thee), U" object.\n"
@@ -6970,7 +7019,7 @@ static void do_function0 (integer irow, integer icol) {
 	}
 }
 static void do_selfFunction1 (integer irow) {
-	Daata me = theSource;
+	Daata me = theFormula -> source;
 	Stackel x = pop;
 	if (x->which == Stackel_NUMBER) {
 		if (! me) Melder_throw (U"The name \"self\" is restricted to formulas for objects.");
@@ -6996,7 +7045,7 @@ static void do_objectLocation1 (integer irow) {
 		if (thy v_hasGetFunction1 ()) {
 			pushNumber (thy v_getFunction1 (irow, x->number));
 		} else if (thy v_hasGetFunction2 ()) {
-			Daata me = theSource;
+			Daata me = theFormula -> source;
 			if (! me)
 				Melder_throw (U"No current object (we are not in a Formula command),\n"
 					U"hence no implicit y value for this ", Thing_className (thee), U" object.\n"
@@ -7015,13 +7064,13 @@ static void do_objectLocation1 (integer irow) {
 	}
 }
 static void do_function1 (integer irow) {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theFormula -> parse [theFormula -> programPointer]. content.object;
 	Stackel x = pop;
 	if (x->which == Stackel_NUMBER) {
 		if (thy v_hasGetFunction1 ()) {
 			pushNumber (thy v_getFunction1 (irow, x->number));
 		} else if (thy v_hasGetFunction2 ()) {
-			Daata me = theSource;
+			Daata me = theFormula -> source;
 			if (! me)
 				Melder_throw (U"No current object (we are not in a Formula command),\n"
 					U"hence no implicit y value for this ", Thing_className (thee), U" object.\n"
@@ -7040,7 +7089,7 @@ static void do_function1 (integer irow) {
 	}
 }
 static void do_selfFunction2 () {
-	Daata me = theSource;
+	Daata me = theFormula -> source;
 	Stackel y = pop, x = pop;
 	if (x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		if (! me) Melder_throw (U"The name \"self\" is restricted to formulas for objects.");
@@ -7063,7 +7112,7 @@ static void do_objectLocation2 () {
 	}
 }
 static void do_function2 () {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theFormula -> parse [theFormula -> programPointer]. content.object;
 	Stackel y = pop, x = pop;
 	if (x->which == Stackel_NUMBER && y->which == Stackel_NUMBER) {
 		if (! thy v_hasGetFunction2 ())
@@ -7074,7 +7123,7 @@ static void do_function2 () {
 	}
 }
 static void do_row_STR () {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theFormula -> parse [theFormula -> programPointer]. content.object;
 	Stackel row = pop;
 	integer irow = Stackel_getRowNumber (row, thee);
 	autostring32 result = Melder_dup (thy v_getRowStr (irow));
@@ -7083,7 +7132,7 @@ static void do_row_STR () {
 	pushString (result.move());
 }
 static void do_col_STR () {
-	Daata thee = parse [programPointer]. content.object;
+	Daata thee = theFormula -> parse [theFormula -> programPointer]. content.object;
 	Stackel col = pop;
 	integer icol = Stackel_getColumnNumber (col, thee);
 	autostring32 result = Melder_dup (thy v_getColStr (icol));
@@ -7106,32 +7155,233 @@ static double NUMerf (double x) {
 	return 1.0 - NUMerfcc (x);
 }
 
+/*
+	Element-wise formulas.
+
+	A numeric formula that combines only numbers, `self`, `row`, `col`, `x` and `y`
+	with arithmetic and with functions of one number (e.g. `self * 2`, `sin (x)`, `abs (self) ^ 0.5`)
+	computes each cell from that cell alone. Such a formula can be run on a whole stretch of a row at once:
+	every instruction then works on a vector of values ("register") instead of on a single stack element,
+	so that the instruction dispatch is paid once per block of cells instead of once per cell.
+	The kernels compute exactly what Formula_run () computes for a single number,
+	including the conversion of non-finite results to `undefined` wherever pushNumber () does that;
+	constant folding uses the same kernels.
+*/
+
+inline static double Formula_pushed (double x) {
+	return ( isdefined (x) ? x : undefined );
+}
+
+static double (*Formula_numericFunction (int symbol)) (double) {
+	switch (symbol) {
+		case SINC_: return NUMsinc;
+		case SINCPI_: return NUMsincpi;
+		case ARCSINH_: return NUMarcsinh;
+		case ARCCOSH_: return NUMarccosh;
+		case ARCTANH_: return NUMarctanh;
+		case SIGMOID_: return NUMsigmoid;
+		case INV_SIGMOID_: return NUMinvSigmoid;
+		case ERF_: return NUMerf;
+		case ERFC_: return NUMerfcc;
+		case GAUSS_P_: return NUMgaussP;
+		case GAUSS_Q_: return NUMgaussQ;
+		case INV_GAUSS_Q_: return NUMinvGaussQ;
+		case LN_GAMMA_: return NUMlnGamma;
+		case HERTZ_TO_BARK_: return NUMhertzToBark;
+		case BARK_TO_HERTZ_: return NUMbarkToHertz;
+		case PHON_TO_DIFFERENCE_LIMENS_: return NUMphonToDifferenceLimens;
+		case DIFFERENCE_LIMENS_TO_PHON_: return NUMdifferenceLimensToPhon;
+		case HERTZ_TO_MEL_: return NUMhertzToMel;
+		case MEL_TO_HERTZ_: return NUMmelToHertz;
+		case HERTZ_TO_SEMITONES_: return NUMhertzToSemitones;
+		case SEMITONES_TO_HERTZ_: return NUMsemitonesToHertz;
+		case ERB_: return NUMerb;
+		case HERTZ_TO_ERB_: return NUMhertzToErb;
+		case ERB_TO_HERTZ_: return NUMerbToHertz;
+		default: return nullptr;   // including the random functions, whose results depend on the order of evaluation
+	}
+}
+
+/*
+	0 for the values that an element-wise formula can load, 1 or 2 for its operations, -1 for everything else.
+*/
+static int Formula_elementwiseArity (int symbol) {
+	switch (symbol) {
+		case NUMBER_: case ROW_: case COL_: case X_: case Y_: case SELF0_:
+			return 0;
+		case MINUS_: case SQR_: case NOT_: case ABS_: case ROUND_: case FLOOR_: case CEILING_: case RECTIFY_:
+		case SQRT_: case SIN_: case COS_: case TAN_: case ARCSIN_: case ARCCOS_: case ARCTAN_:
+		case EXP_: case SINH_: case COSH_: case TANH_: case LOG2_: case LN_: case LOG10_:
+			return 1;
+		case ADD_: case SUB_: case MUL_: case RDIV_: case IDIV_: case MOD_: case POWER_:
+			return 2;
+		default:
+			return ( Formula_numericFunction (symbol) ? 1 : -1 );
+	}
+}
+
+template <typename Function>
+static void Formula_map1 (VEC const& x, Function f) {
+	for (integer i = 1; i <= x.size; i ++)
+		x [i] = Formula_pushed (f (x [i]));
+}
+
+template <typename Function>
+static void Formula_map2 (VEC const& x, constVEC const& y, Function f) {
+	Melder_assert (y.size == x.size);
+	for (integer i = 1; i <= x.size; i ++)
+		x [i] = Formula_pushed (f (x [i], y [i]));
+}
+
+static void Formula_applyElementwise1 (int symbol, VEC const& x) {
+	switch (symbol) {
+		case MINUS_: Formula_map1 (x, [] (double a) { return - a; }); break;
+		case SQR_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : a * a; }); break;
+		case NOT_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : a == 0.0 ? 1.0 : 0.0; }); break;
+		case ABS_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : fabs (a); }); break;
+		case ROUND_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : floor (a + 0.5); }); break;
+		case FLOOR_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : Melder_roundDown (a); }); break;
+		case CEILING_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : Melder_roundUp (a); }); break;
+		case RECTIFY_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : a > 0.0 ? a : 0.0; }); break;
+		case SQRT_: Formula_map1 (x, [] (double a) { return isundef (a) || a < 0.0 ? undefined : sqrt (a); }); break;
+		case SIN_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : sin (a); }); break;
+		case COS_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : cos (a); }); break;
+		case TAN_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : tan (a); }); break;
+		case ARCSIN_: Formula_map1 (x, [] (double a) { return isundef (a) || fabs (a) > 1.0 ? undefined : asin (a); }); break;
+		case ARCCOS_: Formula_map1 (x, [] (double a) { return isundef (a) || fabs (a) > 1.0 ? undefined : acos (a); }); break;
+		case ARCTAN_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : atan (a); }); break;
+		case EXP_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : exp (a); }); break;
+		case SINH_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : sinh (a); }); break;
+		case COSH_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : cosh (a); }); break;
+		case TANH_: Formula_map1 (x, [] (double a) { return isundef (a) ? undefined : tanh (a); }); break;
+		case LOG2_: Formula_map1 (x, [] (double a) { return isundef (a) || a <= 0.0 ? undefined : log (a) * NUMlog2e; }); break;
+		case LN_: Formula_map1 (x, [] (double a) { return isundef (a) || a <= 0.0 ? undefined : log (a); }); break;
+		case LOG10_: Formula_map1 (x, [] (double a) { return isundef (a) || a <= 0.0 ? undefined : log10 (a); }); break;
+		default: {
+			double (*f) (double) = Formula_numericFunction (symbol);
+			Melder_assert (f);
+			Formula_map1 (x, [f] (double a) { return isundef (a) ? undefined : f (a); });
+		}
+	}
+}
+
+static void Formula_applyElementwise2 (int symbol, VEC const& x, constVEC const& y) {
+	switch (symbol) {
+		/*
+			The sum, difference and product of two numbers are left on the stack as they are (see do_add ()),
+			so an overflow to infinity is not converted to `undefined` here.
+		*/
+		case ADD_: for (integer i = 1; i <= x.size; i ++) x [i] += y [i]; break;
+		case SUB_: for (integer i = 1; i <= x.size; i ++) x [i] -= y [i]; break;
+		case MUL_: for (integer i = 1; i <= x.size; i ++) x [i] *= y [i]; break;
+		case RDIV_: Formula_map2 (x, y, [] (double a, double b) { return a / b; }); break;
+		case IDIV_: Formula_map2 (x, y, [] (double a, double b) { return floor (a / b); }); break;
+		case MOD_: Formula_map2 (x, y, [] (double a, double b) { return a - floor (a / b) * b; }); break;
+		case POWER_: Formula_map2 (x, y, [] (double a, double b) { return isundef (a) || isundef (b) ? undefined : pow (a, b); }); break;
+		default: Melder_fatal (U"Formula_applyElementwise2: unknown symbol ", symbol, U".");
+	}
+}
+
+static integer Formula_computeElementwiseStackDepth () {
+	if (theFormula -> expressionType != kFormula_EXPRESSION_TYPE_NUMERIC)
+		return 0;
+	integer depth = 0, maximumDepth = 0;
+	for (int i = 1; i <= theFormula -> numberOfInstructions; i ++) {
+		const int symbol = theFormula -> parse [i]. symbol;
+		const int arity = Formula_elementwiseArity (symbol);
+		if (arity < 0)
+			return 0;
+		if (arity == 0) {
+			/*
+				Formula_run () would complain about a missing object; let it.
+			*/
+			if (symbol == SELF0_ && ! theFormula -> source)
+				return 0;
+			if (symbol == X_ && ! (theFormula -> source && theFormula -> source -> v_hasGetX ()))
+				return 0;
+			if (symbol == Y_ && ! (theFormula -> source && theFormula -> source -> v_hasGetY ()))
+				return 0;
+			if (++ depth > maximumDepth)
+				maximumDepth = depth;
+		} else {
+			if (depth < arity)
+				return 0;
+			depth -= arity - 1;
+		}
+	}
+	return ( depth == 1 ? maximumDepth : 0 );
+}
+
+bool Formula_isElementwise () {
+	return theCompiledFormula && theCompiledFormula -> elementwiseStackDepth > 0;
+}
+
+void Formula_runElementwise (integer row, integer firstColumn, constVEC const& self, VEC const& result) {
+	Melder_assert (Formula_isElementwise ());
+	autoFormulaContextActivation activation (theCompiledFormula, false);
+	Melder_assert (result.size == self.size);
+	constexpr integer maximumBlockSize = 256;
+	if (theFormula -> elementwiseRegisters.nrow < theFormula -> elementwiseStackDepth)
+		theFormula -> elementwiseRegisters = raw_MAT (theFormula -> elementwiseStackDepth, maximumBlockSize);
+	Daata me = theFormula -> source;
+	for (integer offset = 0; offset < self.size; offset += maximumBlockSize) {
+		const integer blockSize = std::min (maximumBlockSize, self.size - offset);
+		const integer firstColumnOfBlock = firstColumn + offset;
+		integer depth = 0;
+		for (int i = 1; i <= theFormula -> numberOfInstructions; i ++) {
+			const int symbol = theFormula -> parse [i]. symbol;
+			const int arity = Formula_elementwiseArity (symbol);
+			if (arity == 0) {
+				const VEC top = theFormula -> elementwiseRegisters.row (++ depth). part (1, blockSize);
+				switch (symbol) {
+					case NUMBER_: top <<= Formula_pushed (theFormula -> parse [i]. content.number); break;
+					case ROW_: top <<= double (row); break;
+					case COL_: for (integer j = 1; j <= blockSize; j ++) top [j] = double (firstColumnOfBlock + j - 1); break;
+					case X_: for (integer j = 1; j <= blockSize; j ++) top [j] = Formula_pushed (my v_getX (firstColumnOfBlock + j - 1)); break;
+					case Y_: top <<= Formula_pushed (my v_getY (row)); break;
+					case SELF0_: for (integer j = 1; j <= blockSize; j ++) top [j] = Formula_pushed (self [offset + j]); break;
+				}
+			} else if (arity == 1) {
+				Formula_applyElementwise1 (symbol, theFormula -> elementwiseRegisters.row (depth). part (1, blockSize));
+			} else {
+				depth --;
+				Formula_applyElementwise2 (symbol, theFormula -> elementwiseRegisters.row (depth). part (1, blockSize),
+						theFormula -> elementwiseRegisters.row (depth + 1). part (1, blockSize));
+			}
+		}
+		Melder_assert (depth == 1);
+		result. part (offset + 1, offset + blockSize) <<= theFormula -> elementwiseRegisters.row (1). part (1, blockSize);
+	}
+}
+
 void Formula_run (integer row, integer col, Formula_Result *result) {
-	FormulaInstruction f = parse;
-	programPointer = 1;   // first symbol of the program
-	if (! theStack) {
-		theStack = Melder_calloc_f (structStackel, 1+Formula_MAXIMUM_STACK_SIZE);
-		if (! theStack)
+	Melder_assert (theCompiledFormula);
+	autoFormulaContextActivation activation (theCompiledFormula, true);
+	FormulaInstruction f = theFormula -> parse;
+	theFormula -> programPointer = 1;   // first symbol of the program
+	if (! theFormula -> stack) {
+		theFormula -> stack = Melder_calloc_f (structStackel, 1+Formula_MAXIMUM_STACK_SIZE);
+		if (! theFormula -> stack)
 			Melder_throw (U"Out of memory during formula computation.");
 	}
-	w = 0;   // start new stack
-	wmax = 0;   // start new stack
+	theFormula -> w = 0;   // start new stack
+	theFormula -> wmax = 0;   // start new stack
 	try {
-		while (programPointer <= numberOfInstructions) {
+		while (theFormula -> programPointer <= theFormula -> numberOfInstructions) {
 			int symbol;
-				switch (symbol = f [programPointer]. symbol) {
+				switch (symbol = f [theFormula -> programPointer]. symbol) {
 
-case NUMBER_: { pushNumber (f [programPointer]. content.number);
+case NUMBER_: { pushNumber (f [theFormula -> programPointer]. content.number);
 } break; case STOPWATCH_: { pushNumber (Melder_stopwatch ());
 } break; case ROW_: { pushNumber (row);
 } break; case COL_: { pushNumber (col);
 } break; case X_: {
-	Daata me = theSource;
+	Daata me = theFormula -> source;
 	Melder_require (my v_hasGetX (),
 		U"No values for \"x\" for this object.");
 	pushNumber (my v_getX (col));
 } break; case Y_: {
-	Daata me = theSource;
+	Daata me = theFormula -> source;
 	Melder_require (my v_hasGetY (),
 		U"No values for \"y\" for this object.");
 	pushNumber (my v_getY (row));
@@ -7422,7 +7672,7 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 		if (condition->number != 0.0) {
 /* Possible compiler BUG: some compilers cannot handle the following assignment. */
 /* Those compilers will have trouble with praat's AND and OR. */
-			programPointer = f [programPointer]. content.label - theOptimize;
+			theFormula -> programPointer = f [theFormula -> programPointer]. content.label - theFormula -> optimize;
 		}
 	} else {
 		Melder_throw (U"A condition between \"if\" and \"then\" should be a number, not ", condition->whichText(), U".");
@@ -7431,13 +7681,13 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 	Stackel condition = pop;
 	if (condition->which == Stackel_NUMBER) {
 		if (condition->number == 0.0) {
-			programPointer = f [programPointer]. content.label - theOptimize;
+			theFormula -> programPointer = f [theFormula -> programPointer]. content.label - theFormula -> optimize;
 		}
 	} else {
 		Melder_throw (U"A condition between \"if\" and \"then\" should be a number, not ", condition->whichText(), U".");
 	}
 } break; case GOTO_: {
-	programPointer = f [programPointer]. content.label - theOptimize;
+	theFormula -> programPointer = f [theFormula -> programPointer]. content.label - theFormula -> optimize;
 } break; case LABEL_: {
 	;
 } break; case DECREMENT_AND_ASSIGN_: {
@@ -7448,7 +7698,7 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 	pushVariable (var);
 } break; case INCREMENT_GREATER_GOTO_: {
 	//Melder_casual (U"top of loop, stack depth ", w);
-	Stackel e = & theStack [w], v = & theStack [w - 1];
+	Stackel e = & theFormula -> stack [theFormula -> w], v = & theFormula -> stack [theFormula -> w - 1];
 	Melder_assert (e->which == Stackel_NUMBER);
 	Melder_assert (v->which == Stackel_VARIABLE);
 	InterpreterVariable var = v->variable;
@@ -7457,17 +7707,17 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 	//Melder_casual (U"loop variable ", var -> numericValue);
 	//Melder_casual (U"end value ", e->number);
 	if (var -> numericValue > e->number) {
-		programPointer = f [programPointer]. content.label - theOptimize;
+		theFormula -> programPointer = f [theFormula -> programPointer]. content.label - theFormula -> optimize;
 	}
 } break; case ADD_3DOWN_: {
-	Stackel x = pop, s = & theStack [w - 2];
+	Stackel x = pop, s = & theFormula -> stack [theFormula -> w - 2];
 	Melder_assert (x->which == Stackel_NUMBER);
 	Melder_assert (s->which == Stackel_NUMBER);
 	//Melder_casual (U"to add ", x->number);
 	s->number += x->number;
 	//Melder_casual (U"sum ", s->number);
 } break; case POP_2_: {
-	w -= 2;
+	theFormula -> w -= 2;
 	//Melder_casual (U"total ", theStack[w].number);
 } break; case VEC_CELL_: { do_numericVectorElement ();
 } break; case MAT_CELL_: { do_numericMatrixElement ();
@@ -7475,11 +7725,11 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 } break; case INDEXED_NUMERIC_VARIABLE_: { do_indexedNumericVariable ();
 } break; case INDEXED_STRING_VARIABLE_: { do_indexedStringVariable ();
 } break; case VARIABLE_REFERENCE_: {
-	InterpreterVariable var = f [programPointer]. content.variable;
+	InterpreterVariable var = f [theFormula -> programPointer]. content.variable;
 	pushVariable (var);
 } break; case SELF0_: { do_self0 (row, col);
 } break; case SELFSTR0_: { do_selfStr0 (row, col);
-} break; case OBJECT_: { pushObject (f [programPointer]. content.object);
+} break; case OBJECT_: { pushObject (f [theFormula -> programPointer]. content.object);
 } break; case TO_OBJECT_: { do_toObject ();
 } break; case SELFMATRIX1_: { do_selfMatrix1 (row);
 } break; case SELFMATRIX1_STR_: { do_selfMatrix1_STR (row);
@@ -7507,145 +7757,145 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 } break; case COL_STR_: { do_col_STR ();
 } break; case SQR_: { do_sqr ();
 } break; case STRING_: {
-	autostring32 string = Melder_dup (f [programPointer]. content.string);
+	autostring32 string = Melder_dup (f [theFormula -> programPointer]. content.string);
 	pushString (string.move());
 } break; case TENSOR_LITERAL_: { do_tensorLiteral ();
 } break; case NUMERIC_VARIABLE_: {
-	InterpreterVariable var = f [programPointer]. content.variable;
+	InterpreterVariable var = f [theFormula -> programPointer]. content.variable;
 	pushNumber (var -> numericValue);
 } break; case NUMERIC_VECTOR_VARIABLE_: {
-	InterpreterVariable var = f [programPointer]. content.variable;
+	InterpreterVariable var = f [theFormula -> programPointer]. content.variable;
 	pushNumericVectorReference (var -> numericVectorValue.get());
 } break; case NUMERIC_MATRIX_VARIABLE_: {
-	InterpreterVariable var = f [programPointer]. content.variable;
+	InterpreterVariable var = f [theFormula -> programPointer]. content.variable;
 	pushNumericMatrixReference (var -> numericMatrixValue.get());
 } break; case STRING_VARIABLE_: {
-	InterpreterVariable var = f [programPointer]. content.variable;
+	InterpreterVariable var = f [theFormula -> programPointer]. content.variable;
 	autostring32 string = Melder_dup (var -> stringValue.get());
 	pushString (string.move());
 } break; case STRING_ARRAY_VARIABLE_: {
-	InterpreterVariable var = f [programPointer]. content.variable;
+	InterpreterVariable var = f [theFormula -> programPointer]. content.variable;
 	pushStringVectorReference (var -> stringArrayValue.get());
-} break; default: Melder_throw (U"Symbol \"", Formula_instructionNames [parse [programPointer]. symbol], U"\" without action.");
+} break; default: Melder_throw (U"Symbol \"", Formula_instructionNames [theFormula -> parse [theFormula -> programPointer]. symbol], U"\" without action.");
 			} // endswitch
-			programPointer ++;
+			theFormula -> programPointer ++;
 		} // endwhile
-		if (w != 1)
-			Melder_fatal (U"Formula: stackpointer ends at ", w, U" instead of 1.");
+		if (theFormula -> w != 1)
+			Melder_fatal (U"Formula: stackpointer ends at ", theFormula -> w, U" instead of 1.");
 		/*
 			Move the result from the stack to `result`.
 		*/
 		result -> reset();
-		if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_NUMERIC) {
-			if (theStack [1]. which == Stackel_STRING)
+		if (theFormula -> expressionType == kFormula_EXPRESSION_TYPE_NUMERIC) {
+			if (theFormula -> stack [1]. which == Stackel_STRING)
 				Melder_throw (U"Found a string expression instead of a numeric expression.");
-			if (theStack [1]. which == Stackel_NUMERIC_VECTOR)
+			if (theFormula -> stack [1]. which == Stackel_NUMERIC_VECTOR)
 				Melder_throw (U"Found a vector expression instead of a numeric expression.");
-			if (theStack [1]. which == Stackel_NUMERIC_MATRIX)
+			if (theFormula -> stack [1]. which == Stackel_NUMERIC_MATRIX)
 				Melder_throw (U"Found a matrix expression instead of a numeric expression.");
-			if (theStack [1]. which == Stackel_STRING_ARRAY)
+			if (theFormula -> stack [1]. which == Stackel_STRING_ARRAY)
 				Melder_throw (U"Found a string vector expression instead of a numeric expression.");
-			Melder_assert (theStack [1]. which == Stackel_NUMBER);
+			Melder_assert (theFormula -> stack [1]. which == Stackel_NUMBER);
 			result -> expressionType = kFormula_EXPRESSION_TYPE_NUMERIC;
-			result -> numericResult = theStack [1]. number;
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_STRING) {
-			if (theStack [1]. which == Stackel_NUMBER)
-				Melder_throw (U"Found a numeric expression (value ", theStack [1]. number, U") instead of a string expression.");
-			if (theStack [1]. which == Stackel_NUMERIC_VECTOR)
+			result -> numericResult = theFormula -> stack [1]. number;
+		} else if (theFormula -> expressionType == kFormula_EXPRESSION_TYPE_STRING) {
+			if (theFormula -> stack [1]. which == Stackel_NUMBER)
+				Melder_throw (U"Found a numeric expression (value ", theFormula -> stack [1]. number, U") instead of a string expression.");
+			if (theFormula -> stack [1]. which == Stackel_NUMERIC_VECTOR)
 				Melder_throw (U"Found a vector expression instead of a string expression.");
-			if (theStack [1]. which == Stackel_NUMERIC_MATRIX)
+			if (theFormula -> stack [1]. which == Stackel_NUMERIC_MATRIX)
 				Melder_throw (U"Found a matrix expression instead of a string expression.");
-			if (theStack [1]. which == Stackel_STRING_ARRAY)
+			if (theFormula -> stack [1]. which == Stackel_STRING_ARRAY)
 				Melder_throw (U"Found a string vector expression instead of a string expression.");
-			Melder_assert (theStack [1]. which == Stackel_STRING);
+			Melder_assert (theFormula -> stack [1]. which == Stackel_STRING);
 			result -> expressionType = kFormula_EXPRESSION_TYPE_STRING;
 			Melder_assert (! result -> stringResult);
-			result -> stringResult = theStack [1]. moveString();
-			Melder_assert (theStack [1]. which == Stackel_STRING);
-			Melder_assert (! theStack [1]. getString());
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR) {
-			if (theStack [1]. which == Stackel_NUMBER)
+			result -> stringResult = theFormula -> stack [1]. moveString();
+			Melder_assert (theFormula -> stack [1]. which == Stackel_STRING);
+			Melder_assert (! theFormula -> stack [1]. getString());
+		} else if (theFormula -> expressionType == kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR) {
+			if (theFormula -> stack [1]. which == Stackel_NUMBER)
 				Melder_throw (U"Found a numeric expression instead of a vector expression.");
-			if (theStack [1]. which == Stackel_STRING)
+			if (theFormula -> stack [1]. which == Stackel_STRING)
 				Melder_throw (U"Found a string expression instead of a vector expression.");
-			if (theStack [1]. which == Stackel_NUMERIC_MATRIX)
+			if (theFormula -> stack [1]. which == Stackel_NUMERIC_MATRIX)
 				Melder_throw (U"Found a matrix expression instead of a vector expression.");
-			if (theStack [1]. which == Stackel_STRING_ARRAY)
+			if (theFormula -> stack [1]. which == Stackel_STRING_ARRAY)
 				Melder_throw (U"Found a string vector expression instead of a numeric vector expression.");
-			Melder_assert (theStack [1]. which == Stackel_NUMERIC_VECTOR);
+			Melder_assert (theFormula -> stack [1]. which == Stackel_NUMERIC_VECTOR);
 			result -> expressionType = kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR;
-			result -> numericVectorResult = theStack [1]. numericVector;
-			result -> owned = theStack [1]. owned;
-			theStack [1]. owned = false;
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX) {
-			if (theStack [1]. which == Stackel_NUMBER)
+			result -> numericVectorResult = theFormula -> stack [1]. numericVector;
+			result -> owned = theFormula -> stack [1]. owned;
+			theFormula -> stack [1]. owned = false;
+		} else if (theFormula -> expressionType == kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX) {
+			if (theFormula -> stack [1]. which == Stackel_NUMBER)
 				Melder_throw (U"Found a numeric expression instead of a matrix expression.");
-			if (theStack [1]. which == Stackel_STRING)
+			if (theFormula -> stack [1]. which == Stackel_STRING)
 				Melder_throw (U"Found a string expression instead of a matrix expression.");
-			if (theStack [1]. which == Stackel_NUMERIC_VECTOR)
+			if (theFormula -> stack [1]. which == Stackel_NUMERIC_VECTOR)
 				Melder_throw (U"Found a vector expression instead of a matrix expression.");
-			if (theStack [1]. which == Stackel_STRING_ARRAY)
+			if (theFormula -> stack [1]. which == Stackel_STRING_ARRAY)
 				Melder_throw (U"Found a string vector expression instead of a numeric matrix expression.");
-			Melder_assert (theStack [1]. which == Stackel_NUMERIC_MATRIX);
+			Melder_assert (theFormula -> stack [1]. which == Stackel_NUMERIC_MATRIX);
 			result -> expressionType = kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX;
-			result -> numericMatrixResult = theStack [1]. numericMatrix;
-			result -> owned = theStack [1]. owned;
-			theStack [1]. owned = false;
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_STRING_ARRAY) {
-			if (theStack [1]. which == Stackel_NUMBER)
+			result -> numericMatrixResult = theFormula -> stack [1]. numericMatrix;
+			result -> owned = theFormula -> stack [1]. owned;
+			theFormula -> stack [1]. owned = false;
+		} else if (theFormula -> expressionType == kFormula_EXPRESSION_TYPE_STRING_ARRAY) {
+			if (theFormula -> stack [1]. which == Stackel_NUMBER)
 				Melder_throw (U"Found a numeric expression instead of a string vector expression.");
-			if (theStack [1]. which == Stackel_STRING)
+			if (theFormula -> stack [1]. which == Stackel_STRING)
 				Melder_throw (U"Found a string expression instead of a string vector expression.");
-			if (theStack [1]. which == Stackel_NUMERIC_VECTOR)
+			if (theFormula -> stack [1]. which == Stackel_NUMERIC_VECTOR)
 				Melder_throw (U"Found a vector expression instead of a string vector expression.");
-			if (theStack [1]. which == Stackel_NUMERIC_MATRIX)
+			if (theFormula -> stack [1]. which == Stackel_NUMERIC_MATRIX)
 				Melder_throw (U"Found a matrix expression instead of a string vector expression.");
-			Melder_assert (theStack [1]. which == Stackel_STRING_ARRAY);
+			Melder_assert (theFormula -> stack [1]. which == Stackel_STRING_ARRAY);
 			result -> expressionType = kFormula_EXPRESSION_TYPE_STRING_ARRAY;
-			result -> stringArrayResult = theStack [1]. stringArray;
-			result -> owned = theStack [1]. owned;
-			theStack [1]. owned = false;
+			result -> stringArrayResult = theFormula -> stack [1]. stringArray;
+			result -> owned = theFormula -> stack [1]. owned;
+			theFormula -> stack [1]. owned = false;
 		} else {
-			Melder_assert (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_UNKNOWN);
-			if (theStack [1]. which == Stackel_NUMBER) {
+			Melder_assert (theFormula -> expressionType == kFormula_EXPRESSION_TYPE_UNKNOWN);
+			if (theFormula -> stack [1]. which == Stackel_NUMBER) {
 				result -> expressionType = kFormula_EXPRESSION_TYPE_NUMERIC;
-				result -> numericResult = theStack [1]. number;
-			} else if (theStack [1]. which == Stackel_STRING) {
+				result -> numericResult = theFormula -> stack [1]. number;
+			} else if (theFormula -> stack [1]. which == Stackel_STRING) {
 				result -> expressionType = kFormula_EXPRESSION_TYPE_STRING;
 				Melder_assert (! result -> stringResult);
-				result -> stringResult = theStack [1]. moveString();
-				Melder_assert (theStack [1]. which == Stackel_STRING);
-				Melder_assert (! theStack [1]. getString());
-			} else if (theStack [1]. which == Stackel_NUMERIC_VECTOR) {
+				result -> stringResult = theFormula -> stack [1]. moveString();
+				Melder_assert (theFormula -> stack [1]. which == Stackel_STRING);
+				Melder_assert (! theFormula -> stack [1]. getString());
+			} else if (theFormula -> stack [1]. which == Stackel_NUMERIC_VECTOR) {
 				result -> expressionType = kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR;
-				result -> numericVectorResult = theStack [1]. numericVector;
-				result -> owned = theStack [1]. owned;
-				theStack [1]. owned = false;
-			} else if (theStack [1]. which == Stackel_NUMERIC_MATRIX) {
+				result -> numericVectorResult = theFormula -> stack [1]. numericVector;
+				result -> owned = theFormula -> stack [1]. owned;
+				theFormula -> stack [1]. owned = false;
+			} else if (theFormula -> stack [1]. which == Stackel_NUMERIC_MATRIX) {
 				result -> expressionType = kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX;
-				result -> numericMatrixResult = theStack [1]. numericMatrix;
-				result -> owned = theStack [1]. owned;
-				theStack [1]. owned = false;
-			} else if (theStack [1]. which == Stackel_STRING_ARRAY) {
+				result -> numericMatrixResult = theFormula -> stack [1]. numericMatrix;
+				result -> owned = theFormula -> stack [1]. owned;
+				theFormula -> stack [1]. owned = false;
+			} else if (theFormula -> stack [1]. which == Stackel_STRING_ARRAY) {
 				result -> expressionType = kFormula_EXPRESSION_TYPE_STRING_ARRAY;
-				result -> stringArrayResult = theStack [1]. stringArray;
-				result -> owned = theStack [1]. owned;
-				theStack [1]. owned = false;
+				result -> stringArrayResult = theFormula -> stack [1]. stringArray;
+				result -> owned = theFormula -> stack [1]. owned;
+				theFormula -> stack [1]. owned = false;
 			} else {
-				Melder_throw (U"Don't know yet how to write ", theStack [1]. whichText(), U".");
+				Melder_throw (U"Don't know yet how to write ", theFormula -> stack [1]. whichText(), U".");
 			}
 		}
 		/*
 			Clean up the stack (theStack [1] has probably been disowned).
 		*/
-		for (w = wmax; w > 0; w --)
-			theStack [w]. reset();
+		for (theFormula -> w = theFormula -> wmax; theFormula -> w > 0; theFormula -> w --)
+			theFormula -> stack [theFormula -> w]. reset();
 	} catch (MelderError) {
 		/*
 			Clean up the stack (theStack [1] has probably not been disowned).
 		*/
-		for (w = wmax; w > 0; w --)
-			theStack [w]. reset();
+		for (theFormula -> w = theFormula -> wmax; theFormula -> w > 0; theFormula -> w --)
+			theFormula -> stack [theFormula -> w]. reset();
 		if (Melder_hasError (U"Script exited.")) {
 			throw;
 		} else {
@@ -211,9 +211,51 @@ struct Formula_Result {
 
 Thing_declare (Interpreter);
 
+/*
+	The state of the compilation and the execution of a formula.
+	Every Interpreter owns one, so that the formulas of different interpreters can be compiled and run
+	in different threads at the same time. A formula that is compiled while another formula of the same interpreter
+	is running (e.g. by evaluate ()) gets a nested context of its own.
+*/
+typedef struct structFormulaInstruction *FormulaInstruction;
+
+Thing_define (FormulaContext, Thing) {
+	Interpreter interpreter;
+	Daata source;
+	conststring32 expression;
+	int expressionType;
+	bool optimize;
+	FormulaInstruction lexan, parse;
+	int ilabel, ilexan, iparse, numberOfInstructions, numberOfStringConstants;
+	integer elementwiseStackDepth;   // 0 if the compiled formula is not element-wise
+	autoMAT elementwiseRegisters;
+	int programPointer;
+	Stackel stack;
+	integer w, wmax;   // w = stack pointer
+	bool isRunning;
+	autoFormulaContext nested;
+
+	void v_destroy () noexcept
+		override;
+};
+
+/*
+	Formula_compile () compiles into the formula context of `interpreter` (or of a local interpreter, if null),
+	and Formula_run () runs the formula that was compiled last in the same thread.
+*/
 void Formula_compile (Interpreter interpreter, Daata data, conststring32 expression, int expressionType, bool optimize);
 
 void Formula_run (integer row, integer col, Formula_Result *result);
 
+/*
+	Whether the numeric formula that was compiled last computes each cell from that cell alone,
+	i.e. combines only numbers, self, row, col, x and y with arithmetic and functions of one number.
+	If so, Formula_runElementwise () computes the cells (row, firstColumn .. firstColumn + self.size - 1) at once,
+	with the same results as Formula_run () would give cell by cell;
+	`self` contains the values of those cells, and `result` may be the same vector as `self`.
+*/
+bool Formula_isElementwise ();
+void Formula_runElementwise (integer row, integer firstColumn, constVEC const& self, VEC const& result);
+
 /* End of file Formula.h */
 #endif
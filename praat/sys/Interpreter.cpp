@@ -645,10 +645,27 @@ static void Interpreter_addStringVariable (Interpreter me, conststring32 key, co
 	variable.releaseToAmbiguousOwner();
 }
 
+static InterpreterVariableSlot *Interpreter_nextVariableSlot (Interpreter me) {
+	if (my currentLineNumber == 0)
+		return nullptr;   // not running a script line: no cache
+	std::vector <InterpreterVariableSlot>& slots = my variableSlots [integer_to_uinteger (my currentLineNumber)];
+	const integer islot = my numberOfVariableSlotsUsedOnCurrentLine ++;
+	if (islot == uinteger_to_integer (slots. size ()))
+		slots. emplace_back ();
+	return & slots [integer_to_uinteger (islot)];
+}
+
 InterpreterVariable Interpreter_hasVariable (Interpreter me, conststring32 key) {
 	Melder_assert (key);
+	InterpreterVariableSlot *slot = Interpreter_nextVariableSlot (me);
+	if (slot && slot -> variable && str32equ (slot -> name.get(), key))
+		return slot -> variable;
 	auto it = my variablesMap. find (key [0] == U'.' ? Melder_cat (my procedureNames [my callDepth], key) : key);
 	if (it != my variablesMap. end()) {
+		if (slot) {
+			slot -> name = Melder_dup (key);
+			slot -> variable = it -> second.get();
+		}
 		return it -> second.get();
 	} else {
 		return nullptr;
@@ -657,18 +674,27 @@ InterpreterVariable Interpreter_hasVariable (Interpreter me, conststring32 key)
 
 InterpreterVariable Interpreter_lookUpVariable (Interpreter me, conststring32 key) {
 	Melder_assert (key);
+	InterpreterVariableSlot *slot = Interpreter_nextVariableSlot (me);
+	if (slot && slot -> variable && str32equ (slot -> name.get(), key))
+		return slot -> variable;
 	conststring32 variableNameIncludingProcedureName =
 		key [0] == U'.' ? Melder_cat (my procedureNames [my callDepth], key) : key;
+	InterpreterVariable variable_ref;
 	auto it = my variablesMap. find (variableNameIncludingProcedureName);
 	if (it != my variablesMap. end()) {
-		return it -> second.get();
+		variable_ref = it -> second.get();
+	} else {
+		/*
+		 * The variable doesn't yet exist: create a new one.
+		 */
+		autoInterpreterVariable variable = InterpreterVariable_create (variableNameIncludingProcedureName);
+		variable_ref = variable.get();
+		my variablesMap [variableNameIncludingProcedureName] = variable.move();
+	}
+	if (slot) {
+		slot -> name = Melder_dup (key);
+		slot -> variable = variable_ref;
 	}
-	/*
-	 * The variable doesn't yet exist: create a new one.
-	 */
-	autoInterpreterVariable variable = InterpreterVariable_create (variableNameIncludingProcedureName);
-	InterpreterVariable variable_ref = variable.get();
-	my variablesMap [variableNameIncludingProcedureName] = variable.move();
 	return variable_ref;
 }
 
@@ -960,7 +986,7 @@ static void Interpreter_do_procedureCall (Interpreter me, char32 *command,
 					q ++;   // step over parenthesis or colon
 			}
 			while (*q && *q != U')' && *q != U';') {
-				static MelderString argument;
+				static thread_local MelderString argument;
 				MelderString_empty (& argument);
 				while (Melder_isHorizontalSpace (*p))
 					p ++;
@@ -1132,7 +1158,7 @@ static void Interpreter_do_oldProcedureCall (Interpreter me, char32 *command,
 				++ p;   // first argument
 				while (*q && *q != U')') {
 					char32 *par, save;
-					static MelderString arg;
+					static thread_local MelderString arg;
 					MelderString_empty (& arg);
 					while (Melder_isHorizontalSpace (*p))
 						p ++;
@@ -1196,7 +1222,7 @@ static void Interpreter_do_oldProcedureCall (Interpreter me, char32 *command,
 
 static void assignToNumericVectorElement (Interpreter me, char32 *& p, const char32* vectorName, MelderString& valueString) {
 	integer indexValue = 0;
-	static MelderString index;
+	static thread_local MelderString index;
 	MelderString_empty (& index);
 	int depth = 0;
 	bool inString = false;
@@ -1275,7 +1301,7 @@ static void assignToNumericMatrixElement (Interpreter me, char32 *& p, const cha
 	/*
 		Get the row number.
 	*/
-	static MelderString rowFormula;
+	static thread_local MelderString rowFormula;
 	MelderString_empty (& rowFormula);
 	int depth = 0;
 	bool inString = false;
@@ -1304,7 +1330,7 @@ static void assignToNumericMatrixElement (Interpreter me, char32 *& p, const cha
 	/*
 		Get the column number.
 	*/
-	static MelderString columnFormula;
+	static thread_local MelderString columnFormula;
 	MelderString_empty (& columnFormula);
 	depth = 0;
 	inString = false;
@@ -1384,7 +1410,7 @@ static void assignToNumericMatrixElement (Interpreter me, char32 *& p, const cha
 
 static void assignToStringArrayElement (Interpreter me, char32 *& p, const char32* vectorName, MelderString& valueString) {
 	integer indexValue = 0;
-	static MelderString index;
+	static thread_local MelderString index;
 	MelderString_empty (& index);
 	int depth = 0;
 	bool inString = false;
@@ -1450,8 +1476,8 @@ void Interpreter_run (Interpreter me, char32 *text) {
 	integer lineNumber = 0;
 	bool assertionFailed = false;
 	try {
-		static MelderString valueString;   // to divert the info
-		static MelderString assertErrorString;
+		static thread_local MelderString valueString;   // to divert the info
+		static thread_local MelderString assertErrorString;
 		char32 *command = text;
 		autoMelderString command2;
 		autoMelderString buffer;
@@ -1534,6 +1560,8 @@ void Interpreter_run (Interpreter me, char32 *text) {
 			Copy the parameter names and argument values into the array of variables.
 		*/
 		my variablesMap. clear ();
+		my variableSlots. clear ();
+		my variableSlots. resize (integer_to_uinteger (numberOfLines + 1));
 		for (ipar = 1; ipar <= my numberOfParameters; ipar ++) {
 			char32 parameter [200];
 			/*
@@ -1602,6 +1630,8 @@ void Interpreter_run (Interpreter me, char32 *text) {
 			try {
 				char32 c0;
 				bool fail = false;
+				my currentLineNumber = lineNumber;
+				my numberOfVariableSlotsUsedOnCurrentLine = 0;
 				MelderString_copy (& command2, lines [lineNumber]);
 				c0 = command2. string [0];
 				if (c0 == U'\0')
@@ -2186,7 +2216,7 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							/*
 								Assign to a string vector variable or a string vector element.
 							*/
-							static MelderString vectorName;
+							static thread_local MelderString vectorName;
 							p ++;
 							*p = U'\0';   // erase the number sign temporarily
 							MelderString_copy (& vectorName, command2.string, U"#");
@@ -2234,11 +2264,11 @@ void Interpreter_run (Interpreter me, char32 *text) {
 									This must be an assignment to an indexed string variable.
 								*/
 								*endOfVariable = U'\0';
-								static MelderString indexedVariableName;
+								static thread_local MelderString indexedVariableName;
 								MelderString_copy (& indexedVariableName, command2.string, U"[");
 								for (;;) {
 									p ++;   // skip opening bracket or comma
-									static MelderString index;
+									static thread_local MelderString index;
 									MelderString_empty (& index);
 									int depth = 0;
 									bool inString = false;
@@ -2363,7 +2393,7 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							/*
 								Assign to a numeric matrix variable or to a matrix element.
 							*/
-							static MelderString matrixName;
+							static thread_local MelderString matrixName;
 							p ++;   // go to second '#'
 							*p = U'\0';   // erase the last number sign temporarily
 							MelderString_copy (& matrixName, command2.string, U'#');
@@ -2462,7 +2492,7 @@ void Interpreter_run (Interpreter me, char32 *text) {
 								if (! var)
 									Melder_throw (U"The matrix ", matrixName.string, U" does not exist.\n"
 										"You can assign a formula only to an existing matrix.");
-								static Matrix matrixObject;
+								static thread_local Matrix matrixObject;
 								if (! matrixObject)
 									matrixObject = Matrix_createSimple (1, 1). releaseToAmbiguousOwner();   // prevent exit-time destruction
 								MAT mat = var -> numericMatrixValue.get();
@@ -2479,7 +2509,7 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							/*
 								Assign to a numeric vector variable or to a vector element.
 							*/
-							static MelderString vectorName;
+							static thread_local MelderString vectorName;
 							*p = U'\0';   // erase the number sign temporarily
 							MelderString_copy (& vectorName, command2.string, U"#");
 							*p = U'#';   // put the number sign back
@@ -2580,7 +2610,7 @@ void Interpreter_run (Interpreter me, char32 *text) {
 								if (! var)
 									Melder_throw (U"The vector ", vectorName.string, U" does not exist.\n"
 										"You can assign a formula only to an existing vector.");
-								static Matrix vectorObject;
+								static thread_local Matrix vectorObject;
 								if (! vectorObject)
 									vectorObject = Matrix_createSimple (1, 1). releaseToAmbiguousOwner();   // prevent destruction when program ends
 								VEC vec = var -> numericVectorValue.get();
@@ -2620,11 +2650,11 @@ void Interpreter_run (Interpreter me, char32 *text) {
 								This must be an assignment to an indexed numeric variable.
 							*/
 							*endOfVariable = U'\0';
-							static MelderString indexedVariableName;
+							static thread_local MelderString indexedVariableName;
 							MelderString_copy (& indexedVariableName, command2.string, U"[");
 							for (;;) {
 								p ++;   // skip opening bracket or comma
-								static MelderString index;
+								static thread_local MelderString index;
 								MelderString_empty (& index);
 								int depth = 0;
 								bool inString = false;
@@ -2775,6 +2805,7 @@ void Interpreter_run (Interpreter me, char32 *text) {
 				}
 			}
 		} // endfor lineNumber
+		my currentLineNumber = 0;
 		my numberOfLabels = 0;
 		my running = false;
 		my stopped = false;
@@ -2789,6 +2820,7 @@ void Interpreter_run (Interpreter me, char32 *text) {
 				Melder_appendError (U"Script line ", lineNumber, U" not performed or completed:\n« ", lines [lineNumber], U" »");
 			}
 		}
+		my currentLineNumber = 0;
 		my numberOfLabels = 0;
 		my running = false;
 		my stopped = false;
@@ -24,6 +24,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 Thing_define (InterpreterVariable, SimpleString) {
 	autostring32 stringValue;
@@ -33,6 +34,14 @@ Thing_define (InterpreterVariable, SimpleString) {
 	autoSTRVEC stringArrayValue;
 };
 
+/*
+	A name that a script line looked up, and the variable it turned out to refer to.
+*/
+struct InterpreterVariableSlot {
+	autostring32 name;
+	InterpreterVariable variable;   // a reference copy; the owner is variablesMap
+};
+
 #define Interpreter_MAXNUM_PARAMETERS  400
 #define Interpreter_MAXNUM_LABELS  1000
 #define Interpreter_MAX_CALL_DEPTH  50
@@ -56,6 +65,17 @@ Thing_define (Interpreter, Thing) {
 	char32 dialogTitle [1+Interpreter_MAX_DIALOG_TITLE_LENGTH], procedureNames [1+Interpreter_MAX_CALL_DEPTH] [100];
 	std::unordered_map <std::u32string, autoInterpreterVariable> variablesMap;
 	bool running, stopped;
+	autoFormulaContext formulaContext;
+	/*
+		While Interpreter_run () executes a line, the n-th variable lookup on that line goes to the n-th slot of that line.
+		If the slot holds the same name, the lookup is done; otherwise, the name is looked up in variablesMap
+		and the slot is refilled. Hence, a line that is executed again (in a loop, or in a procedure)
+		normally resolves its variables without building keys or hashing them.
+		The slots stay valid because no variable is removed from variablesMap while the script runs.
+	*/
+	std::vector <std::vector <InterpreterVariableSlot>> variableSlots;   // one list per line
+	integer currentLineNumber;   // 0 outside Interpreter_run ()
+	integer numberOfVariableSlotsUsedOnCurrentLine;
 };
 
 autoInterpreter Interpreter_create (conststring32 environmentName, ClassInfo editorClass);
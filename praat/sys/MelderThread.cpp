@@ -0,0 +1,318 @@
+/* MelderThread.cpp
+ *
+ * Copyright (C) 2014-2018,2020 Paul Boersma
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This code is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this work. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MelderThread.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#if ! defined (_WIN32)
+	#include <pthread.h>
+#endif
+
+integer MelderThread_getNumberOfProcessors () {
+	return Melder_clippedLeft (1_integer, uinteger_to_integer (std::thread::hardware_concurrency ()));
+}
+
+static std::atomic <integer> theMaximumNumberOfThreads (0);   // 0 = as many as there are processors
+
+void MelderThread_setMaximumNumberOfThreads (integer maximumNumberOfThreads) {
+	Melder_require (maximumNumberOfThreads >= 0,
+		U"The maximum number of threads should not be negative.");
+	theMaximumNumberOfThreads = maximumNumberOfThreads;
+}
+
+integer MelderThread_getMaximumNumberOfThreads () {
+	const integer maximumNumberOfThreads = theMaximumNumberOfThreads;
+	return ( maximumNumberOfThreads > 0 ? maximumNumberOfThreads : MelderThread_getNumberOfProcessors () );
+}
+
+integer MelderThread_computeNumberOfThreads (integer numberOfItems, integer minimumNumberOfItemsPerThread) {
+	Melder_assert (minimumNumberOfItemsPerThread >= 1);
+	if (numberOfItems <= 0)
+		return 1;
+	const integer numberOfThreads = (numberOfItems - 1) / minimumNumberOfItemsPerThread + 1;
+	return Melder_clipped (1_integer, numberOfThreads, MelderThread_getMaximumNumberOfThreads ());
+}
+
+namespace {
+
+	/*
+		The items that a thread has not yet handed out: next .. last.
+		Only the owning thread ever enlarges its range (after it has run empty);
+		other threads only shrink it from the end, by stealing.
+	*/
+	struct MelderThread_Range {
+		std::mutex mutex;
+		integer next, last;
+	};
+
+	struct MelderThread_Job {
+		std::function <void (integer, integer, integer)> const *task;
+		integer numberOfThreads, chunkSize;
+		std::unique_ptr <MelderThread_Range []> ranges;
+		/*
+			Guarded by the pool mutex.
+		*/
+		integer numberOfClaimedThreads = 1;   // thread 1 is the calling thread
+		integer numberOfActiveHelpers = 0;
+		std::condition_variable helpersFinished;
+		/*
+			The first exception thrown by a task cancels the rest of the job.
+		*/
+		std::atomic <bool> cancelled { false };
+		std::mutex exceptionMutex;
+		std::exception_ptr exception;
+		autostring32 errorMessage;   // the error buffer is per thread, so we carry the message over to the calling thread
+		/*
+			The warnings of the pool threads, which are shown by the calling thread when the job has finished
+			(a warning proc may need a lock, such as Python's GIL, that the calling thread holds while it waits).
+		*/
+		std::mutex warningMutex;
+		autoMelderString warnings;
+	};
+
+	struct MelderThread_Pool {
+		std::mutex mutex;
+		std::condition_variable workAvailable;
+		std::deque <MelderThread_Job *> jobs;   // the jobs that still have threads that no pool thread has claimed
+		integer numberOfWorkers = 0;
+	};
+
+}
+
+static thread_local integer theTaskDepth = 0;   // more than 1 if the current thread runs nested tasks
+
+namespace {
+	struct MelderThread_TaskScope {
+		MelderThread_TaskScope () { theTaskDepth ++; }
+		~MelderThread_TaskScope () { theTaskDepth --; }
+	};
+}
+
+bool MelderThread_isRunningTask () {
+	return theTaskDepth > 0;
+}
+
+static bool MelderThread_Job_takeChunk (MelderThread_Job *job, integer ithread, integer *out_firstItem, integer *out_lastItem) {
+	MelderThread_Range& own = job -> ranges [ithread - 1];
+	{
+		std::lock_guard <std::mutex> lock (own.mutex);
+		if (own.next <= own.last) {
+			*out_firstItem = own.next;
+			*out_lastItem = std::min (own.next + job -> chunkSize - 1, own.last);
+			own.next = *out_lastItem + 1;
+			return true;
+		}
+	}
+	/*
+		Our own range is exhausted. Steal the second half of the remaining range of another thread.
+	*/
+	for (integer offset = 1; offset < job -> numberOfThreads; offset ++) {
+		MelderThread_Range& victim = job -> ranges [(ithread - 1 + offset) % job -> numberOfThreads];
+		integer stolenNext, stolenLast;
+		{
+			std::lock_guard <std::mutex> lock (victim.mutex);
+			const integer numberOfRemainingItems = victim.last - victim.next + 1;
+			if (numberOfRemainingItems <= 0)
+				continue;
+			if (numberOfRemainingItems <= job -> chunkSize) {
+				*out_firstItem = victim.next;
+				*out_lastItem = victim.last;
+				victim.next = victim.last + 1;
+				return true;
+			}
+			stolenNext = victim.next + numberOfRemainingItems / 2;
+			stolenLast = victim.last;
+			victim.last = stolenNext - 1;
+		}
+		std::lock_guard <std::mutex> lock (own.mutex);
+		*out_firstItem = stolenNext;
+		*out_lastItem = std::min (stolenNext + job -> chunkSize - 1, stolenLast);
+		own.next = *out_lastItem + 1;
+		own.last = stolenLast;
+		return true;
+	}
+	return false;
+}
+
+static void MelderThread_Job_participate (MelderThread_Job *job, integer ithread) {
+	integer firstItem, lastItem;
+	while (! job -> cancelled && MelderThread_Job_takeChunk (job, ithread, & firstItem, & lastItem)) {
+		try {
+			MelderThread_TaskScope scope;
+			(*job -> task) (ithread, firstItem, lastItem);
+		} catch (...) {
+			{
+				std::lock_guard <std::mutex> lock (job -> exceptionMutex);
+				if (! job -> exception) {
+					job -> exception = std::current_exception ();
+					try {
+						job -> errorMessage = Melder_dup (Melder_getError ());
+					} catch (MelderError) {
+						// out of memory: the exception will have to do without its message
+					}
+				}
+			}
+			Melder_clearError ();
+			job -> cancelled = true;
+		}
+	}
+}
+
+static void MelderThread_Pool_work (MelderThread_Pool *pool) {
+	std::unique_lock <std::mutex> lock (pool -> mutex);
+	for (;;) {
+		pool -> workAvailable. wait (lock, [pool] { return ! pool -> jobs. empty (); });
+		MelderThread_Job *job = pool -> jobs. front ();
+		const integer ithread = ++ job -> numberOfClaimedThreads;
+		if (job -> numberOfClaimedThreads == job -> numberOfThreads)
+			pool -> jobs. pop_front ();
+		job -> numberOfActiveHelpers ++;
+		lock. unlock ();
+		{
+			autoMelderString collectedWarnings;
+			MelderWarning::_p_collectedWarnings = & collectedWarnings;
+			MelderThread_Job_participate (job, ithread);
+			MelderWarning::_p_collectedWarnings = nullptr;
+			if (collectedWarnings. length > 0) {
+				std::lock_guard <std::mutex> warningLock (job -> warningMutex);
+				try {
+					MelderString_append (& job -> warnings, collectedWarnings. string);
+				} catch (MelderError) {
+					Melder_clearError ();   // out of memory: these warnings are lost
+				}
+			}
+		}
+		lock. lock ();
+		if (-- job -> numberOfActiveHelpers == 0)
+			job -> helpersFinished. notify_one ();
+	}
+}
+
+/*
+	The pool is never destroyed: its threads are detached and wait for work until the process exits.
+	A child process created by fork () inherits the pool but not its threads, so it starts a new pool.
+*/
+static MelderThread_Pool *thePool;
+static std::mutex thePoolMutex;
+
+#if ! defined (_WIN32)
+static void MelderThread_atfork_prepare () {
+	thePoolMutex. lock ();
+}
+static void MelderThread_atfork_parent () {
+	thePoolMutex. unlock ();
+}
+static void MelderThread_atfork_child () {
+	thePool = nullptr;   // leaked on purpose: its mutex may be locked by a thread that does not exist in this process
+	thePoolMutex. unlock ();
+}
+#endif
+
+static MelderThread_Pool *MelderThread_getPool (integer minimumNumberOfWorkers) {
+	std::lock_guard <std::mutex> creationLock (thePoolMutex);
+	if (! thePool) {
+		#if ! defined (_WIN32)
+			static bool forkHandlersHaveBeenInstalled = false;
+			if (! forkHandlersHaveBeenInstalled) {
+				pthread_atfork (MelderThread_atfork_prepare, MelderThread_atfork_parent, MelderThread_atfork_child);
+				forkHandlersHaveBeenInstalled = true;
+			}
+		#endif
+		thePool = new MelderThread_Pool;
+	}
+	MelderThread_Pool *pool = thePool;
+	while (pool -> numberOfWorkers < minimumNumberOfWorkers) {
+		try {
+			std::thread (MelderThread_Pool_work, pool). detach ();
+		} catch (std::system_error const&) {
+			break;   // no problem: the calling thread can always do all the work itself
+		}
+		std::lock_guard <std::mutex> lock (pool -> mutex);
+		pool -> numberOfWorkers ++;
+	}
+	return pool;
+}
+
+void MelderThread_run (integer numberOfItems, integer numberOfThreads, integer chunkSize,
+	std::function <void (integer ithread, integer firstItem, integer lastItem)> const& task)
+{
+	if (numberOfItems <= 0)
+		return;
+	Melder_assert (chunkSize >= 1);
+	Melder_clip (1_integer, & numberOfThreads, numberOfItems);
+	if (numberOfThreads == 1) {
+		MelderThread_TaskScope scope;
+		task (1, 1, numberOfItems);
+		return;
+	}
+
+	MelderThread_Job job;
+	job. task = & task;
+	job. numberOfThreads = numberOfThreads;
+	job. chunkSize = chunkSize;
+	job. ranges = std::make_unique <MelderThread_Range []> (integer_to_uinteger (numberOfThreads));
+	const integer minimumNumberOfItemsPerThread = numberOfItems / numberOfThreads;
+	const integer numberOfLargerRanges = numberOfItems % numberOfThreads;
+	integer firstItem = 1;
+	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
+		const integer numberOfItemsInRange = minimumNumberOfItemsPerThread + ( ithread <= numberOfLargerRanges ? 1 : 0 );
+		job. ranges [ithread - 1]. next = firstItem;
+		job. ranges [ithread - 1]. last = firstItem + numberOfItemsInRange - 1;
+		firstItem += numberOfItemsInRange;
+	}
+
+	MelderThread_Pool *pool = MelderThread_getPool (numberOfThreads - 1);
+	{
+		std::lock_guard <std::mutex> lock (pool -> mutex);
+		pool -> jobs. push_back (& job);
+	}
+	for (integer ihelper = 1; ihelper < numberOfThreads; ihelper ++)
+		pool -> workAvailable. notify_one ();
+
+	MelderThread_Job_participate (& job, 1);
+
+	{
+		/*
+			All the items have been handed out (or the job was cancelled),
+			so threads that have not joined yet would have nothing to do.
+		*/
+		std::unique_lock <std::mutex> lock (pool -> mutex);
+		if (job. numberOfClaimedThreads < job. numberOfThreads)
+			pool -> jobs. erase (std::find (pool -> jobs. begin (), pool -> jobs. end (), & job));
+		job. helpersFinished. wait (lock, [& job] { return job. numberOfActiveHelpers == 0; });
+	}
+	if (job. exception) {
+		Melder_clearError ();
+		if (job. errorMessage)
+			Melder_appendError_noLine (job. errorMessage.get());
+		std::rethrow_exception (job. exception);
+	}
+	if (job. warnings. length > 0) {
+		job. warnings. string [-- job. warnings. length] = U'\0';   // remove the final newline
+		Melder_warning (job. warnings. string);
+	}
+}
+
+/* End of file MelderThread.cpp */
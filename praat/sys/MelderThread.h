@@ -18,34 +18,52 @@
  * along with this work. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <vector>
+#include <functional>
 #include "Thing.h"
-#include <thread>
-
-inline integer MelderThread_getNumberOfProcessors () {
-	return uinteger_to_integer (std::thread::hardware_concurrency ());
-}
-
-template <class T> void MelderThread_run (void (*func) (T *), autoSomeThing <T> *args, integer numberOfThreads) {
-	uinteger unsignedNumberOfThreads = integer_to_uinteger (numberOfThreads);
-	if (unsignedNumberOfThreads == 1) {
-		func (args [0].get());
-	} else {
-		std::vector <std::thread> thread (unsignedNumberOfThreads);
-		try {
-			for (uinteger ithread = 1; ithread < unsignedNumberOfThreads; ithread ++)
-				thread [ithread - 1] = std::thread (func, args [ithread - 1].get());
-			func (args [unsignedNumberOfThreads - 1].get());
-		} catch (MelderError) {
-			for (uinteger ithread = 1; ithread < unsignedNumberOfThreads; ithread ++)
-				if (thread [ithread - 1]. joinable ())
-					thread [ithread - 1]. join ();
-			throw;
-		}
-		for (uinteger ithread = 1; ithread < unsignedNumberOfThreads; ithread ++)
-			thread [ithread - 1]. join ();
-	}
-}
+
+integer MelderThread_getNumberOfProcessors ();
+
+/*
+	The maximum number of threads (including the calling thread) that a single call to MelderThread_run () will use.
+	The default, and the value obtained by setting it to 0, is the number of processors.
+	Setting it to 1 makes every analysis run serially in the calling thread.
+*/
+void MelderThread_setMaximumNumberOfThreads (integer maximumNumberOfThreads);
+integer MelderThread_getMaximumNumberOfThreads ();
+
+/*
+	The number of threads that is worth using for `numberOfItems` items
+	if every thread should get at least `minimumNumberOfItemsPerThread` items;
+	the result lies between 1 and MelderThread_getMaximumNumberOfThreads ().
+*/
+integer MelderThread_computeNumberOfThreads (integer numberOfItems, integer minimumNumberOfItemsPerThread);
+
+/*
+	Run `task` over the items 1 .. numberOfItems (typically analysis frames), using at most `numberOfThreads` threads
+	from a process-wide pool that is started the first time it is needed.
+
+	The items are divided into `numberOfThreads` contiguous ranges, which are handed out in chunks of `chunkSize` items;
+	a thread that runs out of work steals half of the remaining range of another thread.
+	Each call `task (ithread, firstItem, lastItem)` processes the items firstItem .. lastItem;
+	`ithread` (1 .. numberOfThreads) identifies the thread, so that the task can use per-thread workspace.
+	No two calls with the same `ithread` ever run at the same time.
+
+	The calling thread always takes part as thread number 1, so only that task is allowed to call Melder_progress () and the like.
+	Calls from within a task (nested parallelism) are allowed; they are helped by idle pool threads only.
+	If a task throws, the remaining chunks are skipped and the first exception is rethrown in the calling thread,
+	together with its error message (Melder's error buffer is per thread).
+	Warnings from tasks on pool threads are collected, and shown by the calling thread after all tasks have finished.
+*/
+void MelderThread_run (integer numberOfItems, integer numberOfThreads, integer chunkSize,
+	std::function <void (integer ithread, integer firstItem, integer lastItem)> const& task);
+
+/*
+	Whether the calling thread is running a task of MelderThread_run ().
+	An analysis that is called from within a task (e.g. one of several analyses that run in parallel)
+	runs nested: it still gets help from idle pool threads, but it should not report progress,
+	because its thread number 1 may be a pool thread.
+*/
+bool MelderThread_isRunningTask ();
 
 /* End of file MelderThread.h */
 #endif
@@ -20,7 +20,7 @@
 #include <time.h>
 #include "Thing.h"
 
-integer theTotalNumberOfThings;
+std::atomic <integer> theTotalNumberOfThings (0);
 
 void structThing :: v_info ()
 {
@@ -102,7 +102,7 @@ void Thing_recognizeClassByOtherName (ClassInfo readableClass, conststring32 oth
 }
 
 ClassInfo Thing_classFromClassName (conststring32 klas, int *out_formatVersion) {
-	static char32 buffer [1+100];
+	static thread_local char32 buffer [1+100];
 	str32ncpy (buffer, klas ? klas : U"", 100);
 	buffer [100] = U'\0';
 	char32 *space = str32chr (buffer, U' ');
@@ -210,8 +210,8 @@ conststring32 Thing_getName (Thing me) {
 }
 
 conststring32 Thing_messageName (Thing me) {
-	static MelderString buffers [19];
-	static int ibuffer = 0;
+	static thread_local MelderString buffers [19];
+	static thread_local int ibuffer = 0;
 	if (++ ibuffer == 19)
 		ibuffer = 0;
 	if (my name)
@@ -222,8 +222,8 @@ conststring32 Thing_messageName (Thing me) {
 }
 
 conststring32 Thing_messageNameAndAddress (Thing me) {
-	static MelderString buffers [19];
-	static int ibuffer = 0;
+	static thread_local MelderString buffers [19];
+	static thread_local int ibuffer = 0;
 	if (++ ibuffer == 19)
 		ibuffer = 0;
 	if (my name)
@@ -20,6 +20,8 @@
 
 /* The root class of all objects. */
 
+#include <atomic>
+
 /* Anyone who uses Thing can also use: */
 	#include "melder.h"
 	/* The macros for struct and class definitions: */
@@ -224,8 +226,9 @@ void _Thing_forget_nozero (Thing me);
 
 /* For debugging. */
 
-extern integer theTotalNumberOfThings;
-/* This number is 0 initially, increments at every successful `new', and decrements at every `forget'. */
+extern std::atomic <integer> theTotalNumberOfThings;
+/* This number is 0 initially, increments at every successful `new', and decrements at every `forget'.
+	Things are created and forgotten in worker threads as well, hence the atomic. */
 
 template <class T>
 class autoSomeThing {
@@ -253,7 +253,7 @@ void praat_reportMemoryUse () {
 	MelderInfo_writeLine (
 			U"   Arrays: ", MelderArray_allocationCount () - MelderArray_deallocationCount (),
 			U" (", Melder_bigInteger (MelderArray_cellAllocationCount () - MelderArray_cellDeallocationCount ()), U" cells)");
-	MelderInfo_writeLine (U"   Things: ", theTotalNumberOfThings,
+	MelderInfo_writeLine (U"   Things: ", theTotalNumberOfThings.load (),
 		U" (objects in list: ", Melder_bigInteger (theCurrentPraatObjects -> n), U")");
 	integer numberOfMotifWidgets =
 	#if motif
@@ -264,7 +264,7 @@ void praat_reportMemoryUse () {
 	#endif
 	MelderInfo_writeLine (U"   Other: ",
 		Melder_allocationCount () - Melder_deallocationCount ()
-		- theTotalNumberOfThings
+		- theTotalNumberOfThings.load ()
 		- (MelderString_allocationCount () - MelderString_deallocationCount ())
 		- (MelderArray_allocationCount () - MelderArray_deallocationCount ())
 		- numberOfMotifWidgets
@@ -80,6 +80,7 @@ PRAAT_EXCEPTION_BINDING(PraatError, PyExc_RuntimeError) {
 PRAAT_EXCEPTION_BINDING(PraatWarning, PyExc_UserWarning) {
 	static auto warning = *this;
 	Melder_setWarningProc([](const char32 *message) {
+			py::gil_scoped_acquire gil; // Analyses run with the GIL released
 			if (PyErr_WarnEx(warning.ptr(), Melder_peek32to8(message), 1) < 0)
 				throw py::error_already_set();
 	});
@@ -88,6 +89,7 @@ PRAAT_EXCEPTION_BINDING(PraatWarning, PyExc_UserWarning) {
 PRAAT_EXCEPTION_BINDING(PraatFatal, PyExc_BaseException) {
 	static auto fatal = *this;
 	Melder_setFatalProc([](const char32 *message) {
+			py::gil_scoped_acquire gil;
 			auto extraMessage = "Parselmouth intercepted a fatal error in Praat:\n\n"s +
 			                    Melder_peek32to8(message) + "\n"s +
 			                    "To ensure correctness of Praat's calculations, it is advisable to NOT ignore this error\n"s
@@ -99,6 +101,7 @@ PRAAT_EXCEPTION_BINDING(PraatFatal, PyExc_BaseException) {
 
 void redirectMelderInfo() {
 	Melder_setInformationProc([](const char32 *message, size_t i) {
+		py::gil_scoped_acquire gil;
 		auto sys = py::module_::import("sys");
 		auto sys_stdout = sys.attr("stdout");
 		sys_stdout.attr("write")(&message[i]);
@@ -108,6 +111,7 @@ void redirectMelderInfo() {
 
 void redirectMelderError() {
 	Melder_setErrorProc([](const char32 *message) {
+		py::gil_scoped_acquire gil;
 		auto sys = py::module_::import("sys");
 		auto sys_stderr = sys.attr("stderr");
 		sys_stderr.attr("write")(message);
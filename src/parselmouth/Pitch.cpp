@@ -316,8 +316,10 @@ PRAAT_CLASS_BINDING(Pitch) {
 	                      });
 
 	def("path_finder",
-	    args_cast<_, _, _, _, _, _, Positive<_>, bool>(Pitch_pathFinder),
-	    "silence_threshold"_a = 0.03, "voicing_threshold"_a = 0.45, "octave_cost"_a = 0.01, "octave_jump_cost"_a = 0.35, "voiced_unvoiced_cost"_a = 0.14, "ceiling"_a = 600.0, "pull_formants"_a = false);
+	    [](Pitch self, double silenceThreshold, double voicingThreshold, double octaveCost, double octaveJumpCost, double voicedUnvoicedCost, Positive<double> ceiling, bool pullFormants, std::optional<Positive<integer>> maximumLookahead) {
+		    Pitch_pathFinder(self, silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, ceiling, pullFormants, maximumLookahead ? static_cast<integer>(*maximumLookahead) : 0);
+	    },
+	    "silence_threshold"_a = 0.03, "voicing_threshold"_a = 0.45, "octave_cost"_a = 0.01, "octave_jump_cost"_a = 0.35, "voiced_unvoiced_cost"_a = 0.14, "ceiling"_a = 600.0, "pull_formants"_a = false, "maximum_lookahead"_a = std::nullopt);
 
 	def("step",
 	    [](Pitch self, double step, Positive<double> precision, std::optional<double> fromTime, std::optional<double> toTime) { Pitch_step(self, step, precision, fromTime.value_or(self->xmin), toTime.value_or(self->xmax)); },
@@ -35,10 +35,14 @@
 #include <praat/fon/Sound_to_Harmonicity.h>
 #include <praat/fon/Sound_to_Intensity.h>
 #include <praat/fon/Sound_to_Pitch.h>
+#include <praat/fon/VoiceAnalysis.h>
+#include <praat/sys/MelderThread.h>
 
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
+#include <variant>
+
 namespace py = pybind11;
 using namespace py::literals;
 
@@ -54,6 +58,122 @@ OrderedOf<T> referencesToOrderedOf(const Container &container) // TODO type_cast
 	return orderedOf;
 }
 
+// Called by Praat when a Sound lets go of samples it borrowed from a Python buffer, possibly on another thread
+void releaseBuffer(void *closure) {
+	if (!Py_IsInitialized())
+		return; // Too late to release anything
+	py::gil_scoped_acquire gil;
+	delete static_cast<py::buffer_info *>(closure);
+}
+
+template <typename T>
+bool hasFormat(const py::buffer_info &info) {
+	return info.itemsize == sizeof(T) && info.format == py::format_descriptor<T>::format();
+}
+
+// Converts and copies in a single pass, following the buffer's strides
+template <typename T>
+void copyBuffer(const py::buffer_info &info, MAT z) {
+	auto data = static_cast<const char *>(info.ptr);
+	auto rowStride = info.ndim == 2 ? info.strides[0] : 0;
+	auto columnStride = info.strides[info.ndim - 1];
+	for (integer channel = 1; channel <= z.nrow; ++channel) {
+		auto row = data + (channel - 1) * rowStride;
+		for (integer i = 1; i <= z.ncol; ++i)
+			z[channel][i] = static_cast<double>(*reinterpret_cast<const T *>(row + (i - 1) * columnStride));
+	}
+}
+
+autoSound soundFromBuffer(const py::buffer &values, double samplingFrequency, double startTime, bool copy) {
+	auto info = values.request();
+	auto ndim = info.ndim;
+
+	if (ndim == 0)
+		throw py::value_error("Cannot create Sound from a single 0-dimensional number");
+	if (ndim > 2)
+		throw py::value_error("Cannot create Sound from an array with more than 2 dimensions");
+
+	auto nx = info.shape[ndim - 1];
+	auto ny = ndim == 2 ? info.shape[0] : 1;
+	if (ndim == 2 && ny > nx)
+		PyErr_WarnEx(PyExc_RuntimeWarning, ("Number of channels (" + std::to_string(ny) + ") is greater than number of samples (" + std::to_string(nx) + "); note that the shape of the `values` array is interpreted as (n_channels, n_samples).").c_str(), 1);
+
+	auto xmin = startTime;
+	auto xmax = startTime + nx / samplingFrequency;
+	auto dx = 1.0 / samplingFrequency;
+	auto x1 = startTime + 0.5 / samplingFrequency;
+
+	if (hasFormat<double>(info)) {
+		auto isCContiguous = info.strides[ndim - 1] == sizeof(double) && (ny == 1 || info.strides[0] == nx * static_cast<ssize_t>(sizeof(double)));
+		if (!copy && !info.readonly && isCContiguous && nx > 0 && ny > 0) {
+			// The Sound keeps the buffer (and so its owner) alive until it lets go of the samples
+			auto cells = static_cast<double *>(info.ptr);
+			auto samples = newmatrixforeign<double>(cells, ny, nx, &releaseBuffer, new py::buffer_info(std::move(info)));
+			return Sound_createFromSamples(std::move(samples), xmin, xmax, dx, x1);
+		}
+	}
+
+	auto result = Sound_create(ny, xmin, xmax, nx, dx, x1);
+	if (hasFormat<double>(info)) {
+		copyBuffer<double>(info, result->z.get());
+	}
+	else if (hasFormat<float>(info)) {
+		copyBuffer<float>(info, result->z.get());
+	}
+	else if (hasFormat<int16_t>(info)) {
+		copyBuffer<int16_t>(info, result->z.get());
+	}
+	else {
+		auto array = py::array_t<double, py::array::c_style | py::array::forcecast>::ensure(values);
+		if (!array)
+			throw py::error_already_set();
+		// We can copy_n because of py::array::c_style making sure things are contiguous
+		std::copy_n(array.data(), static_cast<size_t>(nx) * static_cast<size_t>(ny), result->z.cells);
+	}
+	return result;
+}
+
+using SoundOrFilePath = std::variant<Sound, std::u32string>;
+
+// Runs `analysis` on each Sound, or on the Sound read from each file, spreading the items over Praat's thread pool
+// The GIL is released while the analyses run; the results are in the same order as the items
+template <typename Analysis>
+auto analyzeBatch(const std::vector<SoundOrFilePath> &items, Analysis analysis) {
+	using Result = decltype(analysis(std::declval<Sound>()));
+	auto numberOfItems = static_cast<integer>(items.size());
+
+	// Relative paths are resolved up front, in the calling thread
+	std::vector<structMelderFile> files(items.size());
+	for (size_t i = 0; i < items.size(); ++i) {
+		if (auto filePath = std::get_if<std::u32string>(&items[i]))
+			files[i] = pathToMelderFile(*filePath);
+		else if (!std::get<Sound>(items[i]))
+			throw py::value_error("Cannot analyze None; expected a Sound or a file path");
+	}
+
+	std::vector<Result> results(items.size());
+	{
+		py::gil_scoped_release release;
+		MelderThread_run(numberOfItems, MelderThread_computeNumberOfThreads(numberOfItems, 1), 1, [&](integer, integer firstItem, integer lastItem) {
+			for (auto item = firstItem; item <= lastItem; ++item) {
+				try {
+					auto index = static_cast<size_t>(item - 1);
+					if (auto sound = std::get_if<Sound>(&items[index])) {
+						results[index] = analysis(*sound);
+					}
+					else {
+						auto soundFromFile = Sound_readFromSoundFile(&files[index]);
+						results[index] = analysis(soundFromFile.get());
+					}
+				} catch (MelderError) {
+					Melder_throw (U"Item ", item, U" of the batch not analysed.");
+				}
+			}
+		});
+	}
+	return results;
+}
+
 } // namespace
 
 enum class SoundFileFormat // TODO Nest within Sound?
@@ -93,6 +213,14 @@ enum class ToHarmonicityMethod
 	GNE
 };
 
+enum class BatchAnalysis
+{
+	PITCH,
+	INTENSITY,
+	FORMANT,
+	HARMONICITY
+};
+
 
 // TODO Export befóre using default values for them
 // TODO Can be nested within Sound? Valid documentation (i.e. parselmouth.Sound.WindowShape instead of parselmouth.WindowShape)?
@@ -181,37 +309,73 @@ PRAAT_ENUM_BINDING(ToHarmonicityMethod) {
 	make_implicitly_convertible_from_string(*this);
 }
 
+PRAAT_ENUM_BINDING(BatchAnalysis) {
+	value("PITCH", BatchAnalysis::PITCH);
+	value("INTENSITY", BatchAnalysis::INTENSITY);
+	value("FORMANT", BatchAnalysis::FORMANT);
+	value("HARMONICITY", BatchAnalysis::HARMONICITY);
+
+	make_implicitly_convertible_from_string(*this);
+}
+
+CLASS_BINDING(VoiceReport, VoiceReport)
+BINDING_CONSTRUCTOR(VoiceReport, "VoiceReport")
+BINDING_INIT(VoiceReport) {
+	def_readonly("start_time", &VoiceReport::startTime);
+	def_readonly("end_time", &VoiceReport::endTime);
+
+	def_readonly("median_pitch", &VoiceReport::medianPitch);
+	def_readonly("mean_pitch", &VoiceReport::meanPitch);
+	def_readonly("standard_deviation_of_pitch", &VoiceReport::standardDeviationOfPitch);
+	def_readonly("minimum_pitch", &VoiceReport::minimumPitch);
+	def_readonly("maximum_pitch", &VoiceReport::maximumPitch);
+
+	def_readonly("number_of_pulses", &VoiceReport::numberOfPulses);
+	def_readonly("number_of_periods", &VoiceReport::numberOfPeriods);
+	def_readonly("mean_period", &VoiceReport::meanPeriod);
+	def_readonly("standard_deviation_of_period", &VoiceReport::standardDeviationOfPeriod);
+
+	def_property_readonly("fraction_of_locally_unvoiced_frames", [](const VoiceReport &self) { return self.unvoicedFrames.get(); });
+	def_property_readonly("number_of_voice_breaks", [](const VoiceReport &self) { return self.voiceBreaks.count; });
+	def_property_readonly("degree_of_voice_breaks", [](const VoiceReport &self) { return self.voiceBreaks.getFraction(); });
+
+	def_readonly("jitter_local", &VoiceReport::jitter_local);
+	def_readonly("jitter_local_absolute", &VoiceReport::jitter_local_absolute);
+	def_readonly("jitter_rap", &VoiceReport::jitter_rap);
+	def_readonly("jitter_ppq5", &VoiceReport::jitter_ppq5);
+	def_readonly("jitter_ddp", &VoiceReport::jitter_ddp);
+
+	def_readonly("shimmer_local", &VoiceReport::shimmer_local);
+	def_readonly("shimmer_local_db", &VoiceReport::shimmer_local_dB);
+	def_readonly("shimmer_apq3", &VoiceReport::shimmer_apq3);
+	def_readonly("shimmer_apq5", &VoiceReport::shimmer_apq5);
+	def_readonly("shimmer_apq11", &VoiceReport::shimmer_apq11);
+	def_readonly("shimmer_dda", &VoiceReport::shimmer_dda);
+
+	def_readonly("mean_autocorrelation", &VoiceReport::meanAutocorrelation);
+	def_readonly("mean_noise_to_harmonics_ratio", &VoiceReport::meanNoiseToHarmonicsRatio);
+	def_readonly("mean_harmonics_to_noise_ratio", &VoiceReport::meanHarmonicsToNoiseRatio_dB);
+}
+
 PRAAT_CLASS_BINDING(Sound) {
 	addTimeFrameSampledMixin(*this);
 
 	NESTED_BINDINGS(ToPitchMethod,
-	                ToHarmonicityMethod)
+	                ToHarmonicityMethod,
+	                BatchAnalysis,
+	                VoiceReport)
 
 	using signature_cast_placeholder::_;
 
 	def(py::init(&Data_copy<structSound>),
 	    "other"_a);
 
-	def(py::init([](const py::array_t<double, py::array::c_style> &values, Positive<double> samplingFrequency, double startTime) {
-		    auto ndim = values.ndim();
-
-		    if (ndim == 0)
-			    throw py::value_error("Cannot create Sound from a single 0-dimensional number");
-		    if (ndim > 2)
-			    throw py::value_error("Cannot create Sound from an array with more than 2 dimensions");
-
-		    auto nx = values.shape(ndim - 1);
-		    auto ny = ndim == 2 ? values.shape(0) : 1;
-		    if (ndim == 2 && ny > nx)
-				PyErr_WarnEx(PyExc_RuntimeWarning, ("Number of channels (" + std::to_string(ny) + ") is greater than number of samples (" + std::to_string(nx) + "); note that the shape of the `values` array is interpreted as (n_channels, n_samples).").c_str(), 1);
+	// Without copying, C-contiguous float64 data is shared with the Sound, which keeps the buffer alive
+	def(py::init([](const py::buffer &values, Positive<double> samplingFrequency, double startTime, bool copy) { return soundFromBuffer(values, samplingFrequency, startTime, copy); }),
+	    "values"_a, "sampling_frequency"_a = 44100.0, "start_time"_a = 0.0, "copy"_a = true);
 
-		    auto result = Sound_create(ny, startTime, startTime + nx / samplingFrequency, nx, 1.0 / samplingFrequency, startTime + 0.5 / samplingFrequency);
-
-		    // We can copy_n because of py::array::c_style making sure things are contiguous
-		    std::copy_n(values.data(), static_cast<size_t>(nx) * static_cast<size_t>(ny), result->z.cells);
-		    return result;
-	    }),
-	    "values"_a, "sampling_frequency"_a = 44100.0, "start_time"_a = 0.0);
+	def(py::init([](const py::array_t<double, py::array::c_style> &values, Positive<double> samplingFrequency, double startTime, bool copy) { return soundFromBuffer(values, samplingFrequency, startTime, copy); }),
+	    "values"_a, "sampling_frequency"_a = 44100.0, "start_time"_a = 0.0, "copy"_a = true);
 
 	def(py::init([](const std::u32string &filePath) {
 		    auto file = pathToMelderFile(filePath);
@@ -222,7 +386,6 @@ PRAAT_CLASS_BINDING(Sound) {
 	// TODO Constructor from few special file formats that are not detectable by header
 	// TODO Constructor from file or io.IOBase?
 	// TODO Constructor from Praat-format file?
-	// TODO Constructor from py::buffer?
 	// TODO Empty constructor?
 
 	def("save",
@@ -464,7 +627,7 @@ PRAAT_CLASS_BINDING(Sound) {
 
 	def("resample",
 	    &Sound_resample,
-	    "new_frequency"_a, "precision"_a = 50);
+	    "new_frequency"_a, "precision"_a = 50, py::call_guard<py::gil_scoped_release>());
 
 	def("lengthen", // TODO Lengthen (Overlap-add) ?
 	    [](Sound self, Positive<double> minimumPitch, Positive<double> maximumPitch, Positive<double> factor) {
@@ -472,16 +635,16 @@ PRAAT_CLASS_BINDING(Sound) {
 			    Melder_throw (U"Maximum pitch should be greater than minimum pitch.");
 		    return Sound_lengthen_overlapAdd(self, minimumPitch, maximumPitch, factor);
 	    },
-	    "minimum_pitch"_a = 75.0, "maximum_pitch"_a = 600.0, "factor"_a);
+	    "minimum_pitch"_a = 75.0, "maximum_pitch"_a = 600.0, "factor"_a, py::call_guard<py::gil_scoped_release>());
 
 	def("deepen_band_modulation",
 	    args_cast<_, Positive<_>, Positive<_>, Positive<_>, Positive<_>, Positive<_>, Positive<_>>(Sound_deepenBandModulation),
-	    "enhancement"_a = 20.0, "from_frequency"_a = 300.0, "to_frequency"_a = 8000.0, "slow_modulation"_a = 3.0, "fast_modulation"_a = 30.0, "band_smoothing"_a = 100.0);
+	    "enhancement"_a = 20.0, "from_frequency"_a = 300.0, "to_frequency"_a = 8000.0, "slow_modulation"_a = 3.0, "fast_modulation"_a = 30.0, "band_smoothing"_a = 100.0, py::call_guard<py::gil_scoped_release>());
 
 	// TODO Args cast for std::optional and std::optional ranges!
 	def("to_pitch",
 	    [](Sound self, std::optional<Positive<double>> timeStep, Positive<double> pitchFloor, Positive<double> pitchCeiling) { return Sound_to_Pitch(self, timeStep ? static_cast<double>(*timeStep) : 0.0, pitchFloor, pitchCeiling); },
-	    "time_step"_a = std::nullopt, "pitch_floor"_a = 75.0, "pitch_ceiling"_a = 600.0);
+	    "time_step"_a = std::nullopt, "pitch_floor"_a = 75.0, "pitch_ceiling"_a = 600.0, py::call_guard<py::gil_scoped_release>());
 
 	def("to_pitch",
 	    [](Sound self, ToPitchMethod method, py::args args, py::kwargs kwargs) -> py::object {
@@ -505,28 +668,28 @@ PRAAT_CLASS_BINDING(Sound) {
 		    if (maxNumberOfCandidates <= 1) Melder_throw (U"Your maximum number of candidates should be greater than 1.");
 		    return Sound_to_Pitch_ac(self, timeStep ? static_cast<double>(*timeStep) : 0.0, pitchFloor, 3.0, maxNumberOfCandidates, veryAccurate, silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, pitchCeiling);
 	    },
-	    "time_step"_a = std::nullopt, "pitch_floor"_a = 75.0, "max_number_of_candidates"_a = 15, "very_accurate"_a = false, "silence_threshold"_a = 0.03, "voicing_threshold"_a = 0.45, "octave_cost"_a = 0.01, "octave_jump_cost"_a = 0.35, "voiced_unvoiced_cost"_a = 0.14, "pitch_ceiling"_a = 600.0);
+	    "time_step"_a = std::nullopt, "pitch_floor"_a = 75.0, "max_number_of_candidates"_a = 15, "very_accurate"_a = false, "silence_threshold"_a = 0.03, "voicing_threshold"_a = 0.45, "octave_cost"_a = 0.01, "octave_jump_cost"_a = 0.35, "voiced_unvoiced_cost"_a = 0.14, "pitch_ceiling"_a = 600.0, py::call_guard<py::gil_scoped_release>());
 
 	def("to_pitch_cc",
 	    [](Sound self, std::optional<Positive<double>> timeStep, Positive<double> pitchFloor, Positive<int> maxNumberOfCandidates, bool veryAccurate, double silenceThreshold, double voicingThreshold, double octaveCost, double octaveJumpCost, double voicedUnvoicedCost, Positive<double> pitchCeiling) {
 		    if (maxNumberOfCandidates <= 1) Melder_throw (U"Your maximum number of candidates should be greater than 1.");
 		    return Sound_to_Pitch_cc(self, timeStep ? static_cast<double>(*timeStep) : 0.0, pitchFloor, 1.0, maxNumberOfCandidates, veryAccurate, silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, pitchCeiling);
 	    },
-	    "time_step"_a = std::nullopt, "pitch_floor"_a = 75.0, "max_number_of_candidates"_a = 15, "very_accurate"_a = false, "silence_threshold"_a = 0.03, "voicing_threshold"_a = 0.45, "octave_cost"_a = 0.01, "octave_jump_cost"_a = 0.35, "voiced_unvoiced_cost"_a = 0.14, "pitch_ceiling"_a = 600.0);
+	    "time_step"_a = std::nullopt, "pitch_floor"_a = 75.0, "max_number_of_candidates"_a = 15, "very_accurate"_a = false, "silence_threshold"_a = 0.03, "voicing_threshold"_a = 0.45, "octave_cost"_a = 0.01, "octave_jump_cost"_a = 0.35, "voiced_unvoiced_cost"_a = 0.14, "pitch_ceiling"_a = 600.0, py::call_guard<py::gil_scoped_release>());
 
 	def("to_pitch_spinet",
 	    [](Sound self, Positive<double> timeStep, Positive<double> windowLength, Positive<double> minimumFilterFrequency, Positive<double> maximumFilterFrequency, Positive<long> numberOfFilters, Positive<double> ceiling, Positive<int> maxNumberOfCandidates) {
 		    if (minimumFilterFrequency >= maximumFilterFrequency) Melder_throw(U"Maximum frequency must be larger than minimum frequency.");
 		    return Sound_to_Pitch_SPINET(self, timeStep, windowLength, minimumFilterFrequency, maximumFilterFrequency, numberOfFilters, ceiling, maxNumberOfCandidates);
 	    },
-	    "time_step"_a = 0.005, "window_length"_a = 0.04, "minimum_filter_frequency"_a = 70.0, "maximum_filter_frequency"_a = 5000.0, "number_of_filters"_a = 250, "ceiling"_a = 500.0, "max_number_of_candidates"_a = 15);
+	    "time_step"_a = 0.005, "window_length"_a = 0.04, "minimum_filter_frequency"_a = 70.0, "maximum_filter_frequency"_a = 5000.0, "number_of_filters"_a = 250, "ceiling"_a = 500.0, "max_number_of_candidates"_a = 15, py::call_guard<py::gil_scoped_release>());
 
 	def("to_pitch_shs",
 	    [](Sound self, Positive<double> timeStep, Positive<double> minimumPitch, Positive<long> maxNumberOfCandidates, Positive<double> maximumFrequencyComponent, Positive<long> maxNumberOfSubharmonics, Positive<double> compressionFactor, Positive<double> ceiling, Positive<long> numberOfPointsPerOctave) {
 		    if (minimumPitch >= ceiling) Melder_throw(U"Minimum pitch should be smaller than ceiling.");
 		    if (ceiling > maximumFrequencyComponent) Melder_throw(U"Maximum frequency must be greater than or equal to ceiling.");
 		    return Sound_to_Pitch_shs(self, timeStep, minimumPitch, maximumFrequencyComponent, ceiling, maxNumberOfSubharmonics, maxNumberOfCandidates, compressionFactor, numberOfPointsPerOctave);
-	    }, "time_step"_a = 0.01, "minimum_pitch"_a = 50.0, "max_number_of_candidates"_a = 15, "maximum_frequency_component"_a = 1250.0, "max_number_of_subharmonics"_a = 15, "compression_factor"_a = 0.84, "ceiling"_a = 600.0, "number_of_points_per_octave"_a = 48);
+	    }, "time_step"_a = 0.01, "minimum_pitch"_a = 50.0, "max_number_of_candidates"_a = 15, "maximum_frequency_component"_a = 1250.0, "max_number_of_subharmonics"_a = 15, "compression_factor"_a = 0.84, "ceiling"_a = 600.0, "number_of_points_per_octave"_a = 48, py::call_guard<py::gil_scoped_release>());
 
 	def("to_harmonicity",
 	    [](Sound self, ToHarmonicityMethod method, py::args args, py::kwargs kwargs) -> py::object {
@@ -545,36 +708,45 @@ PRAAT_CLASS_BINDING(Sound) {
 
 	def("to_harmonicity_cc",
 	    args_cast<_, Positive<_>, Positive<_>, _, Positive<_>>(Sound_to_Harmonicity_cc),
-	    "time_step"_a = 0.01, "minimum_pitch"_a = 75.0, "silence_threshold"_a = 0.1, "periods_per_window"_a = 1.0);
+	    "time_step"_a = 0.01, "minimum_pitch"_a = 75.0, "silence_threshold"_a = 0.1, "periods_per_window"_a = 1.0, py::call_guard<py::gil_scoped_release>());
 
 	def("to_harmonicity_ac",
 	    args_cast<_, Positive<_>, Positive<_>, _, Positive<_>>(Sound_to_Harmonicity_ac),
-	    "time_step"_a = 0.01, "minimum_pitch"_a = 75.0, "silence_threshold"_a = 0.1, "periods_per_window"_a = 1.0);
+	    "time_step"_a = 0.01, "minimum_pitch"_a = 75.0, "silence_threshold"_a = 0.1, "periods_per_window"_a = 1.0, py::call_guard<py::gil_scoped_release>());
 
 	def("to_harmonicity_gne",
 	    args_cast<_, Positive<_>, Positive<_>, Positive<_>, Positive<_>>(Sound_to_Harmonicity_GNE),
-	    "minimum_frequency"_a = 500.0, "maximum_frequency"_a = 4500.0, "bandwidth"_a = 1000.0, "step"_a = 80.0);
+	    "minimum_frequency"_a = 500.0, "maximum_frequency"_a = 4500.0, "bandwidth"_a = 1000.0, "step"_a = 80.0, py::call_guard<py::gil_scoped_release>());
 
 	def("autocorrelate",
 	    &Sound_autoCorrelate,
-	    "scaling"_a = kSounds_convolve_scaling::PEAK_099, "signal_outside_time_domain"_a = kSounds_convolve_signalOutsideTimeDomain::ZERO);
+	    "scaling"_a = kSounds_convolve_scaling::PEAK_099, "signal_outside_time_domain"_a = kSounds_convolve_signalOutsideTimeDomain::ZERO, py::call_guard<py::gil_scoped_release>());
 
 	def("to_spectrum",
 	    &Sound_to_Spectrum,
-	    "fast"_a = true);
+	    "fast"_a = true, py::call_guard<py::gil_scoped_release>());
 
 	def("to_spectrogram",
 	    [](Sound self, Positive<double> windowLength, Positive<double> maximumFrequency, Positive<double> timeStep, Positive<double> frequencyStep, kSound_to_Spectrogram_windowShape windowShape) { return Sound_to_Spectrogram(self, windowLength, maximumFrequency, timeStep, frequencyStep, windowShape, 8.0, 8.0); },
-	    "window_length"_a = 0.005, "maximum_frequency"_a = 5000.0, "time_step"_a = 0.002, "frequency_step"_a = 20.0, "window_shape"_a = kSound_to_Spectrogram_windowShape::GAUSSIAN);
+	    "window_length"_a = 0.005, "maximum_frequency"_a = 5000.0, "time_step"_a = 0.002, "frequency_step"_a = 20.0, "window_shape"_a = kSound_to_Spectrogram_windowShape::GAUSSIAN, py::call_guard<py::gil_scoped_release>());
 
 	def("to_formant_burg", // TODO Praat has Max. number of formants as REAL? What the hell? "Pi formants for me, please."? (I know, I know; see Praat documentation)
 	    [](Sound self, std::optional<Positive<double>> timeStep, Positive<double> maxNumberOfFormants, double maximumFormant, Positive<double> windowLength, Positive<double> preEmphasisFrom) { return Sound_to_Formant_burg(self, timeStep ? static_cast<double>(*timeStep) : 0.0, maxNumberOfFormants, maximumFormant, windowLength, preEmphasisFrom); },
-	    "time_step"_a = std::nullopt, "max_number_of_formants"_a = 5.0, "maximum_formant"_a = 5500.0, "window_length"_a = 0.025, "pre_emphasis_from"_a = 50.0);
+	    "time_step"_a = std::nullopt, "max_number_of_formants"_a = 5.0, "maximum_formant"_a = 5500.0, "window_length"_a = 0.025, "pre_emphasis_from"_a = 50.0, py::call_guard<py::gil_scoped_release>());
 	// TODO To Formant...
 
+	// All jitter, shimmer, pitch and harmonicity measures of Praat's voice report, computed in a single pass over the pulses
+	def("voice_report",
+	    [](Sound self, Pitch pitch, Daata pulses, std::optional<double> fromTime, std::optional<double> toTime, Positive<double> pitchFloor, Positive<double> pitchCeiling, double maximumPeriodFactor, double maximumAmplitudeFactor, double silenceThreshold, double voicingThreshold) {
+		    if (!Thing_isa(pulses, classPointProcess))
+			    Melder_throw (U"The pulses should be a PointProcess, not a ", Thing_className(pulses), U".");
+		    return Sound_Pitch_PointProcess_getVoiceReport(self, pitch, static_cast<PointProcess>(pulses), fromTime.value_or(self->xmin), toTime.value_or(self->xmax), pitchFloor, pitchCeiling, maximumPeriodFactor, maximumAmplitudeFactor, silenceThreshold, voicingThreshold);
+	    },
+	    "pitch"_a.none(false), "pulses"_a.none(false), "from_time"_a = std::nullopt, "to_time"_a = std::nullopt, "pitch_floor"_a = 75.0, "pitch_ceiling"_a = 600.0, "maximum_period_factor"_a = 1.3, "maximum_amplitude_factor"_a = 1.6, "silence_threshold"_a = 0.03, "voicing_threshold"_a = 0.45, py::call_guard<py::gil_scoped_release>());
+
 	def("to_intensity",
 	    [](Sound self, Positive<double> minimumPitch, std::optional<Positive<double>> timeStep, bool subtractMean) { return Sound_to_Intensity(self, minimumPitch, timeStep ? static_cast<double>(*timeStep) : 0.0, subtractMean); },
-	    "minimum_pitch"_a = 100.0, "time_step"_a = std::nullopt, "subtract_mean"_a = true);
+	    "minimum_pitch"_a = 100.0, "time_step"_a = std::nullopt, "subtract_mean"_a = true, py::call_guard<py::gil_scoped_release>());
 
 	// TODO Filters
 	// TODO Group different filters into enum/class/...?
@@ -597,11 +769,11 @@ PRAAT_CLASS_BINDING(Sound) {
 
 	def("convolve",
 	    &Sounds_convolve,
-	    "other"_a.none(false), "scaling"_a = kSounds_convolve_scaling::PEAK_099, "signal_outside_time_domain"_a = kSounds_convolve_signalOutsideTimeDomain::ZERO);
+	    "other"_a.none(false), "scaling"_a = kSounds_convolve_scaling::PEAK_099, "signal_outside_time_domain"_a = kSounds_convolve_signalOutsideTimeDomain::ZERO, py::call_guard<py::gil_scoped_release>());
 
 	def("cross_correlate",
 	    &Sounds_crossCorrelate,
-	    "other"_a.none(false), "scaling"_a = kSounds_convolve_scaling::PEAK_099, "signal_outside_time_domain"_a = kSounds_convolve_signalOutsideTimeDomain::ZERO);
+	    "other"_a.none(false), "scaling"_a = kSounds_convolve_scaling::PEAK_099, "signal_outside_time_domain"_a = kSounds_convolve_signalOutsideTimeDomain::ZERO, py::call_guard<py::gil_scoped_release>());
 	// TODO Cross-correlate (short)?
 
 	def("to_mfcc", // Watch out for different order of arguments in interface than in Sound_to_MFCC // TODO REQUIRE (numberOfCoefficients < 25, U"The number of coefficients should be less than 25.")
@@ -609,7 +781,55 @@ PRAAT_CLASS_BINDING(Sound) {
 		    // if (numberOfCoefficients >= 25) Melder_throw(U"The number of coefficients should be less than 25."); // Might be wrong, but I see no reason to enforce this, in the actual code
 		    return Sound_to_MFCC(self, numberOfCoefficients, windowLength, timeStep, firstFilterFrequency, maximumFrequency ? static_cast<double>(*maximumFrequency) : 0.0, distanceBetweenFilters);
 	    },
-	    "number_of_coefficients"_a = 12, "window_length"_a = 0.015, "time_step"_a = 0.005, "firstFilterFreqency"_a = 100.0, "distance_between_filters"_a = 100.0, "maximum_frequency"_a = std::nullopt);
+	    "number_of_coefficients"_a = 12, "window_length"_a = 0.015, "time_step"_a = 0.005, "firstFilterFreqency"_a = 100.0, "distance_between_filters"_a = 100.0, "maximum_frequency"_a = std::nullopt, py::call_guard<py::gil_scoped_release>());
+
+	// Batch versions of the analyses above, for many Sounds (or sound files) at once, running in parallel on Praat's thread pool
+	def_static("batch_to_pitch",
+	           [](const std::vector<SoundOrFilePath> &sounds, std::optional<Positive<double>> timeStep, Positive<double> pitchFloor, Positive<double> pitchCeiling) {
+		           return analyzeBatch(sounds, [&](Sound sound) { return Sound_to_Pitch(sound, timeStep ? static_cast<double>(*timeStep) : 0.0, pitchFloor, pitchCeiling); });
+	           },
+	           "sounds"_a, "time_step"_a = std::nullopt, "pitch_floor"_a = 75.0, "pitch_ceiling"_a = 600.0);
+
+	def_static("batch_to_intensity",
+	           [](const std::vector<SoundOrFilePath> &sounds, Positive<double> minimumPitch, std::optional<Positive<double>> timeStep, bool subtractMean) {
+		           return analyzeBatch(sounds, [&](Sound sound) { return Sound_to_Intensity(sound, minimumPitch, timeStep ? static_cast<double>(*timeStep) : 0.0, subtractMean); });
+	           },
+	           "sounds"_a, "minimum_pitch"_a = 100.0, "time_step"_a = std::nullopt, "subtract_mean"_a = true);
+
+	def_static("batch_to_formant_burg",
+	           [](const std::vector<SoundOrFilePath> &sounds, std::optional<Positive<double>> timeStep, Positive<double> maxNumberOfFormants, double maximumFormant, Positive<double> windowLength, Positive<double> preEmphasisFrom) {
+		           return analyzeBatch(sounds, [&](Sound sound) { return Sound_to_Formant_burg(sound, timeStep ? static_cast<double>(*timeStep) : 0.0, maxNumberOfFormants, maximumFormant, windowLength, preEmphasisFrom); });
+	           },
+	           "sounds"_a, "time_step"_a = std::nullopt, "max_number_of_formants"_a = 5.0, "maximum_formant"_a = 5500.0, "window_length"_a = 0.025, "pre_emphasis_from"_a = 50.0);
+
+	def_static("batch_to_harmonicity_cc",
+	           [](const std::vector<SoundOrFilePath> &sounds, Positive<double> timeStep, Positive<double> minimumPitch, double silenceThreshold, Positive<double> periodsPerWindow) {
+		           return analyzeBatch(sounds, [&](Sound sound) { return Sound_to_Harmonicity_cc(sound, timeStep, minimumPitch, silenceThreshold, periodsPerWindow); });
+	           },
+	           "sounds"_a, "time_step"_a = 0.01, "minimum_pitch"_a = 75.0, "silence_threshold"_a = 0.1, "periods_per_window"_a = 1.0);
+
+	def_static("batch_to_harmonicity_ac",
+	           [](const std::vector<SoundOrFilePath> &sounds, Positive<double> timeStep, Positive<double> minimumPitch, double silenceThreshold, Positive<double> periodsPerWindow) {
+		           return analyzeBatch(sounds, [&](Sound sound) { return Sound_to_Harmonicity_ac(sound, timeStep, minimumPitch, silenceThreshold, periodsPerWindow); });
+	           },
+	           "sounds"_a, "time_step"_a = 0.01, "minimum_pitch"_a = 75.0, "silence_threshold"_a = 0.1, "periods_per_window"_a = 1.0);
+
+	def_static("batch_analyze",
+	           [](py::object sounds, BatchAnalysis analysis, py::args args, py::kwargs kwargs) -> py::object {
+		           auto callBatch = [&](auto which) { return py::type::of<structSound>().attr(which)(sounds, *args, **kwargs); };
+		           switch (analysis) {
+		           case BatchAnalysis::PITCH:
+			           return callBatch("batch_to_pitch");
+		           case BatchAnalysis::INTENSITY:
+			           return callBatch("batch_to_intensity");
+		           case BatchAnalysis::FORMANT:
+			           return callBatch("batch_to_formant_burg");
+		           case BatchAnalysis::HARMONICITY:
+			           return callBatch("batch_to_harmonicity_cc");
+		           }
+		           return py::none(); // Unreachable
+	           },
+	           "sounds"_a, "analysis"_a);
 
 	// TODO For some reason praat_David_init.cpp also still contains Sound functionality
 	// TODO Still a bunch of Sound in praat_LPC_init.cpp
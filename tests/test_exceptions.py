@@ -17,7 +17,9 @@
 
 import pytest
 
+import numpy as np
 import parselmouth
+import threading
 import warnings
 
 
@@ -54,3 +56,28 @@ def test_warnings_default(sound):
 		for w in recorded_warnings:
 			assert str(w.message) == "No non-empty intervals were found."
 			assert isinstance(w.message, parselmouth.PraatWarning)
+
+
+def test_warnings_off_in_other_thread(tmp_path):
+	file_paths = []
+	for i in range(4):
+		file_path = str(tmp_path / f"truncated_{i}.wav")
+		parselmouth.Sound(np.random.uniform(-0.9, 0.9, 16000), sampling_frequency=16000).save(file_path, "WAV")
+		with open(file_path, "r+b") as f:
+			f.truncate(44 + 2 * 12000)
+		file_paths.append(file_path)
+
+	done = threading.Event()
+	def keep_warnings_off():
+		while not done.is_set():
+			parselmouth.praat.run("nowarn Create Sound from formula: \"busy\", 1, 0, 1, 44100, \"sin(x)\"\nRemove")
+
+	thread = threading.Thread(target=keep_warnings_off)
+	thread.start()
+	try:
+		for i in range(20):
+			with pytest.warns(parselmouth.PraatWarning, match="File too small"):
+				parselmouth.Sound.batch_to_intensity(file_paths)
+	finally:
+		done.set()
+		thread.join()
@@ -36,3 +36,96 @@ def test_raw_file(tmp_path):
 	assert reread_matrix.ymax == r + 0.5
 	assert reread_matrix.dy == 1
 	assert reread_matrix.y1 == 1
+
+
+@pytest.mark.parametrize("formula", ["self * 2 + 1", "sin(x) * row", "sqrt(self - 21) / (col - 3)", "-(self mod 7) ^ 2", "self * 0 + 2 ^ 3 - ln(10)"])
+def test_elementwise_formula(formula):
+	r, c = 3, 1000
+	matrix = parselmouth.praat.call("Create Matrix", "matrix", 0, 1, c, 1 / c, 0.5 / c, 0, 1, r, 1 / r, 0.5 / r, 'randomUniform(0, 42)')
+	reference = matrix.copy()
+	matrix.formula(formula)
+	reference.formula("if row > 0 then {} else 0 fi".format(formula))  # conditional, so evaluated cell by cell
+	assert matrix.values == pytest.approx(reference.values, nan_ok=True)
+
+	matrix.formula("self * 2", from_x=0.25, to_x=0.5, from_y=0.5, to_y=1)
+	reference.formula("if row > 0 then self * 2 else 0 fi", from_x=0.25, to_x=0.5, from_y=0.5, to_y=1)
+	assert matrix.values == pytest.approx(reference.values, nan_ok=True)
+
+
+def test_concurrent_formulas():
+	from concurrent.futures import ThreadPoolExecutor
+
+	formulas = ["self * 2", "if col mod 2 = 0 then row else -self fi", "self + evaluate(\"1 / 3\")", "x * y"] * 4
+	matrices = [parselmouth.praat.call("Create Matrix", "matrix", 0, 1, 100, 0.01, 0.005, 0, 1, 10, 0.1, 0.05, 'randomUniform(0, 1)') for _ in formulas]
+	serial = [matrix.copy() for matrix in matrices]
+	for matrix, formula in zip(serial, formulas):
+		matrix.formula(formula)
+	with ThreadPoolExecutor(max_workers=4) as executor:
+		list(executor.map(lambda args: args[0].formula(args[1]), zip(matrices, formulas)))
+
+	for matrix, matrix_ in zip(serial, matrices):
+		assert matrix.values == pytest.approx(matrix_.values)
+
+
+def test_binary_file(tmp_path):
+	import numpy as np
+
+	r, c = 37, 1500  # more cells than are read or written in one go
+	matrix = parselmouth.praat.call("Create Matrix", "matrix", 0, 1, c, 1 / c, 0.5 / c, 0, 1, r, 1 / r, 0.5 / r, 'randomGauss(0, 1) * 10 ^ randomInteger(-300, 300)')
+	values = matrix.values
+	values[0, :6] = [0.0, np.inf, -np.inf, np.nan, 5e-324, -1e-310]
+	matrix.values = values
+	file_path = tmp_path / "matrix.Matrix"
+	matrix.save_as_binary_file(str(file_path))
+	assert file_path.stat().st_size > r * c * 8
+	reread_matrix = parselmouth.read(str(file_path))
+	expected = np.where(np.isfinite(values), values, np.nan)  # infinities and NaNs are read back as undefined
+	assert np.array_equal(reread_matrix.values, expected, equal_nan=True)
+
+
+def test_binary_file_bulk_matches_portable(tmp_path):
+	import numpy as np
+
+	n = 600  # the complex roots are more numbers than are read or written in one go
+	polynomial = parselmouth.praat.call("Create Polynomial", "p", -1, 1, " ".join(map(str, np.random.uniform(-1, 1, n + 1))))
+	roots = parselmouth.praat.call(polynomial, "To Roots")
+	parselmouth.praat.call(roots, "Set root", 1, 5e-324, -1e-310)
+	parselmouth.praat.call(roots, "Set root", 2, 1e300, -1e-300)
+	values = [(parselmouth.praat.call(roots, "Get real part of root", i), parselmouth.praat.call(roots, "Get imaginary part of root", i)) for i in range(1, n + 1)]
+
+	bulk_path, portable_path = tmp_path / "bulk.Roots", tmp_path / "portable.Roots"
+	roots.save_as_binary_file(str(bulk_path))
+	parselmouth.praat.call("Debug", False, 18)  # the number-by-number routines
+	try:
+		roots.save_as_binary_file(str(portable_path))
+		reread_portably = parselmouth.read(str(bulk_path))
+	finally:
+		parselmouth.praat.call("Debug", False, 0)
+	assert bulk_path.read_bytes() == portable_path.read_bytes()
+
+	for reread_roots in [parselmouth.read(str(portable_path)), reread_portably]:
+		assert [(parselmouth.praat.call(reread_roots, "Get real part of root", i), parselmouth.praat.call(reread_roots, "Get imaginary part of root", i)) for i in range(1, n + 1)] == values
+
+
+@pytest.mark.parametrize("short", [False, True])
+def test_text_file(tmp_path, short):
+	r, c = 7, 50
+	matrix = parselmouth.praat.call("Create Matrix", "matrix", 0, 1, c, 1 / c, 0.5 / c, 0, 1, r, 1 / r, 0.5 / r, 'randomGauss(0, 1) * 10 ^ randomInteger(-300, 300)')
+	matrix.set_value(1, 1, 0.1)
+	matrix.set_value(1, 2, -123456789)
+	file_path = tmp_path / "matrix.Matrix"
+	if short:
+		matrix.save_as_short_text_file(str(file_path))
+	else:
+		matrix.save_as_text_file(str(file_path))
+	assert parselmouth.read(str(file_path)).values.tolist() == matrix.values.tolist()
+
+	lines = file_path.read_text().splitlines()
+	z = 13 if short else 15  # the line of the first value
+	lines[z] = "! a comment à la ligne\n" + lines[z]
+	lines[z + 1] = lines[z + 1].replace(lines[z + 1].split()[-1], "1/4")
+	lines[z + 2] = lines[z + 2].replace(lines[z + 2].split()[-1], "50% ")
+	file_path.write_text("\n".join(lines), encoding="utf-8")
+	values = parselmouth.read(str(file_path)).values
+	assert values[0, :3].tolist() == [0.1, 0.25, 0.5]
+	assert values[:, 3:].tolist() == matrix.values[:, 3:].tolist()
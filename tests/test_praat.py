@@ -169,6 +169,43 @@ def test_run_with_return_variables():
 	assert set(variables.keys()) == {'a', 'b$', 'c#', 'd##', 'newline$', 'tab$', 'shellDirectory$', 'defaultDirectory$', 'preferencesDirectory$', 'homeDirectory$', 'temporaryDirectory$', 'macintosh', 'windows', 'unix', 'left', 'right', 'mono', 'stereo', 'all', 'average', 'praatVersion$', 'praatVersion'}
 
 
+def test_run_with_variables_in_loops():
+	script = textwrap.dedent("""\
+	total = 0
+	for i to 100
+		@square: i
+		total += square.result
+		name$ = "x" + string$ (i mod 3)
+		'name$' = i
+	endfor
+	procedure square: .n
+		.result = .n * .n
+	endproc
+	""")
+
+	objects, variables = parselmouth.praat.run(script, return_variables=True)
+	assert variables['total'] == sum(i * i for i in range(1, 101))
+	assert variables['square.result'] == 100 * 100
+	assert (variables['x0'], variables['x1'], variables['x2']) == (99, 100, 98)
+
+
+def test_point_process_add_points_and_set_operations():
+	def times(point_process):
+		n = parselmouth.praat.call(point_process, "Get number of points")
+		return [parselmouth.praat.call(point_process, "Get time from index", i) for i in range(1, n + 1)]
+
+	a = parselmouth.praat.call("Create empty PointProcess", "a", 0, 1)
+	parselmouth.praat.call(a, "Add point", 0.5)
+	parselmouth.praat.call(a, "Add points", np.array([0.9, 0.1, 0.5, 0.3, 0.1]))
+	assert times(a) == [0.1, 0.3, 0.5, 0.9]
+
+	b = parselmouth.praat.call("Create empty PointProcess", "b", 0.5, 2)
+	parselmouth.praat.call(b, "Add points", np.array([0.6, 0.9, 1.5, 0.5]))
+	assert times(parselmouth.praat.call([a, b], "Union")) == [0.1, 0.3, 0.5, 0.6, 0.9, 1.5]
+	assert times(parselmouth.praat.call([a, b], "Intersection")) == [0.5, 0.9]
+	assert times(parselmouth.praat.call([a, b], "Difference")) == [0.1, 0.3]
+
+
 def test_run_with_capture_output_and_return_variables():
 	script = textwrap.dedent("""\
 	a = 42
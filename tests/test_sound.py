@@ -19,6 +19,8 @@ import pytest
 
 import parselmouth
 import numpy as np
+import os
+import warnings
 
 
 @pytest.fixture(params=[100, 16000, 44100])
@@ -62,3 +64,272 @@ def test_from_scalar(sampling_frequency):
 
 	with pytest.raises(ValueError, match="Cannot create Sound from a single 0-dimensional number"):
 		parselmouth.Sound(3.14159, sampling_frequency=sampling_frequency)
+
+
+def test_from_buffer_without_copy(sampling_frequency):
+	values = np.random.normal(size=(2, 1000))
+	sound = parselmouth.Sound(values, sampling_frequency=sampling_frequency, copy=False)
+	values[1, 42] = 0.5
+	assert sound.values[1, 42] == 0.5
+	del values
+	assert sound.values.shape == (2, 1000)
+
+	values = np.random.normal(size=(2, 1000))
+	assert parselmouth.Sound(values, sampling_frequency=sampling_frequency) == parselmouth.Sound(values, sampling_frequency=sampling_frequency, copy=False)
+	sound = parselmouth.Sound(values, sampling_frequency=sampling_frequency)
+	values[1, 42] = 0.5
+	assert sound.values[1, 42] != 0.5
+
+
+@pytest.mark.parametrize("dtype", [np.float64, np.float32, np.int16, np.int32])
+def test_from_buffer_conversions(sampling_frequency, dtype):
+	values = (np.random.normal(size=(2, 1000)) * 1000).astype(dtype)
+	for view in [values, values[0], values[:, ::3], values[::-1], values.T.copy().T]:
+		for copy in [True, False]:
+			sound = parselmouth.Sound(view, sampling_frequency=sampling_frequency, copy=copy)
+			assert np.all(sound.values == np.atleast_2d(view).astype(np.float64))
+
+
+@pytest.mark.parametrize("file_format,resolution", [("WAV", 2**-15), ("AIFF", 2**-15), ("AIFC", 2**-15), ("NEXT_SUN", 2**-15), ("WAV_24", 2**-23), ("WAV_32", 2**-31)])
+def test_save_and_read(sound, tmp_path, file_format, resolution):
+	stereo = parselmouth.Sound(np.vstack((sound.values[0], -0.5 * sound.values[0])), sampling_frequency=sound.sampling_frequency)
+	path = str(tmp_path / "stereo")
+	stereo.save(path, file_format)
+	read = parselmouth.read(path)
+	assert read.n_channels == 2
+	assert read.n_samples == stereo.n_samples
+	assert np.allclose(read.values, stereo.values, rtol=0, atol=resolution)
+
+
+def test_read_float_wav_with_non_finite_samples(tmp_path):
+	samples = np.array([0.25, np.inf, -0.5, np.nan, -np.inf, 0.75], dtype='<f4')
+	data = samples.tobytes()
+	header = b"RIFF" + (36 + len(data)).to_bytes(4, "little") + b"WAVE"
+	header += b"fmt " + (16).to_bytes(4, "little") + (3).to_bytes(2, "little") + (1).to_bytes(2, "little")  # IEEE float, mono
+	header += (8000).to_bytes(4, "little") + (4 * 8000).to_bytes(4, "little") + (4).to_bytes(2, "little") + (32).to_bytes(2, "little")
+	header += b"data" + len(data).to_bytes(4, "little")
+	path = str(tmp_path / "float.wav")
+	with open(path, "wb") as f:
+		f.write(header + data)
+	for read in [parselmouth.Sound(path), parselmouth.praat.call(parselmouth.praat.call("Open long sound file", path), "Extract part", 0, 0, "yes")]:
+		values = read.values[0]
+		assert np.all(np.isnan(values[~np.isfinite(samples)]))
+		assert np.all(values[np.isfinite(samples)] == samples[np.isfinite(samples)])
+
+@pytest.mark.parametrize("factor,tolerance", [(1.5, 1e-10), (160 / 147, 1e-10), (np.pi / 2, 1e-6)])
+def test_resample_matches_sinc_interpolation(factor, tolerance):
+	sound = parselmouth.Sound(np.random.normal(size=20000), sampling_frequency=1000)
+	resampled = sound.resample(1000 * factor, 70)
+	xs = resampled.xs()
+	for i in range(100, resampled.n_samples - 100, 397):
+		assert resampled.values[0, i] == pytest.approx(parselmouth.praat.call(sound, "Get value at time", 1, xs[i], "sinc70"), abs=tolerance)
+
+
+def test_mel_spectrogram_matches_filtered_power_spectrum():
+	sound = parselmouth.Sound(np.random.normal(size=8000), sampling_frequency=16000)
+	window_length, time_step = 0.015, 0.005
+	mel_spectrogram = parselmouth.praat.call(sound, "To MelSpectrogram", window_length, time_step, 100, 100, 0)
+	matrix = parselmouth.praat.call(mel_spectrogram, "To Matrix", "no")
+	values = matrix.values
+	t1 = parselmouth.praat.call(matrix, "Get x of column", 1)
+	f1_mel = parselmouth.praat.call(matrix, "Get y of row", 1)
+
+	n = round(2 * window_length * sound.sampling_frequency)
+	fft_size = 1 << (n - 1).bit_length()
+	window = (np.exp(-48 * (np.arange(1, n + 1) - (n + 1) / 2)**2 / (n + 1)**2) - np.exp(-12)) / (1 - np.exp(-12))
+	bin_frequencies = np.arange(fft_size // 2 + 1) * sound.sampling_frequency / fft_size
+	to_hertz = lambda mel: 700 * (10**(mel / 2595) - 1)
+	expected = np.empty_like(values)
+	for iframe in range(values.shape[1]):
+		first = round((t1 + iframe * time_step - window_length - sound.x1) / sound.dx)
+		frame = np.array([sound.values[0, j] if 0 <= j < sound.n_samples else 0 for j in range(first, first + n)])
+		power = np.abs(np.fft.rfft(frame * window, fft_size))**2
+		power[[0, -1]] /= 2
+		for ifilter in range(values.shape[0]):
+			fl, fc, fh = (to_hertz(f1_mel + (ifilter + k) * 100) for k in (-1, 0, 1))
+			weights = np.where(bin_frequencies < fc, (bin_frequencies - fl) / (fc - fl), (fh - bin_frequencies) / (fh - fc))
+			expected[ifilter, iframe] = np.sum(np.clip(weights, 0, None) * power)
+	assert np.allclose(values / expected, values[0, 0] / expected[0, 0], rtol=1e-9)
+
+
+@pytest.mark.parametrize("window_shape", ["Gaussian", "Hanning (sine-squared)"])
+def test_spectrogram_matches_short_time_power_spectrum(window_shape):
+	sound = parselmouth.Sound(np.random.normal(size=(2, 8000)), sampling_frequency=16000)
+	window_length, frequency_step = 0.005, 200
+	spectrogram = parselmouth.praat.call(sound, "To Spectrogram", window_length, sound.sampling_frequency / 2, 0.002, frequency_step, window_shape)
+	values = spectrogram.values
+
+	physical_window_length = 2 * window_length if window_shape == "Gaussian" else window_length
+	n = (int(physical_window_length * sound.sampling_frequency) // 2 - 1) * 2
+	fft_size = 1
+	while fft_size < n or fft_size < 2 * int(sound.sampling_frequency / 2 / frequency_step):
+		fft_size *= 2
+	bin_width = int(frequency_step * fft_size / sound.sampling_frequency)
+	i = np.arange(1, n + 1)
+	if window_shape == "Gaussian":
+		window = (np.exp(-48 * ((i - (n + 1) / 2) / (physical_window_length * sound.sampling_frequency))**2) - np.exp(-12)) / (1 - np.exp(-12))
+	else:
+		window = 0.5 * (1 - np.cos(2 * np.pi * i / (physical_window_length * sound.sampling_frequency)))
+	expected = np.empty_like(values)
+	for iframe in range(values.shape[1]):
+		first = int(np.floor((spectrogram.x1 + iframe * spectrogram.dx - sound.x1) / sound.dx)) + 1 - n // 2
+		power = np.mean(np.abs(np.fft.rfft(sound.values[:, first:first + n] * window, fft_size))**2, axis=0)
+		expected[:, iframe] = power[:values.shape[0] * bin_width].reshape(-1, bin_width).sum(axis=1) / np.sum(window**2) / bin_width
+	assert np.allclose(values, expected, rtol=1e-9, atol=0)
+
+
+@pytest.mark.parametrize("subtract_trend", [True, False])
+def test_cpps_matches_cpps_of_power_cepstrogram(subtract_trend):
+	sound = parselmouth.Sound(0.5 * np.sin(2 * np.pi * 377 * np.arange(22050) / 44100) + np.random.normal(0, 0.1, 22050), sampling_frequency=44100)
+	cepstrogram_arguments = [60, 0.002, 5000, 50]
+	cpps_arguments = [subtract_trend, 0.02, 0.0005, 60, 330, 0.05, "Parabolic", 0.001, 0.05, "Exponential decay", "Robust"]
+	cepstrogram = parselmouth.praat.call(sound, "To PowerCepstrogram", *cepstrogram_arguments)
+	expected = parselmouth.praat.call(cepstrogram, "Get CPPS", *cpps_arguments)
+	assert parselmouth.praat.call(sound, "Get CPPS", *cepstrogram_arguments, *cpps_arguments) == pytest.approx(expected, rel=1e-12)
+
+	# The steps over the whole cepstrogram that Get CPPS takes without streaming
+	trend_arguments = [0.001, 0.05, "Exponential decay", "Robust"]
+	flattened = parselmouth.praat.call(cepstrogram, "Subtract trend", *trend_arguments) if subtract_trend else cepstrogram
+	smoothed = parselmouth.praat.call(flattened, "Smooth", 0.02, 0.0005)
+	table = parselmouth.praat.call(smoothed, "To Table (peak prominence)", 60, 330, 0.05, "Parabolic", *trend_arguments)
+	assert expected == pytest.approx(parselmouth.praat.call(table, "Get mean", parselmouth.praat.call(table, "Get column label", 3)), rel=1e-12)
+
+
+def test_voice_report_matches_separate_queries(sound):
+	pitch = sound.to_pitch_cc()
+	pulses = parselmouth.praat.call([sound, pitch], "To PointProcess (cc)")
+	report = sound.voice_report(pitch, pulses, from_time=0.2, to_time=1.0)
+	period_arguments = [0.2, 1.0, 0.8 / 600, 1.25 / 75, 1.3]
+	assert report.number_of_periods == parselmouth.praat.call(pulses, "Get number of periods", *period_arguments)
+	assert report.mean_period == parselmouth.praat.call(pulses, "Get mean period", *period_arguments)
+	assert report.standard_deviation_of_period == parselmouth.praat.call(pulses, "Get stdev period", *period_arguments)
+	for name, query in [("local", "local"), ("local_absolute", "local, absolute"), ("rap", "rap"), ("ppq5", "ppq5"), ("ddp", "ddp")]:
+		assert getattr(report, "jitter_" + name) == parselmouth.praat.call(pulses, f"Get jitter ({query})", *period_arguments)
+	for name, query in [("local", "local"), ("local_db", "local_dB"), ("apq3", "apq3"), ("apq5", "apq5"), ("apq11", "apq11"), ("dda", "dda")]:
+		assert getattr(report, "shimmer_" + name) == parselmouth.praat.call([sound, pulses], f"Get shimmer ({query})", *period_arguments, 1.6)
+	with pytest.raises(parselmouth.PraatError, match="should be a PointProcess"):
+		sound.voice_report(pitch, pitch)
+
+
+def test_batch_analysis_matches_single_analyses(sound, sound_path):
+	sounds = [sound, sound_path, sound.extract_part(0.5, 1.5)]
+	expected = [s.to_pitch(pitch_floor=100) for s in [sound, sound, sounds[2]]]
+	assert parselmouth.Sound.batch_to_pitch(sounds, pitch_floor=100) == expected
+	assert parselmouth.Sound.batch_analyze(sounds, "PITCH", pitch_floor=100) == expected
+	assert parselmouth.Sound.batch_to_intensity(sounds) == [s.to_intensity() for s in [sound, sound, sounds[2]]]
+	assert parselmouth.Sound.batch_analyze(sounds, "FORMANT") == [s.to_formant_burg() for s in [sound, sound, sounds[2]]]
+	assert parselmouth.Sound.batch_to_pitch([]) == []
+	with pytest.raises(parselmouth.PraatError, match="Item 2 of the batch not analysed"):
+		parselmouth.Sound.batch_to_pitch([sound, "does_not_exist.wav"])
+
+
+def test_batch_analysis_of_files_that_warn(tmp_path):
+	file_paths = []
+	for i in range(16):
+		file_path = str(tmp_path / f"truncated_{i}.wav")
+		parselmouth.Sound(np.random.uniform(-0.9, 0.9, 16000), sampling_frequency=16000).save(file_path, "WAV")
+		with open(file_path, "r+b") as f:
+			f.truncate(44 + 2 * 12000)
+		file_paths.append(file_path)
+	with pytest.warns(parselmouth.PraatWarning, match="File too small"):
+		expected = [parselmouth.Sound(file_path).to_intensity() for file_path in file_paths]
+	with pytest.warns(parselmouth.PraatWarning, match="File too small") as record:
+		assert parselmouth.Sound.batch_to_intensity(file_paths) == expected
+	assert all("Missing samples set to zero" in str(w.message) for w in record if isinstance(w.message, parselmouth.PraatWarning))
+
+
+@pytest.mark.parametrize("file_format", ["WAV", "AIFF", "NEXT_SUN", "WAV_24", "FLAC"])
+def test_long_sound_extract_part_matches_sound(file_format, tmp_path):
+	sound = parselmouth.Sound(np.random.uniform(-0.9, 0.9, (2, 50000)), sampling_frequency=16000)
+	file_path = str(tmp_path / "long_sound")
+	sound.save(file_path, file_format)
+	expected = parselmouth.Sound(file_path)
+	long_sound = parselmouth.praat.call("Open long sound file", file_path)
+	for from_time, to_time in [(0, 0), (0.1, 0.2), (3.0, 3.125)]:
+		part = parselmouth.praat.call(long_sound, "Extract part", from_time, to_time, "yes")
+		assert part == expected.extract_part(from_time, to_time, preserve_times=True)
+	extracted_path = str(tmp_path / "extracted.wav")
+	parselmouth.praat.call(long_sound, "Save as WAV file", extracted_path)
+	assert np.allclose(parselmouth.Sound(extracted_path).values, expected.values, rtol=0, atol=1 / 32768)
+
+
+def write_mpeg_layer_1(file_path, number_of_frames):
+	"""Writes frames of random MPEG-1 Layer I audio (stereo, 48 kHz, 384 kbit/s), which Praat decodes like MP3"""
+	rng = np.random.default_rng(0)
+	def bits(values, n):
+		return ((np.asarray(values, dtype=np.int64)[:, None] >> np.arange(n - 1, -1, -1)) & 1).ravel()
+	with open(file_path, "wb") as f:
+		for _ in range(number_of_frames):
+			frame = np.concatenate([
+				bits([0xFFFFC400], 32),  # header
+				bits(np.full(64, 2), 4),  # 3 bits per sample, in each subband of each channel
+				bits(rng.integers(6, 30, 64), 6),  # scale factors
+				bits(rng.integers(0, 7, 12 * 64), 3)])  # samples (all ones is not allowed)
+			f.write(np.packbits(np.pad(frame, (0, 384 * 8 - len(frame)))).tobytes())
+
+
+def test_long_sound_mp3(tmp_path):
+	file_path = str(tmp_path / "long_sound.mp3")
+	number_of_frames, samples_per_frame = 430, 384
+	write_mpeg_layer_1(file_path, number_of_frames)
+	expected = parselmouth.Sound(file_path)
+	with pytest.warns(parselmouth.PraatWarning, match="Time measurements in MP3 files"):
+		long_sound = parselmouth.praat.call("Open long sound file", file_path)
+	for from_time, to_time in [(2.7, 3.0), (0.6, 0.75), (1.3, 2.1), (3.3, expected.xmax), (0, 0)]:  # seeking back, over block boundaries, and into the short last block
+		part = parselmouth.praat.call(long_sound, "Extract part", from_time, to_time, "yes")
+		assert part == expected.extract_part(from_time, to_time, preserve_times=True)
+
+	with pytest.warns(parselmouth.PraatWarning, match="Time measurements in MP3 files"):
+		long_sound = parselmouth.praat.call("Open long sound file", file_path)
+	number_of_frames_left = number_of_frames - 5
+	os.truncate(file_path, number_of_frames_left * 384)
+	decoder_delay = number_of_frames * samples_per_frame - expected.n_samples
+	number_of_samples_left = number_of_frames_left * samples_per_frame - decoder_delay
+	part = parselmouth.praat.call(long_sound, "Extract part", 0, 0, "yes")
+	assert np.array_equal(part.values[:, :number_of_samples_left], expected.values[:, :number_of_samples_left])
+	assert np.all(part.values[:, number_of_samples_left:] == 0)  # the decoding stopped early
+
+
+def test_long_sound_survives_truncated_file(tmp_path):
+	sound = parselmouth.Sound(np.random.uniform(-0.9, 0.9, 16000), sampling_frequency=16000)
+	file_path = str(tmp_path / "long_sound.wav")
+	sound.save(file_path, "WAV")
+	expected = parselmouth.Sound(file_path)
+	long_sound = parselmouth.praat.call("Open long sound file", file_path)
+	with open(file_path, "r+b") as f:
+		f.truncate(44 + 2 * 8000)
+	part = parselmouth.praat.call(long_sound, "Extract part", 0.1, 0.2, "yes")
+	assert part == expected.extract_part(0.1, 0.2, preserve_times=True)
+	with pytest.warns(parselmouth.PraatWarning, match="File too small"):
+		part = parselmouth.praat.call(long_sound, "Extract part", 0.75, 0.875, "yes")
+	assert np.all(part.values == 0)
+
+
+def test_long_sound_envelope_queries(tmp_path):
+	sound = parselmouth.Sound(np.random.uniform(-0.9, 0.9, (2, 3000000)), sampling_frequency=44100)
+	file_path = str(tmp_path / "long_sound.wav")
+	sound.save(file_path, "WAV")
+	expected = parselmouth.Sound(file_path)
+	long_sound = parselmouth.praat.call("Open long sound file", file_path)
+	for from_time, to_time in [(0, 0), (0.1, 30.7), (12.345, 12.346), (5.0, 68.0)]:
+		assert parselmouth.praat.call(long_sound, "Get minimum", from_time, to_time) == parselmouth.praat.call(expected, "Get minimum", from_time, to_time, "none")
+		assert parselmouth.praat.call(long_sound, "Get maximum", from_time, to_time) == parselmouth.praat.call(expected, "Get maximum", from_time, to_time, "none")
+		assert parselmouth.praat.call(long_sound, "Get root-mean-square", from_time, to_time) == pytest.approx(parselmouth.praat.call(expected, "Get root-mean-square", from_time, to_time), rel=1e-12)
+
+
+def test_long_sound_short_queries_do_not_need_envelope(tmp_path):
+	sound = parselmouth.Sound(np.random.uniform(-0.9, 0.9, (2, 3000000)), sampling_frequency=44100)
+	file_path = str(tmp_path / "long_sound.wav")
+	sound.save(file_path, "WAV")
+	expected = parselmouth.Sound(file_path)
+	long_sound = parselmouth.praat.call("Open long sound file", file_path)
+	with open(file_path, "r+b") as f:
+		f.truncate(44 + 2 * 2 * 1000000)  # building the envelope would now run into the end of the file
+	with warnings.catch_warnings():
+		warnings.simplefilter("error", parselmouth.PraatWarning)
+		for from_time, to_time in [(0.1, 0.2), (12.345, 12.346), (1.0, 20.0)]:
+			assert parselmouth.praat.call(long_sound, "Get minimum", from_time, to_time) == parselmouth.praat.call(expected, "Get minimum", from_time, to_time, "none")
+			assert parselmouth.praat.call(long_sound, "Get maximum", from_time, to_time) == parselmouth.praat.call(expected, "Get maximum", from_time, to_time, "none")
+			assert parselmouth.praat.call(long_sound, "Get root-mean-square", from_time, to_time) == pytest.approx(parselmouth.praat.call(expected, "Get root-mean-square", from_time, to_time), rel=1e-12)
+	with pytest.warns(parselmouth.PraatWarning, match="File too small"):
+		parselmouth.praat.call(long_sound, "Get maximum", 0, 0)
@@ -15,8 +15,12 @@
 # You should have received a copy of the GNU General Public License
 # along with Parselmouth.  If not, see <http://www.gnu.org/licenses/>
 
+import math
+import warnings
+
 import pytest
 
+import numpy as np
 import parselmouth
 
 
@@ -28,3 +32,177 @@ def test_sound_to_pitch(sound):
 
 	assert fragment.to_pitch(pitch_floor=50.0, method=parselmouth.Sound.ToPitchMethod.AC) == fragment.to_pitch_ac(pitch_floor=50)
 	assert fragment.to_pitch("CC", pitch_ceiling=300) == fragment.to_pitch_cc(pitch_ceiling=300.0)
+
+
+def decode_with_lookahead(pitch, maximum_lookahead, silence_threshold=0.03, voicing_threshold=0.45, octave_cost=0.01, octave_jump_cost=0.35, voiced_unvoiced_cost=0.14, ceiling=600.0):
+	# A plain transcription of the path finder with a bounded lookahead, which keeps the whole history;
+	# returns the selected frequency of every frame
+	frames = [pitch.get_frame(i) for i in range(1, pitch.n_frames + 1)]
+	candidates = [frame.candidates for frame in frames]
+	time_step_correction = 0.01 / pitch.dx
+	octave_jump_cost *= time_step_correction
+	voiced_unvoiced_cost *= time_step_correction
+	log2 = lambda x: math.log(x) * 1.4426950408889634
+	is_voiced = lambda f: 0.0 < f < ceiling
+	psi = [None]
+	selected = [None] * len(frames)
+	number_of_decided_frames = 0
+
+	def decide(last_frame, place):
+		nonlocal number_of_decided_frames
+		for iframe in range(last_frame, number_of_decided_frames, -1):
+			selected[iframe - 1] = candidates[iframe - 1][place].frequency
+			place = psi[iframe - 1][place] if iframe > 1 else None
+		number_of_decided_frames = last_frame
+
+	previous_delta, is_open = None, None
+	for iframe, (frame, current) in enumerate(zip(frames, candidates), start=1):
+		unvoiced_strength = 0.0 if silence_threshold <= 0 else 2.0 - frame.intensity / (silence_threshold / (1.0 + voicing_threshold))
+		unvoiced_strength = voicing_threshold + max(0.0, unvoiced_strength)
+		delta = [c.strength - octave_cost * log2(ceiling / c.frequency) if is_voiced(c.frequency) else unvoiced_strength for c in current]
+		if iframe > 1:
+			psi.append([])
+			for icand2, c2 in enumerate(current):
+				maximum, place = -1e30, None
+				for icand1, c1 in enumerate(candidates[iframe - 2]):
+					if not is_open[icand1]:
+						continue
+					if is_voiced(c2.frequency) and is_voiced(c1.frequency):
+						transition_cost = octave_jump_cost * abs(log2(c1.frequency / c2.frequency))
+					elif is_voiced(c2.frequency) or is_voiced(c1.frequency):
+						transition_cost = voiced_unvoiced_cost
+					else:
+						transition_cost = 0.0
+					value = previous_delta[icand1] - transition_cost + delta[icand2]
+					if value > maximum:
+						maximum, place = value, icand1
+				delta[icand2] = maximum
+				psi[-1].append(place)
+		is_open = [True] * len(current)
+		previous_delta = delta
+
+		# All paths into the last frame agree on a frame, or the lookahead runs out
+		best = max(range(len(current)), key=lambda icand: delta[icand])
+		ancestors = list(range(len(current)))
+		for jframe in range(iframe, number_of_decided_frames + 1, -1):
+			ancestors = [psi[jframe - 1][ancestor] for ancestor in ancestors]
+			if len(set(ancestors)) == 1:
+				decide(jframe - 1, ancestors[0])
+				break
+			if jframe - 1 == iframe - maximum_lookahead:
+				is_open = [ancestor == ancestors[best] for ancestor in ancestors]
+				decide(jframe - 1, ancestors[best])
+				break
+
+	if number_of_decided_frames < len(frames):
+		decide(len(frames), max((icand for icand in range(len(candidates[-1])) if is_open[icand]), key=lambda icand: previous_delta[icand]))
+	return selected
+
+
+def test_pitch_path_finder_with_lookahead(sound, pitch):
+	full = pitch.copy()
+	full.path_finder(octave_jump_cost=0.5)
+	unlimited = pitch.copy()
+	unlimited.path_finder(octave_jump_cost=0.5, maximum_lookahead=pitch.n_frames)
+	assert (unlimited.selected_array == full.selected_array).all()
+
+	# With many candidates in short frames, the lookahead often runs out before the paths agree
+	dense = sound.to_pitch_ac(time_step=0.002, max_number_of_candidates=15, pitch_ceiling=800)
+	full_dense = dense.copy()
+	full_dense.path_finder(octave_jump_cost=0.5, ceiling=800)
+	for candidates, ceiling, full_path in [(pitch, 600, full), (dense, 800, full_dense)]:
+		for maximum_lookahead in [1, 2, 5]:
+			streamed = candidates.copy()
+			streamed.path_finder(octave_jump_cost=0.5, ceiling=ceiling, maximum_lookahead=maximum_lookahead)
+			assert streamed.n_frames == candidates.n_frames
+			expected = decode_with_lookahead(candidates, maximum_lookahead, octave_jump_cost=0.5, ceiling=ceiling)
+			assert [frame.selected.frequency for frame in streamed] == expected
+	assert expected != [frame.selected.frequency for frame in full_dense]
+
+	with pytest.raises(TypeError):
+		pitch.copy().path_finder(maximum_lookahead=0)
+
+
+def test_concurrent_analyses(sound):
+	from concurrent.futures import ThreadPoolExecutor
+
+	fragments = [sound.extract_part(from_time=0.1 * i, to_time=0.1 * i + 0.3) for i in range(4)]
+	serial = [(fragment.to_pitch(), fragment.to_intensity(), fragment.to_formant_burg()) for fragment in fragments]
+	with ThreadPoolExecutor(max_workers=4) as executor:
+		concurrent = list(executor.map(lambda fragment: (fragment.to_pitch(), fragment.to_intensity(), fragment.to_formant_burg()), fragments))
+
+	for (pitch, intensity, formant), (pitch_, intensity_, formant_) in zip(serial, concurrent):
+		assert pitch == pitch_
+		assert intensity == intensity_
+		assert formant == formant_
+
+
+@pytest.mark.parametrize("lpc_model", ["Burg", "Robust"])
+def test_formant_path_matches_analyses_per_ceiling(sound, lpc_model, tmp_path):
+	fragment = sound.extract_part(to_time=1.0)
+	time_step, window_length = 0.005, 0.025
+	ceilings = [1250, 2500, 5000]  # a step of exactly an octave, so that every ceiling's own frames are those of the middle ceiling
+	formant_path = parselmouth.praat.call(fragment, "To FormantPath...", time_step, 5, ceilings[1], window_length, 50, lpc_model, math.log(2), 1, 1e-6, 1e-6, 1.5, 5, 1e-6, False)
+	file_path = tmp_path / "path.FormantPath"
+	formant_path.save_as_text_file(str(file_path))
+	lines = file_path.read_text().splitlines()
+
+	def frames(lines):
+		lines = [line.strip() for line in lines]
+		return lines[lines.index("frames []:"):]
+
+	for i, ceiling in enumerate(ceilings, start=1):
+		first = lines.index(f"formants [{i}]:") + 1
+		last = next(j for j in range(first, len(lines)) if not lines[j].startswith(" "))
+		resampled = fragment.resample(2 * ceiling, 50)
+		if lpc_model == "Burg":
+			lpc = parselmouth.praat.call(resampled, "To LPC (burg)", 10, window_length, time_step, 50)
+		else:
+			lpc = parselmouth.praat.call(resampled, "To LPC (autocorrelation)", 10, window_length, time_step, 50)
+			lpc = parselmouth.praat.call([lpc, resampled], "To LPC (robust)", window_length, 50, 1.5, 5, 1e-6, True)
+		formant = parselmouth.praat.call(lpc, "To Formant")
+		formant.save_as_text_file(str(tmp_path / "ceiling.Formant"))
+		assert frames(lines[first:last]) == frames((tmp_path / "ceiling.Formant").read_text().splitlines()), f"ceiling {ceiling} Hz"
+
+
+@pytest.mark.parametrize("lpc_model", ["Burg", "Robust"])
+def test_formant_path_warns_once(sound, lpc_model):
+	fragment = sound.extract_part(to_time=1.0)
+	values = fragment.values.copy()
+	values[:, values.shape[1] // 2] = np.nan  # spreads over every frame of every resampled ceiling
+	fragment = parselmouth.Sound(values, sampling_frequency=fragment.sampling_frequency)
+	with warnings.catch_warnings(record=True) as caught:
+		warnings.simplefilter("always")
+		parselmouth.praat.call(fragment, "To FormantPath...", 0.005, 5, 5500, 0.025, 50, lpc_model, 0.05, 4, 1e-6, 1e-6, 1.5, 5, 1e-6, False)
+	messages = [str(warning.message) for warning in caught]
+	assert sum("are suspect" in message for message in messages) == 1
+	assert sum("could not be optimised" in message for message in messages) == (1 if lpc_model == "Robust" else 0)
+
+
+def test_long_sound_to_pitch(sound, sound_path):
+	long_sound = parselmouth.praat.call("Open long sound file...", sound_path)
+	assert parselmouth.praat.call(long_sound, "To Pitch...", 0.0, 75.0, 600.0) == sound.to_pitch()
+	assert parselmouth.praat.call(long_sound, "To Pitch...", 0.001, 50.0, 300.0) == sound.to_pitch(0.001, 50.0, 300.0)
+
+
+def test_long_sound_to_pitch_over_several_buffers(tmp_path):
+	sampling_frequency = 16000
+	t = np.arange(35 * sampling_frequency) / sampling_frequency
+	f0 = 200 + 80 * np.sin(2 * np.pi * t / 7)
+	signal = 0.5 * np.sin(2 * np.pi * np.cumsum(f0) / sampling_frequency) * (np.sin(2 * np.pi * t / 3) > -0.5)
+	signal = signal + np.random.uniform(-0.05, 0.05, (2, len(t)))
+	file_path = str(tmp_path / "long_sound.wav")
+	parselmouth.Sound(signal, sampling_frequency=sampling_frequency).save(file_path, "WAV")
+
+	parselmouth.praat.call("LongSound preferences...", 10)  # the shortest buffer, so that the pitch analysis is done in several blocks
+	try:
+		long_sound = parselmouth.praat.call("Open long sound file...", file_path)
+	finally:
+		parselmouth.praat.call("LongSound preferences...", 60)
+	long_pitch = parselmouth.praat.call(long_sound, "To Pitch...", 0.0, 75.0, 600.0)
+	pitch = parselmouth.Sound(file_path).to_pitch()
+
+	assert (long_pitch.n_frames, long_pitch.x1, long_pitch.dx) == (pitch.n_frames, pitch.x1, pitch.dx)
+	for i, (long_frame, frame) in enumerate(zip(long_pitch, pitch), start=1):
+		assert np.array_equal(long_frame.as_array(), frame.as_array()), f"frame {i}"
+	assert long_pitch == pitch
@@ -63,3 +63,26 @@ def test_tgt_exceptions(text_grid_path, monkeypatch):
 		parselmouth.read(text_grid_path).to_tgt()
 	with pytest.raises(TypeError, match="'MockTextGrid' object is not iterable"):
 		parselmouth.TextGrid.from_tgt(MockTextGrid())
+
+
+@pytest.mark.parametrize("short", [False, True])
+def test_text_file(tmp_path, short):
+	text_grid = parselmouth.TextGrid(0.0, 2.0, ["words", "events"], ["events"])
+	for i, (time, label) in enumerate([(0.1, "a"), (1 / 3, 'say "hi"'), (1.25, "ünïcödé")]):
+		parselmouth.praat.call(text_grid, "Insert boundary", 1, time)
+		parselmouth.praat.call(text_grid, "Set interval text", 1, i + 2, label)
+		parselmouth.praat.call(text_grid, "Insert point", 2, time + 0.5, label)
+	file_path = tmp_path / "text_grid.TextGrid"
+	if short:
+		text_grid.save_as_short_text_file(str(file_path))
+	else:
+		text_grid.save_as_text_file(str(file_path))
+	assert parselmouth.read(str(file_path)) == text_grid
+
+	data = file_path.read_bytes()
+	lines = data.decode("utf-16" if data.startswith(b"\xfe\xff") else "utf-8").splitlines()  # non-ASCII labels are written as UTF-16 by default
+	if short:
+		assert lines[15:21] == ["0.1", "0.3333333333333333", '"a"', "0.3333333333333333", "1.25", '"say ""hi"""']
+	else:
+		assert lines[18:22] == ["        intervals [2]:", "            xmin = 0.1 ", "            xmax = 0.3333333333333333 ", '            text = "a" ']
+		assert '            mark = "say ""hi""" ' in lines